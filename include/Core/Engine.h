@@ -13,6 +13,8 @@ class ModuleManager;
 class Scene;
 class RenderSystem;
 class ECSPhysicsSystem;
+class SpatialIndexSystem;
+class SpatialHashSystem;
 
 namespace ECS { class Coordinator; }
 
@@ -40,6 +42,8 @@ private:
 
     std::shared_ptr<RenderSystem>      m_RenderSystem;
     std::shared_ptr<ECSPhysicsSystem>  m_ECSPhysicsSystem;
+    std::shared_ptr<SpatialIndexSystem> m_SpatialIndex;
+    std::shared_ptr<SpatialHashSystem>  m_SpatialHash;
 
     bool m_Running = false;
 
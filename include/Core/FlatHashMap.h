@@ -0,0 +1,582 @@
+#pragma once
+#ifndef MIST_FLAT_HASH_MAP_H
+#define MIST_FLAT_HASH_MAP_H
+
+// Open-addressing hash map/set for lookup-heavy tables (uniform caches,
+// resource tables). Drop-in for the common std::unordered_map surface —
+// find/insert/try_emplace/operator[]/erase/iteration — with different
+// costs:
+//
+//   - Elements live in one flat slot array next to a byte-per-slot control
+//     array. No per-node allocation.
+//   - Each control byte holds 7 bits of the element's hash. A probe loads
+//     eight control bytes as one word and tests them all at once (SWAR),
+//     so a lookup is a hash, one or two word compares and usually a single
+//     key compare, even for a miss at high load.
+//   - Erase leaves a tombstone only when a probe could have passed over
+//     the slot; tombstones are dropped at the next rehash.
+//
+// Unlike std::unordered_map, any insert may rehash and move elements:
+// iterators, pointers and references are invalidated by insert, reserve
+// and rehash. Erase invalidates only the erased element. The map's
+// value_type is std::pair<Key, Value>; don't change a key through an
+// iterator.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Mist {
+
+namespace detail {
+
+// Control byte values. Full slots hold hash bits 0..6 (0x00..0x7F), so the
+// high bit alone says "not an element".
+constexpr std::uint8_t kCtrlEmpty   = 0x80;
+constexpr std::uint8_t kCtrlDeleted = 0xFE;
+
+// Eight control bytes tested as one 64-bit word. Masks have bit 7 of byte
+// i set for a match at slot pos + i (byte 0 is the lowest address; the
+// load is byte-swapped on big-endian hosts).
+struct CtrlGroup {
+    static constexpr std::size_t kWidth = 8;
+    static constexpr std::uint64_t kLsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t kMsbs = 0x8080808080808080ull;
+
+    explicit CtrlGroup(const std::uint8_t* ctrl) {
+        std::memcpy(&word, ctrl, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+    }
+
+    // May flag a byte right after a real match; callers confirm with the
+    // key compare, so a false positive only costs that compare.
+    std::uint64_t Match(std::uint8_t h2) const {
+        const std::uint64_t x = word ^ (kLsbs * h2);
+        return (x - kLsbs) & ~x & kMsbs;
+    }
+    // Exact: 0x80 is the only control value with bit 7 set and bit 1 clear.
+    std::uint64_t MatchEmpty() const { return word & (~word << 6) & kMsbs; }
+    std::uint64_t MatchEmptyOrDeleted() const { return word & kMsbs; }
+
+    static std::size_t LowestIndex(std::uint64_t mask) {
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanForward64(&bit, mask);
+        return std::size_t(bit) / 8;
+#else
+        return std::size_t(__builtin_ctzll(mask)) / 8;
+#endif
+    }
+    static std::size_t HighestIndex(std::uint64_t mask) {
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanReverse64(&bit, mask);
+        return std::size_t(bit) / 8;
+#else
+        return std::size_t(63 - __builtin_clzll(mask)) / 8;
+#endif
+    }
+
+    std::uint64_t word = 0;
+};
+
+struct MapKeyOf {
+    template<typename Pair>
+    static const auto& Get(const Pair& slot) { return slot.first; }
+};
+
+struct SetKeyOf {
+    template<typename Key>
+    static const Key& Get(const Key& slot) { return slot; }
+};
+
+// Shared core of FlatHashMap and FlatHashSet. Slot is the stored element;
+// KeyOf extracts its key.
+template<typename Key, typename Slot, typename KeyOf, typename Hash, typename KeyEqual, typename Allocator>
+class FlatHashTable {
+    using SlotAlloc   = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using CtrlAlloc   = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint8_t>;
+    using SlotTraits  = std::allocator_traits<SlotAlloc>;
+    using CtrlTraits  = std::allocator_traits<CtrlAlloc>;
+
+    static constexpr std::size_t kMinCapacity = 16;
+    static constexpr std::size_t kNotFound    = ~std::size_t(0);
+
+public:
+    using key_type        = Key;
+    using value_type      = Slot;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using allocator_type  = Allocator;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+
+    template<bool Const>
+    class Iterator {
+        using Table = std::conditional_t<Const, const FlatHashTable, FlatHashTable>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Slot;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const Slot&, Slot&>;
+        using pointer           = std::conditional_t<Const, const Slot*, Slot*>;
+
+        Iterator() = default;
+        Iterator(Table* table, std::size_t index) : m_Table(table), m_Index(index) { skipEmpty(); }
+
+        // iterator -> const_iterator
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : m_Table(other.m_Table), m_Index(other.m_Index) {}
+
+        reference operator*() const { return m_Table->m_Slots[m_Index]; }
+        pointer operator->() const { return &m_Table->m_Slots[m_Index]; }
+
+        Iterator& operator++() {
+            ++m_Index;
+            skipEmpty();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_Index == b.m_Index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_Index != b.m_Index; }
+
+    private:
+        friend class FlatHashTable;
+        template<bool> friend class Iterator;
+
+        void skipEmpty() {
+            while (m_Index < m_Table->m_Capacity && m_Table->m_Ctrl[m_Index] & 0x80) ++m_Index;
+        }
+
+        Table* m_Table = nullptr;
+        std::size_t m_Index = 0;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashTable() = default;
+
+    explicit FlatHashTable(size_type capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                           const Allocator& alloc = Allocator())
+        : m_Hash(hash), m_Equal(equal), m_SlotAlloc(alloc), m_CtrlAlloc(alloc) {
+        reserve(capacity);
+    }
+
+    explicit FlatHashTable(const Allocator& alloc) : m_SlotAlloc(alloc), m_CtrlAlloc(alloc) {}
+
+    FlatHashTable(const FlatHashTable& other)
+        : m_Hash(other.m_Hash), m_Equal(other.m_Equal),
+          m_SlotAlloc(SlotTraits::select_on_container_copy_construction(other.m_SlotAlloc)),
+          m_CtrlAlloc(CtrlTraits::select_on_container_copy_construction(other.m_CtrlAlloc)) {
+        copyFrom(other);
+    }
+
+    FlatHashTable(FlatHashTable&& other) noexcept
+        : m_Hash(std::move(other.m_Hash)), m_Equal(std::move(other.m_Equal)),
+          m_SlotAlloc(std::move(other.m_SlotAlloc)), m_CtrlAlloc(std::move(other.m_CtrlAlloc)) {
+        stealFrom(other);
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other) {
+        if (this != &other) {
+            destroyAll();
+            if constexpr (SlotTraits::propagate_on_container_copy_assignment::value) {
+                m_SlotAlloc = other.m_SlotAlloc;
+                m_CtrlAlloc = other.m_CtrlAlloc;
+            }
+            m_Hash = other.m_Hash;
+            m_Equal = other.m_Equal;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept {
+        if (this != &other) {
+            destroyAll();
+            m_Hash = std::move(other.m_Hash);
+            m_Equal = std::move(other.m_Equal);
+            m_SlotAlloc = std::move(other.m_SlotAlloc);
+            m_CtrlAlloc = std::move(other.m_CtrlAlloc);
+            stealFrom(other);
+        }
+        return *this;
+    }
+
+    ~FlatHashTable() { destroyAll(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_Capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_Capacity); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    size_type capacity() const { return m_Capacity; }
+    float load_factor() const { return m_Capacity ? float(m_Size) / float(m_Capacity) : 0.0f; }
+    allocator_type get_allocator() const { return allocator_type(m_SlotAlloc); }
+
+    iterator find(const Key& key) {
+        const std::size_t index = findIndex(key, hashOf(key));
+        return index == kNotFound ? end() : iterator(this, index);
+    }
+    const_iterator find(const Key& key) const {
+        const std::size_t index = findIndex(key, hashOf(key));
+        return index == kNotFound ? end() : const_iterator(this, index);
+    }
+    bool contains(const Key& key) const { return findIndex(key, hashOf(key)) != kNotFound; }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return emplaceKey(KeyOf::Get(value), value); }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        const Key& key = KeyOf::Get(value);
+        return emplaceKey(key, std::move(value));
+    }
+
+    // Builds the element first to find its key; prefer try_emplace on a map.
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const Key& key) {
+        const std::size_t index = findIndex(key, hashOf(key));
+        if (index == kNotFound) return 0;
+        eraseAt(index);
+        return 1;
+    }
+
+    // Returns the iterator following the erased element.
+    iterator erase(const_iterator pos) {
+        eraseAt(pos.m_Index);
+        return iterator(this, pos.m_Index + 1);
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    // Destroys every element; keeps the capacity.
+    void clear() {
+        for (std::size_t i = 0; i < m_Capacity; ++i) {
+            if (isFull(m_Ctrl[i])) SlotTraits::destroy(m_SlotAlloc, m_Slots + i);
+        }
+        if (m_Capacity) std::fill(m_Ctrl, m_Ctrl + ctrlBytes(m_Capacity), kCtrlEmpty);
+        m_Size = 0;
+        m_Tombstones = 0;
+    }
+
+    // Makes room for `count` elements without further rehashing.
+    void reserve(size_type count) {
+        std::size_t capacity = kMinCapacity;
+        while (capacity - capacity / 8 < count) capacity *= 2;
+        if (capacity > m_Capacity) rehashTo(capacity);
+    }
+
+    void swap(FlatHashTable& other) noexcept {
+        using std::swap;
+        swap(m_Hash, other.m_Hash);
+        swap(m_Equal, other.m_Equal);
+        swap(m_SlotAlloc, other.m_SlotAlloc);
+        swap(m_CtrlAlloc, other.m_CtrlAlloc);
+        swap(m_Slots, other.m_Slots);
+        swap(m_Ctrl, other.m_Ctrl);
+        swap(m_Capacity, other.m_Capacity);
+        swap(m_Size, other.m_Size);
+        swap(m_Tombstones, other.m_Tombstones);
+    }
+
+protected:
+    // Inserts Slot(args...) unless `key` is present. The arguments are only
+    // consumed on insertion, which is what makes try_emplace cheap.
+    template<typename... Args>
+    std::pair<iterator, bool> emplaceKey(const Key& key, Args&&... args) {
+        const std::size_t hash = hashOf(key);
+        std::size_t target = kNotFound;
+        if (m_Capacity) {
+            const std::uint8_t h2 = std::uint8_t(hash & 0x7F);
+            std::size_t pos = homeOf(hash);
+            for (std::size_t step = CtrlGroup::kWidth;; step += CtrlGroup::kWidth) {
+                const CtrlGroup group(m_Ctrl + pos);
+                for (std::uint64_t bits = group.Match(h2); bits; bits &= bits - 1) {
+                    const std::size_t i = (pos + CtrlGroup::LowestIndex(bits)) & (m_Capacity - 1);
+                    if (m_Equal(KeyOf::Get(m_Slots[i]), key)) return {iterator(this, i), false};
+                }
+                if (target == kNotFound) {
+                    if (const std::uint64_t free = group.MatchEmptyOrDeleted()) {
+                        target = (pos + CtrlGroup::LowestIndex(free)) & (m_Capacity - 1);
+                    }
+                }
+                if (group.MatchEmpty()) break;
+                pos = (pos + step) & (m_Capacity - 1);
+            }
+        }
+
+        // Reusing a tombstone never raises the occupied count; a fresh
+        // empty slot must stay under 7/8 full.
+        if (target == kNotFound || m_Ctrl[target] == kCtrlEmpty) {
+            if (m_Capacity == 0 || m_Size + m_Tombstones + 1 > m_Capacity - m_Capacity / 8) {
+                growForInsert();
+                target = freeSlotFor(hash);
+            }
+        }
+
+        SlotTraits::construct(m_SlotAlloc, m_Slots + target, std::forward<Args>(args)...);
+        if (m_Ctrl[target] == kCtrlDeleted) --m_Tombstones;
+        setCtrl(target, std::uint8_t(hash & 0x7F));
+        ++m_Size;
+        return {iterator(this, target), true};
+    }
+
+    std::size_t findIndex(const Key& key, std::size_t hash) const {
+        if (m_Capacity == 0) return kNotFound;
+        const std::uint8_t h2 = std::uint8_t(hash & 0x7F);
+        std::size_t pos = homeOf(hash);
+        for (std::size_t step = CtrlGroup::kWidth;; step += CtrlGroup::kWidth) {
+            const CtrlGroup group(m_Ctrl + pos);
+            for (std::uint64_t bits = group.Match(h2); bits; bits &= bits - 1) {
+                const std::size_t i = (pos + CtrlGroup::LowestIndex(bits)) & (m_Capacity - 1);
+                if (m_Equal(KeyOf::Get(m_Slots[i]), key)) return i;
+            }
+            if (group.MatchEmpty()) return kNotFound;
+            pos = (pos + step) & (m_Capacity - 1);
+        }
+    }
+
+    std::size_t hashOf(const Key& key) const {
+        // std::hash is the identity for integers; mix so consecutive keys
+        // (RIDs, entity ids) don't fill one run of slots.
+        std::uint64_t h = std::uint64_t(m_Hash(key)) * 0x9E3779B97F4A7C15ull;
+        return std::size_t(h ^ (h >> 32));
+    }
+
+    Slot* m_Slots = nullptr;
+
+private:
+    static bool isFull(std::uint8_t ctrl) { return (ctrl & 0x80) == 0; }
+
+    // The first kWidth - 1 control bytes are mirrored past the end, so a
+    // group load starting at any slot reads kWidth bytes without wrapping.
+    static std::size_t ctrlBytes(std::size_t capacity) { return capacity + CtrlGroup::kWidth - 1; }
+
+    void setCtrl(std::size_t index, std::uint8_t value) {
+        m_Ctrl[index] = value;
+        if (index < CtrlGroup::kWidth - 1) m_Ctrl[m_Capacity + index] = value;
+    }
+
+    std::size_t homeOf(std::size_t hash) const { return (hash >> 7) & (m_Capacity - 1); }
+
+    // Probe groups at triangular offsets (pos + 8, + 16, + 24, ...): with a
+    // power-of-two capacity that reaches every group start, and the load
+    // cap guarantees an empty slot, so every probe ends.
+    std::size_t freeSlotFor(std::size_t hash) const {
+        std::size_t pos = homeOf(hash);
+        for (std::size_t step = CtrlGroup::kWidth;; step += CtrlGroup::kWidth) {
+            if (const std::uint64_t free = CtrlGroup(m_Ctrl + pos).MatchEmptyOrDeleted()) {
+                return (pos + CtrlGroup::LowestIndex(free)) & (m_Capacity - 1);
+            }
+            pos = (pos + step) & (m_Capacity - 1);
+        }
+    }
+
+    void growForInsert() {
+        if (m_Capacity == 0) {
+            rehashTo(kMinCapacity);
+        } else if (m_Tombstones > m_Size / 2) {
+            // Mostly tombstones: clean up in place rather than doubling.
+            rehashTo(m_Capacity);
+        } else {
+            rehashTo(m_Capacity * 2);
+        }
+    }
+
+    void eraseAt(std::size_t index) {
+        SlotTraits::destroy(m_SlotAlloc, m_Slots + index);
+        // A probe only moves past a group with no empty slot. If every
+        // group covering this slot already has one, no probe ever crossed
+        // it and it can go straight back to empty.
+        const std::size_t mask = m_Capacity - 1;
+        const std::uint64_t after = CtrlGroup(m_Ctrl + ((index + 1) & mask)).MatchEmpty();
+        const std::uint64_t before = CtrlGroup(m_Ctrl + ((index - CtrlGroup::kWidth) & mask)).MatchEmpty();
+        const std::size_t fullAfter = after ? CtrlGroup::LowestIndex(after) : CtrlGroup::kWidth;
+        const std::size_t fullBefore = before ? CtrlGroup::kWidth - 1 - CtrlGroup::HighestIndex(before)
+                                              : CtrlGroup::kWidth;
+        if (fullBefore + fullAfter + 1 < CtrlGroup::kWidth) {
+            setCtrl(index, kCtrlEmpty);
+        } else {
+            setCtrl(index, kCtrlDeleted);
+            ++m_Tombstones;
+        }
+        --m_Size;
+    }
+
+    void rehashTo(std::size_t capacity) {
+        Slot* oldSlots = m_Slots;
+        std::uint8_t* oldCtrl = m_Ctrl;
+        const std::size_t oldCapacity = m_Capacity;
+
+        m_Slots = SlotTraits::allocate(m_SlotAlloc, capacity);
+        m_Ctrl = CtrlTraits::allocate(m_CtrlAlloc, ctrlBytes(capacity));
+        std::fill(m_Ctrl, m_Ctrl + ctrlBytes(capacity), kCtrlEmpty);
+        m_Capacity = capacity;
+        m_Tombstones = 0;
+
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (!isFull(oldCtrl[i])) continue;
+            const std::size_t hash = hashOf(KeyOf::Get(oldSlots[i]));
+            const std::size_t target = freeSlotFor(hash);
+            SlotTraits::construct(m_SlotAlloc, m_Slots + target, std::move(oldSlots[i]));
+            setCtrl(target, std::uint8_t(hash & 0x7F));
+            SlotTraits::destroy(m_SlotAlloc, oldSlots + i);
+        }
+        if (oldCapacity) {
+            SlotTraits::deallocate(m_SlotAlloc, oldSlots, oldCapacity);
+            CtrlTraits::deallocate(m_CtrlAlloc, oldCtrl, ctrlBytes(oldCapacity));
+        }
+    }
+
+    void destroyAll() {
+        if (m_Capacity == 0) return;
+        for (std::size_t i = 0; i < m_Capacity; ++i) {
+            if (isFull(m_Ctrl[i])) SlotTraits::destroy(m_SlotAlloc, m_Slots + i);
+        }
+        SlotTraits::deallocate(m_SlotAlloc, m_Slots, m_Capacity);
+        CtrlTraits::deallocate(m_CtrlAlloc, m_Ctrl, ctrlBytes(m_Capacity));
+        m_Slots = nullptr;
+        m_Ctrl = nullptr;
+        m_Capacity = 0;
+        m_Size = 0;
+        m_Tombstones = 0;
+    }
+
+    // Same capacity and layout as `other`, tombstones included: they may
+    // sit in the middle of another key's probe sequence.
+    void copyFrom(const FlatHashTable& other) {
+        if (other.m_Capacity == 0) return;
+        m_Slots = SlotTraits::allocate(m_SlotAlloc, other.m_Capacity);
+        m_Ctrl = CtrlTraits::allocate(m_CtrlAlloc, ctrlBytes(other.m_Capacity));
+        m_Capacity = other.m_Capacity;
+        std::fill(m_Ctrl, m_Ctrl + ctrlBytes(m_Capacity), kCtrlEmpty);
+        for (std::size_t i = 0; i < m_Capacity; ++i) {
+            if (!isFull(other.m_Ctrl[i])) continue;
+            SlotTraits::construct(m_SlotAlloc, m_Slots + i, other.m_Slots[i]);
+            setCtrl(i, other.m_Ctrl[i]);
+            ++m_Size;
+        }
+        std::copy(other.m_Ctrl, other.m_Ctrl + ctrlBytes(m_Capacity), m_Ctrl);
+        m_Tombstones = other.m_Tombstones;
+    }
+
+    void stealFrom(FlatHashTable& other) {
+        m_Slots = std::exchange(other.m_Slots, nullptr);
+        m_Ctrl = std::exchange(other.m_Ctrl, nullptr);
+        m_Capacity = std::exchange(other.m_Capacity, 0);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_Tombstones = std::exchange(other.m_Tombstones, 0);
+    }
+
+    std::uint8_t* m_Ctrl = nullptr;
+    std::size_t m_Capacity = 0; // 0 or a power of two
+    std::size_t m_Size = 0;
+    std::size_t m_Tombstones = 0;
+    Hash m_Hash;
+    KeyEqual m_Equal;
+    SlotAlloc m_SlotAlloc;
+    CtrlAlloc m_CtrlAlloc;
+};
+
+} // namespace detail
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatHashMap
+    : public detail::FlatHashTable<Key, std::pair<Key, Value>, detail::MapKeyOf, Hash, KeyEqual, Allocator> {
+    using Base = detail::FlatHashTable<Key, std::pair<Key, Value>, detail::MapKeyOf, Hash, KeyEqual, Allocator>;
+
+public:
+    using mapped_type = Value;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using Base::Base;
+
+    FlatHashMap() = default;
+    FlatHashMap(std::initializer_list<std::pair<Key, Value>> values) {
+        this->reserve(values.size());
+        for (const auto& value : values) this->insert(value);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) result.first->second = std::forward<V>(value);
+        return result;
+    }
+
+    Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+    Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+    Value& at(const Key& key) {
+        auto it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("FlatHashMap::at: key not found");
+        return it->second;
+    }
+    const Value& at(const Key& key) const {
+        auto it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("FlatHashMap::at: key not found");
+        return it->second;
+    }
+};
+
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Allocator = std::allocator<Key>>
+class FlatHashSet : public detail::FlatHashTable<Key, Key, detail::SetKeyOf, Hash, KeyEqual, Allocator> {
+    using Base = detail::FlatHashTable<Key, Key, detail::SetKeyOf, Hash, KeyEqual, Allocator>;
+
+public:
+    using Base::Base;
+
+    FlatHashSet() = default;
+    FlatHashSet(std::initializer_list<Key> values) {
+        this->reserve(values.size());
+        for (const Key& value : values) this->insert(value);
+    }
+};
+
+} // namespace Mist
+
+#endif // MIST_FLAT_HASH_MAP_H
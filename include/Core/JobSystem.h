@@ -0,0 +1,188 @@
+#pragma once
+#ifndef MIST_JOB_SYSTEM_H
+#define MIST_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Mist {
+
+// Where a job is allowed to run. MainThread jobs only ever execute on the
+// thread that called BindMainThread() — that's the thread owning the GL
+// context, so anything touching GL (texture/mesh uploads after a
+// background decode) goes there.
+enum class JobAffinity {
+    Any,
+    MainThread,
+};
+
+namespace detail {
+
+struct Job;
+
+// Completion counter shared by one or more jobs. `remaining` is only
+// decremented under `mutex` so a dependency registered concurrently with
+// the last job finishing is either seen as done or gets released.
+struct JobCounter {
+    std::atomic<int>                  remaining{0};
+    std::mutex                        mutex;
+    std::condition_variable           cv;
+    std::vector<std::shared_ptr<Job>> continuations;
+    std::exception_ptr                error;
+};
+
+struct Job {
+    std::function<void()>       fn;
+    std::shared_ptr<JobCounter> counter;
+    std::atomic<int>            unmet{0}; // dependencies not yet finished
+    JobAffinity                 affinity = JobAffinity::Any;
+};
+
+} // namespace detail
+
+// Refers to one scheduled job, or to every chunk of a parallel-for. A
+// default-constructed handle counts as already done, so it can be passed as
+// a dependency unconditionally.
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    bool IsValid() const { return m_Counter != nullptr; }
+    bool IsDone() const { return !m_Counter || m_Counter->remaining.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    explicit JobHandle(std::shared_ptr<detail::JobCounter> counter) : m_Counter(std::move(counter)) {}
+
+    std::shared_ptr<detail::JobCounter> m_Counter;
+};
+
+// Engine-wide worker pool. One worker per hardware thread minus the main
+// thread, each with its own deque: a worker pushes and pops at the back of
+// its own deque (newest first, so nested work stays cache-warm) and, when
+// that runs dry, steals from the front of the others. Threads that aren't
+// workers submit into a shared injection queue.
+//
+// The deques are mutex-guarded rather than lock-free; every thread mostly
+// touches only its own, so the locks are uncontended in the common case.
+//
+// Wait() never just blocks: the waiting thread runs queued jobs until the
+// handle completes, which is what keeps nested waits (a job waiting on jobs
+// it scheduled) from exhausting the pool. If a job throws, the first
+// exception is stored on its handle and rethrown by Wait(); dependents
+// still run.
+class JobSystem {
+public:
+    // Process-wide instance, created on first use with DefaultWorkerCount()
+    // workers. Tests and tools can construct their own.
+    static JobSystem& Instance();
+
+    // hardware_concurrency() - 1, but never fewer than one so fire-and-forget
+    // work (LoadAsync) makes progress even when nobody calls Wait().
+    static unsigned DefaultWorkerCount();
+
+    explicit JobSystem(unsigned workerCount = DefaultWorkerCount());
+    // Runs every job already queued, then joins the workers. Jobs still
+    // waiting on an unfinished dependency are dropped.
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned GetWorkerCount() const { return static_cast<unsigned>(m_Workers.size()); }
+
+    // Records the calling thread as the GL-owning main thread. Call once,
+    // right after the context is made current.
+    void BindMainThread();
+    bool IsMainThread() const;
+    // Runs every MainThread job that is ready. Call once per frame from the
+    // main thread; Wait() on the main thread also drains them.
+    void PumpMainThread();
+
+    JobHandle Schedule(std::function<void()> fn, JobAffinity affinity = JobAffinity::Any);
+    // Runs `fn` once every handle in `dependsOn` is done.
+    JobHandle Schedule(std::function<void()> fn, const std::vector<JobHandle>& dependsOn,
+                       JobAffinity affinity = JobAffinity::Any);
+
+    // Helps run jobs until `handle` is done, then rethrows its first
+    // exception if any. Waiting on a MainThread job from a worker while the
+    // main thread waits on that worker deadlocks — don't.
+    void Wait(const JobHandle& handle);
+
+    // Splits [0, count) into ranges of at most `grain` indices and runs
+    // fn(begin, end) on each. Returns one handle covering every range.
+    template <typename Fn>
+    JobHandle ScheduleParallelFor(std::size_t count, std::size_t grain, Fn&& fn,
+                                  const std::vector<JobHandle>& dependsOn = {}) {
+        auto counter = std::make_shared<detail::JobCounter>();
+        if (count == 0) return JobHandle(counter);
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunks = (count + grain - 1) / grain;
+        counter->remaining.store(static_cast<int>(chunks), std::memory_order_relaxed);
+
+        auto body = std::make_shared<std::decay_t<Fn>>(std::forward<Fn>(fn));
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t begin = c * grain;
+            const std::size_t end = std::min(count, begin + grain);
+            submit([body, begin, end] { (*body)(begin, end); }, counter, dependsOn, JobAffinity::Any);
+        }
+        return JobHandle(counter);
+    }
+
+    // Blocking parallel-for; the calling thread takes part. Runs inline
+    // when the range fits in one grain or there are no workers.
+    template <typename Fn>
+    void ParallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        if (count <= grain || m_Workers.empty()) {
+            fn(std::size_t(0), count);
+            return;
+        }
+        Wait(ScheduleParallelFor(count, grain, [&fn](std::size_t b, std::size_t e) { fn(b, e); }));
+    }
+
+private:
+    using Job = detail::Job;
+
+    // alignas keeps neighbouring queues' mutexes off the same cache line.
+    struct alignas(64) WorkQueue {
+        std::mutex                        mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+
+    std::vector<std::thread>                m_Workers;
+    // One per worker, plus the injection queue at index GetWorkerCount().
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+
+    std::mutex                        m_MainMutex;
+    std::vector<std::shared_ptr<Job>> m_MainQueue;
+    std::atomic<std::thread::id>      m_MainThread{};
+
+    // Workers sleep on m_WakeCv while m_Queued is zero.
+    std::mutex              m_WakeMutex;
+    std::condition_variable m_WakeCv;
+    std::atomic<int>        m_Queued{0};
+    bool                    m_Stop = false;
+
+    void submit(std::function<void()> fn, const std::shared_ptr<detail::JobCounter>& counter,
+                const std::vector<JobHandle>& dependsOn, JobAffinity affinity);
+    void enqueue(std::shared_ptr<Job> job);
+    std::shared_ptr<Job> findWork(int worker);
+    std::shared_ptr<Job> popMainThread();
+    void execute(const std::shared_ptr<Job>& job);
+    void workerLoop(int worker);
+};
+
+} // namespace Mist
+
+#endif // MIST_JOB_SYSTEM_H
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MIST_RANGE_ALLOCATOR_H
+#define MIST_RANGE_ALLOCATOR_H
+
+// Offset allocator over a linear range of units (vertices, indices,
+// bytes): hands out [offset, offset + count) blocks of a space it never
+// touches itself, so one GPU buffer can hold many meshes. Free blocks
+// live in an offset-ordered map; Allocate takes the best fit and Free
+// merges a block with free neighbours on both sides, so freeing
+// everything always leaves a single block again.
+//
+// Bookkeeping only, no storage and no GL: the owner grows the real
+// buffer when Allocate fails, then calls Grow and retries.
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace Mist {
+
+class RangeAllocator {
+public:
+    static constexpr std::uint32_t kInvalid = ~0u;
+
+    explicit RangeAllocator(std::uint32_t capacity = 0);
+
+    // Offset of a free block of `count` units, or kInvalid when no block
+    // is large enough (or `count` is 0).
+    std::uint32_t Allocate(std::uint32_t count);
+    // Returns a block Allocate handed out, with the same count.
+    void Free(std::uint32_t offset, std::uint32_t count);
+    // Extends the space to `capacity` units; the new tail is free. Never
+    // shrinks.
+    void Grow(std::uint32_t capacity);
+
+    std::uint32_t Capacity() const { return m_Capacity; }
+    std::uint32_t Used() const { return m_Used; }
+    std::uint32_t LargestFree() const;
+    std::size_t FreeBlockCount() const { return m_Free.size(); }
+
+private:
+    std::map<std::uint32_t, std::uint32_t> m_Free; // offset -> count
+    std::uint32_t m_Capacity = 0;
+    std::uint32_t m_Used = 0;
+};
+
+} // namespace Mist
+
+#endif // MIST_RANGE_ALLOCATOR_H
@@ -8,6 +8,8 @@ class InputManager;
 class PhysicsSystem;
 class Renderer;
 class Scene;
+class SpatialIndexSystem;
+class SpatialHashSystem;
 
 // Global service registry. Previously also held FPSGameManager and
 // EnemyAISystem pointers; those were removed alongside the FPS gameplay
@@ -26,6 +28,8 @@ public:
     void SetPhysicsSystem(PhysicsSystem* p) { m_PhysicsSystem = p; }
     void SetRenderer(Renderer* r)           { m_Renderer = r; }
     void SetScene(Scene* s)                 { m_Scene = s; }
+    void SetSpatialIndex(SpatialIndexSystem* s) { m_SpatialIndex = s; }
+    void SetSpatialHash(SpatialHashSystem* s)   { m_SpatialHash = s; }
 
     Coordinator*    GetCoordinator()    const { return m_Coordinator; }
     UIManager*      GetUIManager()      const { return m_UIManager; }
@@ -33,6 +37,8 @@ public:
     PhysicsSystem*  GetPhysicsSystem()  const { return m_PhysicsSystem; }
     Renderer*       GetRenderer()       const { return m_Renderer; }
     Scene*          GetScene()          const { return m_Scene; }
+    SpatialIndexSystem* GetSpatialIndex() const { return m_SpatialIndex; }
+    SpatialHashSystem*  GetSpatialHash()  const { return m_SpatialHash; }
 
 private:
     ServiceLocator() = default;
@@ -42,6 +48,8 @@ private:
     PhysicsSystem* m_PhysicsSystem = nullptr;
     Renderer*      m_Renderer      = nullptr;
     Scene*         m_Scene         = nullptr;
+    SpatialIndexSystem* m_SpatialIndex = nullptr;
+    SpatialHashSystem*  m_SpatialHash  = nullptr;
 };
 
 #endif // MIST_SERVICE_LOCATOR_H
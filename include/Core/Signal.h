@@ -7,11 +7,18 @@
 // a handle that can be passed to `Disconnect` later. `Emit(args...)` fires
 // every connected callback in registration order.
 //
-// Thread-safety: guarded by an internal mutex. A connection made during
-// Emit on the same thread is queued and applied at the start of the next
-// Emit; this mirrors Godot's behaviour and avoids iterator invalidation
-// during dispatch.
+// Thread-safety: the connected slots are an immutable list published
+// through an atomic pointer. Connect/Disconnect copy the list, edit the
+// copy and swap it in under a writer mutex; Emit never locks or allocates —
+// it pins the current list, walks it and unpins. So a Connect or
+// Disconnect made during Emit (from a callback or another thread) takes
+// effect from the next Emit, as in Godot: the Emit in flight finishes on
+// the list it started with.
+//
+// Replaced lists are freed by the next Connect/Disconnect that finds no
+// Emit in progress, or by the destructor.
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <mutex>
@@ -26,76 +33,95 @@ public:
     using Callback   = std::function<void(Args...)>;
     using Connection = std::size_t;
 
+    Signal() = default;
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
+
+    ~Signal() {
+        delete m_Slots.load(std::memory_order_relaxed);
+        for (const SlotList* list : m_Retired) delete list;
+    }
+
     // Register a callback. Returns an opaque connection ID that remains
     // stable across later Connect/Disconnect calls — caller stashes it
     // somewhere if they ever want to Disconnect.
     Connection Connect(Callback cb) {
-        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
         const Connection id = m_NextId++;
-        if (m_Emitting) {
-            // Queue the insert; flushed at the next Emit.
-            m_PendingAdds.push_back({id, std::move(cb)});
-        } else {
-            m_Slots.push_back({id, std::move(cb)});
-        }
+        const SlotList* current = m_Slots.load(std::memory_order_relaxed);
+        auto* next = current ? new SlotList(*current) : new SlotList;
+        next->push_back({id, std::move(cb)});
+        publish(current, next);
         return id;
     }
 
     // Remove a connection. Safe to call from inside a callback — the
     // removal takes effect after the current Emit completes.
     void Disconnect(Connection id) {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-        if (m_Emitting) {
-            m_PendingRemoves.push_back(id);
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        const SlotList* current = m_Slots.load(std::memory_order_relaxed);
+        if (!current) return;
+        auto* next = new SlotList;
+        next->reserve(current->size());
+        for (const Slot& slot : *current) {
+            if (slot.id != id) next->push_back(slot);
+        }
+        if (next->size() == current->size()) {
+            delete next; // unknown id
             return;
         }
-        eraseId(id);
+        publish(current, next);
     }
 
     // Fire every connected callback in registration order. Exceptions in
-    // callbacks propagate through (caller's problem) — we just make sure
-    // the emitting flag and pending-ops queues stay consistent.
+    // callbacks propagate through (caller's problem) — the pin is released
+    // on the way out either way.
     void Emit(Args... args) {
-        std::unique_lock<std::mutex> lock(m_Mutex);
-        // Snapshot slots under lock so a concurrent Connect/Disconnect
-        // doesn't invalidate the iteration.
-        auto snapshot = m_Slots;
-        m_Emitting = true;
-        lock.unlock();
-
-        for (auto& [id, cb] : snapshot) {
-            cb(args...);
+        // Pin before loading: a writer that swaps the list after this
+        // point sees the pin and leaves the old list alive.
+        EmitPin pin(m_Emitting);
+        const SlotList* slots = m_Slots.load(std::memory_order_seq_cst);
+        if (!slots) return;
+        for (const Slot& slot : *slots) {
+            slot.cb(args...);
         }
-
-        lock.lock();
-        m_Emitting = false;
-        // Apply deferred ops.
-        for (auto id : m_PendingRemoves) eraseId(id);
-        m_PendingRemoves.clear();
-        for (auto& p : m_PendingAdds) m_Slots.push_back(std::move(p));
-        m_PendingAdds.clear();
     }
 
     std::size_t ConnectionCount() const {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-        return m_Slots.size();
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        const SlotList* current = m_Slots.load(std::memory_order_relaxed);
+        return current ? current->size() : 0;
     }
 
 private:
     struct Slot { Connection id; Callback cb; };
+    using SlotList = std::vector<Slot>;
+
+    struct EmitPin {
+        explicit EmitPin(std::atomic<std::size_t>& count) : count(count) {
+            count.fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~EmitPin() { count.fetch_sub(1, std::memory_order_release); }
+        std::atomic<std::size_t>& count;
+    };
 
-    void eraseId(Connection id) {
-        for (auto it = m_Slots.begin(); it != m_Slots.end(); ++it) {
-            if (it->id == id) { m_Slots.erase(it); return; }
+    // Writer side, under m_WriteMutex. Once `next` is visible, an Emit
+    // that pins from now on can only load `next`; if nothing is pinned,
+    // no Emit can still be walking `current` or anything retired earlier.
+    void publish(const SlotList* current, const SlotList* next) {
+        m_Slots.store(next, std::memory_order_seq_cst);
+        if (current) m_Retired.push_back(current);
+        if (m_Emitting.load(std::memory_order_seq_cst) == 0) {
+            for (const SlotList* list : m_Retired) delete list;
+            m_Retired.clear();
         }
     }
 
-    mutable std::mutex m_Mutex;
-    std::vector<Slot>  m_Slots;
-    std::vector<Slot>  m_PendingAdds;
-    std::vector<Connection> m_PendingRemoves;
-    Connection m_NextId  = 1;
-    bool       m_Emitting = false;
+    std::atomic<const SlotList*> m_Slots{nullptr};
+    std::atomic<std::size_t>     m_Emitting{0};    // Emits in flight
+    mutable std::mutex           m_WriteMutex;     // Connect/Disconnect only
+    std::vector<const SlotList*> m_Retired;        // replaced, maybe still walked
+    Connection                   m_NextId = 1;
 };
 
 } // namespace Mist
@@ -0,0 +1,174 @@
+#pragma once
+#ifndef MIST_SLOT_MAP_H
+#define MIST_SLOT_MAP_H
+
+// Generational handle table: Insert hands back a SlotMapKey, Get resolves
+// it with two array reads and a generation compare, and Erase bumps the
+// slot's generation so every old key for it reads as absent instead of
+// aliasing whatever is stored there next. The generation doubles as the
+// occupancy bit: odd while the slot holds a value, even while it's free,
+// so a key whose generation happens to match a free slot (forged, from
+// another map, or a Pack round-trip gone wrong) still misses. Values are kept packed in one
+// array (swap-and-pop on erase), so iterating a SlotMap walks contiguous
+// memory the way iterating a ComponentArray does.
+//
+// Pointers into a SlotMap are invalidated by Insert (the value array may
+// grow) and by Erase (the last value moves into the hole); keep keys.
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Mist {
+
+struct SlotMapKey {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 = never issued; default key is null
+
+    constexpr bool IsValid() const noexcept { return generation != 0; }
+
+    // Round-trips through one 64-bit integer (RIDs, Lua handles). A valid
+    // key never packs to 0.
+    constexpr std::uint64_t Pack() const noexcept { return (std::uint64_t(generation) << 32) | index; }
+    static constexpr SlotMapKey Unpack(std::uint64_t packed) noexcept {
+        return {std::uint32_t(packed & 0xFFFFFFFFu), std::uint32_t(packed >> 32)};
+    }
+
+    constexpr bool operator==(const SlotMapKey& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+    constexpr bool operator!=(const SlotMapKey& other) const noexcept { return !(*this == other); }
+};
+
+template<typename T, typename Allocator = std::allocator<T>>
+class SlotMap {
+    struct Slot {
+        std::uint32_t generation = 1; // odd = occupied, even = free
+        // Position in m_Values while occupied; next free slot otherwise.
+        // Only meaningful as an index once `generation` says occupied.
+        std::uint32_t indexOrNext = 0;
+    };
+
+    using SlotAlloc  = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using IndexAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+
+    static constexpr std::uint32_t kNoFree = std::numeric_limits<std::uint32_t>::max();
+
+public:
+    using value_type     = T;
+    using size_type      = std::size_t;
+    using allocator_type = Allocator;
+    using iterator       = typename std::vector<T, Allocator>::iterator;
+    using const_iterator = typename std::vector<T, Allocator>::const_iterator;
+
+    SlotMap() = default;
+    explicit SlotMap(const Allocator& alloc) : m_Values(alloc), m_ValueSlots(IndexAlloc(alloc)), m_Slots(SlotAlloc(alloc)) {}
+
+    template<typename... Args>
+    SlotMapKey Emplace(Args&&... args) {
+        m_Values.emplace_back(std::forward<Args>(args)...);
+
+        std::uint32_t slotIndex;
+        if (m_FreeHead != kNoFree) {
+            slotIndex = m_FreeHead;
+            m_FreeHead = m_Slots[slotIndex].indexOrNext;
+            ++m_Slots[slotIndex].generation; // even -> odd
+        } else {
+            assert(m_Slots.size() < kNoFree && "SlotMap is full");
+            slotIndex = static_cast<std::uint32_t>(m_Slots.size());
+            m_Slots.emplace_back();
+        }
+        Slot& slot = m_Slots[slotIndex];
+        slot.indexOrNext = static_cast<std::uint32_t>(m_Values.size() - 1);
+        m_ValueSlots.push_back(slotIndex);
+        return {slotIndex, slot.generation};
+    }
+
+    SlotMapKey Insert(const T& value) { return Emplace(value); }
+    SlotMapKey Insert(T&& value) { return Emplace(std::move(value)); }
+
+    // nullptr for a null, erased or foreign key.
+    T* Get(SlotMapKey key) {
+        if (key.index >= m_Slots.size()) return nullptr;
+        const Slot& slot = m_Slots[key.index];
+        if (!isOccupied(slot) || slot.generation != key.generation) return nullptr;
+        return &m_Values[slot.indexOrNext];
+    }
+    const T* Get(SlotMapKey key) const { return const_cast<SlotMap*>(this)->Get(key); }
+
+    bool Contains(SlotMapKey key) const { return Get(key) != nullptr; }
+
+    // Returns false if the key was already dead.
+    bool Erase(SlotMapKey key) {
+        if (!Contains(key)) return false;
+        Slot& slot = m_Slots[key.index];
+        const std::uint32_t hole = slot.indexOrNext;
+        const std::uint32_t last = static_cast<std::uint32_t>(m_Values.size() - 1);
+        if (hole != last) {
+            m_Values[hole] = std::move(m_Values[last]);
+            m_ValueSlots[hole] = m_ValueSlots[last];
+            m_Slots[m_ValueSlots[hole]].indexOrNext = hole;
+        }
+        m_Values.pop_back();
+        m_ValueSlots.pop_back();
+
+        ++slot.generation; // odd -> even
+        slot.indexOrNext = m_FreeHead;
+        m_FreeHead = key.index;
+        return true;
+    }
+
+    // Erases everything. Every outstanding key goes stale.
+    void Clear() {
+        for (std::uint32_t valueIndex = 0; valueIndex < m_ValueSlots.size(); ++valueIndex) {
+            const std::uint32_t slotIndex = m_ValueSlots[valueIndex];
+            Slot& slot = m_Slots[slotIndex];
+            ++slot.generation;
+            slot.indexOrNext = m_FreeHead;
+            m_FreeHead = slotIndex;
+        }
+        m_Values.clear();
+        m_ValueSlots.clear();
+    }
+
+    void Reserve(size_type count) {
+        m_Values.reserve(count);
+        m_ValueSlots.reserve(count);
+        m_Slots.reserve(count);
+    }
+
+    size_type Size() const { return m_Values.size(); }
+    bool Empty() const { return m_Values.empty(); }
+
+    // Packed values in unspecified order; KeyAt(i) is the key of Data()[i].
+    iterator begin() { return m_Values.begin(); }
+    iterator end() { return m_Values.end(); }
+    const_iterator begin() const { return m_Values.begin(); }
+    const_iterator end() const { return m_Values.end(); }
+    T* Data() { return m_Values.data(); }
+    const T* Data() const { return m_Values.data(); }
+
+    SlotMapKey KeyAt(size_type valueIndex) const {
+        const std::uint32_t slotIndex = m_ValueSlots[valueIndex];
+        return {slotIndex, m_Slots[slotIndex].generation};
+    }
+
+private:
+    // Occupied generations are odd, so a valid key is never 0: the wrap
+    // from 0xFFFFFFFF lands on 0, a free generation, and the next Emplace
+    // takes it to 1.
+    static bool isOccupied(const Slot& slot) { return (slot.generation & 1u) != 0; }
+
+    std::vector<T, Allocator> m_Values;
+    std::vector<std::uint32_t, IndexAlloc> m_ValueSlots; // m_Values index -> slot
+    std::vector<Slot, SlotAlloc> m_Slots;
+    std::uint32_t m_FreeHead = kNoFree;
+};
+
+} // namespace Mist
+
+#endif // MIST_SLOT_MAP_H
@@ -0,0 +1,295 @@
+#pragma once
+#ifndef MIST_SMALL_VECTOR_H
+#define MIST_SMALL_VECTOR_H
+
+// std::vector with room for N elements inside the object. Lists that are
+// almost always short (a mesh's submeshes, an entity's children, the
+// bindings of one draw) stay off the heap entirely; past N the elements
+// move to allocator storage and it behaves like std::vector. It never
+// moves back inline, so the capacity is kept across clear().
+//
+// Moving a SmallVector whose elements are inline moves each element, so
+// pointers into the source don't follow them the way they would with a
+// heap buffer.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Mist {
+
+template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "use std::vector for no inline storage");
+    using Traits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type             = T;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using allocator_type         = Allocator;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type kInlineCapacity = N;
+
+    SmallVector() = default;
+    explicit SmallVector(const Allocator& alloc) : m_Alloc(alloc) {}
+
+    explicit SmallVector(size_type count, const Allocator& alloc = Allocator()) : m_Alloc(alloc) {
+        resize(count);
+    }
+
+    SmallVector(size_type count, const T& value, const Allocator& alloc = Allocator()) : m_Alloc(alloc) {
+        assign(count, value);
+    }
+
+    template<typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    SmallVector(It first, It last, const Allocator& alloc = Allocator()) : m_Alloc(alloc) {
+        assign(first, last);
+    }
+
+    SmallVector(std::initializer_list<T> values, const Allocator& alloc = Allocator()) : m_Alloc(alloc) {
+        assign(values.begin(), values.end());
+    }
+
+    SmallVector(const SmallVector& other) : m_Alloc(Traits::select_on_container_copy_construction(other.m_Alloc)) {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_Alloc(std::move(other.m_Alloc)) {
+        takeFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+                if (m_Alloc != other.m_Alloc) release();
+                m_Alloc = other.m_Alloc;
+            }
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            release();
+            m_Alloc = std::move(other.m_Alloc);
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    ~SmallVector() { release(); }
+
+    void assign(size_type count, const T& value) {
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(m_Data, count, value);
+        m_Size = count;
+    }
+
+    template<typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace_back(*first);
+    }
+
+    iterator begin() { return m_Data; }
+    iterator end() { return m_Data + m_Size; }
+    const_iterator begin() const { return m_Data; }
+    const_iterator end() const { return m_Data + m_Size; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return m_Size; }
+    size_type capacity() const { return m_Capacity; }
+    bool empty() const { return m_Size == 0; }
+    // True while the elements live in the object itself.
+    bool is_inline() const { return m_Data == inlineData(); }
+    allocator_type get_allocator() const { return m_Alloc; }
+
+    T* data() { return m_Data; }
+    const T* data() const { return m_Data; }
+
+    T& operator[](size_type i) {
+        assert(i < m_Size);
+        return m_Data[i];
+    }
+    const T& operator[](size_type i) const {
+        assert(i < m_Size);
+        return m_Data[i];
+    }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[m_Size - 1]; }
+    const T& back() const { return (*this)[m_Size - 1]; }
+
+    void reserve(size_type capacity) {
+        if (capacity > m_Capacity) reallocate(capacity);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (m_Size == m_Capacity) {
+            // Build the element first: args may refer into our own storage.
+            T value(std::forward<Args>(args)...);
+            reallocate(grownCapacity(m_Size + 1));
+            Traits::construct(m_Alloc, m_Data + m_Size, std::move(value));
+        } else {
+            Traits::construct(m_Alloc, m_Data + m_Size, std::forward<Args>(args)...);
+        }
+        return m_Data[m_Size++];
+    }
+
+    void pop_back() {
+        assert(m_Size > 0);
+        Traits::destroy(m_Alloc, m_Data + --m_Size);
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const size_type index = static_cast<size_type>(pos - begin());
+        assert(index <= m_Size);
+        if (index == m_Size) {
+            emplace_back(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+        T value(std::forward<Args>(args)...);
+        emplace_back(std::move(back()));
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+        m_Data[index] = std::move(value);
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        iterator out = begin() + (first - begin());
+        const size_type count = static_cast<size_type>(last - first);
+        if (count == 0) return out;
+        std::move(out + count, end(), out);
+        for (size_type i = m_Size - count; i < m_Size; ++i) Traits::destroy(m_Alloc, m_Data + i);
+        m_Size -= count;
+        return out;
+    }
+
+    void resize(size_type count) {
+        if (count < m_Size) {
+            erase(begin() + count, end());
+            return;
+        }
+        reserve(count);
+        for (; m_Size < count; ++m_Size) Traits::construct(m_Alloc, m_Data + m_Size);
+    }
+
+    void resize(size_type count, const T& value) {
+        if (count < m_Size) {
+            erase(begin() + count, end());
+            return;
+        }
+        if (count > m_Capacity) {
+            T copy(value); // value may live in our storage
+            reallocate(grownCapacity(count));
+            for (; m_Size < count; ++m_Size) Traits::construct(m_Alloc, m_Data + m_Size, copy);
+            return;
+        }
+        for (; m_Size < count; ++m_Size) Traits::construct(m_Alloc, m_Data + m_Size, value);
+    }
+
+    void clear() {
+        for (size_type i = 0; i < m_Size; ++i) Traits::destroy(m_Alloc, m_Data + i);
+        m_Size = 0;
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+
+private:
+    T* inlineData() { return std::launder(reinterpret_cast<T*>(&m_Inline)); }
+    const T* inlineData() const { return std::launder(reinterpret_cast<const T*>(&m_Inline)); }
+
+    size_type grownCapacity(size_type needed) const { return std::max(needed, m_Capacity * 2); }
+
+    void reallocate(size_type capacity) {
+        T* data = Traits::allocate(m_Alloc, capacity);
+        for (size_type i = 0; i < m_Size; ++i) {
+            Traits::construct(m_Alloc, data + i, std::move_if_noexcept(m_Data[i]));
+            Traits::destroy(m_Alloc, m_Data + i);
+        }
+        if (!is_inline()) Traits::deallocate(m_Alloc, m_Data, m_Capacity);
+        m_Data = data;
+        m_Capacity = capacity;
+    }
+
+    // Destroys the elements and frees heap storage; leaves the vector
+    // empty and inline.
+    void release() {
+        clear();
+        if (!is_inline()) Traits::deallocate(m_Alloc, m_Data, m_Capacity);
+        m_Data = inlineData();
+        m_Capacity = N;
+    }
+
+    // Expects *this empty and inline. Heap storage is stolen; inline
+    // elements are moved one by one.
+    void takeFrom(SmallVector& other) {
+        if (!other.is_inline()) {
+            m_Data = std::exchange(other.m_Data, other.inlineData());
+            m_Capacity = std::exchange(other.m_Capacity, N);
+            m_Size = std::exchange(other.m_Size, 0);
+            return;
+        }
+        for (size_type i = 0; i < other.m_Size; ++i) {
+            Traits::construct(m_Alloc, m_Data + i, std::move(other.m_Data[i]));
+        }
+        m_Size = other.m_Size;
+        other.clear();
+    }
+
+    std::aligned_storage_t<sizeof(T) * N, alignof(T)> m_Inline;
+    T* m_Data = inlineData();
+    size_type m_Size = 0;
+    size_type m_Capacity = N;
+    Allocator m_Alloc;
+};
+
+} // namespace Mist
+
+#endif // MIST_SMALL_VECTOR_H
@@ -25,6 +25,9 @@ public:
     // CPU timing
     void BeginCPUSection(const std::string& name);
     void EndCPUSection(const std::string& name);
+    // Record a CPU duration measured elsewhere (e.g. on a worker thread by
+    // SystemScheduler). Main thread only, like the Begin/End pair.
+    void RecordCPUSection(const std::string& name, float ms);
 
     // GPU timing (uses GL_TIME_ELAPSED queries)
     void BeginGPUSection(const std::string& name);
@@ -54,6 +57,13 @@ public:
     void ResetTriangles() { m_Triangles = 0; }
     int GetTriangles() const { return m_Triangles; }
 
+    // Instancing: batches drawn with one instanced call this frame and the
+    // entities they covered (the main pass; shadows repeat the same runs)
+    void AddInstanceGroups(int groups, int instances) { m_InstanceGroups += groups; m_Instances += instances; }
+    void ResetInstanceStats() { m_InstanceGroups = 0; m_Instances = 0; }
+    int GetInstanceGroups() const { return m_InstanceGroups; }
+    int GetInstances() const { return m_Instances; }
+
     bool IsEnabled() const { return m_Enabled; }
     void SetEnabled(bool enabled) { m_Enabled = enabled; }
 
@@ -89,6 +99,8 @@ private:
     // Counters
     int m_DrawCalls = 0;
     int m_Triangles = 0;
+    int m_InstanceGroups = 0;
+    int m_Instances = 0;
 
     ProfileSection& getOrCreateSection(const std::string& name);
 };
@@ -0,0 +1,383 @@
+#pragma once
+#ifndef MIST_ARCHETYPE_STORAGE_H
+#define MIST_ARCHETYPE_STORAGE_H
+
+#include "Component.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include "ParallelForEach.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Archetype/chunk storage — the optional alternative to the per-type
+// sparse-set ComponentArrays. Entities whose archetype-stored components
+// form the same Signature share an Archetype; its rows live in fixed-size
+// chunks with one SoA column per component, so a multi-component View walks
+// plain arrays instead of doing a lookup per component per entity.
+//
+// Which types live here is decided per type at
+// Coordinator::RegisterComponent time; everything else stays in
+// ComponentManager. An entity's archetype is keyed only by its
+// archetype-stored components, so adding a sparse-set component (say a
+// ScriptComponent) never moves its chunk data.
+//
+// Structural changes (add/remove of an archetype-stored component, entity
+// destruction) move the entity's row between archetypes and swap-and-pop
+// the hole, so rows don't keep a stable address. Don't hold component
+// references across structural changes, and don't make them from inside
+// a View iteration — serial or parallel (see ParallelForEach.h).
+class ArchetypeStorage {
+  public:
+    static constexpr std::size_t kChunkBytes = 16 * 1024;
+
+    ArchetypeStorage() = default;
+    ~ArchetypeStorage();
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    template <typename T> void RegisterColumn(ComponentType type) {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "over-aligned components are not supported in chunks");
+        ColumnInfo& info = m_Columns[type];
+        info.size = sizeof(T);
+        info.align = alignof(T);
+        info.relocate = [](void* dst, void* src) {
+            T* from = static_cast<T*>(src);
+            new (dst) T(std::move(*from));
+            from->~T();
+        };
+        info.destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+    }
+
+    template <typename T>
+    void Add(Entity entity, ComponentType type, T component, ChangeTick tick = 0) {
+        Signature signature = SignatureOf(entity);
+        if (signature.test(type)) {
+            Get<T>(entity, type) = std::move(component);
+        } else {
+            signature.set(type);
+            changeArchetype(entity, signature);
+            new (componentPtr(entity, type)) T(std::move(component));
+        }
+        std::vector<ChangeTick>& ticks = m_Ticks[type];
+        const Entity index = EntityIndex(entity);
+        if (index >= ticks.size()) ticks.resize(static_cast<std::size_t>(index) + 1, 0);
+        ticks[index] = tick;
+        bumpLastChanged(type, tick);
+    }
+
+    // Add for several types at once over a batch: each entity moves to its
+    // final archetype in one step instead of once per type. Only the types
+    // set in `handled` are touched (the caller's other Ts live elsewhere);
+    // components[k][i] goes to entities[i].
+    template <typename... Ts>
+    void AddBatch(const Entity* entities, std::size_t count,
+                  const std::array<ComponentType, sizeof...(Ts)>& types, const Signature& handled,
+                  ChangeTick tick, const Ts*... components) {
+        Signature added;
+        for (ComponentType t : types) {
+            if (handled.test(t)) added.set(t);
+        }
+        if (added.none()) return;
+
+        for (ComponentType t : types) {
+            if (!added.test(t)) continue;
+            std::vector<ChangeTick>& ticks = m_Ticks[t];
+            for (std::size_t i = 0; i < count; ++i) {
+                const Entity index = EntityIndex(entities[i]);
+                if (index >= ticks.size()) ticks.resize(static_cast<std::size_t>(index) + 1, 0);
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const Entity entity = entities[i];
+            const Signature before = SignatureOf(entity);
+            if ((before | added) != before) changeArchetype(entity, before | added);
+            placeBatchRow(entity, i, types, added, before, tick, std::index_sequence_for<Ts...>{},
+                          components...);
+        }
+        for (ComponentType t : types) {
+            if (added.test(t)) bumpLastChanged(t, tick);
+        }
+    }
+
+    void Remove(Entity entity, ComponentType type);
+
+    template <typename T> T& Get(Entity entity, ComponentType type) {
+        if (!Has(entity, type)) {
+            throw std::runtime_error("Entity does not have component");
+        }
+        return *static_cast<T*>(componentPtr(entity, type));
+    }
+
+    bool Has(Entity entity, ComponentType type) const {
+        return SignatureOf(entity).test(type);
+    }
+
+    void EntityDestroyed(Entity entity);
+
+    // Change ticks, same contract as ComponentArray's. Rows move between
+    // chunks, so they're kept in a per-type side table indexed by
+    // EntityIndex() rather than next to the data.
+    void MarkChanged(Entity entity, ComponentType type, ChangeTick tick) {
+        if (!Has(entity, type)) return;
+        m_Ticks[type][EntityIndex(entity)] = tick;
+        bumpLastChanged(type, tick);
+    }
+
+    ChangeTick GetChangeTick(Entity entity, ComponentType type) const {
+        return Has(entity, type) ? m_Ticks[type][EntityIndex(entity)] : 0;
+    }
+
+    ChangeTick LastChangeTick(ComponentType type) const {
+        return m_LastChanged[type].load(std::memory_order_relaxed);
+    }
+
+    // fn(Entity, void* component) for every `type` component stamped after
+    // `since`. Typed access goes through Coordinator::ForEachChanged.
+    template <typename Fn> void ForEachChanged(ComponentType type, ChangeTick since, Fn&& fn) {
+        if (LastChangeTick(type) <= since) return;
+        const std::vector<ChangeTick>& ticks = m_Ticks[type];
+        const std::size_t size = m_Columns[type].size;
+        ForEachChunk(std::array<ComponentType, 1>{type},
+                     [&](std::size_t count, const Entity* entities, void* const* columns) {
+                         auto* column = static_cast<std::byte*>(columns[0]);
+                         for (std::size_t i = 0; i < count; ++i) {
+                             if (ticks[EntityIndex(entities[i])] > since) {
+                                 fn(entities[i], static_cast<void*>(column + i * size));
+                             }
+                         }
+                     });
+    }
+
+    // Signature of the entity's archetype-stored components only.
+    Signature SignatureOf(Entity entity) const {
+        const Entity index = EntityIndex(entity);
+        if (index >= m_Locations.size()) return {};
+        const Location& loc = m_Locations[index];
+        if (loc.archetype == kNoArchetype || loc.entity != entity) return {};
+        return m_Archetypes[loc.archetype]->signature;
+    }
+
+    std::size_t ArchetypeCount() const { return m_Archetypes.size(); }
+
+    // Calls fn(count, const Entity*, void* const* columns) once per
+    // non-empty chunk of every archetype containing all of `types`.
+    // `columns[i]` is the start of the column for `types[i]`. Typed access
+    // goes through ArchetypeView below.
+    template <std::size_t N, typename Fn>
+    void ForEachChunk(const std::array<ComponentType, N>& types, Fn&& fn) {
+        Signature mask;
+        for (ComponentType t : types) mask.set(t);
+
+        std::array<void*, N> columns{};
+        for (auto& archetype : m_Archetypes) {
+            Archetype& a = *archetype;
+            if ((a.signature & mask) != mask) continue;
+            for (Chunk& chunk : a.chunks) {
+                if (chunk.count == 0) continue;
+                for (std::size_t i = 0; i < N; ++i) {
+                    columns[i] = chunk.memory.get() + a.offsets[a.column[types[i]]];
+                }
+                fn(static_cast<std::size_t>(chunk.count),
+                   reinterpret_cast<const Entity*>(chunk.memory.get()), columns.data());
+            }
+        }
+    }
+
+    // ForEachChunk spread over the job system. Chunks are never split, so
+    // each job owns whole 16 KiB blocks; jobs take roughly options.grain
+    // rows' worth of chunks. Fewer than options.serialThreshold matching
+    // rows run on the caller.
+    template <std::size_t N, typename Fn>
+    void ParallelForEachChunk(const std::array<ComponentType, N>& types,
+                              const ParallelForOptions& options, Fn&& fn) {
+        struct Span {
+            std::size_t count;
+            const Entity* entities;
+            std::array<void*, N> columns;
+        };
+        std::vector<Span> spans;
+        std::size_t rows = 0;
+        ForEachChunk(types, [&](std::size_t count, const Entity* entities, void* const* columns) {
+            Span span{count, entities, {}};
+            std::copy(columns, columns + N, span.columns.begin());
+            spans.push_back(span);
+            rows += count;
+        });
+
+        Mist::ecs::ParallelPassScope pass(m_ParallelPasses);
+        auto run = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                fn(spans[i].count, spans[i].entities, spans[i].columns.data());
+            }
+        };
+        if (spans.empty() || rows < options.serialThreshold) {
+            run(0, spans.size());
+            return;
+        }
+        const std::size_t rowsPerChunk = std::max<std::size_t>(rows / spans.size(), 1);
+        const std::size_t chunksPerJob = std::max<std::size_t>(options.grain / rowsPerChunk, 1);
+        Mist::JobSystem& jobs = options.jobs ? *options.jobs : Mist::JobSystem::Instance();
+        jobs.ParallelFor(spans.size(), chunksPerJob, run);
+    }
+
+  private:
+    static constexpr std::uint32_t kNoArchetype = ~std::uint32_t(0);
+
+    struct ColumnInfo {
+        std::size_t size = 0;
+        std::size_t align = 0;
+        // Move-construct into dst, then destroy src.
+        void (*relocate)(void* dst, void* src) = nullptr;
+        void (*destroy)(void* p) = nullptr;
+    };
+
+    struct Chunk {
+        std::unique_ptr<std::byte[]> memory;
+        std::uint32_t count = 0;
+    };
+
+    // Chunk layout: [Entity × capacity][column 0 × capacity][column 1 ...],
+    // each column start aligned for its type.
+    struct Archetype {
+        Signature signature;
+        std::vector<ComponentType> types;
+        std::vector<std::size_t> sizes;   // per column, bytes per element
+        std::vector<std::size_t> offsets; // per column, byte offset in chunk
+        std::array<std::int16_t, MAX_COMPONENTS> column{}; // type -> column, -1 absent
+        std::uint32_t capacity = 0;                         // rows per chunk
+        std::size_t chunkBytes = 0;
+        std::vector<Chunk> chunks;
+        std::uint32_t size = 0; // total rows; all chunks but the last are full
+    };
+
+    struct Location {
+        std::uint32_t archetype = kNoArchetype;
+        std::uint32_t row = 0;
+        Entity entity = NULL_ENTITY; // full handle, to reject stale ones
+    };
+
+    // Constructs (new to the entity) or assigns (already present) each
+    // handled component of row `i` of an AddBatch.
+    template <std::size_t N, std::size_t... I, typename... Ts>
+    void placeBatchRow(Entity entity, std::size_t i, const std::array<ComponentType, N>& types,
+                       const Signature& added, const Signature& before, ChangeTick tick,
+                       std::index_sequence<I...>, const Ts*... components) {
+        (placeComponent(entity, types[I], added, before, tick, components[i]), ...);
+    }
+
+    template <typename T>
+    void placeComponent(Entity entity, ComponentType type, const Signature& added,
+                        const Signature& before, ChangeTick tick, const T& component) {
+        if (!added.test(type)) return;
+        void* dst = componentPtr(entity, type);
+        if (before.test(type)) {
+            *static_cast<T*>(dst) = component;
+        } else {
+            new (dst) T(component);
+        }
+        m_Ticks[type][EntityIndex(entity)] = tick;
+    }
+
+    void bumpLastChanged(ComponentType type, ChangeTick tick) {
+        ChangeTick last = m_LastChanged[type].load(std::memory_order_relaxed);
+        while (last < tick && !m_LastChanged[type].compare_exchange_weak(
+                                  last, tick, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::uint32_t findOrCreateArchetype(const Signature& signature);
+    std::uint32_t allocateRow(Archetype& a, Entity entity);
+    void freeRow(Archetype& a, std::uint32_t row);
+    void changeArchetype(Entity entity, const Signature& signature);
+
+    void* columnPtr(Archetype& a, std::uint32_t row, std::size_t col) {
+        Chunk& chunk = a.chunks[row / a.capacity];
+        return chunk.memory.get() + a.offsets[col] + (row % a.capacity) * a.sizes[col];
+    }
+
+    void* componentPtr(Entity entity, ComponentType type) {
+        const Location& loc = m_Locations[EntityIndex(entity)];
+        Archetype& a = *m_Archetypes[loc.archetype];
+        return columnPtr(a, loc.row, static_cast<std::size_t>(a.column[type]));
+    }
+
+    std::array<ColumnInfo, MAX_COMPONENTS> m_Columns{};
+    std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+    std::unordered_map<Signature, std::uint32_t> m_ArchetypeIndex;
+    std::vector<Location> m_Locations; // indexed by EntityIndex()
+    std::array<std::vector<ChangeTick>, MAX_COMPONENTS> m_Ticks; // [type][EntityIndex()]
+    std::array<std::atomic<ChangeTick>, MAX_COMPONENTS> m_LastChanged{};
+    std::atomic<int> m_ParallelPasses{0};
+};
+
+// Typed multi-component iteration over ArchetypeStorage, returned by
+// Coordinator::View<Ts...>(). ForEach hands out one entity at a time;
+// ForEachChunk hands out whole column spans for loops that want to
+// vectorise or batch.
+template <typename... Ts> class ArchetypeView {
+  public:
+    ArchetypeView(ArchetypeStorage& storage, std::array<ComponentType, sizeof...(Ts)> types)
+        : m_Storage(&storage), m_Types(types) {}
+
+    // fn(Entity, Ts&...)
+    template <typename Fn> void ForEach(Fn&& fn) {
+        ForEachChunk([&](std::size_t count, const Entity* entities, Ts*... columns) {
+            for (std::size_t i = 0; i < count; ++i) {
+                fn(entities[i], columns[i]...);
+            }
+        });
+    }
+
+    // fn(std::size_t count, const Entity*, Ts*...)
+    template <typename Fn> void ForEachChunk(Fn&& fn) {
+        m_Storage->ForEachChunk(m_Types, [&](std::size_t count, const Entity* entities,
+                                             void* const* columns) {
+            invoke(fn, count, entities, columns, std::index_sequence_for<Ts...>{});
+        });
+    }
+
+    // Parallel versions of the above. Callbacks for different chunks run
+    // concurrently; no structural changes until they return.
+    template <typename Fn> void ParallelForEach(Fn&& fn, const ParallelForOptions& options = {}) {
+        ParallelForEachChunk(
+            [&](std::size_t count, const Entity* entities, Ts*... columns) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(entities[i], columns[i]...);
+                }
+            },
+            options);
+    }
+
+    template <typename Fn>
+    void ParallelForEachChunk(Fn&& fn, const ParallelForOptions& options = {}) {
+        m_Storage->ParallelForEachChunk(
+            m_Types, options, [&](std::size_t count, const Entity* entities, void* const* columns) {
+                invoke(fn, count, entities, columns, std::index_sequence_for<Ts...>{});
+            });
+    }
+
+  private:
+    template <typename Fn, std::size_t... I>
+    static void invoke(Fn& fn, std::size_t count, const Entity* entities, void* const* columns,
+                       std::index_sequence<I...>) {
+        fn(count, entities, static_cast<Ts*>(columns[I])...);
+    }
+
+    ArchetypeStorage* m_Storage;
+    std::array<ComponentType, sizeof...(Ts)> m_Types;
+};
+
+#endif // MIST_ARCHETYPE_STORAGE_H
@@ -7,4 +7,9 @@
 using ComponentType = std::uint8_t;
 const ComponentType MAX_COMPONENTS = 64;
 
+// Value of the Coordinator's change counter when a component was last
+// written (see Coordinator::MarkChanged). 0 means "never": it predates
+// every query.
+using ChangeTick = std::uint32_t;
+
 #endif // COMPONENT_H
\ No newline at end of file
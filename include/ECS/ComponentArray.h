@@ -1,94 +1,312 @@
 #ifndef COMPONENTARRAY_H
 #define COMPONENTARRAY_H
 
-#include <vector>
-#include <unordered_map>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
-#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Component.h"
 #include "Entity.h"
+#include "ParallelForEach.h"
+#include "SnapshotArena.h"
+#include "SparseEntityIndex.h"
+
+struct OwningGroupData;
+
+// What a WorldSnapshot keeps for an array whose components can't be
+// memcpy'd into its arena: a typed copy of the dense data.
+class ComponentArrayCopy {
+public:
+    virtual ~ComponentArrayCopy() = default;
+};
 
 class IComponentArray {
 public:
     virtual ~IComponentArray() = default;
     virtual void EntityDestroyed(Entity entity) = 0;
+
+    virtual size_t Size() const = 0;
+    virtual const Entity* Entities() const = 0;
+
+    // Untyped hooks for OwningGroupData, which reorders the dense arrays
+    // it owns. IndexOf is SparseEntityIndex::kInvalid when absent.
+    virtual std::uint32_t IndexOf(Entity entity) const = 0;
+    virtual void SwapEntries(std::uint32_t a, std::uint32_t b) = 0;
+
+    // WorldSnapshot hooks. Dense order and entities always go to the
+    // arena; so does the data for trivially copyable T, anything else is
+    // copied into `copy` (created on first capture, reused after). Restore
+    // puts back exactly what was captured and stamps every component with
+    // `tick`, since to any change-tracking consumer it all just changed.
+    //
+    // Non-copyable T has nothing to copy with, so its array can only be
+    // captured empty (and comes back empty); CanCapture says whether it
+    // is, and CaptureState throws std::logic_error when it isn't.
+    virtual bool CanCapture() const = 0;
+    virtual void CaptureState(SnapshotArena& arena, std::unique_ptr<ComponentArrayCopy>& copy) const = 0;
+    virtual void RestoreState(SnapshotArena& arena, const ComponentArrayCopy* copy, ChangeTick tick) = 0;
+
+    // The group that owns this array's order, if any (see OwningGroup.h).
+    OwningGroupData* GetOwningGroup() const { return m_OwningGroup; }
+    void SetOwningGroup(OwningGroupData* group) { m_OwningGroup = group; }
+
+private:
+    OwningGroupData* m_OwningGroup = nullptr;
 };
 
+// Sparse-set component storage. Components live packed in `m_Dense`, with
+// the owning entity stored at the same index in `m_DenseEntities`. Lookup
+// goes through a paged SparseEntityIndex keyed by the handle's slot index,
+// then compares the stored handle so stale ones miss — Get/Has are a few
+// array reads, no hashing.
+//
+// Removal is swap-and-pop: the last element moves into the hole, so dense
+// order is not stable across removes. ForEach walks the dense range in
+// order; callers must not add/remove components of this type from inside
+// the callback. ParallelForEach splits the same walk across the job system
+// under the rule documented in ParallelForEach.h.
+//
+// An OwningGroup may reorder the dense range (SwapEntries) to keep the
+// entities it covers in a leading block; nothing else here depends on order.
+//
+// Each element carries the ChangeTick it was last written at, in a third
+// index-aligned array, plus the array keeps the newest tick overall so
+// ForEachChanged on an untouched array returns without walking anything.
 template<typename T>
-class ComponentArray : public IComponentArray {
+class ComponentArray final : public IComponentArray {
 public:
-    void InsertData(Entity entity, T component) {
-        size_t newIndex = m_Size;
-        m_EntityToIndexMap[entity] = newIndex;
-        m_IndexToEntityMap[newIndex] = entity;
-        if (newIndex >= m_ComponentArray.size()) {
-            m_ComponentArray.resize(newIndex + 1);
+    void InsertData(Entity entity, T component, ChangeTick tick = 0) {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+        std::uint32_t& slot = m_Sparse.Slot(entity);
+        if (slot != SparseEntityIndex::kInvalid) {
+            // Re-adding overwrites in place rather than growing a duplicate
+            // dense entry that RemoveData would later only half-clean. A
+            // leftover from an older generation of the slot is replaced.
+            m_Dense[slot] = std::move(component);
+            m_DenseEntities[slot] = entity;
+            m_Ticks[slot] = tick;
+            bumpLastChanged(tick);
+            return;
         }
-        m_ComponentArray[newIndex] = component;
-        ++m_Size;
+        slot = static_cast<std::uint32_t>(m_Dense.size());
+        m_Dense.push_back(std::move(component));
+        m_DenseEntities.push_back(entity);
+        m_Ticks.push_back(tick);
+        bumpLastChanged(tick);
     }
 
-    void RemoveData(Entity entity) {
-        auto it = m_EntityToIndexMap.find(entity);
-        if (it == m_EntityToIndexMap.end()) {
-            return;
+    // InsertData for components[i] on entities[i], i < count, with the
+    // dense arrays grown once.
+    void InsertBatch(const Entity* entities, const T* components, std::size_t count,
+                     ChangeTick tick = 0) {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+        m_Dense.reserve(m_Dense.size() + count);
+        m_DenseEntities.reserve(m_DenseEntities.size() + count);
+        m_Ticks.reserve(m_Ticks.size() + count);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t& slot = m_Sparse.Slot(entities[i]);
+            if (slot != SparseEntityIndex::kInvalid) {
+                m_Dense[slot] = components[i];
+                m_DenseEntities[slot] = entities[i];
+                m_Ticks[slot] = tick;
+                continue;
+            }
+            slot = static_cast<std::uint32_t>(m_Dense.size());
+            m_Dense.push_back(components[i]);
+            m_DenseEntities.push_back(entities[i]);
+            m_Ticks.push_back(tick);
         }
-        // m_Size == 0 should be impossible when the map lookup above succeeded,
-        // but guarding anyway means a double-remove (e.g. during a crash
-        // cascade) doesn't turn indexOfLastElement into size_t(~0).
-        if (m_Size == 0) {
-            m_EntityToIndexMap.erase(entity);
+        if (count != 0) bumpLastChanged(tick);
+    }
+
+    void RemoveData(Entity entity) {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_DenseEntities[index] != entity) {
             return;
         }
 
-        size_t indexOfRemovedEntity = it->second;
-        size_t indexOfLastElement = m_Size - 1;
-        if (indexOfRemovedEntity != indexOfLastElement) {
-            m_ComponentArray[indexOfRemovedEntity] = m_ComponentArray[indexOfLastElement];
-
-            Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
-            m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-            m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+        const std::uint32_t last = static_cast<std::uint32_t>(m_Dense.size() - 1);
+        if (index != last) {
+            m_Dense[index] = std::move(m_Dense[last]);
+            const Entity moved = m_DenseEntities[last];
+            m_DenseEntities[index] = moved;
+            m_Ticks[index] = m_Ticks[last];
+            m_Sparse.Slot(moved) = index;
         }
 
-        m_EntityToIndexMap.erase(entity);
-        m_IndexToEntityMap.erase(indexOfLastElement);
-
-        --m_Size;
+        m_Sparse.Slot(entity) = SparseEntityIndex::kInvalid;
+        m_Dense.pop_back();
+        m_DenseEntities.pop_back();
+        m_Ticks.pop_back();
     }
 
     T& GetData(Entity entity) {
-        auto it = m_EntityToIndexMap.find(entity);
-        if (it == m_EntityToIndexMap.end()) {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_DenseEntities[index] != entity) {
             throw std::runtime_error("Entity does not have component");
         }
-        return m_ComponentArray[it->second];
+        return m_Dense[index];
     }
 
     bool HasData(Entity entity) const {
-        return m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end();
+        const std::uint32_t index = m_Sparse.Get(entity);
+        return index != SparseEntityIndex::kInvalid && m_DenseEntities[index] == entity;
     }
 
     void EntityDestroyed(Entity entity) override {
-        if (m_EntityToIndexMap.find(entity) != m_EntityToIndexMap.end()) {
-            RemoveData(entity);
+        RemoveData(entity);
+    }
+
+    std::uint32_t IndexOf(Entity entity) const override {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_DenseEntities[index] != entity) {
+            return SparseEntityIndex::kInvalid;
+        }
+        return index;
+    }
+
+    // Exchanges two dense entries (component, entity and tick together).
+    void SwapEntries(std::uint32_t a, std::uint32_t b) override {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+        if (a == b) return;
+        using std::swap;
+        swap(m_Dense[a], m_Dense[b]);
+        swap(m_DenseEntities[a], m_DenseEntities[b]);
+        swap(m_Ticks[a], m_Ticks[b]);
+        m_Sparse.Slot(m_DenseEntities[a]) = a;
+        m_Sparse.Slot(m_DenseEntities[b]) = b;
+    }
+
+    bool CanCapture() const override { return kSnapshottable || m_Dense.empty(); }
+
+    void CaptureState(SnapshotArena& arena, std::unique_ptr<ComponentArrayCopy>& copy) const override {
+        if (!CanCapture()) {
+            throw std::logic_error("can't snapshot a non-empty array of non-copyable components");
+        }
+        arena.Write(static_cast<std::uint64_t>(m_Dense.size()));
+        arena.WriteArray(m_DenseEntities.data(), m_DenseEntities.size());
+        m_Sparse.CaptureState(arena);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            arena.WriteArray(m_Dense.data(), m_Dense.size());
+        } else if constexpr (kSnapshottable) {
+            if (!copy) copy = std::make_unique<DenseCopy>();
+            static_cast<DenseCopy&>(*copy).dense = m_Dense;
+        }
+    }
+
+    void RestoreState(SnapshotArena& arena, const ComponentArrayCopy* copy, ChangeTick tick) override {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+        const std::size_t count = static_cast<std::size_t>(arena.Read<std::uint64_t>());
+        m_DenseEntities.resize(count);
+        arena.ReadArray(m_DenseEntities.data(), count);
+        m_Sparse.RestoreState(arena);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            m_Dense.resize(count);
+            arena.ReadArray(m_Dense.data(), count);
+        } else if constexpr (kSnapshottable) {
+            assert(copy && "snapshot has no copy of this component array");
+            m_Dense = static_cast<const DenseCopy&>(*copy).dense;
+        } else {
+            assert(count == 0 && "non-copyable array captured non-empty");
+            m_Dense.clear();
+        }
+        m_Ticks.assign(count, tick);
+        bumpLastChanged(tick);
+    }
+
+    // Stamps the entity's component as written at `tick`; no-op if it has
+    // none. Not structural, so a parallel pass may call it for the entity
+    // it is visiting.
+    void MarkChanged(Entity entity, ChangeTick tick) {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_DenseEntities[index] != entity) return;
+        m_Ticks[index] = tick;
+        bumpLastChanged(tick);
+    }
+
+    // 0 if the entity has no component here.
+    ChangeTick GetChangeTick(Entity entity) const {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_DenseEntities[index] != entity) return 0;
+        return m_Ticks[index];
+    }
+
+    // Newest tick stamped on any element (removed ones included).
+    ChangeTick LastChangeTick() const { return m_LastChanged.load(std::memory_order_relaxed); }
+
+    // fn(Entity, T&) for every component stamped after `since`, in dense
+    // order. Free when nothing in the array changed; otherwise a linear
+    // scan of the tick array with the callback only on hits.
+    template<typename Fn>
+    void ForEachChanged(ChangeTick since, Fn&& fn) {
+        if (LastChangeTick() <= since) return;
+        for (size_t i = 0; i < m_Dense.size(); i++) {
+            if (m_Ticks[i] > since) fn(m_DenseEntities[i], m_Dense[i]);
         }
     }
 
     // Cache-friendly iteration over all active components
     template<typename Fn>
     void ForEach(Fn&& fn) {
-        for (size_t i = 0; i < m_Size; i++) {
-            fn(m_IndexToEntityMap[i], m_ComponentArray[i]);
+        for (size_t i = 0; i < m_Dense.size(); i++) {
+            fn(m_DenseEntities[i], m_Dense[i]);
         }
     }
 
-    size_t Size() const { return m_Size; }
+    // ForEach over cache-line-aligned chunks of the dense range on the job
+    // system; fn(Entity, T&) runs concurrently for different entities.
+    // Small arrays (options.serialThreshold) run on the caller.
+    template<typename Fn>
+    void ParallelForEach(Fn&& fn, const ParallelForOptions& options = {}) {
+        Mist::ecs::ParallelPassScope pass(m_ParallelPasses);
+        Mist::ecs::ParallelRanges(m_Dense.data(), sizeof(T), m_Dense.size(), options,
+                                  [&](size_t begin, size_t end) {
+                                      for (size_t i = begin; i < end; i++) {
+                                          fn(m_DenseEntities[i], m_Dense[i]);
+                                      }
+                                  });
+    }
+
+    size_t Size() const override { return m_Dense.size(); }
+
+    // Raw dense views, index-aligned: Entities()[i] owns Data()[i].
+    T*            Data()                    { return m_Dense.data(); }
+    const Entity* Entities() const override { return m_DenseEntities.data(); }
 
 private:
-    std::vector<T> m_ComponentArray;
-    std::unordered_map<Entity, size_t> m_EntityToIndexMap;
-    std::unordered_map<size_t, Entity> m_IndexToEntityMap;
-    size_t m_Size{};
+    static constexpr bool kSnapshottable =
+        std::is_trivially_copyable_v<T> || std::is_copy_assignable_v<T>;
+
+    struct DenseCopy final : ComponentArrayCopy {
+        std::vector<T> dense;
+    };
+
+    // Concurrent MarkChanged calls in one pass all carry the same tick, so
+    // a relaxed max is enough.
+    void bumpLastChanged(ChangeTick tick) {
+        ChangeTick last = m_LastChanged.load(std::memory_order_relaxed);
+        while (last < tick &&
+               !m_LastChanged.compare_exchange_weak(last, tick, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::vector<T>          m_Dense;
+    std::vector<Entity>     m_DenseEntities;
+    std::vector<ChangeTick> m_Ticks;
+    SparseEntityIndex       m_Sparse;
+    std::atomic<ChangeTick> m_LastChanged{0};
+    std::atomic<int>        m_ParallelPasses{0};
 };
 
 #endif // COMPONENTARRAY_H
@@ -4,11 +4,16 @@
 #include "Component.h"
 #include "ComponentArray.h"
 #include "Entity.h"
+#include "OwningGroup.h"
 #include "TypeID.h"
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 class ComponentManager {
   public:
@@ -19,16 +24,33 @@ class ComponentManager {
         ++m_NextComponentType;
     }
 
+    // find() before operator[] so lookups of registered types stay
+    // read-only, which parallel passes rely on.
     template <typename T> ComponentType GetComponentType() {
+        const auto it = m_ComponentTypes.find(Mist::ecs::type_id<T>());
+        if (it != m_ComponentTypes.end()) return it->second;
         return m_ComponentTypes[Mist::ecs::type_id<T>()];
     }
 
-    template <typename T> void AddComponent(Entity entity, T component) {
-        GetComponentArray<T>()->InsertData(entity, component);
+    template <typename T> void AddComponent(Entity entity, T component, ChangeTick tick = 0) {
+        ComponentArray<T>* array = GetComponentArray<T>();
+        array->InsertData(entity, std::move(component), tick);
+        if (OwningGroupData* group = array->GetOwningGroup()) group->Join(entity);
+    }
+
+    template <typename T>
+    void AddComponents(const Entity* entities, const T* components, std::size_t count, ChangeTick tick) {
+        ComponentArray<T>* array = GetComponentArray<T>();
+        array->InsertBatch(entities, components, count, tick);
+        if (OwningGroupData* group = array->GetOwningGroup()) {
+            for (std::size_t i = 0; i < count; ++i) group->Join(entities[i]);
+        }
     }
 
     template <typename T> void RemoveComponent(Entity entity) {
-        GetComponentArray<T>()->RemoveData(entity);
+        ComponentArray<T>* array = GetComponentArray<T>();
+        if (OwningGroupData* group = array->GetOwningGroup()) group->Leave(entity);
+        array->RemoveData(entity);
     }
 
     template <typename T> T& GetComponent(Entity entity) {
@@ -39,7 +61,103 @@ class ComponentManager {
         return GetComponentArray<T>()->HasData(entity);
     }
 
+    template <typename T> void MarkChanged(Entity entity, ChangeTick tick) {
+        GetComponentArray<T>()->MarkChanged(entity, tick);
+    }
+
+    template <typename T> ChangeTick GetChangeTick(Entity entity) {
+        return GetComponentArray<T>()->GetChangeTick(entity);
+    }
+
+    template <typename T> ChangeTick LastChangeTick() {
+        return GetComponentArray<T>()->LastChangeTick();
+    }
+
+    template <typename T, typename Fn> void ForEachChanged(ChangeTick since, Fn&& fn) {
+        GetComponentArray<T>()->ForEachChanged(since, std::forward<Fn>(fn));
+    }
+
+    template <typename T, typename Fn> void ForEach(Fn&& fn) {
+        GetComponentArray<T>()->ForEach(std::forward<Fn>(fn));
+    }
+
+    template <typename T, typename Fn>
+    void ParallelForEach(Fn&& fn, const ParallelForOptions& options) {
+        GetComponentArray<T>()->ParallelForEach(std::forward<Fn>(fn), options);
+    }
+
+    // The owning group over Ts, created on first use by packing every
+    // entity that already has all of them. A type can belong to one group
+    // only; asking again for the same Ts returns the same group.
+    template <typename... Ts> OwningGroup<Ts...> Group() {
+        static_assert(sizeof...(Ts) > 1, "an owning group needs at least two component types");
+        const std::vector<IComponentArray*> arrays{GetComponentArray<Ts>()...};
+        OwningGroupData* group = arrays.front()->GetOwningGroup();
+        if (!group) {
+            for (IComponentArray* array : arrays) {
+                assert(!array->GetOwningGroup() && "component type is already owned by another group");
+                (void)array;
+            }
+            m_Groups.push_back(std::make_unique<OwningGroupData>());
+            group = m_Groups.back().get();
+            group->arrays = arrays;
+            for (IComponentArray* array : arrays) array->SetOwningGroup(group);
+            packGroup(*group);
+        }
+        assert(group->arrays == arrays && "component type is already owned by another group");
+        return OwningGroup<Ts...>(*group, GetComponentArray<Ts>()...);
+    }
+
+    // WorldSnapshot support: every array (keyed by type id, so the order
+    // of the map doesn't matter) and each group's block size. `copies`
+    // holds the typed copies of non-memcpy-able arrays between capture
+    // and restore.
+    using ArrayCopies = std::unordered_map<std::uint32_t, std::unique_ptr<ComponentArrayCopy>>;
+
+    // False if some array can't be captured as it stands (see
+    // IComponentArray::CanCapture).
+    bool CanCapture() const {
+        for (auto const& pair : m_ComponentArrays) {
+            if (!pair.second->CanCapture()) return false;
+        }
+        return true;
+    }
+
+    void CaptureState(SnapshotArena& arena, ArrayCopies& copies) const {
+        arena.Write(static_cast<std::uint64_t>(m_ComponentArrays.size()));
+        for (auto const& pair : m_ComponentArrays) {
+            arena.Write(pair.first);
+            pair.second->CaptureState(arena, copies[pair.first]);
+        }
+        arena.Write(static_cast<std::uint64_t>(m_Groups.size()));
+        for (auto const& group : m_Groups) arena.Write(group->size);
+    }
+
+    void RestoreState(SnapshotArena& arena, const ArrayCopies& copies, ChangeTick tick) {
+        const std::size_t arrays = static_cast<std::size_t>(arena.Read<std::uint64_t>());
+        assert(arrays == m_ComponentArrays.size() && "components registered since the snapshot was taken");
+        for (std::size_t i = 0; i < arrays; ++i) {
+            const std::uint32_t typeId = arena.Read<std::uint32_t>();
+            const auto copy = copies.find(typeId);
+            m_ComponentArrays.at(typeId)->RestoreState(arena, copy != copies.end() ? copy->second.get() : nullptr,
+                                                       tick);
+        }
+        // The dense order came back as captured, so captured groups only
+        // need their sizes; groups created since then are packed afresh.
+        const std::size_t groups = static_cast<std::size_t>(arena.Read<std::uint64_t>());
+        for (std::size_t i = 0; i < m_Groups.size(); ++i) {
+            if (i < groups) {
+                m_Groups[i]->size = arena.Read<std::uint32_t>();
+            } else {
+                m_Groups[i]->size = 0;
+                packGroup(*m_Groups[i]);
+            }
+        }
+    }
+
     void EntityDestroyed(Entity entity) {
+        // Leave groups first, while the entity still has every component.
+        for (auto const& group : m_Groups) group->Leave(entity);
         for (auto const& pair : m_ComponentArrays) {
             pair.second->EntityDestroyed(entity);
         }
@@ -51,10 +169,21 @@ class ComponentManager {
     std::unordered_map<std::uint32_t, ComponentType> m_ComponentTypes{};
     std::unordered_map<std::uint32_t, std::shared_ptr<IComponentArray>> m_ComponentArrays{};
     ComponentType m_NextComponentType{};
+    std::vector<std::unique_ptr<OwningGroupData>> m_Groups{};
+
+    // Swapping a member into the block only moves an already-visited
+    // non-member forward, so one pass over the first array packs it.
+    static void packGroup(OwningGroupData& group) {
+        const IComponentArray& first = *group.arrays.front();
+        for (std::size_t i = 0; i < first.Size(); ++i) group.Join(first.Entities()[i]);
+    }
 
-    template <typename T> std::shared_ptr<ComponentArray<T>> GetComponentArray() {
-        return std::static_pointer_cast<ComponentArray<T>>(
-            m_ComponentArrays[Mist::ecs::type_id<T>()]);
+    // Raw pointer: copying the shared_ptr on every lookup would bounce its
+    // refcount between workers during a parallel pass.
+    template <typename T> ComponentArray<T>* GetComponentArray() {
+        const auto it = m_ComponentArrays.find(Mist::ecs::type_id<T>());
+        if (it == m_ComponentArrays.end()) return nullptr;
+        return static_cast<ComponentArray<T>*>(it->second.get());
     }
 };
 
@@ -7,10 +7,13 @@
 struct RenderComponent {
     Renderable* renderable = nullptr;
     bool visible = true;
+    // Off keeps the entity out of the shadow cascades but still drawn.
+    bool castShadows = true;
 };
 
 MIST_REFLECT(RenderComponent)
     MIST_FIELD(RenderComponent, visible, ::Mist::PropertyHint::None, "")
+    MIST_FIELD(RenderComponent, castShadows, ::Mist::PropertyHint::None, "")
 MIST_REFLECT_END(RenderComponent)
 
 #endif // RENDERCOMPONENT_H
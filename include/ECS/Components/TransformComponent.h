@@ -4,31 +4,84 @@
 #include "Core/Reflection.h"
 
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
 
 struct TransformComponent {
     glm::vec3 position{0.0f};
-    glm::vec3 rotation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f}; // unit quaternion, w first
     glm::vec3 scale{1.0f};
 
     // Cached world-space transform populated by HierarchySystem each frame.
     // Callers that want the composed-with-parents matrix read this instead
-    // of rebuilding locally. `dirty` signals the cache needs recomputing —
-    // flipped by HierarchySystem::Attach/Detach + by editor mutations.
+    // of rebuilding locally. HierarchySystem only looks at frames where
+    // some Transform was stamped changed, so writers go through
+    // Coordinator::GetComponentMut or MarkChanged as well as the setters.
     glm::mat4 cachedGlobal{1.0f};
-    bool      dirty{true};
-
-    glm::mat4 GetModelMatrix() const {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::scale(model, scale);
-        return model;
+
+    // `localMatrix` is GetModelMatrix's cache and `dirty` says it's stale.
+    // The setters set `dirty`; code writing the fields directly sets it
+    // itself. HierarchySystem also rebuilds the cache of every stamped
+    // Transform, so a GetComponentMut write is picked up either way.
+    mutable glm::mat4 localMatrix{1.0f};
+    mutable bool      dirty{true};
+
+    void SetPosition(const glm::vec3& p) { position = p; dirty = true; }
+    void SetRotation(const glm::quat& q) { rotation = q; dirty = true; }
+    void SetScale(const glm::vec3& s) { scale = s; dirty = true; }
+
+    // Editor/script view of `rotation`: degrees about X, then Y, then Z
+    // (model = T * Rx * Ry * Rz * S). Not used on any per-frame path.
+    void SetEulerDegrees(const glm::vec3& degrees) {
+        const glm::vec3 r = glm::radians(degrees);
+        SetRotation(glm::angleAxis(r.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
+                    glm::angleAxis(r.y, glm::vec3(0.0f, 1.0f, 0.0f)) *
+                    glm::angleAxis(r.z, glm::vec3(0.0f, 0.0f, 1.0f)));
+    }
+
+    glm::vec3 GetEulerDegrees() const {
+        // Decompose R = Rx * Ry * Rz; m[col][row].
+        const glm::mat3 m = glm::mat3_cast(rotation);
+        // atan2 rather than asin(m[2][0]): asin loses precision near ±90°.
+        const float cy = std::sqrt(m[2][1] * m[2][1] + m[2][2] * m[2][2]);
+        const float y = std::atan2(m[2][0], cy);
+        float x, z;
+        if (cy > 1e-4f) {
+            x = std::atan2(-m[2][1], m[2][2]);
+            z = std::atan2(-m[1][0], m[0][0]);
+        } else {
+            // Gimbal lock: X and Z turn about the same axis; put it all in X.
+            x = std::atan2(m[1][2], m[1][1]);
+            z = 0.0f;
+        }
+        return glm::degrees(glm::vec3(x, y, z));
+    }
+
+    // Local TRS matrix. Rebuilt only when `dirty`, and then without trig:
+    // the rotation columns come straight from the quaternion.
+    const glm::mat4& GetModelMatrix() const {
+        if (dirty) {
+            localMatrix = glm::mat4_cast(rotation);
+            localMatrix[0] *= scale.x;
+            localMatrix[1] *= scale.y;
+            localMatrix[2] *= scale.z;
+            localMatrix[3] = glm::vec4(position, 1.0f);
+            dirty = false;
+        }
+        return localMatrix;
+    }
+
+    // For callers that know the fields changed but not whether `dirty` was
+    // set (HierarchySystem for stamped components).
+    const glm::mat4& RebuildModelMatrix() {
+        dirty = true;
+        return GetModelMatrix();
     }
 };
 
+// `rotation` reflects as an unknown type; the inspector draws Transform by
+// hand, through the Euler view.
 MIST_REFLECT(TransformComponent)
     MIST_FIELD(TransformComponent, position, ::Mist::PropertyHint::None, "")
     MIST_FIELD(TransformComponent, rotation, ::Mist::PropertyHint::None, "")
@@ -1,72 +1,298 @@
 #ifndef COORDINATOR_H
 #define COORDINATOR_H
 
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <memory>
+#include <vector>
+#include "ArchetypeStorage.h"
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "EntitySet.h"
+#include "OwningGroup.h"
+#include "ParallelForEach.h"
 #include "SystemManager.h"
 
+// Where a component type's data lives. SparseSet is the default
+// per-type ComponentArray; Archetype groups it into chunked SoA storage
+// shared with the entity's other archetype-stored components, which is
+// what View<Ts...>() iterates. Systems can migrate one type at a time —
+// Get/Has/Add/Remove route to whichever backend owns the type.
+enum class ComponentStorage {
+    SparseSet,
+    Archetype,
+};
+
 class Coordinator {
 public:
     void Init() {
         m_EntityManager = std::make_unique<EntityManager>();
         m_ComponentManager = std::make_unique<ComponentManager>();
         m_SystemManager = std::make_unique<SystemManager>();
+        m_ArchetypeStorage = std::make_unique<ArchetypeStorage>();
+        m_ArchetypeMask.reset();
     }
 
     // Entity methods
     Entity CreateEntity() {
+        assertNoParallelPass();
         return m_EntityManager->CreateEntity();
     }
 
+    // Bulk spawn: writes `count` new entities to `out`. Same handles as
+    // `count` CreateEntity calls, without growing the living set per call.
+    void CreateEntities(std::size_t count, Entity* out) {
+        assertNoParallelPass();
+        m_EntityManager->CreateEntities(count, out);
+    }
+
+    std::vector<Entity> CreateEntities(std::size_t count) {
+        std::vector<Entity> entities(count);
+        CreateEntities(count, entities.data());
+        return entities;
+    }
+
+    // No-op for a stale handle, so a double destroy can't strip the
+    // components of whatever entity reused the slot.
     void DestroyEntity(Entity entity) {
+        assertNoParallelPass();
+        if (!m_EntityManager->IsAlive(entity)) return;
         m_EntityManager->DestroyEntity(entity);
         m_ComponentManager->EntityDestroyed(entity);
+        if (m_ArchetypeMask.any()) {
+            m_ArchetypeStorage->EntityDestroyed(entity);
+        }
         m_SystemManager->EntityDestroyed(entity);
     }
 
-    const std::unordered_set<Entity>& GetLivingEntities() const {
+    // O(1) stale-handle check; see Entity.h for the handle layout.
+    bool IsAlive(Entity entity) const {
+        return m_EntityManager->IsAlive(entity);
+    }
+
+    const EntitySet& GetLivingEntities() const {
         return m_EntityManager->GetLivingEntities();
     }
 
     // Component methods
     template<typename T>
-    void RegisterComponent() {
+    void RegisterComponent(ComponentStorage storage = ComponentStorage::SparseSet) {
         m_ComponentManager->RegisterComponent<T>();
+        if (storage == ComponentStorage::Archetype) {
+            const ComponentType type = m_ComponentManager->GetComponentType<T>();
+            m_ArchetypeStorage->RegisterColumn<T>(type);
+            m_ArchetypeMask.set(type);
+        }
     }
 
     template<typename T>
     void AddComponent(Entity entity, T component) {
-        m_ComponentManager->AddComponent<T>(entity, component);
-
+        const ComponentType type = storeComponent<T>(entity, std::move(component));
         auto signature = m_EntityManager->GetSignature(entity);
-        signature.set(m_ComponentManager->GetComponentType<T>(), true);
-        m_EntityManager->SetSignature(entity, signature);
-
-        m_SystemManager->EntitySignatureChanged(entity, signature);
+        signature.set(type, true);
+        commitSignature(entity, signature, Signature{}.set(type));
     }
 
     template<typename T>
     void RemoveComponent(Entity entity) {
-        m_ComponentManager->RemoveComponent<T>(entity);
-
+        const ComponentType type = eraseComponent<T>(entity);
         auto signature = m_EntityManager->GetSignature(entity);
-        signature.set(m_ComponentManager->GetComponentType<T>(), false);
-        m_EntityManager->SetSignature(entity, signature);
+        signature.set(type, false);
+        commitSignature(entity, signature, Signature{}.set(type));
+    }
+
+    // Bulk AddComponent: components[k][i] of every type goes to entities[i]
+    // for i < count. Each sparse-set array grows once and appends in one
+    // pass, archetype-stored types move each entity once, signatures are
+    // written once per entity, and system membership is updated in a
+    // single batch. Entities may already hold some of Ts (overwritten).
+    template<typename... Ts>
+    void AddComponents(const Entity* entities, std::size_t count, const Ts*... components) {
+        static_assert(sizeof...(Ts) > 0, "AddComponents needs at least one component type");
+        assertNoParallelPass();
+        const std::array<ComponentType, sizeof...(Ts)> types{
+            m_ComponentManager->GetComponentType<Ts>()...};
+        Signature added;
+        for (ComponentType t : types) added.set(t);
+
+        if ((added & m_ArchetypeMask).any()) {
+            m_ArchetypeStorage->AddBatch(entities, count, types, m_ArchetypeMask, m_ChangeTick,
+                                         components...);
+        }
+        std::size_t k = 0;
+        ((isArchetypeStored(types[k++])
+              ? void()
+              : m_ComponentManager->AddComponents<Ts>(entities, components, count, m_ChangeTick)),
+         ...);
 
-        m_SystemManager->EntitySignatureChanged(entity, signature);
+        std::vector<Signature> signatures(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            signatures[i] = m_EntityManager->GetSignature(entities[i]) | added;
+            m_EntityManager->SetSignature(entities[i], signatures[i]);
+        }
+        m_SystemManager->EntitiesSignatureChanged(entities, signatures.data(), count, added);
+    }
+
+    template<typename... Ts>
+    void AddComponents(const std::vector<Entity>& entities, const std::vector<Ts>&... components) {
+        assert(((components.size() == entities.size()) && ...) &&
+               "AddComponents: one component per entity for every type");
+        AddComponents(entities.data(), entities.size(), components.data()...);
     }
 
     template<typename T>
     T& GetComponent(Entity entity) {
+        if (m_ArchetypeMask.any()) {
+            const ComponentType type = m_ComponentManager->GetComponentType<T>();
+            if (m_ArchetypeMask.test(type)) return m_ArchetypeStorage->Get<T>(entity, type);
+        }
         return m_ComponentManager->GetComponent<T>(entity);
     }
 
     template<typename T>
     bool HasComponent(Entity entity) {
+        if (m_ArchetypeMask.any()) {
+            const ComponentType type = m_ComponentManager->GetComponentType<T>();
+            if (m_ArchetypeMask.test(type)) return m_ArchetypeStorage->Has(entity, type);
+        }
         return m_ComponentManager->HasComponent<T>(entity);
     }
 
+    // Change detection. Adding a component, GetComponentMut and MarkChanged
+    // stamp it with the current change tick; a consumer remembers the tick
+    // it last ran at and asks only for what was stamped since:
+    //
+    //     coord.ForEachChanged<T>(m_LastRun, [](Entity e, T& c) { ... });
+    //     m_LastRun = coord.AdvanceChangeTick();
+    //
+    // Plain GetComponent is untracked — most callers only read through it —
+    // so writers that want to be seen go through GetComponentMut or call
+    // MarkChanged. A 32-bit tick advanced a few times per frame lasts for
+    // months of uptime; wrap-around isn't handled.
+    ChangeTick GetChangeTick() const { return m_ChangeTick; }
+
+    // Closes the current tick and returns it. Writes stamped at or before
+    // the returned value are "seen" by a consumer that stores it.
+    ChangeTick AdvanceChangeTick() { return m_ChangeTick++; }
+
+    template<typename T>
+    T& GetComponentMut(Entity entity) {
+        MarkChanged<T>(entity);
+        return GetComponent<T>(entity);
+    }
+
+    // Not structural: fine from inside a parallel pass for the entity being
+    // visited. No-op if the entity doesn't have T.
+    template<typename T>
+    void MarkChanged(Entity entity) {
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) {
+            m_ArchetypeStorage->MarkChanged(entity, type, m_ChangeTick);
+        } else {
+            m_ComponentManager->MarkChanged<T>(entity, m_ChangeTick);
+        }
+    }
+
+    template<typename T>
+    bool ChangedSince(Entity entity, ChangeTick since) {
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) return m_ArchetypeStorage->GetChangeTick(entity, type) > since;
+        return m_ComponentManager->GetChangeTick<T>(entity) > since;
+    }
+
+    // Newest stamp on any T; `<= since` means no T changed at all.
+    template<typename T>
+    ChangeTick LastChangeTick() {
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) return m_ArchetypeStorage->LastChangeTick(type);
+        return m_ComponentManager->LastChangeTick<T>();
+    }
+
+    // fn(Entity, T&) for every T stamped after `since`. O(1) when nothing
+    // of type T changed.
+    template<typename T, typename Fn>
+    void ForEachChanged(ChangeTick since, Fn&& fn) {
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) {
+            m_ArchetypeStorage->ForEachChanged(type, since, [&](Entity e, void* component) {
+                fn(e, *static_cast<T*>(component));
+            });
+        } else {
+            m_ComponentManager->ForEachChanged<T>(since, std::forward<Fn>(fn));
+        }
+    }
+
+    // Linear iteration over every entity holding all of Ts, chunk by chunk.
+    // Every T must have been registered with ComponentStorage::Archetype.
+    template<typename... Ts>
+    ArchetypeView<Ts...> View() {
+        std::array<ComponentType, sizeof...(Ts)> types{
+            m_ComponentManager->GetComponentType<Ts>()...};
+        for (ComponentType t : types) {
+            assert(m_ArchetypeMask.test(t) && "View<Ts...> requires archetype-stored components");
+            (void)t;
+        }
+        return ArchetypeView<Ts...>(*m_ArchetypeStorage, types);
+    }
+
+    // Owning group over sparse-set types: keeps the entities holding all
+    // of Ts packed at the front of each type's array so ForEach walks them
+    // in lockstep, without per-entity lookups. For hot pairs such as
+    // Transform+Render, short of moving them to archetype storage. Adds
+    // and removes of Ts pay a few swaps to keep the block packed.
+    template<typename... Ts>
+    OwningGroup<Ts...> Group() {
+        for (ComponentType t : {m_ComponentManager->GetComponentType<Ts>()...}) {
+            assert(!isArchetypeStored(t) && "Group<Ts...> requires sparse-set components");
+            (void)t;
+        }
+        return m_ComponentManager->Group<Ts...>();
+    }
+
+    // fn(Entity, T&) for every entity holding T, on the calling thread.
+    // Works for either storage backend; no structural changes from fn.
+    template<typename T, typename Fn>
+    void ForEach(Fn&& fn) {
+        if (isArchetypeStored(m_ComponentManager->GetComponentType<T>())) {
+            View<T>().ForEach(std::forward<Fn>(fn));
+        } else {
+            m_ComponentManager->ForEach<T>(std::forward<Fn>(fn));
+        }
+    }
+
+    // fn(Entity, T&) for every entity holding T, spread across the job
+    // system. Works for either storage backend. See ParallelForEach.h for
+    // the no-structural-changes rule; debug builds assert on it.
+    template<typename T, typename Fn>
+    void ParallelForEach(Fn&& fn, const ParallelForOptions& options = {}) {
+        Mist::ecs::ParallelPassScope pass(m_ParallelPasses);
+        if (isArchetypeStored(m_ComponentManager->GetComponentType<T>())) {
+            View<T>().ParallelForEach(std::forward<Fn>(fn), options);
+        } else {
+            m_ComponentManager->ParallelForEach<T>(std::forward<Fn>(fn), options);
+        }
+    }
+
+    // fn(Entity) for every member of `entities` — typically a system's
+    // m_Entities — spread across the job system. The callback looks up
+    // whatever components it needs; same rule as above.
+    template<typename Fn>
+    void ParallelForEach(const EntitySet& entities, Fn&& fn, const ParallelForOptions& options = {}) {
+        Mist::ecs::ParallelPassScope pass(m_ParallelPasses);
+        const Entity* members = entities.data();
+        Mist::ecs::ParallelRanges(members, sizeof(Entity), entities.size(), options,
+                                  [&](std::size_t begin, std::size_t end) {
+                                      for (std::size_t i = begin; i < end; ++i) fn(members[i]);
+                                  });
+    }
+
+    // For systems that spread a pass over arrays of their own (see
+    // TransformHierarchy::Update) while callbacks touch components: holds
+    // the coordinator mid-pass so structural changes assert as above.
+    Mist::ecs::ParallelPassScope BeginParallelPass() { return Mist::ecs::ParallelPassScope(m_ParallelPasses); }
+
     template<typename T>
     ComponentType GetComponentType() {
         return m_ComponentManager->GetComponentType<T>();
@@ -84,9 +310,65 @@ public:
     }
 
 private:
+    // EntityCommandBuffer playback stores several components per entity
+    // and then publishes one signature change for the lot.
+    friend class EntityCommandBuffer;
+    // WorldSnapshot copies the managers' state wholesale.
+    friend class WorldSnapshot;
+
+    // Storage half of Add/RemoveComponent: moves the data in or out of
+    // whichever backend owns T, leaving the signature and systems alone.
+    template<typename T>
+    ComponentType storeComponent(Entity entity, T&& component) {
+        assertNoParallelPass();
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) {
+            m_ArchetypeStorage->Add<T>(entity, type, std::move(component), m_ChangeTick);
+        } else {
+            m_ComponentManager->AddComponent<T>(entity, std::move(component), m_ChangeTick);
+        }
+        return type;
+    }
+
+    template<typename T>
+    ComponentType eraseComponent(Entity entity) {
+        assertNoParallelPass();
+        const ComponentType type = m_ComponentManager->GetComponentType<T>();
+        if (isArchetypeStored(type)) {
+            m_ArchetypeStorage->Remove(entity, type);
+        } else {
+            m_ComponentManager->RemoveComponent<T>(entity);
+        }
+        return type;
+    }
+
+    Signature signatureOf(Entity entity) {
+        return m_EntityManager->GetSignature(entity);
+    }
+
+    // Publishes `signature` and re-buckets the entity in the systems that
+    // care about the bits in `changed`.
+    void commitSignature(Entity entity, Signature signature, Signature changed) {
+        m_EntityManager->SetSignature(entity, signature);
+        m_SystemManager->EntitySignatureChanged(entity, signature, changed);
+    }
+
+    bool isArchetypeStored(ComponentType type) const {
+        return m_ArchetypeMask.any() && m_ArchetypeMask.test(type);
+    }
+
+    void assertNoParallelPass() const {
+        assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+               "structural change during ParallelForEach");
+    }
+
     std::unique_ptr<EntityManager> m_EntityManager;
     std::unique_ptr<ComponentManager> m_ComponentManager;
     std::unique_ptr<SystemManager> m_SystemManager;
+    std::unique_ptr<ArchetypeStorage> m_ArchetypeStorage;
+    Signature m_ArchetypeMask; // bit set = type lives in m_ArchetypeStorage
+    std::atomic<int> m_ParallelPasses{0};
+    ChangeTick m_ChangeTick{1}; // 0 is reserved for "never changed"
 };
 
 #endif // COORDINATOR_H
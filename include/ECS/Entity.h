@@ -5,8 +5,30 @@
 #include <cstdint>
 #include <limits>
 
+// An Entity is a 32-bit handle: the low kEntityIndexBits are a slot index,
+// the high bits a generation bumped every time that slot is freed. A handle
+// kept past DestroyEntity therefore stops comparing equal to whatever
+// reuses the slot, and EntityManager::IsAlive detects it in O(1).
+//
+// Storage keyed "by entity" (sparse sets, archetype locations) indexes by
+// EntityIndex() and keeps the full handle alongside to reject stale ones.
 using Entity = std::uint32_t;
-const Entity MAX_ENTITIES = 100000;
-const Entity NULL_ENTITY = std::numeric_limits<Entity>::max();
+
+constexpr std::uint32_t kEntityIndexBits = 20;
+constexpr std::uint32_t kEntityGenerationBits = 32 - kEntityIndexBits;
+constexpr Entity kEntityIndexMask = (Entity(1) << kEntityIndexBits) - 1;
+constexpr Entity kEntityGenerationMask = (Entity(1) << kEntityGenerationBits) - 1;
+
+// Upper bound on simultaneously live entities (~1M). Storage grows on
+// demand up to here; nothing is sized to it up front. The all-ones index
+// is reserved so NULL_ENTITY can never name a live entity.
+constexpr Entity MAX_ENTITIES = kEntityIndexMask;
+constexpr Entity NULL_ENTITY = std::numeric_limits<Entity>::max();
+
+constexpr Entity EntityIndex(Entity entity) { return entity & kEntityIndexMask; }
+constexpr Entity EntityGeneration(Entity entity) { return entity >> kEntityIndexBits; }
+constexpr Entity MakeEntity(Entity index, Entity generation) {
+    return ((generation & kEntityGenerationMask) << kEntityIndexBits) | (index & kEntityIndexMask);
+}
 
 #endif // ENTITY_H
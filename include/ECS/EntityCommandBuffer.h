@@ -0,0 +1,175 @@
+#pragma once
+#ifndef MIST_ECS_ENTITY_COMMAND_BUFFER_H
+#define MIST_ECS_ENTITY_COMMAND_BUFFER_H
+
+#include "Coordinator.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Records structural changes (create/destroy, add/remove/set component) so
+// they can be applied later at a sync point, instead of mutating the
+// Coordinator while a system is still walking its entity set.
+//
+// Recording is safe from any number of threads at once and takes no locks:
+// each thread appends to its own stream (a command vector plus a bump
+// arena for component payloads), found through a small thread-local cache.
+// Playback must run on one thread with no recording in flight — the main
+// loop calls it between systems.
+//
+// Playback order: pending creates first, then every command grouped by
+// target entity. Within a group commands apply in recording order for one
+// thread; commands from different threads apply stream by stream, so don't
+// race two threads on the same entity within a frame. A group that
+// contains a destroy just destroys the entity. Otherwise all its
+// add/remove ops are applied to storage and systems are told once, through
+// a single EntitySignatureChanged carrying the combined change mask.
+class EntityCommandBuffer {
+public:
+    // Stand-in for an entity this buffer creates at playback. Valid as the
+    // target of later commands on the same buffer (from any thread);
+    // Resolve() maps it to the real handle once Playback has run.
+    struct PendingEntity {
+        std::uint32_t stream = 0;
+        std::uint32_t index = 0;
+    };
+
+    EntityCommandBuffer();
+    ~EntityCommandBuffer();
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    PendingEntity CreateEntity();
+
+    // Stale handles are ignored at playback, like Coordinator::DestroyEntity.
+    void DestroyEntity(Entity entity) { record(Op::Destroy, Target::Live(entity), nullptr, nullptr, nullptr); }
+    void DestroyEntity(PendingEntity entity) { record(Op::Destroy, Target::Pending(entity), nullptr, nullptr, nullptr); }
+
+    template<typename T>
+    void AddComponent(Entity entity, T component) {
+        recordPayload<T>(Op::Add, Target::Live(entity), std::move(component), &applyAdd<T>);
+    }
+    template<typename T>
+    void AddComponent(PendingEntity entity, T component) {
+        recordPayload<T>(Op::Add, Target::Pending(entity), std::move(component), &applyAdd<T>);
+    }
+
+    // Overwrites an existing T without touching the signature. Dropped if
+    // the entity no longer has T by the time the buffer plays back.
+    template<typename T>
+    void SetComponent(Entity entity, T component) {
+        recordPayload<T>(Op::Set, Target::Live(entity), std::move(component), &applySet<T>);
+    }
+
+    template<typename T>
+    void RemoveComponent(Entity entity) {
+        record(Op::Remove, Target::Live(entity), nullptr, &applyRemove<T>, nullptr);
+    }
+    template<typename T>
+    void RemoveComponent(PendingEntity entity) {
+        record(Op::Remove, Target::Pending(entity), nullptr, &applyRemove<T>, nullptr);
+    }
+
+    // Applies everything recorded so far to `coordinator`, then empties the
+    // buffer (streams and their memory are kept for reuse).
+    void Playback(Coordinator& coordinator);
+
+    // Drops everything recorded so far without applying it.
+    void Clear();
+
+    // Commands waiting for playback. Like Playback, only meaningful while
+    // no thread is recording.
+    std::size_t GetCommandCount() const;
+
+    // The entity Playback created for `pending`, or NULL_ENTITY if it
+    // hasn't been played back yet. Valid until the next Playback or Clear.
+    Entity Resolve(PendingEntity pending) const;
+
+    // Bumped by every Playback and Clear. Anything that mirrors recorded
+    // commands compares it to learn they've since been applied or dropped.
+    std::uint64_t GetEpoch() const { return m_Epoch; }
+
+private:
+    enum class Op : std::uint8_t { Destroy, Add, Set, Remove };
+
+    struct Target {
+        static constexpr std::uint32_t kLive = ~std::uint32_t(0);
+        Entity entity = NULL_ENTITY;       // handle, or pending index
+        std::uint32_t stream = kLive;      // pending stream, or kLive
+
+        static Target Live(Entity e) { return {e, kLive}; }
+        static Target Pending(PendingEntity p) { return {p.index, p.stream}; }
+    };
+
+    // Add/Remove return the component type they touched so playback can
+    // build the signature delta; Set returns kNoType.
+    using ApplyFn = ComponentType (*)(Coordinator&, Entity, void* payload);
+    using DestroyFn = void (*)(void* payload);
+    static constexpr ComponentType kNoType = MAX_COMPONENTS;
+
+    struct Command {
+        Op op;
+        Target target;
+        void* payload;
+        ApplyFn apply;
+        DestroyFn destroy;
+    };
+
+    struct Stream;
+
+    template<typename T>
+    static ComponentType applyAdd(Coordinator& coordinator, Entity entity, void* payload) {
+        return coordinator.storeComponent<T>(entity, std::move(*static_cast<T*>(payload)));
+    }
+    template<typename T>
+    static ComponentType applySet(Coordinator& coordinator, Entity entity, void* payload) {
+        if (coordinator.HasComponent<T>(entity)) {
+            coordinator.GetComponent<T>(entity) = std::move(*static_cast<T*>(payload));
+        }
+        return kNoType;
+    }
+    template<typename T>
+    static ComponentType applyRemove(Coordinator& coordinator, Entity entity, void*) {
+        return coordinator.eraseComponent<T>(entity);
+    }
+    template<typename T>
+    static void destroyPayload(void* payload) {
+        static_cast<T*>(payload)->~T();
+    }
+
+    template<typename T>
+    void recordPayload(Op op, Target target, T&& component, ApplyFn apply) {
+        using U = std::decay_t<T>;
+        static_assert(alignof(U) <= alignof(std::max_align_t),
+                      "over-aligned components can't be recorded");
+        Stream& stream = localStream();
+        void* payload = allocate(stream, sizeof(U), alignof(U));
+        new (payload) U(std::move(component));
+        append(stream, {op, target, payload, apply,
+                        std::is_trivially_destructible_v<U> ? nullptr : &destroyPayload<U>});
+    }
+
+    void record(Op op, Target target, void* payload, ApplyFn apply, DestroyFn destroy) {
+        append(localStream(), {op, target, payload, apply, destroy});
+    }
+
+    Stream& localStream();
+    static void* allocate(Stream& stream, std::size_t size, std::size_t align);
+    static void append(Stream& stream, const Command& command);
+    std::vector<Stream*> collectStreams() const;
+    void resetStreams();
+
+    const std::uint64_t m_Id;
+    std::atomic<Stream*> m_Head{nullptr};      // lock-free push-only list
+    std::atomic<std::uint32_t> m_StreamCount{0};
+    std::vector<Stream*> m_ByOrdinal;          // rebuilt at playback, for Resolve
+    std::uint64_t m_Epoch = 0;
+};
+
+#endif // MIST_ECS_ENTITY_COMMAND_BUFFER_H
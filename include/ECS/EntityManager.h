@@ -1,50 +1,106 @@
 #ifndef ENTITYMANAGER_H
 #define ENTITYMANAGER_H
 
-#include <queue>
-#include <unordered_set>
 #include <vector>
+#include <algorithm>
 #include <bitset>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 #include "Entity.h"
+#include "EntitySet.h"
 #include "Component.h"
+#include "SnapshotArena.h"
 
 using Signature = std::bitset<MAX_COMPONENTS>;
 
+// Hands out versioned Entity handles (see Entity.h). Slots live in pages
+// allocated as the world grows, so an empty world costs nothing and large
+// ones aren't capped at a preallocated count.
+//
+// Free slots form an implicit free list threaded through the slot array
+// itself: a free slot's handle field stores the index of the next free slot
+// plus the generation its next occupant will get. CreateEntity pops the
+// most recently freed slot (LIFO keeps the hot end of the pages warm).
 class EntityManager {
 public:
-    EntityManager() {
-        m_Signatures.resize(MAX_ENTITIES);
-        for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
-            m_AvailableEntities.push(entity);
+    Entity CreateEntity() {
+        Entity index;
+        if (m_FreeHead != kNoFreeSlot) {
+            index = m_FreeHead;
+            Slot& slot = slotAt(index);
+            m_FreeHead = EntityIndex(slot.handle);
+            slot.handle = MakeEntity(index, EntityGeneration(slot.handle));
+        } else {
+            assert(m_SlotCount < MAX_ENTITIES && "Too many entities");
+            index = m_SlotCount++;
+            if ((index >> kPageShift) >= m_Pages.size()) {
+                m_Pages.push_back(std::make_unique<Slot[]>(kPageSize));
+            }
+            slotAt(index).handle = MakeEntity(index, 0);
         }
-    }
 
-    Entity CreateEntity() {
-        assert(m_LivingEntityCount < MAX_ENTITIES && "Too many entities");
-        Entity id = m_AvailableEntities.front();
-        m_AvailableEntities.pop();
+        const Entity entity = slotAt(index).handle;
         ++m_LivingEntityCount;
-        m_LivingEntities.insert(id);
-        return id;
+        m_LivingEntities.insert(entity);
+        return entity;
+    }
+
+    // CreateEntity × count into out[0..count): recycled slots first, then a
+    // run of fresh ones, with the living set grown once up front.
+    void CreateEntities(std::size_t count, Entity* out) {
+        m_LivingEntities.reserve(m_LivingEntities.size() + count);
+        std::size_t i = 0;
+        for (; i < count && m_FreeHead != kNoFreeSlot; ++i) out[i] = CreateEntity();
+
+        const std::size_t fresh = count - i;
+        assert(m_SlotCount + fresh <= MAX_ENTITIES && "Too many entities");
+        const std::size_t pagesNeeded = (m_SlotCount + fresh + kPageSize - 1) >> kPageShift;
+        while (m_Pages.size() < pagesNeeded) {
+            m_Pages.push_back(std::make_unique<Slot[]>(kPageSize));
+        }
+        for (; i < count; ++i) {
+            const Entity index = m_SlotCount++;
+            Slot& slot = slotAt(index);
+            slot.handle = MakeEntity(index, 0);
+            slot.signature.reset();
+            out[i] = slot.handle;
+            m_LivingEntities.insert(slot.handle);
+        }
+        m_LivingEntityCount += static_cast<uint32_t>(fresh);
     }
 
+    // Destroying a stale or never-issued handle is a no-op.
     void DestroyEntity(Entity entity) {
-        assert(entity < MAX_ENTITIES && "Entity out of range");
-        m_Signatures[entity].reset();
-        m_AvailableEntities.push(entity);
+        if (!IsAlive(entity)) return;
+        const Entity index = EntityIndex(entity);
+        Slot& slot = slotAt(index);
+        slot.signature.reset();
+        // Bump the generation now so `entity` is stale from here on, and
+        // link the slot in as the new free-list head.
+        slot.handle = MakeEntity(m_FreeHead, EntityGeneration(entity) + 1);
+        m_FreeHead = index;
         m_LivingEntities.erase(entity);
         --m_LivingEntityCount;
     }
 
+    // O(1): the slot's current handle matches only while this generation
+    // is alive. A free slot's handle carries a bumped generation.
+    bool IsAlive(Entity entity) const {
+        const Entity index = EntityIndex(entity);
+        return index < m_SlotCount && slotAt(index).handle == entity;
+    }
+
     void SetSignature(Entity entity, Signature signature) {
-        assert(entity < MAX_ENTITIES && "Entity out of range");
-        m_Signatures[entity] = signature;
+        assert(IsAlive(entity) && "Stale or invalid entity");
+        slotAt(EntityIndex(entity)).signature = signature;
     }
 
     Signature GetSignature(Entity entity) {
-        assert(entity < MAX_ENTITIES && "Entity out of range");
-        return m_Signatures[entity];
+        assert(IsAlive(entity) && "Stale or invalid entity");
+        return slotAt(EntityIndex(entity)).signature;
     }
 
     uint32_t GetLivingEntityCount() const { return m_LivingEntityCount; }
@@ -53,13 +109,57 @@ public:
     // serialization iterate this rather than guessing from a max-seen-ID
     // counter — the latter silently skips entities created by non-UI
     // paths (Lua, plugins) and was the root cause of the "Entity 0"
-    // hierarchy bug.
-    const std::unordered_set<Entity>& GetLivingEntities() const { return m_LivingEntities; }
+    // hierarchy bug. Dense, so iteration walks a plain array in creation
+    // order (modulo swap-and-pop on destroy).
+    const EntitySet& GetLivingEntities() const { return m_LivingEntities; }
+
+    // WorldSnapshot support: the slots in use (handles, free list and
+    // signatures) and the living set, in order. Handles issued after the
+    // capture are stale once it's restored.
+    void CaptureState(SnapshotArena& arena) const {
+        static_assert(std::is_trivially_copyable_v<Slot>, "slots are memcpy'd into snapshots");
+        arena.Write(m_SlotCount);
+        arena.Write(m_FreeHead);
+        arena.Write(m_LivingEntityCount);
+        for (Entity first = 0; first < m_SlotCount; first += kPageSize) {
+            const std::size_t count = std::min<std::size_t>(kPageSize, m_SlotCount - first);
+            arena.WriteArray(&slotAt(first), count);
+        }
+        m_LivingEntities.CaptureState(arena);
+    }
+
+    void RestoreState(SnapshotArena& arena) {
+        m_SlotCount = arena.Read<Entity>();
+        m_FreeHead = arena.Read<Entity>();
+        m_LivingEntityCount = arena.Read<uint32_t>();
+        for (Entity first = 0; first < m_SlotCount; first += kPageSize) {
+            if ((first >> kPageShift) >= m_Pages.size()) {
+                m_Pages.push_back(std::make_unique<Slot[]>(kPageSize));
+            }
+            const std::size_t count = std::min<std::size_t>(kPageSize, m_SlotCount - first);
+            arena.ReadArray(&slotAt(first), count);
+        }
+        m_LivingEntities.RestoreState(arena);
+    }
 
 private:
-    std::queue<Entity> m_AvailableEntities{};
-    std::unordered_set<Entity> m_LivingEntities{};
-    std::vector<Signature> m_Signatures{};
+    struct Slot {
+        Entity handle = 0;
+        Signature signature{};
+    };
+
+    static constexpr Entity kNoFreeSlot = kEntityIndexMask;
+    static constexpr std::size_t kPageShift = 12;
+    static constexpr std::size_t kPageSize = std::size_t(1) << kPageShift;
+    static constexpr std::size_t kPageMask = kPageSize - 1;
+
+    Slot& slotAt(Entity index) { return m_Pages[index >> kPageShift][index & kPageMask]; }
+    const Slot& slotAt(Entity index) const { return m_Pages[index >> kPageShift][index & kPageMask]; }
+
+    std::vector<std::unique_ptr<Slot[]>> m_Pages;
+    Entity m_SlotCount{};            // slots ever handed out
+    Entity m_FreeHead{kNoFreeSlot};  // most recently freed slot
+    EntitySet m_LivingEntities{};
     uint32_t m_LivingEntityCount{};
 };
 
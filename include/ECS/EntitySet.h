@@ -0,0 +1,91 @@
+#pragma once
+#ifndef MIST_ENTITY_SET_H
+#define MIST_ENTITY_SET_H
+
+#include "Entity.h"
+#include "SnapshotArena.h"
+#include "SparseEntityIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sparse set of entities: O(1) insert/erase/contains with the members
+// packed in a contiguous vector for iteration. Replaces std::set<Entity>
+// for System::m_Entities, so the method names follow std::set's
+// (insert/erase/count/begin/end) and existing range-for loops keep
+// compiling unchanged.
+//
+// Unlike std::set, iteration order is insertion order until an erase,
+// which swap-and-pops the last member into the hole. Don't insert or
+// erase while iterating. Membership is by full handle: a stale handle to a
+// recycled slot is not a member, even if the slot's new occupant is.
+class EntitySet {
+  public:
+    using const_iterator = std::vector<Entity>::const_iterator;
+
+    // Returns false if `entity` was already a member.
+    bool insert(Entity entity) {
+        std::uint32_t& slot = m_Sparse.Slot(entity);
+        if (slot != SparseEntityIndex::kInvalid) {
+            if (m_Dense[slot] == entity) return false;
+            // An older generation of this slot was never erased; the new
+            // handle takes its place.
+            m_Dense[slot] = entity;
+            return true;
+        }
+        slot = static_cast<std::uint32_t>(m_Dense.size());
+        m_Dense.push_back(entity);
+        return true;
+    }
+
+    // Returns false if `entity` was not a member.
+    bool erase(Entity entity) {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_Dense[index] != entity) return false;
+        const Entity last = m_Dense.back();
+        m_Dense[index] = last;
+        m_Sparse.Slot(last) = index;
+        m_Sparse.Slot(entity) = SparseEntityIndex::kInvalid;
+        m_Dense.pop_back();
+        return true;
+    }
+
+    bool contains(Entity entity) const {
+        const std::uint32_t index = m_Sparse.Get(entity);
+        return index != SparseEntityIndex::kInvalid && m_Dense[index] == entity;
+    }
+    std::size_t count(Entity entity) const { return contains(entity) ? 1 : 0; }
+
+    std::size_t size() const { return m_Dense.size(); }
+    bool empty() const { return m_Dense.empty(); }
+    void reserve(std::size_t n) { m_Dense.reserve(n); }
+
+    void clear() {
+        for (Entity e : m_Dense) m_Sparse.Slot(e) = SparseEntityIndex::kInvalid;
+        m_Dense.clear();
+    }
+
+    // WorldSnapshot support: members in order plus the sparse index.
+    void CaptureState(SnapshotArena& arena) const {
+        arena.Write(static_cast<std::uint64_t>(m_Dense.size()));
+        arena.WriteArray(m_Dense.data(), m_Dense.size());
+        m_Sparse.CaptureState(arena);
+    }
+
+    void RestoreState(SnapshotArena& arena) {
+        m_Dense.resize(static_cast<std::size_t>(arena.Read<std::uint64_t>()));
+        arena.ReadArray(m_Dense.data(), m_Dense.size());
+        m_Sparse.RestoreState(arena);
+    }
+
+    const_iterator begin() const { return m_Dense.begin(); }
+    const_iterator end() const { return m_Dense.end(); }
+    const Entity* data() const { return m_Dense.data(); }
+
+  private:
+    SparseEntityIndex m_Sparse;
+    std::vector<Entity> m_Dense;
+};
+
+#endif // MIST_ENTITY_SET_H
@@ -2,40 +2,299 @@
 #ifndef MIST_EVENT_H
 #define MIST_EVENT_H
 
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <unordered_map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <typeindex>
-#include <any>
 
+// Read-only view of a contiguous run of events, handed to subscribers by
+// EventBus::Flush. Valid only for the duration of the callback.
+template<typename T>
+class EventSpan {
+public:
+    EventSpan() = default;
+    EventSpan(const T* data, std::size_t size) : m_Data(data), m_Size(size) {}
+
+    const T* data() const { return m_Data; }
+    std::size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    const T& operator[](std::size_t i) const { return m_Data[i]; }
+    const T* begin() const { return m_Data; }
+    const T* end() const { return m_Data + m_Size; }
+
+private:
+    const T* m_Data = nullptr;
+    std::size_t m_Size = 0;
+};
+
+// Queued, typed event bus. Each event type gets its own channel holding the
+// frame's events contiguously; Publish appends (no type erasure, no
+// allocation once the buffer has grown to a frame's worth) and Flush hands
+// every subscriber the channel's whole batch as one EventSpan:
+//
+//     bus.Subscribe<CollisionEvent>([](EventSpan<CollisionEvent> hits) {
+//         for (const CollisionEvent& hit : hits) { ... }
+//     });
+//     bus.Publish(CollisionEvent{a, b});   // queued
+//     bus.Flush();                         // dispatched here
+//
+// Threading: Subscribe, Unsubscribe, Publish and Flush belong to the thread
+// that owns the bus. Worker threads use PublishConcurrent, which is
+// lock-free and may run concurrently with each other and with Publish, but
+// not with Flush or with Subscribe of a new event type — same rule as
+// EntityCommandBuffer recording vs playback.
+//
+// Events published with no subscriber for their type are dropped. Events
+// published during Flush (from a handler) are delivered at the next Flush.
 class EventBus {
 public:
     template<typename T>
-    using Handler = std::function<void(const T&)>;
+    using Handler = std::function<void(EventSpan<T>)>;
+
+    // Packs (event type, per-type sequence); 0 is never a valid handle.
+    using Subscription = std::uint64_t;
+
+    EventBus() = default;
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    template<typename T>
+    Subscription Subscribe(Handler<T> handler) {
+        return channel<T>().subscribe(std::move(handler));
+    }
+
+    // Safe from inside a handler; the handler isn't called again, even
+    // later in the same Flush.
+    void Unsubscribe(Subscription subscription) {
+        const std::uint32_t type = static_cast<std::uint32_t>(subscription >> 32);
+        if (type < m_Channels.size() && m_Channels[type]) {
+            m_Channels[type]->unsubscribe(static_cast<std::uint32_t>(subscription));
+        }
+    }
 
     template<typename T>
-    void Subscribe(Handler<T> handler) {
-        auto key = std::type_index(typeid(T));
-        m_Handlers[key].push_back([handler](const std::any& event) {
-            handler(std::any_cast<const T&>(event));
-        });
+    void Publish(T event) {
+        if (Channel<T>* c = find<T>()) c->queued.push_back(std::move(event));
     }
 
+    // Lock-free multi-producer publish for job and physics threads.
     template<typename T>
-    void Publish(const T& event) {
-        auto key = std::type_index(typeid(T));
-        auto it = m_Handlers.find(key);
-        if (it != m_Handlers.end()) {
-            for (auto& handler : it->second) {
-                handler(event);
-            }
+    void PublishConcurrent(T event) {
+        if (Channel<T>* c = find<T>()) c->concurrent.push(std::move(event));
+    }
+
+    // Delivers every queued event, one channel at a time. Within a
+    // channel, events from Publish come first in publish order, then those
+    // from PublishConcurrent (ordered per thread, interleaved across
+    // threads).
+    void Flush() {
+        for (std::size_t i = 0; i < m_Channels.size(); ++i) {
+            if (m_Channels[i]) m_Channels[i]->flush();
         }
     }
 
-    void Clear() { m_Handlers.clear(); }
+    // Drops every subscriber and every queued event. Not from a handler.
+    void Clear() { m_Channels.clear(); }
 
 private:
-    std::unordered_map<std::type_index, std::vector<std::function<void(const std::any&)>>> m_Handlers;
+    struct ChannelBase {
+        struct Slot {
+            std::uint32_t id; // 0 = unsubscribed during dispatch
+            std::function<void(const void*, std::size_t)> call;
+        };
+
+        explicit ChannelBase(std::uint32_t type) : type(type) {}
+        virtual ~ChannelBase() = default;
+        virtual void flush() = 0;
+
+        void unsubscribe(std::uint32_t id) {
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                if (slots[i].id != id) continue;
+                if (dispatching) {
+                    slots[i].id = 0;
+                } else {
+                    slots.erase(slots.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+                return;
+            }
+            for (std::size_t i = 0; i < pendingAdds.size(); ++i) {
+                if (pendingAdds[i].id == id) {
+                    pendingAdds.erase(pendingAdds.begin() + static_cast<std::ptrdiff_t>(i));
+                    return;
+                }
+            }
+        }
+
+        // Hands `count` events to every live subscriber. Subscribe/Unsubscribe
+        // from a handler are deferred so the slot vector stays put.
+        void dispatch(const void* events, std::size_t count) {
+            if (count == 0) return;
+            dispatching = true;
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                if (slots[i].id != 0) slots[i].call(events, count);
+            }
+            dispatching = false;
+            for (std::size_t i = slots.size(); i-- > 0;) {
+                if (slots[i].id == 0) slots.erase(slots.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            for (Slot& slot : pendingAdds) slots.push_back(std::move(slot));
+            pendingAdds.clear();
+        }
+
+        const std::uint32_t type;
+        std::uint32_t nextId = 1;
+        bool dispatching = false;
+        std::vector<Slot> slots;
+        std::vector<Slot> pendingAdds;
+    };
+
+    // Multi-producer append buffer: a chain of fixed-size blocks that
+    // producers claim slots from with one fetch_add. A full block is
+    // followed by the next one in the chain (allocated by whichever
+    // producer gets there first), so the only allocations are chain
+    // growth; drained blocks are rewound and reused on later frames.
+    template<typename T>
+    class ConcurrentQueue {
+    public:
+        ConcurrentQueue() : m_Tail(&m_First) {}
+        ~ConcurrentQueue() {
+            drain([](T&&) {});
+            Block* block = m_First.next.load(std::memory_order_relaxed);
+            while (block) {
+                Block* next = block->next.load(std::memory_order_relaxed);
+                delete block;
+                block = next;
+            }
+        }
+
+        void push(T&& event) {
+            for (;;) {
+                Block* block = m_Tail.load(std::memory_order_acquire);
+                const std::uint32_t index = block->claimed.fetch_add(1, std::memory_order_relaxed);
+                if (index < kBlockEvents) {
+                    new (block->slot(index)) T(std::move(event));
+                    block->published.fetch_add(1, std::memory_order_release);
+                    return;
+                }
+
+                Block* next = block->next.load(std::memory_order_acquire);
+                if (!next) {
+                    auto* fresh = new Block;
+                    if (block->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+                        next = fresh;
+                    } else {
+                        delete fresh; // lost the race; `next` now holds the winner's block
+                    }
+                }
+                m_Tail.compare_exchange_strong(block, next, std::memory_order_acq_rel);
+            }
+        }
+
+        // Moves every event out in claim order, block by block, and rewinds
+        // the chain. No push may be in flight.
+        template<typename Fn>
+        void drain(Fn&& fn) {
+            Block* const tail = m_Tail.load(std::memory_order_acquire);
+            for (Block* block = &m_First;; block = block->next.load(std::memory_order_relaxed)) {
+                const std::uint32_t claimed = block->claimed.load(std::memory_order_relaxed);
+                const std::uint32_t count = claimed < kBlockEvents ? claimed : kBlockEvents;
+                assert(block->published.load(std::memory_order_acquire) == count &&
+                       "EventBus::Flush raced with PublishConcurrent");
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    T* event = std::launder(reinterpret_cast<T*>(block->slot(i)));
+                    fn(std::move(*event));
+                    event->~T();
+                }
+                block->claimed.store(0, std::memory_order_relaxed);
+                block->published.store(0, std::memory_order_relaxed);
+                if (block == tail) break;
+            }
+            m_Tail.store(&m_First, std::memory_order_release);
+        }
+
+    private:
+        // ~16 KiB of payload per block, like the command buffer arenas.
+        static constexpr std::uint32_t kBlockEvents =
+            sizeof(T) >= 16 * 1024 ? 1u : static_cast<std::uint32_t>(16 * 1024 / sizeof(T));
+
+        struct Block {
+            std::atomic<std::uint32_t> claimed{0};
+            std::atomic<std::uint32_t> published{0};
+            std::atomic<Block*> next{nullptr};
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage[kBlockEvents];
+
+            void* slot(std::uint32_t i) { return &storage[i]; }
+        };
+
+        Block m_First;
+        std::atomic<Block*> m_Tail;
+    };
+
+    template<typename T>
+    struct Channel final : ChannelBase {
+        using ChannelBase::ChannelBase;
+
+        Subscription subscribe(Handler<T> handler) {
+            Slot slot{nextId++, [fn = std::move(handler)](const void* events, std::size_t count) {
+                          fn(EventSpan<T>(static_cast<const T*>(events), count));
+                      }};
+            const Subscription handle = (Subscription(type) << 32) | slot.id;
+            if (dispatching) {
+                pendingAdds.push_back(std::move(slot));
+            } else {
+                slots.push_back(std::move(slot));
+            }
+            return handle;
+        }
+
+        void flush() override {
+            // Swap out the batch first so events published by handlers
+            // land in the fresh buffer for next frame.
+            batch.swap(queued);
+            concurrent.drain([this](T&& event) { batch.push_back(std::move(event)); });
+            dispatch(batch.data(), batch.size());
+            batch.clear();
+        }
+
+        std::vector<T> queued;
+        std::vector<T> batch; // capacity kept across frames
+        ConcurrentQueue<T> concurrent;
+    };
+
+    // Dense per-process index for event types, separate from component ids.
+    static std::uint32_t nextEventType() {
+        static std::atomic<std::uint32_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    template<typename T>
+    static std::uint32_t eventType() {
+        static const std::uint32_t id = nextEventType();
+        return id;
+    }
+
+    template<typename T>
+    Channel<T>* find() {
+        const std::uint32_t type = eventType<T>();
+        if (type >= m_Channels.size()) return nullptr;
+        return static_cast<Channel<T>*>(m_Channels[type].get());
+    }
+
+    template<typename T>
+    Channel<T>& channel() {
+        if (Channel<T>* c = find<T>()) return *c;
+        const std::uint32_t type = eventType<T>();
+        if (type >= m_Channels.size()) m_Channels.resize(type + 1);
+        m_Channels[type] = std::make_unique<Channel<T>>(type);
+        return static_cast<Channel<T>&>(*m_Channels[type]);
+    }
+
+    std::vector<std::unique_ptr<ChannelBase>> m_Channels; // indexed by eventType<T>()
 };
 
 // Common events
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef MIST_ECS_OWNING_GROUP_H
+#define MIST_ECS_OWNING_GROUP_H
+
+#include "ComponentArray.h"
+#include "Entity.h"
+#include "SparseEntityIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// Bookkeeping for one owning group. The group owns the order of a few
+// sparse-set arrays and keeps every entity that has all of them in the
+// first `size` dense slots of each, at the same index in every array.
+// ComponentManager calls Join after an add and Leave before a remove or
+// destroy, so the leading block is always exact; swap-and-pop removal only
+// ever pulls from past the block's end.
+struct OwningGroupData {
+    std::vector<IComponentArray*> arrays;
+    std::uint32_t size = 0;
+
+    bool Contains(Entity entity) const {
+        // kInvalid (absent) is never < size.
+        return arrays.front()->IndexOf(entity) < size;
+    }
+
+    // No-op unless the entity now has every owned component and isn't in
+    // the block yet.
+    void Join(Entity entity) {
+        if (Contains(entity)) return;
+        for (IComponentArray* array : arrays) {
+            if (array->IndexOf(entity) == SparseEntityIndex::kInvalid) return;
+        }
+        for (IComponentArray* array : arrays) {
+            array->SwapEntries(array->IndexOf(entity), size);
+        }
+        ++size;
+    }
+
+    void Leave(Entity entity) {
+        if (!Contains(entity)) return;
+        --size;
+        for (IComponentArray* array : arrays) {
+            array->SwapEntries(array->IndexOf(entity), size);
+        }
+    }
+};
+
+// Typed view over an owning group: ForEach is a lockstep walk of the
+// leading block of each owned array, with no per-entity lookups. Cheap to
+// copy; get one from Coordinator::Group<Ts...>() each time it's needed.
+// Same no-structural-changes rule as ComponentArray::ForEach.
+template<typename... Ts>
+class OwningGroup {
+public:
+    OwningGroup(const OwningGroupData& data, ComponentArray<Ts>*... arrays)
+        : m_Data(&data), m_Arrays(arrays...) {}
+
+    std::size_t Size() const { return m_Data->size; }
+
+    // fn(Entity, Ts&...) for every entity holding all of Ts.
+    template<typename Fn>
+    void ForEach(Fn&& fn) {
+        const std::size_t count = m_Data->size;
+        const Entity* entities = std::get<0>(m_Arrays)->Entities();
+        std::tuple<Ts*...> data(std::get<ComponentArray<Ts>*>(m_Arrays)->Data()...);
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(entities[i], std::get<Ts*>(data)[i]...);
+        }
+    }
+
+private:
+    const OwningGroupData* m_Data;
+    std::tuple<ComponentArray<Ts>*...> m_Arrays;
+};
+
+#endif // MIST_ECS_OWNING_GROUP_H
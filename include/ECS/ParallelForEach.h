@@ -0,0 +1,101 @@
+#pragma once
+#ifndef MIST_ECS_PARALLEL_FOR_EACH_H
+#define MIST_ECS_PARALLEL_FOR_EACH_H
+
+#include "Core/JobSystem.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Knobs for ComponentArray::ParallelForEach, ArchetypeView::ParallelForEach
+// and Coordinator::ParallelForEach.
+//
+// THE RULE: a parallel pass may read and write the components it was handed
+// (and read other components), but must not make structural changes — no
+// Create/DestroyEntity, no Add/RemoveComponent, no Attach/Detach — on any
+// thread until the pass returns. Those reallocate or swap-and-pop the dense
+// arrays other workers are walking. Debug builds assert on it; queue the
+// change and apply it after the pass instead.
+//
+// Callbacks for different entities run concurrently, so anything they share
+// beyond their own components (counters, containers, Bullet objects) must be
+// thread-safe.
+struct ParallelForOptions {
+    // Target elements per job. Rounded up so chunk boundaries fall on cache
+    // lines of the dense array and two workers never write the same line.
+    std::size_t grain = 1024;
+    // Ranges smaller than this run serially on the calling thread; below a
+    // few thousand light-weight elements the fan-out costs more than it saves.
+    std::size_t serialThreshold = 4096;
+    // Defaults to Mist::JobSystem::Instance().
+    Mist::JobSystem* jobs = nullptr;
+};
+
+namespace Mist::ecs {
+
+constexpr std::size_t kCacheLineBytes = 64;
+
+// Marks a container as mid-pass for the lifetime of the scope so its
+// structural mutators can assert. A counter rather than a flag because
+// passes over the same container may nest.
+class ParallelPassScope {
+  public:
+    explicit ParallelPassScope(std::atomic<int>& passes) : m_Passes(passes) {
+        m_Passes.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~ParallelPassScope() { m_Passes.fetch_sub(1, std::memory_order_relaxed); }
+    ParallelPassScope(const ParallelPassScope&) = delete;
+    ParallelPassScope& operator=(const ParallelPassScope&) = delete;
+
+  private:
+    std::atomic<int>& m_Passes;
+};
+
+// Splits [0, count) of an array of `elementSize`-byte elements starting at
+// `base` into chunks whose interior boundaries land on cache-line
+// boundaries, and calls fn(begin, end) for each — in parallel when `count`
+// reaches opts.serialThreshold, otherwise once on the caller.
+template <typename Fn>
+void ParallelRanges(const void* base, std::size_t elementSize, std::size_t count,
+                    const ParallelForOptions& opts, Fn&& fn) {
+    if (count == 0) return;
+    JobSystem& jobs = opts.jobs ? *opts.jobs : JobSystem::Instance();
+    if (count < opts.serialThreshold || jobs.GetWorkerCount() == 0) {
+        fn(std::size_t(0), count);
+        return;
+    }
+
+    // Smallest element count spanning a whole number of cache lines.
+    std::size_t a = elementSize, b = kCacheLineBytes;
+    while (b != 0) {
+        const std::size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    const std::size_t lineElems = kCacheLineBytes / a;
+    std::size_t grain = opts.grain < lineElems ? lineElems : opts.grain;
+    grain = (grain + lineElems - 1) / lineElems * lineElems;
+
+    // Index of the first element that starts a cache line; the first chunk
+    // absorbs the unaligned head. If no element ever lands on a line start
+    // (base not aligned to gcd(size, 64)) boundaries just stay grain-spaced.
+    const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(base);
+    std::size_t head = 0;
+    while (head < lineElems && (addr + head * elementSize) % kCacheLineBytes != 0) ++head;
+    if (head == lineElems) head = 0;
+    if (head >= count) head = 0;
+
+    const std::size_t chunks = (count - head + grain - 1) / grain;
+    jobs.ParallelFor(chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c) {
+            const std::size_t begin = c == 0 ? 0 : head + c * grain;
+            const std::size_t end = head + (c + 1) * grain < count ? head + (c + 1) * grain : count;
+            fn(begin, end);
+        }
+    });
+}
+
+} // namespace Mist::ecs
+
+#endif // MIST_ECS_PARALLEL_FOR_EACH_H
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef MIST_ECS_SNAPSHOT_ARENA_H
+#define MIST_ECS_SNAPSHOT_ARENA_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Flat byte buffer behind WorldSnapshot. Storage classes append their
+// state with Write/WriteArray at capture and read it back in the same
+// order at restore. Everything is memcpy'd, so only trivially copyable
+// types go in. The buffer keeps its capacity across captures and isn't
+// zero-filled, so a repeat capture is just the copies.
+class SnapshotArena {
+public:
+    // Drops the contents for a new capture.
+    void Clear() {
+        m_Size = 0;
+        m_ReadPos = 0;
+    }
+
+    // Starts reading from the beginning again.
+    void Rewind() { m_ReadPos = 0; }
+
+    std::size_t Size() const { return m_Size; }
+    bool Empty() const { return m_Size == 0; }
+
+    template<typename T>
+    void Write(const T& value) {
+        WriteArray(&value, 1);
+    }
+
+    template<typename T>
+    void WriteArray(const T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "SnapshotArena only holds trivially copyable data");
+        if (count == 0) return;
+        const std::size_t bytes = count * sizeof(T);
+        if (m_Size + bytes > m_Capacity) grow(m_Size + bytes);
+        std::memcpy(m_Data.get() + m_Size, values, bytes);
+        m_Size += bytes;
+    }
+
+    template<typename T>
+    T Read() {
+        T value;
+        ReadArray(&value, 1);
+        return value;
+    }
+
+    template<typename T>
+    void ReadArray(T* out, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "SnapshotArena only holds trivially copyable data");
+        if (count == 0) return;
+        assert(m_ReadPos + count * sizeof(T) <= m_Size && "snapshot read past the end");
+        std::memcpy(out, m_Data.get() + m_ReadPos, count * sizeof(T));
+        m_ReadPos += count * sizeof(T);
+    }
+
+private:
+    void grow(std::size_t needed) {
+        std::size_t capacity = m_Capacity ? m_Capacity * 2 : 64 * 1024;
+        while (capacity < needed) capacity *= 2;
+        std::unique_ptr<std::byte[]> data(new std::byte[capacity]);
+        if (m_Size) std::memcpy(data.get(), m_Data.get(), m_Size);
+        m_Data = std::move(data);
+        m_Capacity = capacity;
+    }
+
+    std::unique_ptr<std::byte[]> m_Data;
+    std::size_t m_Size = 0;
+    std::size_t m_Capacity = 0;
+    std::size_t m_ReadPos = 0;
+};
+
+#endif // MIST_ECS_SNAPSHOT_ARENA_H
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef MIST_SPARSE_ENTITY_INDEX_H
+#define MIST_SPARSE_ENTITY_INDEX_H
+
+#include "Entity.h"
+#include "SnapshotArena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Paged Entity -> uint32_t map, the "sparse" half of a sparse set. Keyed by
+// EntityIndex(), so every generation of a slot shares one entry — owners
+// store the full handle in their dense array and compare it to tell the
+// live entity from a stale handle. Pages of 4096 slots are allocated on
+// first write, so a world that only uses low indices never pays for the
+// whole MAX_ENTITIES range, and reads of an untouched page are a bounds
+// check rather than an allocation.
+class SparseEntityIndex {
+  public:
+    static constexpr std::uint32_t kInvalid = ~std::uint32_t(0);
+
+    std::uint32_t Get(Entity entity) const {
+        const std::size_t index = EntityIndex(entity);
+        const std::size_t page = index >> kPageShift;
+        if (page >= m_Pages.size() || !m_Pages[page]) {
+            return kInvalid;
+        }
+        return m_Pages[page][index & kPageMask];
+    }
+
+    // Slot for `entity`, allocating its page (filled with kInvalid) on
+    // first use.
+    std::uint32_t& Slot(Entity entity) {
+        const std::size_t index = EntityIndex(entity);
+        const std::size_t page = index >> kPageShift;
+        if (page >= m_Pages.size()) {
+            m_Pages.resize(page + 1);
+        }
+        if (!m_Pages[page]) {
+            m_Pages[page] = Page(new std::uint32_t[kPageSize]);
+            std::fill_n(m_Pages[page].get(), kPageSize, kInvalid);
+        }
+        return m_Pages[page][index & kPageMask];
+    }
+
+    void Clear() { m_Pages.clear(); }
+
+    // WorldSnapshot support: allocated pages are copied whole, so a
+    // restore is a memcpy per page rather than a write per entity.
+    void CaptureState(SnapshotArena& arena) const {
+        arena.Write(static_cast<std::uint64_t>(m_Pages.size()));
+        for (const Page& page : m_Pages) {
+            arena.Write(static_cast<std::uint8_t>(page ? 1 : 0));
+            if (page) arena.WriteArray(page.get(), kPageSize);
+        }
+    }
+
+    void RestoreState(SnapshotArena& arena) {
+        m_Pages.resize(static_cast<std::size_t>(arena.Read<std::uint64_t>()));
+        for (Page& page : m_Pages) {
+            if (arena.Read<std::uint8_t>() == 0) {
+                page.reset();
+                continue;
+            }
+            if (!page) page = Page(new std::uint32_t[kPageSize]);
+            arena.ReadArray(page.get(), kPageSize);
+        }
+    }
+
+  private:
+    // 4096 entries × 4 bytes = one 16 KiB page per 4096 consecutive IDs.
+    static constexpr std::size_t kPageShift = 12;
+    static constexpr std::size_t kPageSize = std::size_t(1) << kPageShift;
+    static constexpr std::size_t kPageMask = kPageSize - 1;
+
+    using Page = std::unique_ptr<std::uint32_t[]>;
+    std::vector<Page> m_Pages;
+};
+
+#endif // MIST_SPARSE_ENTITY_INDEX_H
@@ -1,15 +1,18 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
-#include <set>
 #include "Entity.h"
+#include "EntitySet.h"
 
 class System {
 public:
     virtual ~System() = default;
     virtual void Update(float deltaTime) {}
-    
-    std::set<Entity> m_Entities;
+
+    // Entities whose signature matches the system's. Maintained by
+    // SystemManager; a dense sparse set so membership churn during scene
+    // loads doesn't allocate per insert and iteration is a linear walk.
+    EntitySet m_Entities;
 };
 
 #endif // SYSTEM_H
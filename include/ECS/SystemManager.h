@@ -1,51 +1,180 @@
 #ifndef SYSTEMMANAGER_H
 #define SYSTEMMANAGER_H
 
+#include "Component.h"
+#include "EntityManager.h"
+#include "SnapshotArena.h"
 #include "System.h"
 #include "TypeID.h"
 
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 class SystemManager {
   public:
     template <typename T> std::shared_ptr<T> RegisterSystem() {
         const std::uint32_t typeId = Mist::ecs::type_id<T>();
         auto system = std::make_shared<T>();
-        m_Systems.insert({typeId, system});
+        if (m_SystemIndex.count(typeId) == 0) {
+            SystemRecord record;
+            record.system = system;
+            auto pending = m_PendingSignatures.find(typeId);
+            if (pending != m_PendingSignatures.end()) {
+                record.signature = pending->second;
+                record.signatureSet = true;
+                m_PendingSignatures.erase(pending);
+            }
+            m_SystemIndex.insert({typeId, m_Records.size()});
+            m_Records.push_back(std::move(record));
+            rebuildComponentIndex();
+        }
         return system;
     }
 
+    // First call wins, matching the previous map::insert behaviour. May be
+    // called before RegisterSystem; the signature is applied on register.
     template <typename T> void SetSignature(Signature signature) {
-        m_Signatures.insert({Mist::ecs::type_id<T>(), signature});
+        const std::uint32_t typeId = Mist::ecs::type_id<T>();
+        auto it = m_SystemIndex.find(typeId);
+        if (it == m_SystemIndex.end()) {
+            m_PendingSignatures.insert({typeId, signature});
+            return;
+        }
+        SystemRecord& record = m_Records[it->second];
+        if (record.signatureSet) return;
+        record.signature = signature;
+        record.signatureSet = true;
+        rebuildComponentIndex();
     }
 
     void EntityDestroyed(Entity entity) {
-        for (auto const& pair : m_Systems) {
-            pair.second->m_Entities.erase(entity);
+        // EntitySet::erase is O(1) and allocation-free, so a flat sweep is
+        // cheaper than recovering which systems held the entity.
+        for (auto& record : m_Records) {
+            record.system->m_Entities.erase(entity);
         }
     }
 
+    // Full re-evaluation against every system. Prefer the overload below
+    // when the caller knows which component bits changed.
     void EntitySignatureChanged(Entity entity, Signature entitySignature) {
-        for (auto const& pair : m_Systems) {
-            auto const typeId = pair.first;
-            auto const& system = pair.second;
-            auto const& systemSignature = m_Signatures[typeId];
-
-            if ((entitySignature & systemSignature) == systemSignature) {
-                system->m_Entities.insert(entity);
-            } else {
-                system->m_Entities.erase(entity);
+        for (auto& record : m_Records) {
+            updateMembership(record, entity, entitySignature);
+        }
+    }
+
+    // Only systems whose signature includes one of the `changed` bits can
+    // have their membership flipped, so only those are visited (plus
+    // systems with an empty signature, which match every entity).
+    void EntitySignatureChanged(Entity entity, Signature entitySignature, Signature changed) {
+        ++m_VisitStamp;
+        for (std::size_t bit = 0; bit < MAX_COMPONENTS && changed.any(); ++bit) {
+            if (!changed.test(bit)) continue;
+            changed.reset(bit);
+            for (std::uint32_t index : m_SystemsByComponent[bit]) {
+                visit(index, entity, entitySignature);
             }
         }
+        for (std::uint32_t index : m_UnfilteredSystems) {
+            visit(index, entity, entitySignature);
+        }
+    }
+
+    // Batch form for bulk spawns where every entity's signature changed in
+    // (a subset of) the same `changed` bits. The affected systems are
+    // collected once and each walks the whole batch, instead of a bucket
+    // walk per entity.
+    void EntitiesSignatureChanged(const Entity* entities, const Signature* signatures,
+                                  std::size_t count, Signature changed) {
+        ++m_VisitStamp;
+        std::vector<std::uint32_t> affected;
+        auto collect = [&](std::uint32_t index) {
+            SystemRecord& record = m_Records[index];
+            if (record.visitStamp == m_VisitStamp) return;
+            record.visitStamp = m_VisitStamp;
+            affected.push_back(index);
+        };
+        for (std::size_t bit = 0; bit < MAX_COMPONENTS && changed.any(); ++bit) {
+            if (!changed.test(bit)) continue;
+            changed.reset(bit);
+            for (std::uint32_t index : m_SystemsByComponent[bit]) collect(index);
+        }
+        for (std::uint32_t index : m_UnfilteredSystems) collect(index);
+
+        for (std::uint32_t index : affected) {
+            SystemRecord& record = m_Records[index];
+            record.system->m_Entities.reserve(record.system->m_Entities.size() + count);
+            for (std::size_t i = 0; i < count; ++i) {
+                updateMembership(record, entities[i], signatures[i]);
+            }
+        }
+    }
+
+    // WorldSnapshot support: every system's entity set, in order.
+    void CaptureState(SnapshotArena& arena) const {
+        arena.Write(static_cast<std::uint64_t>(m_Records.size()));
+        for (const auto& record : m_Records) record.system->m_Entities.CaptureState(arena);
+    }
+
+    void RestoreState(SnapshotArena& arena) {
+        const std::size_t systems = static_cast<std::size_t>(arena.Read<std::uint64_t>());
+        assert(systems == m_Records.size() && "systems registered since the snapshot was taken");
+        for (std::size_t i = 0; i < systems; ++i) m_Records[i].system->m_Entities.RestoreState(arena);
     }
 
   private:
-    // Integer-keyed maps; same rationale as ComponentManager — avoids the
-    // per-call typeid().name() string hash.
-    std::unordered_map<std::uint32_t, Signature> m_Signatures{};
-    std::unordered_map<std::uint32_t, std::shared_ptr<System>> m_Systems{};
+    struct SystemRecord {
+        std::shared_ptr<System> system;
+        Signature signature;
+        std::uint64_t visitStamp = 0;
+        bool signatureSet = false;
+    };
+
+    static void updateMembership(SystemRecord& record, Entity entity, const Signature& entitySignature) {
+        if ((entitySignature & record.signature) == record.signature) {
+            record.system->m_Entities.insert(entity);
+        } else {
+            record.system->m_Entities.erase(entity);
+        }
+    }
+
+    // Dedupes systems reachable from more than one changed bit.
+    void visit(std::uint32_t index, Entity entity, const Signature& entitySignature) {
+        SystemRecord& record = m_Records[index];
+        if (record.visitStamp == m_VisitStamp) return;
+        record.visitStamp = m_VisitStamp;
+        updateMembership(record, entity, entitySignature);
+    }
+
+    void rebuildComponentIndex() {
+        for (auto& bucket : m_SystemsByComponent) bucket.clear();
+        m_UnfilteredSystems.clear();
+        for (std::uint32_t i = 0; i < m_Records.size(); ++i) {
+            const Signature& sig = m_Records[i].signature;
+            if (sig.none()) {
+                m_UnfilteredSystems.push_back(i);
+                continue;
+            }
+            for (std::size_t bit = 0; bit < MAX_COMPONENTS; ++bit) {
+                if (sig.test(bit)) m_SystemsByComponent[bit].push_back(i);
+            }
+        }
+    }
+
+    // Integer-keyed map; same rationale as ComponentManager — avoids the
+    // per-call typeid().name() string hash. Only consulted at registration
+    // time; the hot path goes through the per-component buckets.
+    std::unordered_map<std::uint32_t, std::size_t> m_SystemIndex{};
+    std::vector<SystemRecord> m_Records{};
+    std::array<std::vector<std::uint32_t>, MAX_COMPONENTS> m_SystemsByComponent{};
+    std::vector<std::uint32_t> m_UnfilteredSystems{};
+    std::unordered_map<std::uint32_t, Signature> m_PendingSignatures{};
+    std::uint64_t m_VisitStamp = 0;
 };
 
 #endif // SYSTEMMANAGER_H
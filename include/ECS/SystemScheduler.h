@@ -2,33 +2,154 @@
 #ifndef MIST_SYSTEM_SCHEDULER_H
 #define MIST_SYSTEM_SCHEDULER_H
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include "System.h"
+#include "TypeID.h"
 
+class Profiler;
+
+namespace Mist {
+class JobSystem;
+}
+
+// Component types a system touches, keyed by Mist::ecs::type_id<T>() so
+// the declaration doesn't need a Coordinator. Two systems conflict when
+// either writes a type the other reads or writes; conflicting systems never
+// overlap. A system that declares nothing is treated as touching
+// everything — existing systems stay serial, on the main thread, until
+// someone opts them in.
+//
+// MainThread() pins a system to the JobSystem's bound main thread, for
+// anything that touches GL or the Lua state; it still overlaps with
+// non-conflicting systems running on workers.
+struct SystemAccess {
+    std::vector<std::uint32_t> reads;
+    std::vector<std::uint32_t> writes;
+    bool mainThread = false;
+
+    template <typename... Ts> SystemAccess& Read() {
+        (reads.push_back(Mist::ecs::type_id<Ts>()), ...);
+        return *this;
+    }
+
+    template <typename... Ts> SystemAccess& Write() {
+        (writes.push_back(Mist::ecs::type_id<Ts>()), ...);
+        return *this;
+    }
+
+    SystemAccess& MainThread() {
+        mainThread = true;
+        return *this;
+    }
+
+    bool Declared() const { return !reads.empty() || !writes.empty(); }
+    bool NeedsMainThread() const { return mainThread || !Declared(); }
+    bool ConflictsWith(const SystemAccess& other) const;
+};
+
+// Runs systems in an order consistent with their name-based dependencies.
+// With access declared, BuildExecutionOrder also derives a DAG: explicit
+// dependencies plus one edge per conflicting pair, pointed the way the
+// dependency-only topological order already runs them. Execute schedules
+// one Mist::JobSystem job per system, each depending on its predecessors'
+// jobs, and waits on them (the calling thread helps), so non-conflicting
+// systems overlap while conflicting ones keep a deterministic order.
+//
+// Main-thread systems need Execute to be called on the JobSystem's bound
+// main thread; from any other thread the whole frame runs serially on the
+// caller. SetParallel(false) does the same — use it when stepping through
+// systems in a debugger.
 class SystemScheduler {
 public:
     struct SystemEntry {
         std::string name;
         std::shared_ptr<System> system;
         std::vector<std::string> dependencies;
+        SystemAccess access;
+    };
+
+    // Per-system timing from the most recent Execute. Offsets are relative
+    // to the start of that Execute; `worker` is 0 for the calling thread.
+    struct SystemTiming {
+        std::string name;
+        float startMs    = 0.0f;
+        float durationMs = 0.0f;
+        int   worker     = 0;
     };
 
+    SystemScheduler() = default;
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
     void AddSystem(const std::string& name, std::shared_ptr<System> system);
+    void AddSystem(const std::string& name, std::shared_ptr<System> system, SystemAccess access);
+    // For a frame stage that isn't a System subclass (a call into one with
+    // its own signature, a command-buffer playback).
+    void AddSystem(const std::string& name, std::function<void(float)> update, SystemAccess access);
+    void SetAccess(const std::string& system, SystemAccess access);
     void AddDependency(const std::string& system, const std::string& dependsOn);
     void BuildExecutionOrder();
     void Execute(float dt);
 
+    // Defaults to Mist::JobSystem::Instance(). One with no workers makes
+    // Execute serial.
+    void SetJobSystem(Mist::JobSystem* jobs) { m_Jobs = jobs; }
+    Mist::JobSystem& GetJobSystem() const;
+
+    void SetParallel(bool parallel) { m_Parallel = parallel; }
+    bool IsParallel() const { return m_Parallel; }
+
+    // When set, Execute reports one CPU section per system ("System: <name>")
+    // plus "Systems (wall)" and "Systems (sum)" — sum / wall is how many
+    // cores' worth of system work the frame actually overlapped.
+    void SetProfiler(Profiler* profiler) { m_Profiler = profiler; }
+
+    const std::vector<SystemTiming>& GetLastTimings() const { return m_Timings; }
+    float GetLastWallTimeMs() const { return m_LastWallMs; }
+
+    const std::vector<int>& GetExecutionOrder() const { return m_ExecutionOrder; }
+
 private:
     std::vector<SystemEntry> m_Systems;
     std::vector<int> m_ExecutionOrder;
     std::unordered_map<std::string, int> m_NameToIndex;
     bool m_OrderBuilt = false;
 
+    // DAG over m_Systems indices. Systems caught in a dependency cycle
+    // have no node (they're absent from m_ExecutionOrder).
+    std::vector<std::vector<int>> m_Predecessors;
+
+    bool m_Parallel = true;
+    Mist::JobSystem* m_Jobs = nullptr;
+    Profiler* m_Profiler = nullptr;
+    std::vector<SystemTiming> m_Timings;
+    float m_LastWallMs = 0.0f;
+
+    // Per Execute. m_Threads maps thread ids to SystemTiming::worker (the
+    // caller is 0); m_Error keeps the first exception a system threw.
+    std::mutex m_Mutex;
+    std::vector<std::thread::id> m_Threads;
+    float m_FrameDt = 0.0f;
+    std::chrono::steady_clock::time_point m_FrameStart;
+    std::exception_ptr m_Error;
+
     void topologicalSort();
+    void buildGraph();
+    void executeSerial();
+    void executeParallel(Mist::JobSystem& jobs);
+    void runSystem(int index);
+    int workerIndex();
+    void rethrowError();
+    void reportTimings();
 };
 
 #endif
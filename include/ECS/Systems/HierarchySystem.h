@@ -5,42 +5,66 @@
 #include "ECS/Coordinator.h"
 #include "ECS/Entity.h"
 #include "ECS/System.h"
+#include "ECS/Systems/TransformHierarchy.h"
 
-// Scene-graph management. Walks the HierarchyComponent tree each frame,
-// propagates dirty flags, and computes `TransformComponent::cachedGlobal`
-// for every entity. Also handles the ordered OnReady callback so a parent
-// sees all its children initialized before its own ready fires.
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Scene-graph management. Mirrors the HierarchyComponent tree into a
+// depth-sorted TransformHierarchy, updated incrementally from the change
+// ticks, and recomputes `TransformComponent::cachedGlobal` for the dirty
+// subtrees only. Also handles the ordered OnReady callback so a parent
+// sees all its children initialized before its own ready fires. Both
+// passes cost nothing on a frame where nothing was added, attached or
+// moved.
 //
 // Design: MistEngine's ECS is flat, so hierarchy is another component.
 // System's `m_Entities` only picks up entities that have a
-// HierarchyComponent — roots iterate children from there. Entities without
-// HierarchyComponent still render (RenderSystem reads cachedGlobal; if
-// never touched it equals identity and RenderSystem falls back to the
-// local GetModelMatrix — see RenderSystem::Update for that path).
+// HierarchyComponent — the tree is rebuilt from their parent links. Entities without
+// HierarchyComponent still render (RenderSystem reads cachedGlobal for
+// hierarchy members and the local GetModelMatrix for everyone else — see
+// RenderSystem::Extract for that path).
 class HierarchySystem : public System {
 public:
     using System::Update;
 
-    // Compute cachedGlobal for every dirty entity under every root.
-    // Called once per frame before RenderSystem.
+    // Compute cachedGlobal for every entity whose Transform or Hierarchy
+    // changed (see Coordinator::MarkChanged), plus everything below it.
+    // Called once per frame before RenderSystem; a frame where neither
+    // component array changed costs nothing.
     void UpdateTransforms(Coordinator& coord);
 
-    // Fire OnReady (post-order) for entities that haven't fired yet.
+    // Fire OnReady for entities that haven't fired yet, children before
+    // parents. Only entities added or attached since the last call are
+    // looked at.
     void FireReadyCallbacks(Coordinator& coord);
 
-    // Wire parent/child in both components atomically. Marks the child's
-    // transform dirty and returns false if either entity lacks a
-    // HierarchyComponent (caller forgot to AddComponent).
+    // Wire parent/child in both components atomically. Stamps the child's
+    // HierarchyComponent changed and returns false if either entity lacks
+    // a HierarchyComponent (caller forgot to AddComponent).
     static bool Attach(Coordinator& coord, Entity parent, Entity child);
 
-    // Detach breaks the link both ways and re-marks the child as dirty so
-    // the next UpdateTransforms recomputes it as a root.
+    // Detach breaks the link both ways and stamps the child so the next
+    // UpdateTransforms recomputes it as a root.
     static bool Detach(Coordinator& coord, Entity child);
 
     // The OnReady signal fired by FireReadyCallbacks. Consumers (editor,
     // plugins, modules) connect here to run once-per-entity init logic in
     // the right order. See Core/Signal.h for connection semantics.
     static Mist::Signal<Entity>& OnReady();
+
+    const TransformHierarchy& GetTree() const { return m_Tree; }
+
+private:
+    // Brings m_Tree's membership, links and local matrices up to date with
+    // everything stamped after `since`.
+    void SyncTree(Coordinator& coord, ChangeTick since);
+
+    TransformHierarchy m_Tree;
+    ChangeTick m_LastUpdateTick = 0; // change tick seen by the last UpdateTransforms
+    ChangeTick m_LastReadyTick = 0;  // ... and by the last FireReadyCallbacks
+    std::vector<std::pair<std::uint32_t, Entity>> m_PendingReady; // (depth, entity)
 };
 
 #endif // HIERARCHYSYSTEM_H
@@ -4,17 +4,88 @@
 #include "../System.h"
 #include "../Coordinator.h"
 #include "../../Shader.h"
+#include "../../Renderer/RenderQueue.h"
+#include "../../Renderer/StreamBuffer.h"
+#include "../../Scene/FrustumCuller.h"
+
+#include <cstddef>
+#include <vector>
 
 extern Coordinator gCoordinator;
 
+// Feeds the Renderer's passes. Extract walks the ECS once per frame into a
+// sorted RenderQueue; each pass (every shadow cascade, then the main pass)
+// draws its slice of that queue with Draw. Runs of entities sharing a mesh
+// and material are drawn instanced: the pass's instance matrices are
+// streamed into one StreamBuffer and each run is a single draw. Meshes in
+// the GeometryPool go further: each material bucket is one multi-draw
+// indirect over the shared buffers. Cull
+// tests the queue against every view of the frame in one SIMD sweep, and
+// a Draw for a view skips what that view cannot see.
 class RenderSystem : public System {
 public:
-    // Hide the base's `Update(float)` explicitly. RenderSystem takes a shader
-    // rather than deltaTime because it's driven by the Renderer pass, not by
-    // the generic scheduler — `using` import silences GCC's
-    // -Woverloaded-virtual warning without changing runtime behaviour.
+    // Hide the base's `Update(float)` explicitly. RenderSystem is driven by
+    // the Renderer pass, not by the generic scheduler — `using` import
+    // silences GCC's -Woverloaded-virtual warning without changing runtime
+    // behaviour.
     using System::Update;
-    void Update(Shader& shader);
+
+    // Gathers this frame's visible renderables with their world matrices
+    // (cachedGlobal for hierarchy members) and sorts them; depth bits are
+    // measured from `eye` along `forward` over [nearPlane, farPlane].
+    void Extract(const glm::vec3& eye, const glm::vec3& forward, float nearPlane, float farPlane);
+
+    // Culls the extracted items against `count` views at once; view i of a
+    // later Draw is viewProjections[i]. Extract forgets the views.
+    void Cull(const glm::mat4* viewProjections, std::size_t count);
+
+    // Draws the extracted items of `passMask` with `shader`, which the
+    // caller has bound, keeping those visible in `view` (a Cull index; -1
+    // or a view not culled this frame draws everything). Depth-only passes
+    // skip materials altogether. Each (mask, view, bindMaterials) grouping
+    // is built on its first Draw after Extract and reused by later Draws
+    // with the same three.
+    Mist::Renderer::SubmitStats Draw(Shader& shader, std::uint32_t passMask, bool bindMaterials, int view = -1);
+
+    // Shortest run drawn instanced; 0 draws every entity on its own.
+    // Applies when indirect drawing is off or the geometry isn't pooled.
+    void SetMinInstances(std::uint32_t minInstances) { m_MinInstances = minInstances; }
+    std::uint32_t GetMinInstances() const { return m_MinInstances; }
+
+    // Multi-draw indirect over the GeometryPool (when there is one); on by
+    // default, off falls back to per-run instancing.
+    void SetIndirect(bool indirect) { m_Indirect = indirect; m_ResidentPass = -1; }
+    bool GetIndirect() const { return m_Indirect; }
+
+    const Mist::Renderer::RenderQueue& GetQueue() const { return m_Queue; }
+    std::size_t GetViewCount() const { return m_ViewCount; }
+    const VisibilityBitset& GetVisibility(std::size_t view) const { return m_Visibility[view]; }
+
+private:
+    struct PassList {
+        std::uint32_t passMask = 0;
+        int view = -1;
+        // Part of the key: indirect lists only break at material
+        // boundaries when the pass binds materials.
+        bool bindMaterials = false;
+        bool built = false;
+        bool indirect = false; // which of the two lists was built
+        Mist::Renderer::DrawList list;
+        Mist::Renderer::IndirectList indirectList;
+    };
+
+    Mist::Renderer::RenderQueue m_Queue;
+    std::vector<PassList> m_PassLists;
+    std::vector<Frustum> m_Frusta;
+    std::vector<VisibilityBitset> m_Visibility;
+    std::size_t m_ViewCount = 0;
+    Mist::Renderer::StreamBuffer m_InstanceBuffer;
+    Mist::Renderer::StreamBuffer m_DrawDataBuffer;
+    Mist::Renderer::StreamBuffer m_CommandBuffer;
+    // Index of the PassList whose data the stream buffers hold; -1 for none.
+    int m_ResidentPass = -1;
+    std::uint32_t m_MinInstances = 2;
+    bool m_Indirect = true;
 };
 
 #endif // RENDERSYSTEM_H
@@ -0,0 +1,34 @@
+#ifndef SPATIALHASHSYSTEM_H
+#define SPATIALHASHSYSTEM_H
+
+#include "ECS/Coordinator.h"
+#include "ECS/System.h"
+#include "Scene/SpatialHashGrid.h"
+
+// Keeps a SpatialHashGrid of the world position of every Transform entity,
+// for proximity queries from gameplay code and scripts (query_radius /
+// query_box in Lua). Incremental like SpatialIndexSystem: only entities
+// whose Transform was stamped since the last Update are looked at, and a
+// move inside its cell is a position write.
+class SpatialHashSystem : public System {
+public:
+    using System::Update;
+
+    explicit SpatialHashSystem(float cellSize = SpatialHashGrid::kDefaultCellSize) : m_Grid(cellSize) {}
+
+    // Run after HierarchySystem::UpdateTransforms (cachedGlobal is read for
+    // entities in the hierarchy) and before the scripts that query it.
+    void Update(Coordinator& coord);
+
+    void SetCellSize(float cellSize) { m_Grid.SetCellSize(cellSize); }
+
+    const SpatialHashGrid& GetGrid() const { return m_Grid; }
+    // Non-const for the span-returning queries, which reuse a buffer.
+    SpatialHashGrid& GetGrid() { return m_Grid; }
+
+private:
+    SpatialHashGrid m_Grid;
+    ChangeTick m_LastUpdateTick = 0;
+};
+
+#endif // SPATIALHASHSYSTEM_H
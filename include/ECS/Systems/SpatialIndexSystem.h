@@ -0,0 +1,47 @@
+#ifndef SPATIALINDEXSYSTEM_H
+#define SPATIALINDEXSYSTEM_H
+
+#include "ECS/Coordinator.h"
+#include "ECS/System.h"
+#include "Scene/DynamicAABBTree.h"
+#include "Scene/TriangleBVH.h"
+
+// Keeps a DynamicAABBTree of the world bounds of every Transform+Render
+// entity (the renderable's local bounds through its world matrix), so
+// culling, picking and scripts can ask "what's here" without scanning the
+// world. Incremental: only entities whose Transform or Render was stamped
+// since the last Update are looked at, and most moves stay inside their
+// fat box. A renderable without bounds is indexed as a point at its
+// origin.
+class SpatialIndexSystem : public System {
+public:
+    using System::Update;
+
+    // Run after the frame's last command-buffer playback and directly
+    // after a HierarchySystem::UpdateTransforms that follows every writer
+    // (scripts included): cachedGlobal is read for entities in the
+    // hierarchy, and a stamp seen here is consumed.
+    void Update(Coordinator& coord);
+
+    const DynamicAABBTree& GetTree() const { return m_Tree; }
+
+    // Closest entity whose geometry the segment origin + t * direction,
+    // 0 <= t <= maxDistance, hits. The tree narrows it to the entities
+    // whose bounds the ray enters; those are tested nearest first with
+    // Renderable::RaycastLocal in object space (triangles, for meshes)
+    // until the next one starts past the best hit. `distance` is in units
+    // of `direction`. Editor picking and Lua's raycast come through here.
+    bool Raycast(Coordinator& coord, const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 DynamicAABBTree::RayHit& hit) const;
+
+    // Raycast for each ray into hits[i] (entity NULL_ENTITY on a miss).
+    // Returns how many hit.
+    std::size_t RaycastBatch(Coordinator& coord, const TriangleBVH::Ray* rays, std::size_t count,
+                             DynamicAABBTree::RayHit* hits) const;
+
+private:
+    DynamicAABBTree m_Tree;
+    ChangeTick m_LastUpdateTick = 0;
+};
+
+#endif // SPATIALINDEXSYSTEM_H
@@ -0,0 +1,237 @@
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include "ECS/Entity.h"
+#include "ECS/ParallelForEach.h"
+#include "ECS/SparseEntityIndex.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Flattened scene graph behind HierarchySystem. Nodes live in one array
+// sorted by depth — every root, then every depth-1 node, and so on — with
+// each node's parent stored as an index into the same array. A parent
+// always sits in an earlier level than its children, so Update computes
+// world = parentWorld * local one level at a time with no recursion and no
+// entity lookups, and the nodes of a level are independent of each other:
+// each level is split across the job system.
+//
+// Per-node data is SoA (parent index, local, world, flags in separate
+// arrays), so a level pass streams through contiguous matrices.
+//
+// Reparenting is incremental: a node only moves between levels when its
+// depth changes, and each level it crosses costs one element move (the
+// first or last element of that level shifts to make room or fill the
+// hole). Children are found through per-node sibling links keyed by a
+// stable node id, so a node's move patches its children's parent index
+// without searching.
+//
+// Dirty nodes are tracked in a list rather than found by scanning, so an
+// Update with few changes only touches the changed subtrees.
+//
+// Not thread-safe; mutate from one thread, outside Update.
+class TransformHierarchy {
+public:
+    bool Contains(Entity entity) const { return nodeOf(entity) != kNone; }
+    std::size_t Size() const { return m_SlotNode.size(); }
+    std::size_t LevelCount() const { return m_LevelEnd.size(); }
+
+    // Entity in depth-sorted position `slot` (< Size()).
+    Entity EntityAt(std::size_t slot) const { return m_NodeEntity[m_SlotNode[slot]]; }
+
+    // Adds `entity` as a root with the given local matrix. No-op if it's
+    // already tracked; a stale handle sharing its index is removed first.
+    void Insert(Entity entity, const glm::mat4& local);
+
+    // Drops the node. Its children become roots.
+    void Remove(Entity entity);
+
+    // Moves `child` and its subtree under `parent`; an untracked parent
+    // (or NULL_ENTITY) makes it a root. Returns false, changing nothing,
+    // if `parent` is inside `child`'s subtree.
+    bool SetParent(Entity child, Entity parent);
+
+    // NULL_ENTITY for roots and untracked entities.
+    Entity GetParent(Entity entity) const;
+
+    // Depth of the node (roots are 0); only meaningful for tracked entities.
+    std::uint32_t GetDepth(Entity entity) const { return m_NodeDepth[nodeOf(entity)]; }
+
+    void SetLocal(Entity entity, const glm::mat4& local);
+
+    // World matrix as of the last Update. Tracked entities only.
+    const glm::mat4& GetWorld(Entity entity) const { return m_World[m_NodeSlot[nodeOf(entity)]]; }
+
+    // Recomputes the world matrix of every node whose local matrix or
+    // parent changed since the last Update, plus everything below it, and
+    // calls onRecomputed(Entity, const glm::mat4& world, bool localChanged)
+    // for each, parents before children; localChanged is true when the
+    // node's own SetLocal caused it rather than an ancestor or a reparent. The callback may run concurrently for nodes in
+    // different subtrees. Free when nothing is dirty.
+    //
+    // Work is driven by the dirty list: each dirty node without a dirty
+    // ancestor roots one subtree walk, and the walks are spread across the
+    // job system. Once a large share of the tree is dirty, a level-by-level
+    // pass over the whole array is cheaper than chasing child links, so
+    // Update switches to that.
+    template<typename Fn>
+    void Update(Fn&& onRecomputed, const ParallelForOptions& options = {}) {
+        if (m_DirtyNodes.empty()) return;
+        if (m_DirtyNodes.size() * kLevelPassRatio >= Size()) {
+            updateLevels(onRecomputed, options);
+        } else {
+            updateSubtrees(onRecomputed, options);
+        }
+        for (std::uint32_t node : m_DirtyNodes) {
+            if (m_NodeSlot[node] != kNone) m_Flags[m_NodeSlot[node]] = 0;
+        }
+        m_DirtyNodes.clear();
+    }
+
+private:
+    static constexpr std::uint32_t kNone = ~std::uint32_t(0);
+
+    enum Flags : std::uint8_t {
+        kDirty        = 1, // local or parent link changed
+        kRecomputed   = 2, // world rewritten this Update; children follow
+        kLocalChanged = 4, // SetLocal since the last Update
+    };
+
+    // Node payload while it's between levels.
+    struct Detached {
+        glm::mat4 local;
+        glm::mat4 world;
+        std::uint8_t flags;
+    };
+
+    // Dirty nodes per node in the tree at which Update stops walking
+    // subtrees and sweeps every level instead.
+    static constexpr std::size_t kLevelPassRatio = 8;
+    // Subtree roots per job; each one is a whole walk.
+    static constexpr std::size_t kWalkGrain = 16;
+
+    template<typename Fn>
+    void updateLevels(Fn& onRecomputed, const ParallelForOptions& options) {
+        std::size_t begin = 0;
+        for (std::size_t end : m_LevelEnd) {
+            // Chunked on the flag bytes: a boundary there is also one in
+            // every 64-byte matrix array.
+            Mist::ecs::ParallelRanges(m_Flags.data() + begin, 1, end - begin, options,
+                                      [&, begin](std::size_t first, std::size_t last) {
+                                          updateRange(begin + first, begin + last, onRecomputed);
+                                      });
+            begin = end;
+        }
+        // Only the dirty list is cleared by Update; the sweep flagged more.
+        std::fill(m_Flags.begin(), m_Flags.end(), std::uint8_t(0));
+    }
+
+    template<typename Fn>
+    void updateRange(std::size_t first, std::size_t last, Fn& onRecomputed) {
+        for (std::size_t i = first; i < last; ++i) {
+            const std::uint32_t parent = m_SlotParent[i];
+            const bool parentMoved = parent != kNone && (m_Flags[parent] & kRecomputed);
+            if (!(m_Flags[i] & kDirty) && !parentMoved) continue;
+            m_World[i] = parent == kNone ? m_Local[i] : m_World[parent] * m_Local[i];
+            m_Flags[i] |= kRecomputed;
+            onRecomputed(m_NodeEntity[m_SlotNode[i]], m_World[i], (m_Flags[i] & kLocalChanged) != 0);
+        }
+    }
+
+    template<typename Fn>
+    void updateSubtrees(Fn& onRecomputed, const ParallelForOptions& options) {
+        // A dirty node under a dirty ancestor is covered by the ancestor's
+        // walk; the rest root disjoint subtrees.
+        std::sort(m_DirtyNodes.begin(), m_DirtyNodes.end());
+        m_DirtyNodes.erase(std::unique(m_DirtyNodes.begin(), m_DirtyNodes.end()), m_DirtyNodes.end());
+        m_WalkRoots.clear();
+        for (std::uint32_t node : m_DirtyNodes) {
+            if (m_NodeSlot[node] == kNone || !(m_Flags[m_NodeSlot[node]] & kDirty)) continue;
+            bool covered = false;
+            for (std::uint32_t up = m_NodeParent[node]; up != kNone && !covered; up = m_NodeParent[up]) {
+                covered = (m_Flags[m_NodeSlot[up]] & kDirty) != 0;
+            }
+            if (!covered) m_WalkRoots.push_back(node);
+        }
+
+        ParallelForOptions walk = options;
+        walk.grain = kWalkGrain;
+        walk.serialThreshold = 2 * kWalkGrain;
+        Mist::ecs::ParallelRanges(m_WalkRoots.data(), sizeof(std::uint32_t), m_WalkRoots.size(), walk,
+                                  [&](std::size_t first, std::size_t last) {
+                                      std::vector<std::uint32_t> stack;
+                                      for (std::size_t i = first; i < last; ++i) {
+                                          walkSubtree(m_WalkRoots[i], stack, onRecomputed);
+                                      }
+                                  });
+    }
+
+    // Depth-first from `root`, so every node is recomputed after its parent.
+    template<typename Fn>
+    void walkSubtree(std::uint32_t root, std::vector<std::uint32_t>& stack, Fn& onRecomputed) {
+        stack.assign(1, root);
+        while (!stack.empty()) {
+            const std::uint32_t node = stack.back();
+            stack.pop_back();
+            const std::uint32_t slot = m_NodeSlot[node];
+            const std::uint32_t parent = m_SlotParent[slot];
+            m_World[slot] = parent == kNone ? m_Local[slot] : m_World[parent] * m_Local[slot];
+            onRecomputed(m_NodeEntity[node], m_World[slot], (m_Flags[slot] & kLocalChanged) != 0);
+            for (std::uint32_t c = m_NodeFirstChild[node]; c != kNone; c = m_NodeNextSibling[c]) {
+                stack.push_back(c);
+            }
+        }
+    }
+
+    std::uint32_t nodeOf(Entity entity) const {
+        const std::uint32_t node = m_Index.Get(entity);
+        return node != SparseEntityIndex::kInvalid && m_NodeEntity[node] == entity ? node : kNone;
+    }
+
+    std::size_t levelStart(std::size_t level) const { return level ? m_LevelEnd[level - 1] : 0; }
+
+    void markDirty(std::uint32_t node, std::uint8_t extra = 0) {
+        std::uint8_t& flags = m_Flags[m_NodeSlot[node]];
+        if (!(flags & kDirty)) m_DirtyNodes.push_back(node);
+        flags |= kDirty | extra;
+    }
+
+    bool setParentNode(std::uint32_t node, std::uint32_t parent);
+    void link(std::uint32_t node, std::uint32_t parent);
+    void unlink(std::uint32_t node);
+    void moveSlot(std::uint32_t from, std::uint32_t to);
+    Detached detach(std::uint32_t node);
+    void attach(std::uint32_t node, std::uint32_t level, const Detached& payload);
+    void fixChildren(std::uint32_t node);
+
+    // Per node id (stable while the node lives).
+    std::vector<Entity> m_NodeEntity;
+    std::vector<std::uint32_t> m_NodeParent;
+    std::vector<std::uint32_t> m_NodeFirstChild;
+    std::vector<std::uint32_t> m_NodeNextSibling;
+    std::vector<std::uint32_t> m_NodePrevSibling;
+    std::vector<std::uint32_t> m_NodeDepth;
+    std::vector<std::uint32_t> m_NodeSlot; // kNone while detached or free
+    std::vector<std::uint32_t> m_FreeNodes;
+    SparseEntityIndex m_Index; // entity -> node id
+
+    // Per slot, depth-sorted.
+    std::vector<std::uint32_t> m_SlotNode;
+    std::vector<std::uint32_t> m_SlotParent; // parent's slot, kNone for roots
+    std::vector<glm::mat4> m_Local;
+    std::vector<glm::mat4> m_World;
+    std::vector<std::uint8_t> m_Flags;
+
+    std::vector<std::size_t> m_LevelEnd; // level L is [m_LevelEnd[L-1], m_LevelEnd[L])
+
+    // Node ids marked dirty since the last Update (may hold ids removed
+    // since; Update skips those).
+    std::vector<std::uint32_t> m_DirtyNodes;
+    std::vector<std::uint32_t> m_WalkRoots;
+};
+
+#endif // TRANSFORMHIERARCHY_H
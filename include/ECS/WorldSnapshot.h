@@ -0,0 +1,114 @@
+#pragma once
+#ifndef MIST_ECS_WORLD_SNAPSHOT_H
+#define MIST_ECS_WORLD_SNAPSHOT_H
+
+#include "Coordinator.h"
+#include "SnapshotArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// In-memory copy of a Coordinator's world, for the editor's play mode and
+// for rollback/replay in tests:
+//
+//     snapshot.Capture(coord);   // entering play mode
+//     ...                        // simulate, spawn, destroy
+//     snapshot.Restore(coord);   // back to exactly the captured state
+//
+// Capture copies entity slots, the living set, every sparse-set
+// ComponentArray, owning-group sizes and system membership. Arrays of
+// trivially copyable components are memcpy'd into one reusable arena;
+// other copyable components are copied into typed buffers that are also
+// kept between captures. A non-copyable component type (one holding a
+// unique_ptr, say) can't be copied at all: its array is captured only
+// while empty and Restore empties it again, so components of that type
+// added after the capture go away with the rest. Capture throws
+// std::logic_error if such an array holds anything, before touching the
+// previous capture. Restore writes everything back in place — same
+// handles, same dense order, same iteration order — so a deterministic
+// simulation replays bit-for-bit. Handles created after the capture are
+// stale once it's restored.
+//
+// Components that point at state living outside the ECS (a btRigidBody,
+// a script VM instance) come back as the same pointers; register hooks to
+// save and reapply whatever that outside state needs (see AddHooks).
+//
+// Both calls are structural changes: run them at a sync point, with no
+// parallel pass in flight and the frame's EntityCommandBuffer played back
+// or cleared. Archetype-stored components aren't covered yet.
+class WorldSnapshot {
+public:
+    void Capture(Coordinator& coordinator);
+
+    // No-op without a capture. The capture is kept, so a snapshot can be
+    // restored any number of times (rollback).
+    void Restore(Coordinator& coordinator);
+
+    bool HasCapture() const { return m_HasCapture; }
+    void Clear();
+
+    // Arena bytes used by the last capture (typed copies not included).
+    std::size_t GetArenaSize() const { return m_Arena.Size(); }
+
+    // capture(entity, component) runs for every T at Capture and returns
+    // a trivially copyable State; after Restore has put the components
+    // back, restore(entity, component, state) runs for each of them.
+    template<typename T, typename State>
+    void AddHooks(std::function<State(Entity, const T&)> capture,
+                  std::function<void(Entity, T&, const State&)> restore) {
+        static_assert(std::is_trivially_copyable_v<State>, "hook state is stored in the snapshot arena");
+        m_Hooks.push_back(std::make_unique<Hook<T, State>>(std::move(capture), std::move(restore)));
+    }
+
+private:
+    struct HookBase {
+        virtual ~HookBase() = default;
+        virtual void capture(Coordinator& coordinator, SnapshotArena& arena) = 0;
+        virtual void restore(Coordinator& coordinator, SnapshotArena& arena) = 0;
+    };
+
+    template<typename T, typename State>
+    struct Hook final : HookBase {
+        struct Record {
+            Entity entity;
+            State state;
+        };
+
+        Hook(std::function<State(Entity, const T&)> onCapture,
+             std::function<void(Entity, T&, const State&)> onRestore)
+            : onCapture(std::move(onCapture)), onRestore(std::move(onRestore)) {}
+
+        void capture(Coordinator& coordinator, SnapshotArena& arena) override {
+            records.clear();
+            coordinator.ForEach<T>([this](Entity e, T& component) {
+                records.push_back({e, onCapture(e, component)});
+            });
+            arena.Write(static_cast<std::uint64_t>(records.size()));
+            arena.WriteArray(records.data(), records.size());
+        }
+
+        void restore(Coordinator& coordinator, SnapshotArena& arena) override {
+            records.resize(static_cast<std::size_t>(arena.Read<std::uint64_t>()));
+            arena.ReadArray(records.data(), records.size());
+            for (const Record& record : records) {
+                onRestore(record.entity, coordinator.GetComponent<T>(record.entity), record.state);
+            }
+        }
+
+        std::function<State(Entity, const T&)> onCapture;
+        std::function<void(Entity, T&, const State&)> onRestore;
+        std::vector<Record> records; // scratch, kept for its capacity
+    };
+
+    SnapshotArena m_Arena;
+    ComponentManager::ArrayCopies m_Copies;
+    std::vector<std::unique_ptr<HookBase>> m_Hooks;
+    bool m_HasCapture = false;
+};
+
+#endif // MIST_ECS_WORLD_SNAPSHOT_H
@@ -10,7 +10,9 @@
 #include "Shader.h"
 #include "Texture.h"
 #include "Renderable.h"
+#include "Renderer/GeometryPool.h"
 #include "Renderer/RID.h"
+#include "Scene/TriangleBVH.h"
 
 struct Vertex {
     glm::vec3 Position;
@@ -34,15 +36,49 @@ public:
     ~Mesh();
 
     void Draw(Shader& shader) override;
+    void BindState(Shader& shader) override;
+    void DrawGeometry(Shader& shader) override;
+    bool SupportsInstancing() const override { return true; }
+    void DrawInstanced(Shader& shader, std::uint32_t instanceBuffer, std::uint32_t firstInstance,
+                       std::uint32_t count) override;
+
+    // First of the four attribute locations (one per column) an instanced
+    // draw feeds the per-instance model matrix through; 5-7 are left to
+    // skinning's bone ids and weights.
+    static constexpr unsigned int kInstanceAttribute = 8;
+
+    // Null without a PBR material: the legacy path binds per-mesh textures.
+    const PBRMaterial* GetMaterial() const override { return pbrMaterial.get(); }
+
+    // Null when the mesh has its own buffers (no pool at construction).
+    const Mist::Renderer::GeometryRange* GetGeometryRange() const override { return m_Geometry.get(); }
+
+    // Exact: nearest triangle, through GetBVH().
+    bool RaycastLocal(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const override;
+
+    // Triangle BVH over `vertices`/`indices`, built on first use and shared
+    // by copies. The first call isn't safe to race; call InvalidateBVH
+    // after editing the geometry.
+    const TriangleBVH& GetBVH() const;
+    void InvalidateBVH() { m_Bvh.reset(); }
 
 private:
-    // VAO stays raw — vertex layout is a GL concept. Future Vulkan/D3D12
-    // backends express this via pipeline-state objects instead. VBO + EBO
-    // lifetimes are owned by the device; the GLuint fields are cached for
-    // the per-draw bind path.
+    // With a GeometryPool, the vertices and indices live in its shared
+    // buffers and every draw binds its VAO; copies share the range.
+    Mist::Renderer::GeometryHandle m_Geometry;
+
+    // Without one: VAO stays raw — vertex layout is a GL concept. Future
+    // Vulkan/D3D12 backends express this via pipeline-state objects
+    // instead. VBO + EBO lifetimes are owned by the device; the GLuint
+    // fields are cached for the per-draw bind path.
     unsigned int VAO = 0, VBO = 0, EBO = 0;
     RID          m_VboRid{};
     RID          m_EboRid{};
+    // Instance buffer the VAO's instance attributes point at; set up on
+    // the first instanced draw and again only if the buffer changes.
+    unsigned int m_InstanceBuffer = 0;
+
+    mutable std::shared_ptr<const TriangleBVH> m_Bvh;
 
     void setupMesh();
 };
@@ -20,6 +20,7 @@ public:
     ~Model();
 
     void Draw(Shader& shader) override;
+    bool RaycastLocal(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const override;
 
 private:
     std::vector<Mesh> meshes;
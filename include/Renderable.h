@@ -3,11 +3,58 @@
 #define RENDERABLE_H
 
 #include "Shader.h"
+#include "Scene/AABB.h"
+
+#include <cstdint>
+
+struct PBRMaterial;
+
+namespace Mist::Renderer {
+struct GeometryRange;
+}
 
 class Renderable {
 public:
     virtual ~Renderable() {}
     virtual void Draw(Shader& shader) = 0; // Pure virtual function
+
+    // Draw split in two for callers that batch state (RenderQueue): BindState
+    // sets the material uniforms and textures Draw would, DrawGeometry
+    // issues the draw alone. A subclass that overrides neither still works;
+    // its whole Draw runs as the geometry half.
+    virtual void BindState(Shader& /*shader*/) {}
+    virtual void DrawGeometry(Shader& shader) { Draw(shader); }
+
+    // Instanced form of DrawGeometry: `count` copies, the i-th placed by
+    // the matrix at index firstInstance + i of the GL buffer
+    // `instanceBuffer` (tightly packed mat4s). Only called when
+    // SupportsInstancing() says so; the shader's `useInstancing` is set.
+    virtual bool SupportsInstancing() const { return false; }
+    virtual void DrawInstanced(Shader& /*shader*/, std::uint32_t /*instanceBuffer*/,
+                               std::uint32_t /*firstInstance*/, std::uint32_t /*count*/) {}
+
+    // Where the geometry sits in the shared GeometryPool, if it does;
+    // pooled renderables can be drawn by multi-draw indirect commands
+    // with the pool's VAO bound, and the rest are drawn one by one.
+    virtual const Mist::Renderer::GeometryRange* GetGeometryRange() const { return nullptr; }
+
+    // The material BindState applies, when it is a single shared one;
+    // draws that report the same material can share a bind.
+    virtual const PBRMaterial* GetMaterial() const { return nullptr; }
+
+    // Object-space bounds, set by the subclass once its geometry is known.
+    // Invalid (AABB::IsValid) for a renderable that never set them.
+    const AABB& GetLocalBounds() const { return m_LocalBounds; }
+
+    // Nearest point where the object-space segment origin + t * dir,
+    // 0 <= t <= maxT, meets this renderable; `t` is in units of `dir`.
+    // The default tests the local bounds; meshes test their triangles.
+    virtual bool RaycastLocal(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const {
+        return m_LocalBounds.IsValid() && m_LocalBounds.IntersectRay(origin, dir, maxT, t);
+    }
+
+protected:
+    AABB m_LocalBounds;
 };
 
 #endif
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "Debug/Profiler.h"
 #include "Renderer/Viewport.h"
 #include "Renderer/GLRenderingDevice.h"
+#include "Renderer/GeometryPool.h"
 
 class Scene;
 struct PhysicsRenderable;
@@ -121,6 +122,10 @@ private:
     // destruction through `Mist::GPU::Device()` without taking a pointer.
     Mist::GPU::GLRenderingDevice m_GpuDevice;
 
+    // Shared vertex/index buffers every Mesh allocates from, published as
+    // `Mist::Renderer::Geometry()` right after the device.
+    Mist::Renderer::GeometryPool m_GeometryPool;
+
     // New subsystems
     PostProcessStack m_PostProcess;
     ShadowSystem m_ShadowSystem;
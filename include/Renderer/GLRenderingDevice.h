@@ -2,12 +2,11 @@
 #ifndef MIST_GL_RENDERING_DEVICE_H
 #define MIST_GL_RENDERING_DEVICE_H
 
+#include "Core/SlotMap.h"
 #include "Renderer/RenderingDevice.h"
 
-#include <atomic>
 #include <cstdint>
 #include <mutex>
-#include <unordered_map>
 
 // OpenGL-backed RenderingDevice. First concrete implementation — thin
 // shim over glCreateXxx / glDeleteXxx. Migrated subsystems use this via
@@ -47,9 +46,14 @@ private:
         std::uint32_t glHandle = 0;   // GLuint; kept as uint32 so this header doesn't include glad
     };
 
-    mutable std::mutex                       m_Mutex;
-    std::atomic<std::uint64_t>               m_NextId{1};
-    std::unordered_map<std::uint64_t, Entry> m_Live;
+    // RID::id is a packed SlotMapKey: GetGLHandle, hit on every bind, is
+    // an index and a generation check, and a destroyed RID can't resolve
+    // to a newer resource that reused its slot.
+    RID track(Kind kind, std::uint32_t glHandle);
+    const Entry* lookup(RID rid) const;
+
+    mutable std::mutex    m_Mutex;
+    Mist::SlotMap<Entry>  m_Live;
 };
 
 } // namespace Mist::GPU
@@ -0,0 +1,115 @@
+#pragma once
+#ifndef MIST_GEOMETRY_POOL_H
+#define MIST_GEOMETRY_POOL_H
+
+#include "Core/RangeAllocator.h"
+#include "Renderer/RID.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct Vertex;
+
+namespace Mist::Renderer {
+
+// Where a mesh lives in the GeometryPool: its vertices start at
+// baseVertex and its indices (relative to baseVertex) at firstIndex.
+// These are the fields of a DrawElementsIndirectCommand.
+struct GeometryRange {
+    std::uint32_t baseVertex = 0;
+    std::uint32_t vertexCount = 0;
+    std::uint32_t firstIndex = 0;
+    std::uint32_t indexCount = 0;
+
+    bool IsValid() const { return indexCount > 0; }
+};
+
+// glMultiDrawElementsIndirect's command layout, field for field; a
+// GeometryRange supplies the first four.
+struct DrawElementsIndirectCommand {
+    std::uint32_t count = 0; // indices
+    std::uint32_t instanceCount = 0;
+    std::uint32_t firstIndex = 0;
+    std::int32_t baseVertex = 0;
+    std::uint32_t baseInstance = 0;
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "matches the GL command struct");
+
+// Shared geometry, handed out per mesh; the range returns to the pool
+// when the last copy of the handle goes away.
+using GeometryHandle = std::shared_ptr<const GeometryRange>;
+
+// One vertex buffer and one index buffer for every Mesh, sub-allocated
+// with RangeAllocator, behind a single VAO. Drawing any pooled mesh binds
+// the same VAO, so a run of them (a whole material bucket) can go out as
+// one glMultiDrawElementsIndirect. Both buffers grow by doubling: a new
+// buffer, a GPU-side copy, and the VAO repointed; ranges keep their
+// offsets.
+//
+// Lives in the Renderer, published through Geometry() the way the device
+// is through Mist::GPU::Device(). Needs the GL context; main thread only.
+class GeometryPool {
+public:
+    GeometryPool() = default;
+    ~GeometryPool();
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    // Copies the mesh in. Null without a device, or for empty geometry.
+    GeometryHandle Allocate(const Vertex* vertices, std::uint32_t vertexCount,
+                            const std::uint32_t* indices, std::uint32_t indexCount);
+
+    // Binds the shared VAO.
+    void Bind() const;
+
+    // SSBO binding the vertex shaders read per-draw data from
+    // (`DrawData`, indexed by gl_BaseInstance + gl_InstanceID).
+    static constexpr std::uint32_t kDrawDataBinding = 7;
+
+    // One glMultiDrawElementsIndirect of `commandCount` commands, starting
+    // at `firstCommand`, from the DrawElementsIndirectCommand array in
+    // `commandBuffer`, with `drawDataBuffer` bound as the DrawData SSBO.
+    void MultiDrawIndirect(std::uint32_t commandBuffer, std::uint32_t drawDataBuffer, std::uint32_t firstCommand,
+                           std::uint32_t commandCount);
+
+    // Releases the GL buffers while the device is still up; outstanding
+    // handles then free nothing.
+    void Shutdown();
+
+    std::uint32_t GetVAO() const { return m_VAO; }
+    const Mist::RangeAllocator& Vertices() const { return m_Vertices; }
+    const Mist::RangeAllocator& Indices() const { return m_Indices; }
+
+    // Points the VAO's instance attributes (Mesh::kInstanceAttribute) at
+    // `instanceBuffer`, only when it changes; 0 disables them, for draws
+    // that take their matrices from the draw-data SSBO instead.
+    void BindInstanceBuffer(std::uint32_t instanceBuffer);
+
+private:
+    static constexpr std::uint32_t kMinVertices = 1u << 16;
+    static constexpr std::uint32_t kMinIndices = 3u << 16;
+
+    void free(const GeometryRange& range);
+    bool reserve(std::uint32_t vertexCount, std::uint32_t indexCount);
+    bool growBuffer(RID& rid, std::uint32_t& handle, std::size_t oldBytes, std::size_t newBytes, bool index);
+    void createVAO();
+
+    Mist::RangeAllocator m_Vertices;
+    Mist::RangeAllocator m_Indices;
+    RID m_VboRid{};
+    RID m_EboRid{};
+    std::uint32_t m_VBO = 0, m_EBO = 0, m_VAO = 0;
+    std::uint32_t m_InstanceBuffer = 0;
+    // Handles watch this; Shutdown drops it so theirs stop freeing.
+    std::shared_ptr<GeometryPool*> m_Self = std::make_shared<GeometryPool*>(this);
+};
+
+// Process-wide pool, set by Renderer::Init and cleared at shutdown. Null
+// means meshes keep their own buffers.
+GeometryPool* Geometry();
+void SetGeometry(GeometryPool*);
+
+} // namespace Mist::Renderer
+
+#endif // MIST_GEOMETRY_POOL_H
@@ -0,0 +1,254 @@
+#pragma once
+#ifndef MIST_RENDER_QUEUE_H
+#define MIST_RENDER_QUEUE_H
+
+#include "Core/FlatHashMap.h"
+#include "ECS/Entity.h"
+#include "Renderer/GeometryPool.h"
+#include "Scene/FrustumCuller.h"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Renderable;
+struct PBRMaterial;
+
+namespace Mist::Renderer {
+
+// Which passes an item takes part in; a pass consumes the items whose mask
+// overlaps the one it asks for.
+enum PassBits : std::uint32_t {
+    kPassShadow = 1u << 0,
+    kPassMain   = 1u << 1,
+    kPassAll    = kPassShadow | kPassMain,
+};
+
+// A 64-bit sort key, most significant field first, so sorting by key
+// groups draws by shader, then material, then mesh, and orders each run
+// front to back:
+//
+//   [63..52] shader    12 bits
+//   [51..36] material  16 bits
+//   [35..20] mesh      16 bits
+//   [19.. 0] depth     20 bits (view distance mapped onto [near, far])
+//
+// Fields are the queue's dense per-frame ids, not pointers; ids past a
+// field's range saturate, which only weakens the grouping.
+struct DrawKey {
+    static constexpr int kShaderBits   = 12;
+    static constexpr int kMaterialBits = 16;
+    static constexpr int kMeshBits     = 16;
+    static constexpr int kDepthBits    = 20;
+    static_assert(kShaderBits + kMaterialBits + kMeshBits + kDepthBits == 64, "key fields fill 64 bits");
+
+    static std::uint64_t Make(std::uint32_t shader, std::uint32_t material, std::uint32_t mesh, std::uint32_t depth);
+
+    static std::uint32_t Shader(std::uint64_t key)   { return std::uint32_t(key >> 52); }
+    static std::uint32_t Material(std::uint64_t key) { return std::uint32_t(key >> 36) & 0xFFFFu; }
+    static std::uint32_t Mesh(std::uint64_t key)     { return std::uint32_t(key >> 20) & 0xFFFFu; }
+    static std::uint32_t Depth(std::uint64_t key)    { return std::uint32_t(key) & 0xFFFFFu; }
+};
+
+struct DrawItem {
+    std::uint64_t key = 0;
+    Renderable* renderable = nullptr;
+    // Null when the renderable binds its own state (legacy textures, a
+    // Model's per-mesh materials); such items never share a bind.
+    const PBRMaterial* material = nullptr;
+    std::uint32_t transform = 0; // index into RenderQueue::Transforms()
+    std::uint32_t passMask = kPassAll;
+    Entity entity = NULL_ENTITY;
+};
+
+// One entry of a DrawList: a single draw of `item`, or, when `instanced`,
+// one draw of `count` copies of its renderable and material whose world
+// matrices are DrawList::instances[firstInstance, firstInstance + count).
+struct DrawBatch {
+    std::uint32_t item = 0; // first item of the run; it stands for all of them
+    std::uint32_t firstInstance = 0;
+    std::uint32_t count = 1;
+    bool instanced = false;
+};
+
+// A pass's share of the queue with runs of the same renderable and
+// material folded into instanced batches. Built once and submitted as
+// often as needed (once per shadow cascade); `instances` is what the
+// caller streams to the GPU before submitting.
+struct DrawList {
+    std::vector<DrawBatch> batches;
+    std::vector<glm::mat4> instances;
+    std::vector<std::uint32_t> items; // the pass's items in key order
+
+    void Clear() {
+        batches.clear();
+        instances.clear();
+        items.clear();
+    }
+};
+
+// One entry of an IndirectList: when `indirect`, a single multi-draw of
+// commands[firstCommand, firstCommand + commandCount), all sharing
+// `item`'s material; otherwise a plain draw of `item`, whose renderable
+// is not in the GeometryPool.
+struct IndirectBatch {
+    std::uint32_t item = 0;
+    std::uint32_t firstCommand = 0;
+    std::uint32_t commandCount = 0;
+    bool indirect = false;
+};
+
+// A pass's share of the queue as multi-draw indirect commands over the
+// shared GeometryPool. `commands` and `drawData` are what the caller
+// streams to the GPU (the draw-indirect buffer and the per-draw SSBO)
+// before submitting; instance i of a command draws with
+// drawData[baseInstance + i].
+struct IndirectList {
+    std::vector<IndirectBatch> batches;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<glm::mat4> drawData;
+
+    void Clear() {
+        batches.clear();
+        commands.clear();
+        drawData.clear();
+    }
+};
+
+// What a pass does with the items it consumes. RenderSystem's
+// implementation sets uniforms and issues GL draws; tests record calls.
+class DrawSink {
+public:
+    virtual ~DrawSink() = default;
+    // State for every following Draw until the next BindMaterial.
+    virtual void BindMaterial(const DrawItem& item) = 0;
+    virtual void Draw(const DrawItem& item, const glm::mat4& world) = 0;
+    // `count` copies of `item`'s renderable, taking their world matrices
+    // from the submitted DrawList's instances starting at `firstInstance`.
+    virtual void DrawInstanced(const DrawItem& item, std::uint32_t firstInstance, std::uint32_t count) = 0;
+    // One multi-draw of the submitted IndirectList's commands
+    // [firstCommand, firstCommand + commandCount); `item` is the first.
+    virtual void DrawIndirect(const DrawItem& item, std::uint32_t firstCommand, std::uint32_t commandCount) = 0;
+};
+
+struct SubmitStats {
+    std::uint32_t draws = 0; // instanced batches and multi-draws count once
+    std::uint32_t materialBinds = 0;
+    std::uint32_t instanceGroups = 0;
+    std::uint32_t instances = 0; // drawn through instanced batches or commands
+    std::uint32_t indirectCommands = 0;
+};
+
+// Per-frame list of everything visible, built once and shared by every
+// pass that frame (four shadow cascades plus the main pass), so the ECS
+// walk, the world matrices and the sort happen once instead of per pass.
+//
+//   queue.Begin(eye, forward, near, far);
+//   for (...) queue.Add(renderable, material, world, mask, entity);
+//   queue.Sort();
+//   queue.Submit(kPassShadow, depthSink, false); // per cascade
+//   queue.Submit(kPassMain, sceneSink, true);
+//
+// or, to draw runs of one mesh and material as instances, BuildDrawList
+// per pass and Submit the lists; or, for geometry in the GeometryPool,
+// BuildIndirectList and Submit that, one multi-draw per material.
+//
+// Sort is an LSD radix sort on the keys; it is stable, so equal keys keep
+// submission order. Not thread-safe.
+class RenderQueue {
+public:
+    // Starts a frame: drops last frame's items (keeping capacity) and sets
+    // the view the depth bits are measured along.
+    void Begin(const glm::vec3& eye, const glm::vec3& forward, float nearPlane, float farPlane);
+
+    // `shader` identifies a pipeline variant for the key; null means the
+    // pass's own shader. Returns the item's index.
+    std::uint32_t Add(Renderable* renderable, const PBRMaterial* material, const glm::mat4& world,
+                      std::uint32_t passMask = kPassAll, Entity entity = NULL_ENTITY,
+                      const void* shader = nullptr);
+
+    void Sort();
+
+    std::size_t Size() const { return m_Items.size(); }
+    bool Empty() const { return m_Items.empty(); }
+
+    // Items in submission order; Sorted() gives the draw order.
+    const std::vector<DrawItem>& Items() const { return m_Items; }
+    const std::vector<glm::mat4>& Transforms() const { return m_Transforms; }
+    const DrawItem& Sorted(std::size_t i) const { return m_Items[m_Order[i]]; }
+
+    // World bounds by item index, ready for FrustumCuller. An item whose
+    // renderable has no local bounds gets a box covering everything, so
+    // culling never drops it.
+    const BoundsSoA& Bounds() const { return m_Bounds; }
+
+    // Visits the items of `passMask` in key order; with `visible` (a
+    // culling result over this queue's items), only those whose bit is set.
+    template<typename Fn>
+    void ForEach(std::uint32_t passMask, Fn&& fn, const VisibilityBitset* visible = nullptr) const {
+        for (std::uint32_t index : m_Order) {
+            const DrawItem& item = m_Items[index];
+            if ((item.passMask & passMask) && (!visible || visible->Test(index))) fn(item);
+        }
+    }
+
+    // Draws the items of `passMask` (and `visible`) in key order. With
+    // `bindMaterials`, binds each material once per run instead of once
+    // per draw; without, binds nothing (depth-only passes).
+    SubmitStats Submit(std::uint32_t passMask, DrawSink& sink, bool bindMaterials,
+                       const VisibilityBitset* visible = nullptr) const;
+
+    // Groups the items of `passMask` (and `visible`) for instancing: a run
+    // of at least `minInstances` consecutive items (in key order) sharing
+    // a renderable and material becomes one instanced batch, if the
+    // renderable SupportsInstancing(). Everything else stays a single
+    // draw; `minInstances` 0 turns grouping off.
+    void BuildDrawList(std::uint32_t passMask, std::uint32_t minInstances, DrawList& list,
+                       const VisibilityBitset* visible = nullptr) const;
+
+    // Submit for a list built from this frame's queue; binds materials as
+    // the mask form does, per batch.
+    SubmitStats Submit(const DrawList& list, DrawSink& sink, bool bindMaterials) const;
+
+    // Turns the items of `passMask` (and `visible`) with pooled geometry
+    // (Renderable::GetGeometryRange) into indirect commands: one per run
+    // of the same renderable, with the run's length as its instance count,
+    // and one multi-draw batch per material. Without `splitByMaterial`
+    // (depth-only passes) a batch runs until an unpooled item, which
+    // stays a single draw in its place in key order.
+    void BuildIndirectList(std::uint32_t passMask, bool splitByMaterial, IndirectList& list,
+                           const VisibilityBitset* visible = nullptr) const;
+
+    // Submit for an indirect list; one bind per multi-draw batch.
+    SubmitStats Submit(const IndirectList& list, DrawSink& sink, bool bindMaterials) const;
+
+private:
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t item;
+    };
+
+    static std::uint32_t denseId(Mist::FlatHashMap<const void*, std::uint32_t>& ids, const void* ptr);
+    std::uint32_t depthBits(const glm::vec3& center) const;
+
+    std::vector<DrawItem> m_Items;
+    std::vector<glm::mat4> m_Transforms;
+    BoundsSoA m_Bounds;
+    std::vector<std::uint32_t> m_Order;
+    std::vector<SortEntry> m_SortKeys;
+    std::vector<SortEntry> m_SortScratch;
+
+    Mist::FlatHashMap<const void*, std::uint32_t> m_ShaderIds;
+    Mist::FlatHashMap<const void*, std::uint32_t> m_MaterialIds;
+    Mist::FlatHashMap<const void*, std::uint32_t> m_MeshIds;
+
+    glm::vec3 m_Eye{0.0f};
+    glm::vec3 m_Forward{0.0f, 0.0f, -1.0f};
+    float m_Near = 0.1f;
+    float m_InvRange = 1.0f / 99.9f;
+};
+
+} // namespace Mist::Renderer
+
+#endif // MIST_RENDER_QUEUE_H
@@ -50,6 +50,7 @@ enum class BufferUsage : std::uint8_t {
     Index,
     Uniform,
     Storage,
+    Indirect, // draw commands for multi-draw indirect
 };
 
 struct BufferDesc {
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef MIST_STREAM_BUFFER_H
+#define MIST_STREAM_BUFFER_H
+
+#include "Renderer/RID.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Mist::Renderer {
+
+// GPU buffer rewritten from the CPU every frame or pass: per-instance
+// model matrices, per-draw data, indirect draw commands. Each Upload
+// orphans the previous storage (glNamedBufferData with null data) before
+// writing, so draws still in flight keep reading theirs and the CPU never
+// waits on them; the buffer name stays the same, so VAOs and bindings
+// that point at it stay valid. Grows geometrically, never shrinks.
+//
+// Created lazily on the first Upload, through the process-wide
+// RenderingDevice; needs the GL context like every other GPU resource.
+class StreamBuffer {
+public:
+    StreamBuffer() = default;
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    void Upload(const void* data, std::size_t bytes);
+
+    template<typename T>
+    void Upload(const std::vector<T>& elements) {
+        Upload(elements.data(), elements.size() * sizeof(T));
+    }
+
+    // Raw GL name for attribute setup and binding; 0 before the first
+    // Upload.
+    std::uint32_t GetGLHandle() const { return m_Handle; }
+    std::size_t Capacity() const { return m_Capacity; } // bytes
+
+private:
+    static constexpr std::size_t kMinCapacity = 64 * 1024;
+
+    RID m_Rid{};
+    std::uint32_t m_Handle = 0;
+    std::size_t m_Capacity = 0;
+};
+
+} // namespace Mist::Renderer
+
+#endif // MIST_STREAM_BUFFER_H
@@ -3,7 +3,9 @@
 #define MIST_RESOURCE_MANAGER_H
 
 #include "ResourceHandle.h"
+#include "Core/JobSystem.h"
 #include "Core/Logger.h"
+#include <algorithm>
 #include <atomic>
 #include <future>
 #include <functional>
@@ -20,8 +22,25 @@ public:
 
     ResourceManager() : m_NextId(1), m_CurrentGeneration(1) {}
 
+    // In-flight LoadAsync jobs capture `this`; let them land before the
+    // maps they write to go away.
+    ~ResourceManager() {
+        std::vector<Mist::JobHandle> inFlight;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            inFlight.swap(m_InFlight);
+        }
+        for (const auto& job : inFlight) {
+            if (!job.IsDone()) m_Jobs->Wait(job);
+        }
+    }
+
     void SetLoader(LoadFn loader) { m_Loader = std::move(loader); }
 
+    // Job system LoadAsync runs on. Defaults to Mist::JobSystem::Instance();
+    // must outlive this manager.
+    void SetJobSystem(Mist::JobSystem* jobs) { m_Jobs = jobs; }
+
     ResourceHandle<T> Load(const std::string& path) {
         // Fast path: cache hit. Lock briefly, check, return.
         {
@@ -103,10 +122,11 @@ public:
     // G14 — async loading.
     //
     // LoadAsync returns a future that resolves to the same handle Load
-    // would return. Under the hood we use std::async with deferred status
-    // tracked via a shared_ptr<atomic<LoadStatus>> keyed by path so
-    // multiple callers against the same in-flight load see consistent
-    // status. A proper thread pool lands with G6/G9.
+    // would return. The load itself runs as a job on the engine JobSystem,
+    // so a scene that fires hundreds of requests queues them on a bounded
+    // worker pool instead of spawning a thread apiece. Status is tracked
+    // per path so callers against the same in-flight load agree. A loader
+    // exception surfaces through the future, as it did with std::async.
     // ------------------------------------------------------------------
     enum class LoadStatus {
         NotLoaded,
@@ -116,6 +136,7 @@ public:
     };
 
     std::future<ResourceHandle<T>> LoadAsync(const std::string& path) {
+        Mist::JobSystem* jobs = nullptr;
         {
             std::lock_guard<std::mutex> lock(m_Mutex);
             auto cached = m_PathToHandle.find(path);
@@ -127,14 +148,36 @@ public:
                 return p.get_future();
             }
             m_Status[path] = LoadStatus::InProgress;
+            if (!m_Jobs) m_Jobs = &Mist::JobSystem::Instance();
+            jobs = m_Jobs;
         }
 
-        return std::async(std::launch::async, [this, path]() {
-            auto handle = Load(path); // Load is already thread-safe.
-            std::lock_guard<std::mutex> lock(m_Mutex);
-            m_Status[path] = handle.IsValid() ? LoadStatus::Ready : LoadStatus::Failed;
-            return handle;
+        auto promise = std::make_shared<std::promise<ResourceHandle<T>>>();
+        auto future = promise->get_future();
+
+        Mist::JobHandle job = jobs->Schedule([this, path, promise]() {
+            try {
+                auto handle = Load(path); // Load is already thread-safe.
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    m_Status[path] = handle.IsValid() ? LoadStatus::Ready : LoadStatus::Failed;
+                }
+                promise->set_value(handle);
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    m_Status[path] = LoadStatus::Failed;
+                }
+                promise->set_exception(std::current_exception());
+            }
         });
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_InFlight.erase(std::remove_if(m_InFlight.begin(), m_InFlight.end(),
+                                        [](const Mist::JobHandle& h) { return h.IsDone(); }),
+                         m_InFlight.end());
+        m_InFlight.push_back(std::move(job));
+        return future;
     }
 
     LoadStatus GetStatus(const std::string& path) const {
@@ -154,6 +197,9 @@ private:
     std::unordered_map<uint32_t,   std::string>        m_HandleToPath;
     std::unordered_map<std::string, ResourceHandle<T>> m_PathToHandle;
     std::unordered_map<std::string, LoadStatus>        m_Status;
+
+    Mist::JobSystem*             m_Jobs = nullptr;
+    std::vector<Mist::JobHandle> m_InFlight;
 };
 
 #endif // MIST_RESOURCE_MANAGER_H
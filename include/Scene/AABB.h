@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <algorithm>
 #include <array>
+#include <limits>
+#include <utility>
 
 struct Frustum;
 
@@ -46,6 +48,38 @@ struct AABB {
                (min.z <= other.max.z && max.z >= other.min.z);
     }
 
+    // True if `other` lies entirely inside this box (touching counts).
+    bool Contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    // Half the surface area; only ever compared, so the factor is dropped.
+    float HalfArea() const {
+        const glm::vec3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    // Where the segment origin + t * dir, 0 <= t <= maxT, enters the box
+    // (0 if it starts inside). False if it misses.
+    bool IntersectRay(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& entry) const {
+        float tNear = 0.0f, tFar = maxT;
+        for (int i = 0; i < 3; ++i) {
+            if (dir[i] == 0.0f) {
+                if (origin[i] < min[i] || origin[i] > max[i]) return false;
+                continue;
+            }
+            float t0 = (min[i] - origin[i]) / dir[i];
+            float t1 = (max[i] - origin[i]) / dir[i];
+            if (t0 > t1) std::swap(t0, t1);
+            tNear = std::max(tNear, t0);
+            tFar = std::min(tFar, t1);
+            if (tNear > tFar) return false;
+        }
+        entry = tNear;
+        return true;
+    }
+
     bool IsValid() const {
         return min.x <= max.x && min.y <= max.y && min.z <= max.z;
     }
@@ -0,0 +1,269 @@
+#pragma once
+#ifndef MIST_DYNAMIC_AABB_TREE_H
+#define MIST_DYNAMIC_AABB_TREE_H
+
+#include "Core/SmallVector.h"
+#include "ECS/Entity.h"
+#include "ECS/SparseEntityIndex.h"
+#include "Scene/AABB.h"
+#include "Scene/Frustum.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Incrementally maintained bounding-volume tree over entity bounds: the
+// ECS-side spatial index (SceneGraph culls its own nodes). Each leaf keeps
+// the entity's tight world box and a "fat" copy grown by kFatMargin and
+// stretched along the last move, and the tree is built over the fat
+// boxes. Move only restructures when the tight box escapes its fat one, so
+// an entity drifting or jittering in place costs a box compare. Inserts
+// pick a sibling by surface-area cost and rebalance the path back to the
+// root with AVL-style rotations, so the tree stays shallow however the
+// entities arrive.
+//
+// Queries descend through the fat boxes but test leaves against the tight
+// ones, so they report exactly what a scan over every box would. Writes
+// aren't thread-safe; concurrent const queries are.
+class DynamicAABBTree {
+public:
+    // World units added on every side of a leaf's fat box.
+    static constexpr float kFatMargin = 0.1f;
+    // The fat box leads a move by this many times its displacement.
+    static constexpr float kDisplacementMultiplier = 4.0f;
+
+    struct RayHit {
+        Entity entity = NULL_ENTITY;
+        float  distance = 0.0f; // along the ray, in units of its direction
+    };
+
+    bool Contains(Entity entity) const { return leafOf(entity) != kNull; }
+    std::size_t Size() const { return m_LeafCount; }
+    bool Empty() const { return m_LeafCount == 0; }
+
+    // Adds `entity` with world bounds `bounds`. An entity already in the
+    // tree (or a stale handle sharing its index) is replaced.
+    void Insert(Entity entity, const AABB& bounds);
+
+    // False if `entity` wasn't in the tree.
+    bool Remove(Entity entity);
+
+    // New bounds for `entity`; `displacement` is how far it moved since the
+    // last call and stretches the fat box ahead of it. Returns true if the
+    // leaf was reinserted, false if the fat box still covered the move.
+    bool Move(Entity entity, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f));
+
+    void Clear();
+
+    // Tight and fat bounds of a member.
+    const AABB& GetBounds(Entity entity) const { return m_Tight[leafOf(entity)]; }
+    const AABB& GetFatBounds(Entity entity) const { return m_Nodes[leafOf(entity)].box; }
+
+    // fn(Entity) for every member, in no particular order.
+    template<typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (const Node& node : m_Nodes) {
+            if (node.height == 0) fn(node.entity);
+        }
+    }
+
+    // fn(Entity) for every member whose bounds overlap `box`.
+    template<typename Fn>
+    void QueryAABB(const AABB& box, Fn&& fn) const {
+        if (m_Root == kNull) return;
+        Mist::SmallVector<std::int32_t, 64> stack{m_Root};
+        while (!stack.empty()) {
+            const std::int32_t index = stack.back();
+            const Node& node = m_Nodes[index];
+            stack.pop_back();
+            if (!node.box.Intersects(box)) continue;
+            if (node.IsLeaf()) {
+                if (m_Tight[index].Intersects(box)) fn(node.entity);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    // fn(Entity) for every member whose bounds pass Frustum::Intersects.
+    // Planes a subtree is fully inside aren't tested again below it, and a
+    // subtree inside all six is reported without touching its boxes.
+    template<typename Fn>
+    void QueryFrustum(const Frustum& frustum, Fn&& fn) const {
+        if (m_Root == kNull) return;
+        Mist::SmallVector<std::pair<std::int32_t, std::uint8_t>, 64> stack{{m_Root, kAllPlanes}};
+        while (!stack.empty()) {
+            const auto [index, planes] = stack.back();
+            stack.pop_back();
+            const Node& node = m_Nodes[index];
+            if (planes == 0) {
+                reportSubtree(index, fn);
+                continue;
+            }
+            std::uint8_t remaining = planes;
+            if (!classify(frustum, node.IsLeaf() ? m_Tight[index] : node.box, remaining)) continue;
+            if (node.IsLeaf()) {
+                fn(node.entity);
+            } else {
+                stack.push_back({node.left, remaining});
+                stack.push_back({node.right, remaining});
+            }
+        }
+    }
+
+    // fn(Entity, float distance) for every member whose bounds the segment
+    // origin + t * direction, 0 <= t <= maxDistance, touches. `distance` is
+    // where it enters (0 if the origin is inside), in units of `direction`,
+    // which need not be normalized. Unordered.
+    template<typename Fn>
+    void Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn&& fn) const {
+        if (m_Root == kNull) return;
+        const Ray ray(origin, direction);
+        Mist::SmallVector<std::int32_t, 64> stack{m_Root};
+        float t = 0.0f;
+        while (!stack.empty()) {
+            const std::int32_t index = stack.back();
+            const Node& node = m_Nodes[index];
+            stack.pop_back();
+            if (!ray.Hit(node.box, maxDistance, t)) continue;
+            if (node.IsLeaf()) {
+                if (ray.Hit(m_Tight[index], maxDistance, t)) fn(node.entity, t);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    // The member whose bounds the ray enters first within maxDistance
+    // (editor picking). False if it hits nothing.
+    bool RaycastClosest(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                        RayHit& hit) const;
+
+    // Up to `k` members nearest `point` by distance to their bounds (0 for
+    // a point inside), nearest first, as (entity, distance). Replaces the
+    // contents of `out`.
+    void QueryNearest(const glm::vec3& point, std::size_t k,
+                      std::vector<std::pair<Entity, float>>& out) const;
+
+    // Longest root-to-leaf path in edges; 0 for a single leaf or an empty tree.
+    int Height() const { return m_Root == kNull ? 0 : m_Nodes[m_Root].height; }
+
+    // Checks links, heights, the entity index and that every box is the
+    // union of its children. For tests; walks the whole tree.
+    bool Validate() const;
+
+private:
+    static constexpr std::int32_t kNull = -1;
+    static constexpr std::uint8_t kAllPlanes = 0x3F;
+
+    struct Node {
+        AABB box;                    // fat box for a leaf, union of children otherwise
+        std::int32_t parent = kNull; // next free node while on the free list
+        std::int32_t left = kNull;
+        std::int32_t right = kNull;
+        std::int32_t height = 0;     // leaf 0; -1 while free
+        Entity entity = NULL_ENTITY;
+
+        bool IsLeaf() const { return left == kNull; }
+    };
+
+    // Segment against box, slab method. Axes the direction doesn't move
+    // along are a containment check instead of a divide by zero.
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 invDir;
+        bool      still[3];
+
+        Ray(const glm::vec3& o, const glm::vec3& d) : origin(o) {
+            for (int i = 0; i < 3; ++i) {
+                still[i] = d[i] == 0.0f;
+                invDir[i] = still[i] ? 0.0f : 1.0f / d[i];
+            }
+        }
+
+        bool Hit(const AABB& box, float maxDistance, float& entry) const {
+            float tNear = 0.0f, tFar = maxDistance;
+            for (int i = 0; i < 3; ++i) {
+                if (still[i]) {
+                    if (origin[i] < box.min[i] || origin[i] > box.max[i]) return false;
+                    continue;
+                }
+                float t0 = (box.min[i] - origin[i]) * invDir[i];
+                float t1 = (box.max[i] - origin[i]) * invDir[i];
+                if (t0 > t1) std::swap(t0, t1);
+                tNear = std::max(tNear, t0);
+                tFar = std::min(tFar, t1);
+                if (tNear > tFar) return false;
+            }
+            entry = tNear;
+            return true;
+        }
+    };
+
+    // Drops from `planes` each plane `box` is fully inside; false if it's
+    // fully outside one. Same p-vertex test as Frustum::Intersects.
+    static bool classify(const Frustum& frustum, const AABB& box, std::uint8_t& planes) {
+        for (int i = 0; i < 6; ++i) {
+            if (!(planes & (1u << i))) continue;
+            const Plane& p = frustum.planes[i];
+            const glm::vec3 pos(p.normal.x >= 0 ? box.max.x : box.min.x,
+                                p.normal.y >= 0 ? box.max.y : box.min.y,
+                                p.normal.z >= 0 ? box.max.z : box.min.z);
+            if (p.DistanceToPoint(pos) < 0) return false;
+            const glm::vec3 neg(p.normal.x >= 0 ? box.min.x : box.max.x,
+                                p.normal.y >= 0 ? box.min.y : box.max.y,
+                                p.normal.z >= 0 ? box.min.z : box.max.z);
+            if (p.DistanceToPoint(neg) >= 0) planes &= std::uint8_t(~(1u << i));
+        }
+        return true;
+    }
+
+    template<typename Fn>
+    void reportSubtree(std::int32_t root, Fn& fn) const {
+        Mist::SmallVector<std::int32_t, 64> stack{root};
+        while (!stack.empty()) {
+            const Node& node = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (node.IsLeaf()) {
+                fn(node.entity);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    std::int32_t leafOf(Entity entity) const {
+        const std::uint32_t index = m_Index.Get(entity);
+        if (index == SparseEntityIndex::kInvalid || m_Nodes[index].entity != entity) return kNull;
+        return static_cast<std::int32_t>(index);
+    }
+
+    static AABB fatten(const AABB& bounds, const glm::vec3& displacement);
+
+    std::int32_t allocateNode();
+    void freeNode(std::int32_t index);
+    // Links `leaf` in below `start` (any node; normally the root) and
+    // refits up to the root.
+    void insertLeaf(std::int32_t leaf, std::int32_t start);
+    // Unlinks `leaf`, freeing its parent; returns the sibling that took the
+    // parent's place (kNull if `leaf` was the root).
+    std::int32_t removeLeaf(std::int32_t leaf);
+    std::int32_t balance(std::int32_t index);
+    void replaceChild(std::int32_t parent, std::int32_t from, std::int32_t to);
+
+    // Tight boxes live beside the nodes, indexed the same, so the descent
+    // in insertLeaf and the inner levels of a query don't pull them in.
+    std::vector<Node> m_Nodes;
+    std::vector<AABB> m_Tight; // leaves only
+    std::int32_t m_Root = kNull;
+    std::int32_t m_FreeList = kNull;
+    std::size_t m_LeafCount = 0;
+    SparseEntityIndex m_Index; // entity -> leaf node
+};
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef MIST_FRUSTUM_CULLER_H
+#define MIST_FRUSTUM_CULLER_H
+
+#include "Scene/AABB.h"
+#include "Scene/Frustum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// World-space boxes stored as six parallel float arrays, so a frustum test
+// loads 4 (SSE) or 8 (AVX) boxes' worth of each coordinate at once.
+struct BoundsSoA {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    std::size_t Size() const { return minX.size(); }
+    bool Empty() const { return minX.empty(); }
+
+    void Clear();
+    void Reserve(std::size_t count);
+    void Push(const AABB& box);
+    AABB Get(std::size_t i) const { return AABB{{minX[i], minY[i], minZ[i]}, {maxX[i], maxY[i], maxZ[i]}}; }
+};
+
+// One bit per box: set when it may be visible in the view it was culled
+// against.
+class VisibilityBitset {
+public:
+    // Sized for `count` bits, all clear.
+    void Reset(std::size_t count);
+
+    std::size_t Size() const { return m_Size; }
+    bool Test(std::size_t i) const { return (m_Words[i >> 6] >> (i & 63)) & 1u; }
+    void Set(std::size_t i) { m_Words[i >> 6] |= std::uint64_t(1) << (i & 63); }
+    std::size_t Count() const;
+
+    const std::vector<std::uint64_t>& Words() const { return m_Words; }
+    std::vector<std::uint64_t>& Words() { return m_Words; }
+
+    bool operator==(const VisibilityBitset& other) const {
+        return m_Size == other.m_Size && m_Words == other.m_Words;
+    }
+
+private:
+    std::vector<std::uint64_t> m_Words;
+    std::size_t m_Size = 0;
+};
+
+// Frustum culling of box batches. The answer is Frustum::Intersects's,
+// box by box: a box is dropped only when it lies wholly behind one plane,
+// so it is conservative near the corners, and a NaN box is kept.
+//
+// CullFrustums sweeps the boxes once for several views (the camera and
+// each shadow cascade) so every box is loaded once per frame, not once
+// per view. Uses AVX when the build targets it, else SSE on x86, else
+// CullFrustumsScalar.
+namespace FrustumCuller {
+
+// out[v] gets the visibility of every box in view frusta[v].
+void CullFrustums(const Frustum* frusta, std::size_t viewCount, const BoundsSoA& bounds, VisibilityBitset* out);
+
+inline void CullFrustum(const Frustum& frustum, const BoundsSoA& bounds, VisibilityBitset& out) {
+    CullFrustums(&frustum, 1, bounds, &out);
+}
+
+// Box at a time, through Frustum::Intersects; the reference for tests and
+// the path on targets without SIMD.
+void CullFrustumsScalar(const Frustum* frusta, std::size_t viewCount, const BoundsSoA& bounds, VisibilityBitset* out);
+
+// "AVX", "SSE" or "scalar": which path CullFrustums compiled to.
+const char* BackendName();
+
+} // namespace FrustumCuller
+
+#endif // MIST_FRUSTUM_CULLER_H
@@ -0,0 +1,221 @@
+#pragma once
+#ifndef MIST_SPATIAL_HASH_GRID_H
+#define MIST_SPATIAL_HASH_GRID_H
+
+#include "Core/FlatHashMap.h"
+#include "ECS/Entity.h"
+#include "ECS/SparseEntityIndex.h"
+#include "Scene/AABB.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Contiguous, read-only view of query results. Valid until the grid that
+// produced it is queried or written again.
+class EntitySpan {
+public:
+    EntitySpan() = default;
+    EntitySpan(const Entity* data, std::size_t size) : m_Data(data), m_Size(size) {}
+
+    const Entity* data() const { return m_Data; }
+    std::size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    Entity operator[](std::size_t i) const { return m_Data[i]; }
+    const Entity* begin() const { return m_Data; }
+    const Entity* end() const { return m_Data + m_Size; }
+
+private:
+    const Entity* m_Data = nullptr;
+    std::size_t m_Size = 0;
+};
+
+// Uniform grid over entity positions, hashed so only occupied cells cost
+// memory: the "who's near me" index for gameplay code and scripts. Where
+// DynamicAABBTree indexes render bounds for culling and picking, this
+// indexes points and answers radius and box queries by visiting the few
+// cells the query overlaps.
+//
+// Moving within a cell rewrites a position; crossing into another is a
+// swap-remove and an append. Cells that empty out are unhashed and their
+// storage recycled, so a crowd walking across the map doesn't leave a
+// trail of dead cells. Pick a cell size around the typical query radius:
+// much smaller and queries visit many cells, much larger and they test
+// many points that are out of range.
+//
+// Queries report exactly the members a scan would (boundary inclusive),
+// in no particular order. Writes and the span-returning queries aren't
+// thread-safe; concurrent ForEachIn* calls are.
+class SpatialHashGrid {
+public:
+    static constexpr float kDefaultCellSize = 4.0f;
+
+    explicit SpatialHashGrid(float cellSize = kDefaultCellSize);
+
+    float GetCellSize() const { return m_CellSize; }
+    // Re-buckets every member; `cellSize` must be positive.
+    void SetCellSize(float cellSize);
+
+    bool Contains(Entity entity) const { return locationOf(entity) != SparseEntityIndex::kInvalid; }
+    std::size_t Size() const { return m_Locations.size(); }
+    bool Empty() const { return m_Locations.empty(); }
+    // Occupied cells.
+    std::size_t CellCount() const { return m_CellLookup.size(); }
+
+    // Adds `entity` at `position`. An entity already in the grid (or a
+    // stale handle sharing its index) is replaced.
+    void Insert(Entity entity, const glm::vec3& position);
+
+    // False if `entity` wasn't in the grid.
+    bool Remove(Entity entity);
+
+    // New position for a member. Returns true if it changed cells.
+    bool Move(Entity entity, const glm::vec3& position);
+
+    void Clear();
+
+    const glm::vec3& GetPosition(Entity entity) const {
+        const Location& at = m_Locations[locationOf(entity)];
+        return m_Cells[at.cell].members[at.slot].position;
+    }
+
+    // fn(Entity) for every member, in no particular order.
+    template<typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (const Location& at : m_Locations) fn(at.entity);
+    }
+
+    // fn(Entity) for every member within `radius` of `center`.
+    template<typename Fn>
+    void ForEachInRadius(const glm::vec3& center, float radius, Fn&& fn) const {
+        if (!(radius >= 0.0f)) return;
+        const float radiusSq = radius * radius;
+        forEachCell(cellOf(center - glm::vec3(radius)), cellOf(center + glm::vec3(radius)), [&](const Cell& cell) {
+            for (const Member& member : cell.members) {
+                const glm::vec3 d = member.position - center;
+                if (glm::dot(d, d) <= radiusSq) fn(member.entity);
+            }
+        });
+    }
+
+    // fn(Entity) for every member inside `box`.
+    template<typename Fn>
+    void ForEachInBox(const AABB& box, Fn&& fn) const {
+        if (!box.IsValid()) return;
+        forEachCell(cellOf(box.min), cellOf(box.max), [&](const Cell& cell) {
+            for (const Member& member : cell.members) {
+                const glm::vec3& p = member.position;
+                if (p.x >= box.min.x && p.y >= box.min.y && p.z >= box.min.z &&
+                    p.x <= box.max.x && p.y <= box.max.y && p.z <= box.max.z) {
+                    fn(member.entity);
+                }
+            }
+        });
+    }
+
+    // The same queries collected into a buffer the grid reuses, so a
+    // per-frame caller allocates nothing once it has grown.
+    EntitySpan QueryRadius(const glm::vec3& center, float radius);
+    EntitySpan QueryBox(const AABB& box);
+
+private:
+    // Cell coordinates are clamped to 21 bits a side so they pack into one
+    // 64-bit key; points past +-2^20 cells share the border cells, which
+    // costs speed out there but not correctness.
+    static constexpr std::int32_t kCoordLimit = (1 << 20) - 1;
+
+    struct CellCoord {
+        std::int32_t x = 0, y = 0, z = 0;
+    };
+
+    struct Member {
+        Entity entity;
+        glm::vec3 position;
+    };
+
+    struct Cell {
+        CellCoord coord;
+        std::vector<Member> members; // empty: on the free list
+    };
+
+    // Where a member lives: m_Cells[cell].members[slot].
+    struct Location {
+        Entity entity;
+        std::uint32_t cell;
+        std::uint32_t slot;
+    };
+
+    static std::uint64_t keyOf(const CellCoord& c) {
+        constexpr std::uint64_t kMask = (std::uint64_t(1) << 21) - 1;
+        return (std::uint64_t(c.x + kCoordLimit + 1) & kMask) |
+               ((std::uint64_t(c.y + kCoordLimit + 1) & kMask) << 21) |
+               ((std::uint64_t(c.z + kCoordLimit + 1) & kMask) << 42);
+    }
+
+    CellCoord cellOf(const glm::vec3& p) const {
+        CellCoord c;
+        std::int32_t* out[3] = {&c.x, &c.y, &c.z};
+        for (int axis = 0; axis < 3; ++axis) {
+            float f = std::floor(p[axis] * m_InvCellSize);
+            // Written as !(f >= lo) so NaN lands on the low border rather
+            // than in an undefined cast.
+            if (!(f >= -float(kCoordLimit))) f = -float(kCoordLimit);
+            if (f > float(kCoordLimit)) f = float(kCoordLimit);
+            *out[axis] = static_cast<std::int32_t>(f);
+        }
+        return c;
+    }
+
+    // fn(const Cell&) for every occupied cell in [lo, hi]. A range with
+    // more cells than are occupied is answered by walking the occupied
+    // ones instead, so a huge query costs O(cells in use), not O(volume).
+    template<typename Fn>
+    void forEachCell(const CellCoord& lo, const CellCoord& hi, Fn&& fn) const {
+        const std::uint64_t volume = std::uint64_t(hi.x - lo.x + 1) * std::uint64_t(hi.y - lo.y + 1) *
+                                     std::uint64_t(hi.z - lo.z + 1);
+        if (volume > m_CellLookup.size()) {
+            for (const Cell& cell : m_Cells) {
+                const CellCoord& c = cell.coord;
+                if (!cell.members.empty() && c.x >= lo.x && c.y >= lo.y && c.z >= lo.z && c.x <= hi.x &&
+                    c.y <= hi.y && c.z <= hi.z) {
+                    fn(cell);
+                }
+            }
+            return;
+        }
+        for (std::int32_t z = lo.z; z <= hi.z; ++z) {
+            for (std::int32_t y = lo.y; y <= hi.y; ++y) {
+                for (std::int32_t x = lo.x; x <= hi.x; ++x) {
+                    const auto it = m_CellLookup.find(keyOf({x, y, z}));
+                    if (it != m_CellLookup.end()) fn(m_Cells[it->second]);
+                }
+            }
+        }
+    }
+
+    std::uint32_t locationOf(Entity entity) const {
+        const std::uint32_t index = m_Index.Get(entity);
+        return index != SparseEntityIndex::kInvalid && m_Locations[index].entity == entity
+                   ? index
+                   : SparseEntityIndex::kInvalid;
+    }
+
+    std::uint32_t acquireCell(const CellCoord& coord);
+    void addToCell(std::uint32_t location, std::uint32_t cell, const glm::vec3& position);
+    void removeFromCell(std::uint32_t location);
+
+    float m_CellSize = kDefaultCellSize;
+    float m_InvCellSize = 1.0f / kDefaultCellSize;
+
+    std::vector<Cell> m_Cells;
+    std::vector<std::uint32_t> m_FreeCells;
+    Mist::FlatHashMap<std::uint64_t, std::uint32_t> m_CellLookup;
+
+    std::vector<Location> m_Locations; // dense, one per member
+    SparseEntityIndex m_Index;         // entity -> m_Locations
+
+    std::vector<Entity> m_Results;
+};
+
+#endif // MIST_SPATIAL_HASH_GRID_H
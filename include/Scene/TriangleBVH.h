@@ -0,0 +1,104 @@
+#pragma once
+#ifndef MIST_TRIANGLE_BVH_H
+#define MIST_TRIANGLE_BVH_H
+
+#include "Scene/AABB.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Static bounding-volume hierarchy over one mesh's triangles, for exact
+// ray queries (picking, script raycasts) in the mesh's object space.
+// Built once with binned surface-area splits; the geometry is copied in,
+// so the BVH doesn't care where the vertices came from or whether they
+// still exist. DynamicAABBTree answers "which entities' boxes", this
+// answers "which triangle, where".
+//
+// Nodes are 32 bytes, children adjacent, and leaves hold up to
+// kMaxLeafTriangles triangles stored contiguously in traversal order with
+// their edges precomputed. Traversal visits the nearer child first and
+// skips anything entered past the best hit so far. Box tests use SSE on
+// x86 and a scalar slab test elsewhere.
+//
+// Build isn't thread-safe; concurrent queries on a built BVH are.
+class TriangleBVH {
+public:
+    static constexpr std::uint32_t kNoTriangle = ~std::uint32_t(0);
+    static constexpr std::uint32_t kMaxLeafTriangles = 4;
+    static constexpr int kBins = 12;
+
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        float maxDistance = std::numeric_limits<float>::max();
+    };
+
+    struct Hit {
+        // Along the ray, in units of its direction.
+        float distance = std::numeric_limits<float>::max();
+        // Index of the triangle in the input (its indices start at
+        // 3 * triangle); kNoTriangle for a miss.
+        std::uint32_t triangle = kNoTriangle;
+        // Barycentrics of the hit point: v0 + u * (v1 - v0) + v * (v2 - v0).
+        float u = 0.0f, v = 0.0f;
+    };
+
+    // Triangles from `indexCount / 3` index triples into `positions`,
+    // which are `strideBytes` apart (so an interleaved vertex array can be
+    // passed as &vertices[0].Position, sizeof(Vertex)). Null `indices`
+    // means consecutive vertex triples. Replaces any previous contents.
+    void Build(const glm::vec3* positions, std::size_t strideBytes, std::size_t vertexCount,
+               const std::uint32_t* indices, std::size_t indexCount);
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<std::uint32_t>& indices) {
+        Build(positions.data(), sizeof(glm::vec3), positions.size(), indices.data(), indices.size());
+    }
+
+    void Clear();
+
+    bool Empty() const { return m_Triangles.empty(); }
+    std::size_t TriangleCount() const { return m_Triangles.size(); }
+    std::size_t NodeCount() const { return m_Nodes.size(); }
+    // Bounds of every triangle; invalid when empty.
+    AABB Bounds() const;
+
+    // Nearest triangle (two-sided) the segment origin + t * direction,
+    // 0 <= t <= maxDistance, touches. `direction` need not be normalized.
+    bool Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const;
+
+    // Intersect for each of `count` rays into hits[i] (triangle ==
+    // kNoTriangle on a miss). Returns how many hit.
+    std::size_t IntersectBatch(const Ray* rays, std::size_t count, Hit* hits) const;
+
+    // Checks that every node box holds its children or triangles and that
+    // each input triangle sits in exactly one leaf. For tests.
+    bool Validate() const;
+
+private:
+    // Interior: `first` is the left child, the right is first + 1 and
+    // count is 0. Leaf: triangles [first, first + count).
+    struct Node {
+        glm::vec3 min;
+        std::uint32_t first;
+        glm::vec3 max;
+        std::uint32_t count;
+
+        bool IsLeaf() const { return count != 0; }
+    };
+    static_assert(sizeof(Node) == 32, "two nodes per cache line");
+
+    // Möller–Trumbore form: a vertex and the two edges leaving it.
+    struct Triangle {
+        glm::vec3 v0, e1, e2;
+    };
+
+    struct BuildState;
+    void subdivide(BuildState& state, std::uint32_t nodeIndex);
+
+    std::vector<Node> m_Nodes;
+    std::vector<Triangle> m_Triangles;       // leaf order
+    std::vector<std::uint32_t> m_TriangleIds; // leaf order -> input triangle
+};
+
+#endif // MIST_TRIANGLE_BVH_H
@@ -4,7 +4,8 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
-#include <unordered_map>
+
+#include "Core/FlatHashMap.h"
 
 #include "Renderer/RID.h"
 
@@ -54,7 +55,8 @@ private:
    // Owns the program lifetime via the process-wide RenderingDevice.
    RID m_ProgramRID{};
 
-   mutable std::unordered_map<std::string, GLint> m_UniformLocationCache;
+   // Looked up on every uniform set; flat so a hit is one probe.
+   mutable Mist::FlatHashMap<std::string, GLint> m_UniformLocationCache;
 
    GLint getUniformLocation(const std::string& name) const;
    bool checkCompileErrors(unsigned int shader, const std::string& type);
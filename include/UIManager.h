@@ -12,6 +12,7 @@
 #include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <memory>
 #include <vector>
 #include <string>
@@ -31,6 +32,7 @@ class Renderer;
 class AssetBrowser;
 class GizmoSystem;
 class EditorState;
+class WorldSnapshot;
 class ConsoleSystem;
 class Profiler;
 
@@ -65,10 +67,13 @@ public:
     // re-adds the component if they want it back.
     struct EntitySnapshot {
         bool        hasTransform = false;
-        glm::vec3   position{0}, rotation{0}, scale{1};
+        glm::vec3   position{0};
+        glm::quat   rotation{1, 0, 0, 0};
+        glm::vec3   scale{1};
         bool        hasRender    = false;
         void*       renderable   = nullptr;   // Renderable*; opaque here
         bool        visible      = true;
+        bool        castShadows  = true;
         bool        hasHierarchy = false;
         Entity      parent       = static_cast<Entity>(-1);
         std::string name;
@@ -76,6 +81,18 @@ public:
     EntitySnapshot SnapshotEntity(Entity e) const;
     Entity         RespawnFromSnapshot(const EntitySnapshot& snap);
 
+    // Deletes recorded into gEntityCommands that haven't played back yet.
+    // The name and the undo entry wait until the destroy has landed, so an
+    // undo never respawns next to the still-live original.
+    struct PendingDelete {
+        Entity         entity;
+        EntitySnapshot snapshot;
+    };
+    std::vector<PendingDelete> m_PendingDeletes;
+    // Finishes every pending delete whose entity is gone. Called at the
+    // top of NewFrame, after the frame's playbacks.
+    void FlushPendingDeletes();
+
     // Called when an ASSET_PATH payload is dropped onto the viewport.
     // Routes by file extension: mesh-ish → spawn entity, scene-ish →
     // load scene, anything else → toast a warning.
@@ -158,6 +175,15 @@ private:
 
     // Inspector helpers
     void DrawTransformComponent(TransformComponent& transform);
+    // Angles last shown in the Rotation field, kept while the entity's
+    // quaternion is the one they produced so typed values (say 190°) don't
+    // snap to the canonical decomposition on the next frame.
+    struct EulerView {
+        Entity    entity = static_cast<Entity>(-1);
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 degrees{0.0f};
+    };
+    EulerView m_EulerView;
     void DrawRenderComponent(RenderComponent& render);
     void DrawPhysicsComponent(PhysicsComponent& physics);
 
@@ -184,6 +210,9 @@ private:
     void DrawLightEditor();
     void DrawSkyboxControls();
 
+    // Wires EditorState's Play/Stop to m_PlaySnapshot.
+    void InstallPlaySnapshot();
+
     // Utility
     void DrawVec3Control(const std::string& label, glm::vec3& values, float resetValue = 0.0f, float columnWidth = 100.0f);
 
@@ -198,6 +227,8 @@ private:
     std::unique_ptr<AssetBrowser> m_AssetBrowser;
     std::unique_ptr<GizmoSystem> m_GizmoSystem;
     std::unique_ptr<EditorState> m_EditorState;
+    // World captured on Play, restored on Stop.
+    std::unique_ptr<WorldSnapshot> m_PlaySnapshot;
     std::unique_ptr<ConsoleSystem> m_ConsoleSystem;
 
     // Game export components
@@ -244,7 +275,7 @@ private:
         bool      active = false;
         Entity    entity = 0;
         glm::vec3 position{};
-        glm::vec3 rotation{};
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
         glm::vec3 scale{1.0f};
     };
     GizmoCapture m_GizmoCapture;
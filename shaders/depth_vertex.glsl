@@ -1,9 +1,20 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
+// Per-instance model matrix (locations 8-11), read when useInstancing is set.
+layout (location = 8) in mat4 aInstanceModel;
+// Per-draw world matrices for multi-draw indirect, read when useDrawData
+// is set; a command's instances start at its baseInstance.
+layout (std430, binding = 7) readonly buffer DrawData {
+    mat4 drawModels[];
+};
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+uniform bool useInstancing;
+uniform bool useDrawData;
 
 void main() {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    mat4 world = useDrawData ? drawModels[gl_BaseInstance + gl_InstanceID]
+               : useInstancing ? aInstanceModel : model;
+    gl_Position = lightSpaceMatrix * world * vec4(aPos, 1.0);
 }
\ No newline at end of file
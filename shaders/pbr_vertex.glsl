@@ -4,8 +4,17 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in vec3 aTangent;
 layout (location = 4) in vec3 aBitangent;
+// Per-instance model matrix (locations 8-11), read when useInstancing is set.
+layout (location = 8) in mat4 aInstanceModel;
+// Per-draw world matrices for multi-draw indirect, read when useDrawData
+// is set; a command's instances start at its baseInstance.
+layout (std430, binding = 7) readonly buffer DrawData {
+    mat4 drawModels[];
+};
 
 uniform mat4 model;
+uniform bool useInstancing;
+uniform bool useDrawData;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;
@@ -19,11 +28,13 @@ out VS_OUT {
 } vs_out;
 
 void main() {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    mat4 world = useDrawData ? drawModels[gl_BaseInstance + gl_InstanceID]
+               : useInstancing ? aInstanceModel : model;
+    vec4 worldPos = world * vec4(aPos, 1.0);
     vs_out.FragPos = worldPos.xyz;
     vs_out.TexCoords = aTexCoords;
 
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
+    mat3 normalMatrix = transpose(inverse(mat3(world)));
     vs_out.Normal = normalize(normalMatrix * aNormal);
 
     // Gram-Schmidt re-orthogonalization of TBN
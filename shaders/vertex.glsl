@@ -2,8 +2,17 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// Per-instance model matrix (locations 8-11), read when useInstancing is set.
+layout (location = 8) in mat4 aInstanceModel;
+// Per-draw world matrices for multi-draw indirect, read when useDrawData
+// is set; a command's instances start at its baseInstance.
+layout (std430, binding = 7) readonly buffer DrawData {
+    mat4 drawModels[];
+};
 
 uniform mat4 model;
+uniform bool useInstancing;
+uniform bool useDrawData;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;
@@ -14,8 +23,10 @@ out vec2 TexCoords;
 out vec4 FragPosLightSpace;
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    mat4 world = useDrawData ? drawModels[gl_BaseInstance + gl_InstanceID]
+               : useInstancing ? aInstanceModel : model;
+    FragPos = vec3(world * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(world))) * aNormal;
     TexCoords = aTexCoords;
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
     gl_Position = projection * view * vec4(FragPos, 1.0);
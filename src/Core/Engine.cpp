@@ -14,18 +14,23 @@
 #include "UIManager.h"
 #include "Version.h"
 
+#include "ECS/Components/HierarchyComponent.h"
 #include "ECS/Components/PhysicsComponent.h"
 #include "ECS/Components/RenderComponent.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
 #include "ECS/Systems/ECSPhysicsSystem.h"
 #include "ECS/Systems/RenderSystem.h"
+#include "ECS/Systems/SpatialHashSystem.h"
+#include "ECS/Systems/SpatialIndexSystem.h"
 
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <sys/stat.h>
 
 extern Coordinator gCoordinator;
+extern EntityCommandBuffer gEntityCommands;
 
 static bool DirectoryExists(const std::string& path) {
     struct stat statbuf;
@@ -44,14 +49,23 @@ bool Engine::Initialize(unsigned int width, unsigned int height) {
     gCoordinator.RegisterComponent<TransformComponent>();
     gCoordinator.RegisterComponent<RenderComponent>();
     gCoordinator.RegisterComponent<PhysicsComponent>();
+    // Not used by this loop's systems, but the spatial ones look it up.
+    gCoordinator.RegisterComponent<HierarchyComponent>();
 
     m_RenderSystem = gCoordinator.RegisterSystem<RenderSystem>();
     m_ECSPhysicsSystem = gCoordinator.RegisterSystem<ECSPhysicsSystem>();
+    m_SpatialIndex = gCoordinator.RegisterSystem<SpatialIndexSystem>();
+    m_SpatialHash = gCoordinator.RegisterSystem<SpatialHashSystem>();
 
     Signature renderSig;
     renderSig.set(gCoordinator.GetComponentType<TransformComponent>());
     renderSig.set(gCoordinator.GetComponentType<RenderComponent>());
     gCoordinator.SetSystemSignature<RenderSystem>(renderSig);
+    gCoordinator.SetSystemSignature<SpatialIndexSystem>(renderSig);
+
+    Signature transformSig;
+    transformSig.set(gCoordinator.GetComponentType<TransformComponent>());
+    gCoordinator.SetSystemSignature<SpatialHashSystem>(transformSig);
 
     Signature physicsSig;
     physicsSig.set(gCoordinator.GetComponentType<TransformComponent>());
@@ -101,6 +115,8 @@ bool Engine::Initialize(unsigned int width, unsigned int height) {
     sl.SetPhysicsSystem(m_PhysicsSystem.get());
     sl.SetRenderer(m_Renderer.get());
     sl.SetScene(m_Scene.get());
+    sl.SetSpatialIndex(m_SpatialIndex.get());
+    sl.SetSpatialHash(m_SpatialHash.get());
 
     m_Running = true;
     LOG_INFO("=== Engine Initialization Complete ===");
@@ -148,7 +164,13 @@ void Engine::ProcessGlobalInput() {
 
 void Engine::UpdateSystems(float deltaTime) {
     m_InputManager->Update(deltaTime);
+    // Sync points for deferred structural changes (see EntityCommandBuffer.h):
+    // last frame's UI edits before the systems run, theirs before rendering.
+    gEntityCommands.Playback(gCoordinator);
     m_ModuleManager->UpdateModules(deltaTime);
     m_PhysicsSystem->Update(deltaTime);
     m_ECSPhysicsSystem->Update(deltaTime);
+    gEntityCommands.Playback(gCoordinator);
+    m_SpatialIndex->Update(gCoordinator);
+    m_SpatialHash->Update(gCoordinator);
 }
@@ -0,0 +1,241 @@
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+
+#include <chrono>
+
+namespace Mist {
+
+namespace {
+
+// Which JobSystem (if any) owns the current thread, and its worker index.
+// Non-worker threads submit to the injection queue.
+thread_local JobSystem* tls_Owner = nullptr;
+thread_local int tls_Worker = -1;
+
+} // namespace
+
+JobSystem& JobSystem::Instance() {
+    static JobSystem instance;
+    return instance;
+}
+
+unsigned JobSystem::DefaultWorkerCount() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 1;
+}
+
+JobSystem::JobSystem(unsigned workerCount) {
+    // Queues are built before any worker starts so findWork never sees a
+    // partially-populated m_Queues.
+    m_Queues.reserve(workerCount + 1);
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+    m_Workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back([this, i] { workerLoop(static_cast<int>(i)); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Stop = true;
+    }
+    m_WakeCv.notify_all();
+    for (auto& t : m_Workers) t.join();
+}
+
+void JobSystem::BindMainThread() {
+    m_MainThread.store(std::this_thread::get_id());
+}
+
+bool JobSystem::IsMainThread() const {
+    return m_MainThread.load() == std::this_thread::get_id();
+}
+
+void JobSystem::PumpMainThread() {
+    if (!IsMainThread()) {
+        LOG_ERROR("JobSystem: PumpMainThread called off the main thread");
+        return;
+    }
+    while (auto job = popMainThread()) {
+        execute(job);
+    }
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> fn, JobAffinity affinity) {
+    return Schedule(std::move(fn), {}, affinity);
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> fn, const std::vector<JobHandle>& dependsOn,
+                              JobAffinity affinity) {
+    auto counter = std::make_shared<detail::JobCounter>();
+    counter->remaining.store(1, std::memory_order_relaxed);
+    submit(std::move(fn), counter, dependsOn, affinity);
+    return JobHandle(counter);
+}
+
+void JobSystem::submit(std::function<void()> fn, const std::shared_ptr<detail::JobCounter>& counter,
+                       const std::vector<JobHandle>& dependsOn, JobAffinity affinity) {
+    auto job = std::make_shared<Job>();
+    job->fn = std::move(fn);
+    job->counter = counter;
+    job->affinity = affinity;
+    // The extra 1 stops a dependency that finishes mid-loop from enqueuing
+    // the job before every dependency has been looked at.
+    job->unmet.store(static_cast<int>(dependsOn.size()) + 1, std::memory_order_relaxed);
+
+    for (const JobHandle& dep : dependsOn) {
+        if (!dep.m_Counter) {
+            job->unmet.fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(dep.m_Counter->mutex);
+        if (dep.m_Counter->remaining.load(std::memory_order_acquire) == 0) {
+            job->unmet.fetch_sub(1, std::memory_order_acq_rel);
+        } else {
+            dep.m_Counter->continuations.push_back(job);
+        }
+    }
+
+    if (job->unmet.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        enqueue(std::move(job));
+    }
+}
+
+void JobSystem::enqueue(std::shared_ptr<Job> job) {
+    if (job->affinity == JobAffinity::MainThread) {
+        std::lock_guard<std::mutex> lock(m_MainMutex);
+        m_MainQueue.push_back(std::move(job));
+        return;
+    }
+
+    const bool ownWorker = tls_Owner == this && tls_Worker >= 0;
+    WorkQueue& queue = *m_Queues[ownWorker ? tls_Worker : m_Workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_Queued.fetch_add(1, std::memory_order_release);
+    // Taking m_WakeMutex orders this against a worker that has just seen
+    // m_Queued == 0 and is about to sleep.
+    { std::lock_guard<std::mutex> lock(m_WakeMutex); }
+    m_WakeCv.notify_one();
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::findWork(int worker) {
+    const std::size_t queueCount = m_Queues.size();
+    const std::size_t injection = queueCount - 1;
+
+    auto take = [this](WorkQueue& queue, bool back) -> std::shared_ptr<Job> {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) return nullptr;
+        std::shared_ptr<Job> job;
+        if (back) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        m_Queued.fetch_sub(1, std::memory_order_acq_rel);
+        return job;
+    };
+
+    if (worker >= 0) {
+        if (auto job = take(*m_Queues[worker], true)) return job;
+    }
+    if (auto job = take(*m_Queues[injection], false)) return job;
+
+    // Steal oldest-first, starting after our own queue so thieves spread
+    // across victims instead of all hammering worker 0.
+    const std::size_t start = worker >= 0 ? std::size_t(worker) + 1 : 0;
+    for (std::size_t i = 0; i < injection; ++i) {
+        const std::size_t victim = (start + i) % injection;
+        if (static_cast<int>(victim) == worker) continue;
+        if (auto job = take(*m_Queues[victim], false)) return job;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::popMainThread() {
+    std::lock_guard<std::mutex> lock(m_MainMutex);
+    if (m_MainQueue.empty()) return nullptr;
+    // FIFO so uploads land in submission order.
+    auto job = std::move(m_MainQueue.front());
+    m_MainQueue.erase(m_MainQueue.begin());
+    return job;
+}
+
+void JobSystem::execute(const std::shared_ptr<Job>& job) {
+    std::exception_ptr error;
+    try {
+        job->fn();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    job->fn = nullptr; // release captures before waiters wake
+
+    detail::JobCounter& counter = *job->counter;
+    std::vector<std::shared_ptr<Job>> released;
+    bool finished = false;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        if (error && !counter.error) counter.error = error;
+        finished = counter.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        if (finished) released.swap(counter.continuations);
+    }
+    if (!finished) return;
+
+    counter.cv.notify_all();
+    for (auto& next : released) {
+        if (next->unmet.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            enqueue(std::move(next));
+        }
+    }
+}
+
+void JobSystem::Wait(const JobHandle& handle) {
+    if (!handle.m_Counter) return;
+    detail::JobCounter& counter = *handle.m_Counter;
+    const bool onMain = IsMainThread();
+    const int worker = tls_Owner == this ? tls_Worker : -1;
+
+    while (counter.remaining.load(std::memory_order_acquire) != 0) {
+        std::shared_ptr<Job> job = onMain ? popMainThread() : nullptr;
+        if (!job) job = findWork(worker);
+        if (job) {
+            execute(job);
+            continue;
+        }
+        // Nothing to help with: sleep until the counter finishes, waking
+        // periodically in case new work became stealable meanwhile.
+        std::unique_lock<std::mutex> lock(counter.mutex);
+        counter.cv.wait_for(lock, std::chrono::milliseconds(1),
+                            [&] { return counter.remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        error = counter.error;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void JobSystem::workerLoop(int worker) {
+    tls_Owner = this;
+    tls_Worker = worker;
+    for (;;) {
+        if (auto job = findWork(worker)) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCv.wait(lock, [this] { return m_Stop || m_Queued.load(std::memory_order_acquire) > 0; });
+        if (m_Stop && m_Queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+} // namespace Mist
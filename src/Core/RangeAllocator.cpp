@@ -0,0 +1,81 @@
+#include "Core/RangeAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace Mist {
+
+RangeAllocator::RangeAllocator(std::uint32_t capacity) {
+    Grow(capacity);
+}
+
+std::uint32_t RangeAllocator::Allocate(std::uint32_t count) {
+    if (count == 0) return kInvalid;
+
+    // Best fit keeps large blocks whole for large meshes; the free list is
+    // short next to the number of draws, so a linear scan is fine.
+    auto best = m_Free.end();
+    for (auto it = m_Free.begin(); it != m_Free.end(); ++it) {
+        if (it->second < count) continue;
+        if (best == m_Free.end() || it->second < best->second) best = it;
+        if (best->second == count) break;
+    }
+    if (best == m_Free.end()) return kInvalid;
+
+    const std::uint32_t offset = best->first;
+    const std::uint32_t remaining = best->second - count;
+    m_Free.erase(best);
+    if (remaining > 0) m_Free.emplace(offset + count, remaining);
+    m_Used += count;
+    return offset;
+}
+
+void RangeAllocator::Free(std::uint32_t offset, std::uint32_t count) {
+    if (count == 0 || offset == kInvalid) return;
+    assert(offset + count <= m_Capacity && count <= m_Used);
+
+    auto next = m_Free.lower_bound(offset);
+    assert(next == m_Free.end() || next->first >= offset + count); // no double free
+
+    std::uint32_t start = offset;
+    std::uint32_t size = count;
+    if (next != m_Free.begin()) {
+        auto prev = std::prev(next);
+        assert(prev->first + prev->second <= offset);
+        if (prev->first + prev->second == offset) {
+            start = prev->first;
+            size += prev->second;
+            m_Free.erase(prev);
+        }
+    }
+    if (next != m_Free.end() && next->first == offset + count) {
+        size += next->second;
+        m_Free.erase(next);
+    }
+    m_Free.emplace(start, size);
+    m_Used -= count;
+}
+
+void RangeAllocator::Grow(std::uint32_t capacity) {
+    if (capacity <= m_Capacity) return;
+    const std::uint32_t oldCapacity = m_Capacity;
+    m_Capacity = capacity;
+    // A free tail absorbs the new space instead of leaving a seam.
+    if (!m_Free.empty()) {
+        auto last = std::prev(m_Free.end());
+        if (last->first + last->second == oldCapacity) {
+            last->second += capacity - oldCapacity;
+            return;
+        }
+    }
+    m_Free.emplace(oldCapacity, capacity - oldCapacity);
+}
+
+std::uint32_t RangeAllocator::LargestFree() const {
+    std::uint32_t largest = 0;
+    for (const auto& block : m_Free) largest = std::max(largest, block.second);
+    return largest;
+}
+
+} // namespace Mist
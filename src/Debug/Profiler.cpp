@@ -33,6 +33,11 @@ void Profiler::EndCPUSection(const std::string& name) {
     section.cpuTimeMs = ms;
 }
 
+void Profiler::RecordCPUSection(const std::string& name, float ms) {
+    if (!m_Enabled) return;
+    getOrCreateSection(name).cpuTimeMs = ms;
+}
+
 void Profiler::BeginGPUSection(const std::string& name) {
     if (!m_Enabled) return;
     if (m_NextQueryIndex >= MAX_GPU_QUERIES) return;
@@ -85,6 +90,7 @@ void Profiler::BeginFrame() {
     m_NextQueryIndex = 0;
     ResetDrawCalls();
     ResetTriangles();
+    ResetInstanceStats();
 }
 
 void Profiler::EndFrame() {
@@ -0,0 +1,147 @@
+#include "ECS/ArchetypeStorage.h"
+
+#include <algorithm>
+
+namespace {
+
+std::size_t AlignUp(std::size_t value, std::size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+} // namespace
+
+ArchetypeStorage::~ArchetypeStorage() {
+    // Chunks are raw bytes; run component destructors before they go.
+    for (auto& archetype : m_Archetypes) {
+        Archetype& a = *archetype;
+        for (std::uint32_t row = 0; row < a.size; ++row) {
+            for (std::size_t c = 0; c < a.types.size(); ++c) {
+                m_Columns[a.types[c]].destroy(columnPtr(a, row, c));
+            }
+        }
+    }
+}
+
+void ArchetypeStorage::Remove(Entity entity, ComponentType type) {
+    Signature signature = SignatureOf(entity);
+    if (!signature.test(type)) return;
+    signature.reset(type);
+    changeArchetype(entity, signature);
+}
+
+void ArchetypeStorage::EntityDestroyed(Entity entity) {
+    if (SignatureOf(entity).none()) return;
+    changeArchetype(entity, Signature{});
+}
+
+std::uint32_t ArchetypeStorage::findOrCreateArchetype(const Signature& signature) {
+    auto it = m_ArchetypeIndex.find(signature);
+    if (it != m_ArchetypeIndex.end()) return it->second;
+
+    auto a = std::make_unique<Archetype>();
+    a->signature = signature;
+    a->column.fill(-1);
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!signature.test(t)) continue;
+        assert(m_Columns[t].relocate && "component type was not registered for archetype storage");
+        a->column[t] = static_cast<std::int16_t>(a->types.size());
+        a->types.push_back(static_cast<ComponentType>(t));
+        a->sizes.push_back(m_Columns[t].size);
+    }
+
+    // Size the chunk for as many rows as fit in kChunkBytes after per-column
+    // alignment padding. A row too big for one chunk still gets a single-row
+    // chunk, just a larger one.
+    std::size_t rowBytes = sizeof(Entity);
+    for (std::size_t size : a->sizes) rowBytes += size;
+    std::uint32_t capacity =
+        static_cast<std::uint32_t>(std::max<std::size_t>(1, kChunkBytes / rowBytes));
+    for (;;) {
+        std::size_t offset = sizeof(Entity) * capacity;
+        a->offsets.clear();
+        for (ComponentType t : a->types) {
+            offset = AlignUp(offset, m_Columns[t].align);
+            a->offsets.push_back(offset);
+            offset += m_Columns[t].size * capacity;
+        }
+        if (offset <= kChunkBytes || capacity == 1) {
+            a->capacity = capacity;
+            a->chunkBytes = offset;
+            break;
+        }
+        --capacity;
+    }
+
+    const auto index = static_cast<std::uint32_t>(m_Archetypes.size());
+    m_Archetypes.push_back(std::move(a));
+    m_ArchetypeIndex.emplace(signature, index);
+    return index;
+}
+
+std::uint32_t ArchetypeStorage::allocateRow(Archetype& a, Entity entity) {
+    if (a.chunks.empty() || a.chunks.back().count == a.capacity) {
+        Chunk chunk;
+        chunk.memory.reset(new std::byte[a.chunkBytes]);
+        a.chunks.push_back(std::move(chunk));
+    }
+    Chunk& chunk = a.chunks.back();
+    reinterpret_cast<Entity*>(chunk.memory.get())[chunk.count] = entity;
+    ++chunk.count;
+    return a.size++;
+}
+
+void ArchetypeStorage::freeRow(Archetype& a, std::uint32_t row) {
+    // Precondition: every column at `row` has already been relocated out or
+    // destroyed. Fill the hole with the archetype's last row.
+    const std::uint32_t last = a.size - 1;
+    if (row != last) {
+        for (std::size_t c = 0; c < a.types.size(); ++c) {
+            m_Columns[a.types[c]].relocate(columnPtr(a, row, c), columnPtr(a, last, c));
+        }
+        Entity* rowEntities = reinterpret_cast<Entity*>(a.chunks[row / a.capacity].memory.get());
+        Entity* lastEntities = reinterpret_cast<Entity*>(a.chunks[last / a.capacity].memory.get());
+        const Entity moved = lastEntities[last % a.capacity];
+        rowEntities[row % a.capacity] = moved;
+        m_Locations[EntityIndex(moved)].row = row;
+    }
+
+    --a.size;
+    if (--a.chunks.back().count == 0) {
+        a.chunks.pop_back();
+    }
+}
+
+void ArchetypeStorage::changeArchetype(Entity entity, const Signature& signature) {
+    assert(m_ParallelPasses.load(std::memory_order_relaxed) == 0 &&
+           "structural change during ParallelForEach");
+    const Entity index = EntityIndex(entity);
+    if (index >= m_Locations.size()) {
+        m_Locations.resize(static_cast<std::size_t>(index) + 1);
+    }
+
+    const std::uint32_t target = signature.none() ? kNoArchetype : findOrCreateArchetype(signature);
+    std::uint32_t targetRow = 0;
+    if (target != kNoArchetype) {
+        targetRow = allocateRow(*m_Archetypes[target], entity);
+    }
+
+    // Callers only move live entities, and destruction always empties the
+    // slot, so the location here is either this handle's or empty.
+    const Location source = m_Locations[index];
+    if (source.archetype != kNoArchetype) {
+        Archetype& src = *m_Archetypes[source.archetype];
+        for (std::size_t c = 0; c < src.types.size(); ++c) {
+            const ComponentType t = src.types[c];
+            void* from = columnPtr(src, source.row, c);
+            if (signature.test(t)) {
+                Archetype& dst = *m_Archetypes[target];
+                m_Columns[t].relocate(columnPtr(dst, targetRow, dst.column[t]), from);
+            } else {
+                m_Columns[t].destroy(from);
+            }
+        }
+        freeRow(src, source.row);
+    }
+
+    m_Locations[index] = {target, targetRow, entity};
+}
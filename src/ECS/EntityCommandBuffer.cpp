@@ -0,0 +1,225 @@
+#include "ECS/EntityCommandBuffer.h"
+
+#include <algorithm>
+
+// The engine's frame-level buffer; see the sync points in MistEngine.cpp.
+EntityCommandBuffer gEntityCommands;
+
+namespace {
+
+std::atomic<std::uint64_t> s_NextBufferId{1};
+
+constexpr std::size_t kArenaBlockBytes = 16 * 1024;
+
+} // namespace
+
+// One recording thread's share of the buffer. Only that thread touches it
+// while recording; playback reads it once recording has stopped.
+struct EntityCommandBuffer::Stream {
+    struct Block {
+        std::unique_ptr<std::byte[]> bytes;
+        std::size_t size = 0;
+    };
+
+    Stream* next = nullptr;
+    std::uint32_t ordinal = 0;
+    std::uint32_t createCount = 0;
+    std::vector<Command> commands;
+    std::vector<Block> blocks;    // kept across playbacks
+    std::size_t block = 0;        // block currently being filled
+    std::size_t offset = 0;
+    std::vector<Entity> resolved; // pending index -> created entity
+};
+
+EntityCommandBuffer::EntityCommandBuffer()
+    : m_Id(s_NextBufferId.fetch_add(1, std::memory_order_relaxed)) {}
+
+EntityCommandBuffer::~EntityCommandBuffer() {
+    resetStreams();
+    Stream* stream = m_Head.load(std::memory_order_acquire);
+    while (stream) {
+        Stream* next = stream->next;
+        delete stream;
+        stream = next;
+    }
+}
+
+EntityCommandBuffer::Stream& EntityCommandBuffer::localStream() {
+    // A few (buffer id, stream) pairs per thread. Ids are never reused, so
+    // an entry for a destroyed buffer is never matched again and just ages
+    // out. Evicting a live buffer's entry only means this thread opens a
+    // second stream for it; that stream has a higher ordinal, so playback
+    // still sees the thread's commands in recording order.
+    struct CacheEntry {
+        std::uint64_t id = 0;
+        Stream* stream = nullptr;
+    };
+    constexpr std::size_t kCacheSize = 8;
+    thread_local CacheEntry tls_Cache[kCacheSize];
+    thread_local std::size_t tls_Victim = 0;
+
+    for (const CacheEntry& entry : tls_Cache) {
+        if (entry.id == m_Id) return *entry.stream;
+    }
+
+    auto* stream = new Stream;
+    stream->ordinal = m_StreamCount.fetch_add(1, std::memory_order_relaxed);
+    stream->next = m_Head.load(std::memory_order_relaxed);
+    while (!m_Head.compare_exchange_weak(stream->next, stream, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+
+    tls_Cache[tls_Victim] = {m_Id, stream};
+    tls_Victim = (tls_Victim + 1) % kCacheSize;
+    return *stream;
+}
+
+void* EntityCommandBuffer::allocate(Stream& stream, std::size_t size, std::size_t align) {
+    // Bump-allocate from the current block; payloads never move once
+    // placed, so non-trivially-movable components are fine.
+    while (stream.block < stream.blocks.size()) {
+        Stream::Block& block = stream.blocks[stream.block];
+        const std::size_t start = (stream.offset + align - 1) & ~(align - 1);
+        if (start + size <= block.size) {
+            stream.offset = start + size;
+            return block.bytes.get() + start;
+        }
+        ++stream.block;
+        stream.offset = 0;
+    }
+
+    const std::size_t blockSize = std::max(kArenaBlockBytes, size);
+    stream.blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+    stream.block = stream.blocks.size() - 1;
+    stream.offset = size;
+    return stream.blocks.back().bytes.get();
+}
+
+void EntityCommandBuffer::append(Stream& stream, const Command& command) {
+    stream.commands.push_back(command);
+}
+
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::CreateEntity() {
+    Stream& stream = localStream();
+    return {stream.ordinal, stream.createCount++};
+}
+
+std::vector<EntityCommandBuffer::Stream*> EntityCommandBuffer::collectStreams() const {
+    std::vector<Stream*> streams(m_StreamCount.load(std::memory_order_acquire), nullptr);
+    for (Stream* s = m_Head.load(std::memory_order_acquire); s; s = s->next) {
+        streams[s->ordinal] = s;
+    }
+    return streams;
+}
+
+void EntityCommandBuffer::resetStreams() {
+    for (Stream* s = m_Head.load(std::memory_order_acquire); s; s = s->next) {
+        for (const Command& command : s->commands) {
+            if (command.destroy) command.destroy(command.payload);
+        }
+        s->commands.clear();
+        s->createCount = 0;
+        s->block = 0;
+        s->offset = 0;
+    }
+}
+
+void EntityCommandBuffer::Playback(Coordinator& coordinator) {
+    ++m_Epoch;
+    m_ByOrdinal = collectStreams();
+
+    // Payloads are destroyed even if a component constructor throws midway.
+    struct ResetGuard {
+        EntityCommandBuffer& buffer;
+        ~ResetGuard() { buffer.resetStreams(); }
+    } guard{*this};
+
+    for (Stream* s : m_ByOrdinal) {
+        s->resolved.clear();
+        for (std::uint32_t i = 0; i < s->createCount; ++i) {
+            s->resolved.push_back(coordinator.CreateEntity());
+        }
+    }
+
+    struct Entry {
+        Entity entity;
+        std::uint32_t stream;
+        std::uint32_t sequence;
+        const Command* command;
+    };
+    std::vector<Entry> entries;
+    std::size_t total = 0;
+    for (Stream* s : m_ByOrdinal) total += s->commands.size();
+    entries.reserve(total);
+
+    for (Stream* s : m_ByOrdinal) {
+        for (std::uint32_t i = 0; i < s->commands.size(); ++i) {
+            const Command& command = s->commands[i];
+            const Target& target = command.target;
+            const Entity entity = target.stream == Target::kLive
+                                      ? target.entity
+                                      : Resolve({target.stream, target.entity});
+            entries.push_back({entity, s->ordinal, i, &command});
+        }
+    }
+
+    // Group by entity, in slot order so storage is touched front to back;
+    // within a group keep stream then recording order.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (EntityIndex(a.entity) != EntityIndex(b.entity)) return EntityIndex(a.entity) < EntityIndex(b.entity);
+        if (a.entity != b.entity) return a.entity < b.entity;
+        if (a.stream != b.stream) return a.stream < b.stream;
+        return a.sequence < b.sequence;
+    });
+
+    for (std::size_t first = 0; first < entries.size();) {
+        const Entity entity = entries[first].entity;
+        std::size_t last = first;
+        bool destroy = false;
+        while (last < entries.size() && entries[last].entity == entity) {
+            destroy |= entries[last].command->op == Op::Destroy;
+            ++last;
+        }
+
+        if (!coordinator.IsAlive(entity)) {
+            // Stale handle: drop the whole group.
+        } else if (destroy) {
+            coordinator.DestroyEntity(entity);
+        } else {
+            Signature signature = coordinator.signatureOf(entity);
+            Signature changed;
+            for (std::size_t i = first; i < last; ++i) {
+                const Command& command = *entries[i].command;
+                const ComponentType type = command.apply(coordinator, entity, command.payload);
+                if (command.op == Op::Set) continue;
+                signature.set(type, command.op == Op::Add);
+                changed.set(type);
+            }
+            if (changed.any()) coordinator.commitSignature(entity, signature, changed);
+        }
+        first = last;
+    }
+}
+
+void EntityCommandBuffer::Clear() {
+    ++m_Epoch;
+    resetStreams();
+    for (Stream* s = m_Head.load(std::memory_order_acquire); s; s = s->next) {
+        s->resolved.clear();
+    }
+}
+
+std::size_t EntityCommandBuffer::GetCommandCount() const {
+    std::size_t count = 0;
+    for (Stream* s = m_Head.load(std::memory_order_acquire); s; s = s->next) {
+        count += s->commands.size() + s->createCount;
+    }
+    return count;
+}
+
+Entity EntityCommandBuffer::Resolve(PendingEntity pending) const {
+    if (pending.stream >= m_ByOrdinal.size()) return NULL_ENTITY;
+    const Stream* s = m_ByOrdinal[pending.stream];
+    if (!s || pending.index >= s->resolved.size()) return NULL_ENTITY;
+    return s->resolved[pending.index];
+}
@@ -1,15 +1,66 @@
 #include "ECS/SystemScheduler.h"
+#include "Core/JobSystem.h"
 #include "Core/Logger.h"
+#include "Debug/Profiler.h"
 #include <queue>
 #include <algorithm>
 
+namespace {
+
+bool Intersects(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b) {
+    for (std::uint32_t x : a) {
+        if (std::find(b.begin(), b.end(), x) != b.end()) return true;
+    }
+    return false;
+}
+
+// AddSystem's adapter for a plain update function.
+class FunctionSystem : public System {
+public:
+    explicit FunctionSystem(std::function<void(float)> update) : m_Update(std::move(update)) {}
+    void Update(float dt) override { m_Update(dt); }
+
+private:
+    std::function<void(float)> m_Update;
+};
+
+float MsSince(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+
+} // namespace
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const {
+    if (!Declared() || !other.Declared()) return true;
+    return Intersects(writes, other.writes) || Intersects(writes, other.reads) ||
+           Intersects(reads, other.writes);
+}
+
 void SystemScheduler::AddSystem(const std::string& name, std::shared_ptr<System> system) {
+    AddSystem(name, std::move(system), SystemAccess{});
+}
+
+void SystemScheduler::AddSystem(const std::string& name, std::shared_ptr<System> system,
+                                SystemAccess access) {
     int idx = (int)m_Systems.size();
     m_NameToIndex[name] = idx;
-    m_Systems.push_back({name, system, {}});
+    m_Systems.push_back({name, system, {}, std::move(access)});
     m_OrderBuilt = false;
 }
 
+void SystemScheduler::AddSystem(const std::string& name, std::function<void(float)> update,
+                                SystemAccess access) {
+    AddSystem(name, std::make_shared<FunctionSystem>(std::move(update)), std::move(access));
+}
+
+void SystemScheduler::SetAccess(const std::string& system, SystemAccess access) {
+    auto it = m_NameToIndex.find(system);
+    if (it != m_NameToIndex.end()) {
+        m_Systems[it->second].access = std::move(access);
+        m_OrderBuilt = false;
+    }
+}
+
 void SystemScheduler::AddDependency(const std::string& system, const std::string& dependsOn) {
     auto it = m_NameToIndex.find(system);
     if (it != m_NameToIndex.end()) {
@@ -20,9 +71,14 @@ void SystemScheduler::AddDependency(const std::string& system, const std::string
 
 void SystemScheduler::BuildExecutionOrder() {
     topologicalSort();
+    buildGraph();
     m_OrderBuilt = true;
 }
 
+Mist::JobSystem& SystemScheduler::GetJobSystem() const {
+    return m_Jobs ? *m_Jobs : Mist::JobSystem::Instance();
+}
+
 void SystemScheduler::topologicalSort() {
     int n = (int)m_Systems.size();
     std::vector<int> inDegree(n, 0);
@@ -57,9 +113,132 @@ void SystemScheduler::topologicalSort() {
     }
 }
 
+void SystemScheduler::buildGraph() {
+    const int n = (int)m_Systems.size();
+    m_Predecessors.assign(n, {});
+
+    auto addEdge = [&](int from, int to) {
+        auto& pred = m_Predecessors[to];
+        if (std::find(pred.begin(), pred.end(), from) == pred.end()) pred.push_back(from);
+    };
+
+    for (int i : m_ExecutionOrder) {
+        for (const auto& dep : m_Systems[i].dependencies) {
+            auto it = m_NameToIndex.find(dep);
+            if (it != m_NameToIndex.end()) addEdge(it->second, i);
+        }
+    }
+
+    // Conflicting pairs are ordered the way the dependency-only sort already
+    // runs them, which keeps the graph acyclic and the result deterministic.
+    for (size_t a = 0; a < m_ExecutionOrder.size(); ++a) {
+        for (size_t b = a + 1; b < m_ExecutionOrder.size(); ++b) {
+            const int first = m_ExecutionOrder[a];
+            const int second = m_ExecutionOrder[b];
+            if (m_Systems[first].access.ConflictsWith(m_Systems[second].access)) {
+                addEdge(first, second);
+            }
+        }
+    }
+}
+
 void SystemScheduler::Execute(float dt) {
     if (!m_OrderBuilt) BuildExecutionOrder();
+
+    Mist::JobSystem& jobs = GetJobSystem();
+    m_Timings.assign(m_Systems.size(), SystemTiming{});
+    m_Threads.assign(1, std::this_thread::get_id());
+    m_FrameDt = dt;
+    m_Error = nullptr;
+    m_FrameStart = std::chrono::steady_clock::now();
+
+    // Main-thread jobs only run on the bound main thread, and only while
+    // it is inside Wait; anywhere else they would never start.
+    bool parallel = m_Parallel && jobs.GetWorkerCount() > 0 && m_ExecutionOrder.size() > 1;
+    if (parallel && !jobs.IsMainThread()) {
+        for (int idx : m_ExecutionOrder) {
+            if (m_Systems[idx].access.NeedsMainThread()) parallel = false;
+        }
+    }
+
+    if (parallel) {
+        executeParallel(jobs);
+    } else {
+        executeSerial();
+    }
+    m_LastWallMs = MsSince(m_FrameStart, std::chrono::steady_clock::now());
+    reportTimings();
+    rethrowError();
+}
+
+void SystemScheduler::executeSerial() {
+    for (int idx : m_ExecutionOrder) {
+        runSystem(idx);
+        // Serial mode keeps the old fail-fast behaviour.
+        if (m_Error) return;
+    }
+}
+
+void SystemScheduler::executeParallel(Mist::JobSystem& jobs) {
+    // m_ExecutionOrder is topological, so every predecessor's handle
+    // exists by the time its successors are scheduled.
+    std::vector<Mist::JobHandle> handles(m_Systems.size());
+    std::vector<Mist::JobHandle> dependsOn;
+    for (int idx : m_ExecutionOrder) {
+        dependsOn.clear();
+        for (int pred : m_Predecessors[idx]) dependsOn.push_back(handles[pred]);
+        const auto affinity =
+            m_Systems[idx].access.NeedsMainThread() ? Mist::JobAffinity::MainThread : Mist::JobAffinity::Any;
+        handles[idx] = jobs.Schedule([this, idx] { runSystem(idx); }, dependsOn, affinity);
+    }
+    // runSystem catches, so Wait never throws; the frame always completes.
+    for (int idx : m_ExecutionOrder) jobs.Wait(handles[idx]);
+}
+
+int SystemScheduler::workerIndex() {
+    const auto id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = std::find(m_Threads.begin(), m_Threads.end(), id);
+    if (it != m_Threads.end()) return static_cast<int>(it - m_Threads.begin());
+    m_Threads.push_back(id);
+    return static_cast<int>(m_Threads.size()) - 1;
+}
+
+void SystemScheduler::runSystem(int index) {
+    // Each index is run by exactly one thread per Execute, so its timing
+    // slot needs no lock; Execute reads them after waiting on every job.
+    auto& timing = m_Timings[index];
+    timing.name = m_Systems[index].name;
+    timing.worker = workerIndex();
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        m_Systems[index].system->Update(m_FrameDt);
+    } catch (...) {
+        // First failure wins; in parallel mode the frame still runs to
+        // completion so no system is left half-way through its update.
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Error) m_Error = std::current_exception();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    timing.startMs = MsSince(m_FrameStart, start);
+    timing.durationMs = MsSince(start, end);
+}
+
+void SystemScheduler::rethrowError() {
+    if (!m_Error) return;
+    auto error = m_Error;
+    m_Error = nullptr;
+    std::rethrow_exception(error);
+}
+
+void SystemScheduler::reportTimings() {
+    if (!m_Profiler) return;
+    float sum = 0.0f;
     for (int idx : m_ExecutionOrder) {
-        m_Systems[idx].system->Update(dt);
+        const auto& t = m_Timings[idx];
+        m_Profiler->RecordCPUSection("System: " + t.name, t.durationMs);
+        sum += t.durationMs;
     }
+    m_Profiler->RecordCPUSection("Systems (wall)", m_LastWallMs);
+    m_Profiler->RecordCPUSection("Systems (sum)", sum);
 }
@@ -2,14 +2,15 @@
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Components/PhysicsComponent.h"
 #include <glm/gtc/type_ptr.hpp>
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/euler_angles.hpp>
 
 // Add the global coordinator declaration
 extern Coordinator gCoordinator;
 
 void ECSPhysicsSystem::Update(float deltaTime) {
-    for (auto const& entity : m_Entities) {
+    // Each entity only writes its own TransformComponent and reads its own
+    // motion state, and the world isn't stepping while this runs, so the
+    // sync fans out across the job system once there are enough bodies.
+    gCoordinator.ParallelForEach(m_Entities, [](Entity entity) {
         auto& transform = gCoordinator.GetComponent<TransformComponent>(entity);
         auto& physics = gCoordinator.GetComponent<PhysicsComponent>(entity);
 
@@ -18,16 +19,13 @@ void ECSPhysicsSystem::Update(float deltaTime) {
             btTransform trans;
             physics.rigidBody->getMotionState()->getWorldTransform(trans);
 
-            // Update position
-            btVector3 origin = trans.getOrigin();
-            transform.position = glm::vec3(origin.getX(), origin.getY(), origin.getZ());
-
-            // Update rotation
-            btQuaternion rotation = trans.getRotation();
-            btScalar yaw, pitch, roll;
-            rotation.getEulerZYX(yaw, pitch, roll);
-            transform.rotation = glm::vec3(glm::degrees(pitch), glm::degrees(yaw), glm::degrees(roll));
+            // Both sides store a quaternion, so this is a straight copy.
+            const btVector3 origin = trans.getOrigin();
+            const btQuaternion rotation = trans.getRotation();
+            transform.SetPosition(glm::vec3(origin.getX(), origin.getY(), origin.getZ()));
+            transform.SetRotation(glm::quat(rotation.getW(), rotation.getX(), rotation.getY(), rotation.getZ()));
+            gCoordinator.MarkChanged<TransformComponent>(entity);
         }
-    }
+    });
 }
 
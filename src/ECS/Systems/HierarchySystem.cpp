@@ -3,8 +3,7 @@
 #include "ECS/Components/HierarchyComponent.h"
 #include "ECS/Components/TransformComponent.h"
 
-#include <glm/gtc/matrix_transform.hpp>
-#include <stack>
+#include <algorithm>
 #include <vector>
 
 Mist::Signal<Entity>& HierarchySystem::OnReady() {
@@ -22,70 +21,113 @@ HierarchyComponent* TryGetHier(Coordinator& c, Entity e) {
     return &c.GetComponent<HierarchyComponent>(e);
 }
 
-TransformComponent* TryGetTrans(Coordinator& c, Entity e) {
-    if (!c.HasComponent<TransformComponent>(e)) return nullptr;
-    return &c.GetComponent<TransformComponent>(e);
+// Number of ancestors, following HierarchyComponent::parent. Bounded by
+// the entity count so a hand-made cycle can't hang it.
+std::uint32_t ParentDepth(Coordinator& c, Entity e) {
+    std::uint32_t depth = 0;
+    for (auto* h = TryGetHier(c, e); h && h->parent != HierarchyComponent::kNoParent && depth <= MAX_ENTITIES;
+         h = TryGetHier(c, h->parent)) {
+        ++depth;
+    }
+    return depth;
 }
 
-// Recursive compose: if dirty, multiply parent's cachedGlobal with our
-// local. If not dirty but parent changed, we still have to recompute, so
-// callers should propagate dirty down before invoking this. Returns the
-// cachedGlobal that was written, mostly so the caller can feed it into
-// children as their parent matrix.
-void RecomputeSubtree(Coordinator& c, Entity e, const glm::mat4& parentGlobal, bool parentDirty) {
-    auto* t = TryGetTrans(c, e);
-    if (!t) return;
-
-    const bool mustRecompute = t->dirty || parentDirty;
-    if (mustRecompute) {
-        t->cachedGlobal = parentGlobal * t->GetModelMatrix();
-        t->dirty        = false;
-    }
+} // namespace
 
-    auto* h = TryGetHier(c, e);
-    if (!h) return;
-    for (Entity child : h->children) {
-        RecomputeSubtree(c, child, t->cachedGlobal, mustRecompute);
+void HierarchySystem::UpdateTransforms(Coordinator& coord) {
+    // Nothing stamped since the last run (the common case in a static
+    // level): every cachedGlobal is still valid. Destroying an entity
+    // stamps nothing, so a tree larger than the membership also has work:
+    // the departed node's children need re-deriving as roots.
+    const ChangeTick since = m_LastUpdateTick;
+    if (coord.LastChangeTick<TransformComponent>() <= since &&
+        coord.LastChangeTick<HierarchyComponent>() <= since && m_Tree.Size() <= m_Entities.size()) {
+        m_LastUpdateTick = coord.AdvanceChangeTick();
+        return;
     }
+
+    SyncTree(coord, since);
+
+    auto pass = coord.BeginParallelPass();
+    m_Tree.Update([&coord](Entity e, const glm::mat4& world, bool localChanged) {
+        coord.GetComponent<TransformComponent>(e).cachedGlobal = world;
+        // Moved by a parent or a reparent rather than its own (already
+        // stamped) write: stamp it so cachedGlobal consumers see the change.
+        if (!localChanged) coord.MarkChanged<TransformComponent>(e);
+    });
+    // Stamps made during the update belong to the closed tick, so they
+    // don't re-trigger the next run.
+    m_LastUpdateTick = coord.AdvanceChangeTick();
 }
 
-// Post-order traversal so a parent's OnReady fires after all children. We
-// flag entities whose readyFired is already true so listeners see each
-// entity exactly once across the engine's lifetime.
-void ReadyPostOrder(Coordinator& c, Entity e, Mist::Signal<Entity>& sig) {
-    auto* h = TryGetHier(c, e);
-    if (h) {
-        for (Entity child : h->children) {
-            ReadyPostOrder(c, child, sig);
+void HierarchySystem::SyncTree(Coordinator& coord, ChangeTick since) {
+    // New members show up as a freshly added Transform or Hierarchy; both
+    // are stamped by AddComponent. Insert them all before linking anything
+    // so parent lookups below see the whole set.
+    std::vector<Entity> relink;
+    auto track = [&](Entity e) {
+        if (!m_Entities.contains(e)) return;
+        if (!m_Tree.Contains(e)) {
+            m_Tree.Insert(e, coord.GetComponent<TransformComponent>(e).RebuildModelMatrix());
+            // Children that joined earlier were linked as roots while this
+            // entity wasn't tracked.
+            for (Entity child : coord.GetComponent<HierarchyComponent>(e).children) relink.push_back(child);
         }
+        relink.push_back(e);
+    };
+    coord.ForEachChanged<HierarchyComponent>(since, [&](Entity e, HierarchyComponent&) { track(e); });
+    coord.ForEachChanged<TransformComponent>(since, [&](Entity e, TransformComponent& t) {
+        if (m_Tree.Contains(e)) {
+            m_Tree.SetLocal(e, t.RebuildModelMatrix());
+        } else {
+            track(e);
+        }
+    });
+
+    // Members that left (entity destroyed or a component removed) are only
+    // visible as a count mismatch once the new ones are in. Handles whose
+    // index was reused were replaced in Insert, so this sweep only has to
+    // run when the tree is larger than the membership.
+    if (m_Tree.Size() > m_Entities.size()) {
+        std::vector<Entity> gone;
+        for (std::size_t slot = 0; slot < m_Tree.Size(); ++slot) {
+            if (!m_Entities.contains(m_Tree.EntityAt(slot))) gone.push_back(m_Tree.EntityAt(slot));
+        }
+        for (Entity e : gone) m_Tree.Remove(e);
     }
-    if (h && !h->readyFired) {
-        h->readyFired = true;
-        sig.Emit(e);
-    }
-}
-
-} // namespace
 
-void HierarchySystem::UpdateTransforms(Coordinator& coord) {
-    // Walk every entity with a HierarchyComponent. Skip those with a
-    // parent — we only want roots as entry points. RecomputeSubtree then
-    // recurses through children and propagates the parent matrix.
-    for (Entity e : m_Entities) {
-        auto* h = TryGetHier(coord, e);
-        if (!h) continue;
-        if (h->parent != HierarchyComponent::kNoParent) continue;
-        RecomputeSubtree(coord, e, glm::mat4(1.0f), false);
+    // Attach doesn't check for cycles (the editor does before calling it);
+    // if one slips through, SetParent leaves that node where it was.
+    for (Entity e : relink) {
+        if (!m_Tree.Contains(e)) continue;
+        m_Tree.SetParent(e, coord.GetComponent<HierarchyComponent>(e).parent);
     }
 }
 
 void HierarchySystem::FireReadyCallbacks(Coordinator& coord) {
+    // Only an entity whose HierarchyComponent was stamped since the last
+    // call can still owe OnReady — AddComponent and Attach both stamp — so
+    // those form the pending queue and the rest of the tree is never
+    // visited. Each entity fires exactly once across the engine's
+    // lifetime (readyFired).
+    const ChangeTick since = m_LastReadyTick;
+    m_LastReadyTick = coord.AdvanceChangeTick();
+    m_PendingReady.clear();
+    coord.ForEachChanged<HierarchyComponent>(since, [this, &coord](Entity e, HierarchyComponent& h) {
+        if (!h.readyFired) m_PendingReady.emplace_back(ParentDepth(coord, e), e);
+    });
+    if (m_PendingReady.empty()) return;
+
+    // Deepest first, so a parent fires after all its children.
+    std::stable_sort(m_PendingReady.begin(), m_PendingReady.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
     auto& sig = OnReady();
-    for (Entity e : m_Entities) {
+    for (const auto& [depth, e] : m_PendingReady) {
+        // A listener may have removed a later entry's component.
         auto* h = TryGetHier(coord, e);
-        if (!h) continue;
-        if (h->parent != HierarchyComponent::kNoParent) continue;
-        ReadyPostOrder(coord, e, sig);
+        if (!h || h->readyFired) continue;
+        h->readyFired = true;
+        sig.Emit(e);
     }
 }
 
@@ -105,7 +147,7 @@ bool HierarchySystem::Attach(Coordinator& coord, Entity parent, Entity child) {
     ch->parent = parent;
     ph->children.push_back(child);
 
-    if (auto* t = TryGetTrans(coord, child)) t->dirty = true;
+    coord.MarkChanged<HierarchyComponent>(child);
     return true;
 }
 
@@ -119,6 +161,6 @@ bool HierarchySystem::Detach(Coordinator& coord, Entity child) {
         vec.erase(std::remove(vec.begin(), vec.end(), child), vec.end());
     }
     ch->parent = HierarchyComponent::kNoParent;
-    if (auto* t = TryGetTrans(coord, child)) t->dirty = true;
+    coord.MarkChanged<HierarchyComponent>(child);
     return true;
 }
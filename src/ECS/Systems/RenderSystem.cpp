@@ -1,18 +1,167 @@
 #include "ECS/Systems/RenderSystem.h"
+#include "ECS/Components/HierarchyComponent.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Components/RenderComponent.h"
 
+#include <algorithm>
+#include <iterator>
+
 extern Coordinator gCoordinator;
 
-void RenderSystem::Update(Shader& shader) {
-    for (auto const& entity : m_Entities) {
-        auto& transform = gCoordinator.GetComponent<TransformComponent>(entity);
-        auto& render = gCoordinator.GetComponent<RenderComponent>(entity);
+namespace {
+
+using Mist::Renderer::DrawItem;
+
+// Uniforms and GL draws for one pass's shader.
+class ShaderSink final : public Mist::Renderer::DrawSink {
+public:
+    // `instances` is the submitted list's matrices, already streamed into
+    // `instanceBuffer`; without a buffer, instanced batches fall back to
+    // one draw per matrix.
+    ShaderSink(Shader& shader, std::uint32_t instanceBuffer, const std::vector<glm::mat4>* instances)
+        : m_Shader(shader), m_InstanceBuffer(instanceBuffer), m_Instances(instances) {}
+
+    // For an IndirectList whose commands and draw data are streamed into
+    // these two buffers.
+    void SetIndirectBuffers(std::uint32_t commandBuffer, std::uint32_t drawDataBuffer) {
+        m_CommandBuffer = commandBuffer;
+        m_DrawDataBuffer = drawDataBuffer;
+    }
+
+    // Leave the shader on the `model` uniform for whatever draws next.
+    ~ShaderSink() override { setSource(Source::Model); }
+
+    void BindMaterial(const DrawItem& item) override { item.renderable->BindState(m_Shader); }
+
+    void Draw(const DrawItem& item, const glm::mat4& world) override {
+        setSource(Source::Model);
+        m_Shader.setMat4("model", world);
+        item.renderable->DrawGeometry(m_Shader);
+    }
 
-        if (render.visible && render.renderable) {
-            glm::mat4 model = transform.GetModelMatrix();
-            shader.setMat4("model", model);
-            render.renderable->Draw(shader);
+    void DrawInstanced(const DrawItem& item, std::uint32_t firstInstance, std::uint32_t count) override {
+        if (!m_InstanceBuffer) {
+            for (std::uint32_t i = 0; i < count; ++i) Draw(item, (*m_Instances)[firstInstance + i]);
+            return;
         }
+        setSource(Source::Instance);
+        item.renderable->DrawInstanced(m_Shader, m_InstanceBuffer, firstInstance, count);
+    }
+
+    void DrawIndirect(const DrawItem& /*item*/, std::uint32_t firstCommand, std::uint32_t commandCount) override {
+        auto* pool = Mist::Renderer::Geometry();
+        if (!pool) return;
+        setSource(Source::DrawData);
+        pool->MultiDrawIndirect(m_CommandBuffer, m_DrawDataBuffer, firstCommand, commandCount);
+    }
+
+private:
+    // Where the vertex shader takes the world matrix from.
+    enum class Source { Model, Instance, DrawData };
+
+    void setSource(Source source) {
+        if (source == m_Source) return;
+        m_Shader.setBool("useInstancing", source == Source::Instance);
+        m_Shader.setBool("useDrawData", source == Source::DrawData);
+        m_Source = source;
+    }
+
+    Shader& m_Shader;
+    std::uint32_t m_InstanceBuffer;
+    const std::vector<glm::mat4>* m_Instances;
+    std::uint32_t m_CommandBuffer = 0;
+    std::uint32_t m_DrawDataBuffer = 0;
+    Source m_Source = Source::Model;
+};
+
+} // namespace
+
+void RenderSystem::Extract(const glm::vec3& eye, const glm::vec3& forward, float nearPlane, float farPlane) {
+    m_Queue.Begin(eye, forward, nearPlane, farPlane);
+    for (PassList& pass : m_PassLists) pass.built = false;
+    m_ResidentPass = -1;
+    m_ViewCount = 0;
+
+    // The owning group holds the same entities as m_Entities, packed.
+    gCoordinator.Group<TransformComponent, RenderComponent>().ForEach(
+        [this](Entity e, TransformComponent& transform, RenderComponent& render) {
+            if (!render.visible || !render.renderable) return;
+            // Hierarchy members have their parents folded into cachedGlobal;
+            // the rest are in world space already.
+            const glm::mat4 world = gCoordinator.HasComponent<HierarchyComponent>(e)
+                ? transform.cachedGlobal : transform.GetModelMatrix();
+            const std::uint32_t passes = render.castShadows
+                ? Mist::Renderer::kPassAll : Mist::Renderer::kPassMain;
+            m_Queue.Add(render.renderable, render.renderable->GetMaterial(), world, passes, e);
+        });
+
+    m_Queue.Sort();
+}
+
+void RenderSystem::Cull(const glm::mat4* viewProjections, std::size_t count) {
+    m_Frusta.resize(count);
+    for (std::size_t i = 0; i < count; ++i) m_Frusta[i].ExtractFromVP(viewProjections[i]);
+    // Bitsets outlive the frame so their words are reused, not reallocated.
+    if (m_Visibility.size() < count) m_Visibility.resize(count);
+    FrustumCuller::CullFrustums(m_Frusta.data(), count, m_Queue.Bounds(), m_Visibility.data());
+    m_ViewCount = count;
+    for (PassList& pass : m_PassLists) {
+        if (pass.view >= 0) pass.built = false;
+    }
+}
+
+Mist::Renderer::SubmitStats RenderSystem::Draw(Shader& shader, std::uint32_t passMask, bool bindMaterials, int view) {
+    if (view >= static_cast<int>(m_ViewCount)) view = -1;
+    const VisibilityBitset* visible = view >= 0 ? &m_Visibility[view] : nullptr;
+
+    const bool indirect = m_Indirect && Mist::Renderer::Geometry();
+    if (!indirect && m_MinInstances == 0) {
+        ShaderSink sink(shader, 0, nullptr);
+        return m_Queue.Submit(passMask, sink, bindMaterials, visible);
+    }
+
+    auto it = std::find_if(m_PassLists.begin(), m_PassLists.end(), [&](const PassList& pass) {
+        return pass.passMask == passMask && pass.view == view && pass.bindMaterials == bindMaterials;
+    });
+    if (it == m_PassLists.end()) {
+        m_PassLists.emplace_back();
+        m_PassLists.back().passMask = passMask;
+        m_PassLists.back().view = view;
+        m_PassLists.back().bindMaterials = bindMaterials;
+        it = std::prev(m_PassLists.end());
+    }
+    PassList& pass = *it;
+    const int passIndex = static_cast<int>(it - m_PassLists.begin());
+    if (!pass.built || pass.indirect != indirect) {
+        // Depth-only passes bind nothing, so their commands needn't break
+        // at material boundaries.
+        if (indirect) {
+            m_Queue.BuildIndirectList(passMask, bindMaterials, pass.indirectList, visible);
+        } else {
+            m_Queue.BuildDrawList(passMask, m_MinInstances, pass.list, visible);
+        }
+        pass.built = true;
+        pass.indirect = indirect;
+        if (m_ResidentPass == passIndex) m_ResidentPass = -1;
+    }
+
+    // One upload serves every Draw of this grouping until another's data
+    // replaces it.
+    if (indirect) {
+        if (m_ResidentPass != passIndex && !pass.indirectList.commands.empty()) {
+            m_CommandBuffer.Upload(pass.indirectList.commands);
+            m_DrawDataBuffer.Upload(pass.indirectList.drawData);
+            m_ResidentPass = passIndex;
+        }
+        ShaderSink sink(shader, 0, nullptr);
+        sink.SetIndirectBuffers(m_CommandBuffer.GetGLHandle(), m_DrawDataBuffer.GetGLHandle());
+        return m_Queue.Submit(pass.indirectList, sink, bindMaterials);
+    }
+
+    if (m_ResidentPass != passIndex && !pass.list.instances.empty()) {
+        m_InstanceBuffer.Upload(pass.list.instances);
+        m_ResidentPass = passIndex;
     }
+    ShaderSink sink(shader, m_InstanceBuffer.GetGLHandle(), &pass.list.instances);
+    return m_Queue.Submit(pass.list, sink, bindMaterials);
 }
@@ -0,0 +1,39 @@
+#include "ECS/Systems/SpatialHashSystem.h"
+
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/TransformComponent.h"
+
+#include <vector>
+
+void SpatialHashSystem::Update(Coordinator& coord) {
+    // Removals aren't stamped; they show up as the grid outgrowing the
+    // membership.
+    const ChangeTick since = m_LastUpdateTick;
+    if (coord.LastChangeTick<TransformComponent>() <= since && m_Grid.Size() <= m_Entities.size()) {
+        m_LastUpdateTick = coord.AdvanceChangeTick();
+        return;
+    }
+
+    coord.ForEachChanged<TransformComponent>(since, [&](Entity e, TransformComponent& t) {
+        if (!m_Entities.contains(e)) return;
+        // Hierarchy members have their parents folded into cachedGlobal.
+        const glm::vec3 position = coord.HasComponent<HierarchyComponent>(e)
+                                       ? glm::vec3(t.cachedGlobal[3])
+                                       : t.position;
+        if (m_Grid.Contains(e)) {
+            m_Grid.Move(e, position);
+        } else {
+            m_Grid.Insert(e, position);
+        }
+    });
+
+    // Handles whose index was reused were replaced by Insert above.
+    if (m_Grid.Size() > m_Entities.size()) {
+        std::vector<Entity> gone;
+        m_Grid.ForEach([&](Entity e) {
+            if (!m_Entities.contains(e)) gone.push_back(e);
+        });
+        for (Entity e : gone) m_Grid.Remove(e);
+    }
+    m_LastUpdateTick = coord.AdvanceChangeTick();
+}
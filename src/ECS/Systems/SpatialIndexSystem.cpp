@@ -0,0 +1,105 @@
+#include "ECS/Systems/SpatialIndexSystem.h"
+
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/RenderComponent.h"
+#include "ECS/Components/TransformComponent.h"
+
+#include "Core/SmallVector.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const glm::mat4& WorldMatrix(Coordinator& coord, Entity e) {
+    const auto& t = coord.GetComponent<TransformComponent>(e);
+    // Hierarchy members have their parents folded into cachedGlobal; the
+    // rest are in world space already.
+    return coord.HasComponent<HierarchyComponent>(e) ? t.cachedGlobal : t.GetModelMatrix();
+}
+
+AABB WorldBounds(Coordinator& coord, Entity e) {
+    const glm::mat4& world = WorldMatrix(coord, e);
+    const Renderable* renderable = coord.GetComponent<RenderComponent>(e).renderable;
+    if (renderable && renderable->GetLocalBounds().IsValid()) {
+        return renderable->GetLocalBounds().Transform(world);
+    }
+    const glm::vec3 origin(world[3]);
+    return AABB{origin, origin};
+}
+
+} // namespace
+
+void SpatialIndexSystem::Update(Coordinator& coord) {
+    // Removals aren't stamped; they show up as the tree outgrowing the
+    // membership.
+    const ChangeTick since = m_LastUpdateTick;
+    if (coord.LastChangeTick<TransformComponent>() <= since &&
+        coord.LastChangeTick<RenderComponent>() <= since && m_Tree.Size() <= m_Entities.size()) {
+        m_LastUpdateTick = coord.AdvanceChangeTick();
+        return;
+    }
+
+    auto refresh = [&](Entity e) {
+        if (!m_Entities.contains(e)) return;
+        const AABB bounds = WorldBounds(coord, e);
+        if (!m_Tree.Contains(e)) {
+            m_Tree.Insert(e, bounds);
+            return;
+        }
+        const AABB& old = m_Tree.GetBounds(e);
+        m_Tree.Move(e, bounds, bounds.Center() - old.Center());
+    };
+    coord.ForEachChanged<TransformComponent>(since, [&](Entity e, TransformComponent&) { refresh(e); });
+    coord.ForEachChanged<RenderComponent>(since, [&](Entity e, RenderComponent&) { refresh(e); });
+
+    // Handles whose index was reused were replaced by Insert above.
+    if (m_Tree.Size() > m_Entities.size()) {
+        std::vector<Entity> gone;
+        m_Tree.ForEach([&](Entity e) {
+            if (!m_Entities.contains(e)) gone.push_back(e);
+        });
+        for (Entity e : gone) m_Tree.Remove(e);
+    }
+    m_LastUpdateTick = coord.AdvanceChangeTick();
+}
+
+bool SpatialIndexSystem::Raycast(Coordinator& coord, const glm::vec3& origin, const glm::vec3& direction,
+                                 float maxDistance, DynamicAABBTree::RayHit& hit) const {
+    Mist::SmallVector<std::pair<float, Entity>, 32> candidates;
+    m_Tree.Raycast(origin, direction, maxDistance, [&](Entity e, float entry) { candidates.push_back({entry, e}); });
+    std::sort(candidates.begin(), candidates.end());
+
+    float best = maxDistance;
+    bool found = false;
+    for (const auto& [entry, e] : candidates) {
+        if (entry > best) break;
+        // Destroyed since the last Update: still in the tree, no longer ours.
+        if (!m_Entities.contains(e)) continue;
+        const Renderable* renderable = coord.GetComponent<RenderComponent>(e).renderable;
+        if (!renderable) continue;
+        // An affine map keeps the ray parameter, so t found in object space
+        // is the world-space distance too.
+        const glm::mat4 toLocal = glm::inverse(WorldMatrix(coord, e));
+        const glm::vec3 localOrigin(toLocal * glm::vec4(origin, 1.0f));
+        const glm::vec3 localDir(toLocal * glm::vec4(direction, 0.0f));
+        float t = 0.0f;
+        if (renderable->RaycastLocal(localOrigin, localDir, best, t) && (!found || t < best)) {
+            best = t;
+            hit = {e, t};
+            found = true;
+        }
+    }
+    return found;
+}
+
+std::size_t SpatialIndexSystem::RaycastBatch(Coordinator& coord, const TriangleBVH::Ray* rays, std::size_t count,
+                                             DynamicAABBTree::RayHit* hits) const {
+    std::size_t hitCount = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        hits[i] = DynamicAABBTree::RayHit{};
+        hitCount += Raycast(coord, rays[i].origin, rays[i].direction, rays[i].maxDistance, hits[i]);
+    }
+    return hitCount;
+}
@@ -0,0 +1,206 @@
+#include "ECS/Systems/TransformHierarchy.h"
+
+void TransformHierarchy::Insert(Entity entity, const glm::mat4& local) {
+    if (Contains(entity)) return;
+    const std::uint32_t stale = m_Index.Get(entity);
+    if (stale != SparseEntityIndex::kInvalid) Remove(m_NodeEntity[stale]);
+
+    std::uint32_t node;
+    if (!m_FreeNodes.empty()) {
+        node = m_FreeNodes.back();
+        m_FreeNodes.pop_back();
+    } else {
+        node = static_cast<std::uint32_t>(m_NodeEntity.size());
+        m_NodeEntity.push_back(NULL_ENTITY);
+        m_NodeParent.push_back(kNone);
+        m_NodeFirstChild.push_back(kNone);
+        m_NodeNextSibling.push_back(kNone);
+        m_NodePrevSibling.push_back(kNone);
+        m_NodeDepth.push_back(0);
+        m_NodeSlot.push_back(kNone);
+    }
+    m_NodeEntity[node] = entity;
+    m_NodeParent[node] = kNone;
+    m_NodeFirstChild[node] = kNone;
+    m_NodeNextSibling[node] = kNone;
+    m_NodePrevSibling[node] = kNone;
+    m_NodeDepth[node] = 0;
+    m_Index.Slot(entity) = node;
+
+    attach(node, 0, Detached{local, local, 0});
+    markDirty(node);
+}
+
+void TransformHierarchy::Remove(Entity entity) {
+    const std::uint32_t node = nodeOf(entity);
+    if (node == kNone) return;
+
+    while (m_NodeFirstChild[node] != kNone) {
+        setParentNode(m_NodeFirstChild[node], kNone);
+    }
+    unlink(node);
+    detach(node);
+
+    m_Index.Slot(entity) = SparseEntityIndex::kInvalid;
+    m_NodeEntity[node] = NULL_ENTITY;
+    m_FreeNodes.push_back(node);
+}
+
+bool TransformHierarchy::SetParent(Entity child, Entity parent) {
+    const std::uint32_t node = nodeOf(child);
+    if (node == kNone) return false;
+    return setParentNode(node, parent == NULL_ENTITY ? kNone : nodeOf(parent));
+}
+
+Entity TransformHierarchy::GetParent(Entity entity) const {
+    const std::uint32_t node = nodeOf(entity);
+    if (node == kNone || m_NodeParent[node] == kNone) return NULL_ENTITY;
+    return m_NodeEntity[m_NodeParent[node]];
+}
+
+void TransformHierarchy::SetLocal(Entity entity, const glm::mat4& local) {
+    const std::uint32_t node = nodeOf(entity);
+    if (node == kNone) return;
+    m_Local[m_NodeSlot[node]] = local;
+    markDirty(node, kLocalChanged);
+}
+
+bool TransformHierarchy::setParentNode(std::uint32_t node, std::uint32_t parent) {
+    if (m_NodeParent[node] == parent) return true;
+    for (std::uint32_t up = parent; up != kNone; up = m_NodeParent[up]) {
+        if (up == node) return false;
+    }
+
+    unlink(node);
+    link(node, parent);
+
+    const std::uint32_t depth = parent == kNone ? 0 : m_NodeDepth[parent] + 1;
+    if (depth == m_NodeDepth[node]) {
+        // Same level: only the parent index changes.
+        m_SlotParent[m_NodeSlot[node]] = parent == kNone ? kNone : m_NodeSlot[parent];
+        markDirty(node);
+        return true;
+    }
+
+    // Breadth-first, so each node lands in its new level after its parent
+    // has and reads the parent's final slot.
+    std::vector<std::uint32_t> subtree{node};
+    for (std::size_t i = 0; i < subtree.size(); ++i) {
+        for (std::uint32_t c = m_NodeFirstChild[subtree[i]]; c != kNone; c = m_NodeNextSibling[c]) {
+            subtree.push_back(c);
+        }
+    }
+    for (std::uint32_t moving : subtree) {
+        const std::uint32_t up = m_NodeParent[moving];
+        const std::uint32_t level = up == kNone ? 0 : m_NodeDepth[up] + 1;
+        attach(moving, level, detach(moving));
+    }
+    markDirty(node);
+    return true;
+}
+
+void TransformHierarchy::link(std::uint32_t node, std::uint32_t parent) {
+    m_NodeParent[node] = parent;
+    m_NodePrevSibling[node] = kNone;
+    m_NodeNextSibling[node] = kNone;
+    if (parent == kNone) return;
+    const std::uint32_t first = m_NodeFirstChild[parent];
+    m_NodeNextSibling[node] = first;
+    if (first != kNone) m_NodePrevSibling[first] = node;
+    m_NodeFirstChild[parent] = node;
+}
+
+void TransformHierarchy::unlink(std::uint32_t node) {
+    const std::uint32_t parent = m_NodeParent[node];
+    if (parent == kNone) return;
+    const std::uint32_t prev = m_NodePrevSibling[node];
+    const std::uint32_t next = m_NodeNextSibling[node];
+    if (prev != kNone) {
+        m_NodeNextSibling[prev] = next;
+    } else {
+        m_NodeFirstChild[parent] = next;
+    }
+    if (next != kNone) m_NodePrevSibling[next] = prev;
+    m_NodeParent[node] = kNone;
+    m_NodePrevSibling[node] = kNone;
+    m_NodeNextSibling[node] = kNone;
+}
+
+void TransformHierarchy::moveSlot(std::uint32_t from, std::uint32_t to) {
+    const std::uint32_t node = m_SlotNode[from];
+    m_SlotNode[to] = node;
+    m_SlotParent[to] = m_SlotParent[from];
+    m_Local[to] = m_Local[from];
+    m_World[to] = m_World[from];
+    m_Flags[to] = m_Flags[from];
+    m_NodeSlot[node] = to;
+    fixChildren(node);
+}
+
+void TransformHierarchy::fixChildren(std::uint32_t node) {
+    const std::uint32_t slot = m_NodeSlot[node];
+    for (std::uint32_t c = m_NodeFirstChild[node]; c != kNone; c = m_NodeNextSibling[c]) {
+        // A child that is itself between levels gets its parent slot when
+        // it's attached.
+        if (m_NodeSlot[c] != kNone) m_SlotParent[m_NodeSlot[c]] = slot;
+    }
+}
+
+TransformHierarchy::Detached TransformHierarchy::detach(std::uint32_t node) {
+    std::uint32_t hole = m_NodeSlot[node];
+    const Detached payload{m_Local[hole], m_World[hole], m_Flags[hole]};
+    m_NodeSlot[node] = kNone;
+
+    // Fill the hole from the end of the node's own level, then let each
+    // deeper level shift down by one: its last element moves into the slot
+    // its level just gained at the front.
+    const std::size_t level = m_NodeDepth[node];
+    for (std::size_t l = level; l < m_LevelEnd.size(); ++l) {
+        const std::uint32_t last = static_cast<std::uint32_t>(m_LevelEnd[l] - 1);
+        if (last != hole) moveSlot(last, hole);
+        hole = last;
+        --m_LevelEnd[l];
+    }
+
+    m_SlotNode.pop_back();
+    m_SlotParent.pop_back();
+    m_Local.pop_back();
+    m_World.pop_back();
+    m_Flags.pop_back();
+    while (!m_LevelEnd.empty() && m_LevelEnd.back() == levelStart(m_LevelEnd.size() - 1)) {
+        m_LevelEnd.pop_back();
+    }
+    return payload;
+}
+
+void TransformHierarchy::attach(std::uint32_t node, std::uint32_t level, const Detached& payload) {
+    if (level == m_LevelEnd.size()) m_LevelEnd.push_back(m_SlotNode.size());
+
+    m_SlotNode.push_back(node);
+    m_SlotParent.push_back(kNone);
+    m_Local.push_back(payload.local);
+    m_World.push_back(payload.world);
+    m_Flags.push_back(payload.flags);
+
+    // Open a hole at the end of `level` by walking back from the new last
+    // slot: each deeper level moves its first element to just past its end.
+    std::uint32_t hole = static_cast<std::uint32_t>(m_SlotNode.size() - 1);
+    for (std::size_t l = m_LevelEnd.size() - 1; l > level; --l) {
+        const std::uint32_t first = static_cast<std::uint32_t>(levelStart(l));
+        if (first != hole) moveSlot(first, hole);
+        hole = first;
+        ++m_LevelEnd[l];
+    }
+    ++m_LevelEnd[level];
+
+    m_SlotNode[hole] = node;
+    m_Local[hole] = payload.local;
+    m_World[hole] = payload.world;
+    m_Flags[hole] = payload.flags;
+    m_NodeSlot[node] = hole;
+    m_NodeDepth[node] = level;
+
+    const std::uint32_t parent = m_NodeParent[node];
+    m_SlotParent[hole] = parent == kNone ? kNone : m_NodeSlot[parent];
+    fixChildren(node);
+}
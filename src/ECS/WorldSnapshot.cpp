@@ -0,0 +1,41 @@
+#include "ECS/WorldSnapshot.h"
+
+#include <cassert>
+#include <stdexcept>
+
+void WorldSnapshot::Capture(Coordinator& coordinator) {
+    coordinator.assertNoParallelPass();
+    assert(coordinator.m_ArchetypeMask.none() && "WorldSnapshot doesn't cover archetype storage yet");
+    // Checked before anything is overwritten, so a refused capture leaves
+    // the previous one restorable.
+    if (!coordinator.m_ComponentManager->CanCapture()) {
+        throw std::logic_error("WorldSnapshot: a non-copyable component type has live components");
+    }
+
+    m_Arena.Clear();
+    coordinator.m_EntityManager->CaptureState(m_Arena);
+    coordinator.m_ComponentManager->CaptureState(m_Arena, m_Copies);
+    coordinator.m_SystemManager->CaptureState(m_Arena);
+    for (auto& hook : m_Hooks) hook->capture(coordinator, m_Arena);
+    m_HasCapture = true;
+}
+
+void WorldSnapshot::Restore(Coordinator& coordinator) {
+    if (!m_HasCapture) return;
+    coordinator.assertNoParallelPass();
+
+    // The change tick keeps counting forward: restored components are
+    // stamped with it so every change-driven consumer (HierarchySystem,
+    // render caches) sees the whole world as modified.
+    m_Arena.Rewind();
+    coordinator.m_EntityManager->RestoreState(m_Arena);
+    coordinator.m_ComponentManager->RestoreState(m_Arena, m_Copies, coordinator.m_ChangeTick);
+    coordinator.m_SystemManager->RestoreState(m_Arena);
+    for (auto& hook : m_Hooks) hook->restore(coordinator, m_Arena);
+}
+
+void WorldSnapshot::Clear() {
+    m_Arena.Clear();
+    m_Copies.clear();
+    m_HasCapture = false;
+}
@@ -120,6 +120,7 @@ void RenderProfilerWindow(Profiler& profiler) {
     ImGui::Text("FPS: %.1f (%.2f ms)", profiler.GetFPS(), profiler.GetFrameTimeMs());
     ImGui::Text("Draw Calls: %d", profiler.GetDrawCalls());
     ImGui::Text("Triangles: %d", profiler.GetTriangles());
+    ImGui::Text("Instance Groups: %d (%d instances)", profiler.GetInstanceGroups(), profiler.GetInstances());
 
     ImGui::PlotLines("FPS", profiler.GetFPSHistory(), profiler.GetFPSHistorySize(),
         profiler.GetFPSHistoryOffset(), nullptr, 0.0f, 120.0f, ImVec2(0, 60));
@@ -21,6 +21,7 @@ static GLuint getDummyWhiteTexture() {
 
 Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Texture>& textures)
     : vertices(vertices), indices(indices), textures(textures) {
+    for (const Vertex& v : vertices) m_LocalBounds.Merge(v.Position);
     setupMesh();
 }
 
@@ -32,7 +33,31 @@ Mesh::~Mesh() {
     }
 }
 
+const TriangleBVH& Mesh::GetBVH() const {
+    if (!m_Bvh) {
+        auto bvh = std::make_shared<TriangleBVH>();
+        if (!vertices.empty()) {
+            bvh->Build(&vertices[0].Position, sizeof(Vertex), vertices.size(),
+                       indices.empty() ? nullptr : indices.data(), indices.size());
+        }
+        m_Bvh = std::move(bvh);
+    }
+    return *m_Bvh;
+}
+
+bool Mesh::RaycastLocal(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const {
+    TriangleBVH::Hit hit;
+    if (!GetBVH().Intersect(origin, dir, maxT, hit)) return false;
+    t = hit.distance;
+    return true;
+}
+
 void Mesh::Draw(Shader& shader) {
+    BindState(shader);
+    DrawGeometry(shader);
+}
+
+void Mesh::BindState(Shader& shader) {
     // If we have a PBR material, use it
     if (pbrMaterial) {
         pbrMaterial->Bind(shader, 1);
@@ -73,13 +98,66 @@ void Mesh::Draw(Shader& shader) {
         }
         glActiveTexture(GL_TEXTURE0);
     }
+}
 
+void Mesh::DrawGeometry(Shader& /*shader*/) {
+    if (m_Geometry) {
+        auto* pool = Mist::Renderer::Geometry();
+        if (!pool) return;
+        pool->Bind();
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_Geometry->indexCount), GL_UNSIGNED_INT,
+                                 (void*)(std::size_t(m_Geometry->firstIndex) * sizeof(std::uint32_t)),
+                                 static_cast<GLint>(m_Geometry->baseVertex));
+        glBindVertexArray(0);
+        return;
+    }
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
+void Mesh::DrawInstanced(Shader& /*shader*/, std::uint32_t instanceBuffer, std::uint32_t firstInstance,
+                         std::uint32_t count) {
+    if (m_Geometry) {
+        auto* pool = Mist::Renderer::Geometry();
+        if (!pool) return;
+        pool->BindInstanceBuffer(instanceBuffer);
+        pool->Bind();
+        glDrawElementsInstancedBaseVertexBaseInstance(
+            GL_TRIANGLES, static_cast<GLsizei>(m_Geometry->indexCount), GL_UNSIGNED_INT,
+            (void*)(std::size_t(m_Geometry->firstIndex) * sizeof(std::uint32_t)), static_cast<GLsizei>(count),
+            static_cast<GLint>(m_Geometry->baseVertex), firstInstance);
+        glBindVertexArray(0);
+        return;
+    }
+    glBindVertexArray(VAO);
+    if (m_InstanceBuffer != instanceBuffer) {
+        // A mat4 attribute takes four vec4 locations; advancing once per
+        // instance, so base instance picks the batch's slice. The buffer
+        // is orphaned between uploads, never renamed, so this sticks.
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (unsigned int column = 0; column < 4; ++column) {
+            const GLuint location = kInstanceAttribute + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(sizeof(glm::vec4) * column));
+            glVertexAttribDivisor(location, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_InstanceBuffer = instanceBuffer;
+    }
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT,
+                                        0, static_cast<GLsizei>(count), firstInstance);
+    glBindVertexArray(0);
+}
+
 void Mesh::setupMesh() {
+    if (auto* pool = Mist::Renderer::Geometry()) {
+        m_Geometry = pool->Allocate(vertices.data(), static_cast<std::uint32_t>(vertices.size()),
+                                    indices.data(), static_cast<std::uint32_t>(indices.size()));
+        if (m_Geometry) return;
+    }
+
     auto* dev = static_cast<Mist::GPU::GLRenderingDevice*>(Mist::GPU::Device());
     // A Mesh constructed before Renderer::Init is an asset-pipeline bug —
     // below we fall through to leave VBO/EBO zero so the failure is noisy
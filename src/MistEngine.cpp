@@ -7,7 +7,9 @@
 #include <sys/stat.h>
 #include <vector>
 
+#include "Core/JobSystem.h"
 #include "Core/PathGuard.h"
+#include "Core/ServiceLocator.h"
 #include "InputManager.h"
 #include "Mesh.h"
 #include "ModuleManager.h"
@@ -29,9 +31,13 @@
 #include "ECS/Components/RenderComponent.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
+#include "ECS/SystemScheduler.h"
 #include "ECS/Systems/ECSPhysicsSystem.h"
 #include "ECS/Systems/HierarchySystem.h"
 #include "ECS/Systems/RenderSystem.h"
+#include "ECS/Systems/SpatialHashSystem.h"
+#include "ECS/Systems/SpatialIndexSystem.h"
 
 // Optional Lua scripting (G10 concrete).
 #if MIST_ENABLE_SCRIPTING
@@ -46,6 +52,7 @@
 // gCoordinator is defined in src/ECS/Coordinator.cpp so MistEngineLib exports
 // the symbol for tests and modules.
 extern Coordinator gCoordinator;
+extern EntityCommandBuffer gEntityCommands;
 
 // Global managers kept for the few callbacks that still need them.
 UIManager*      g_uiManager      = nullptr;
@@ -127,6 +134,8 @@ int main() {
     auto renderSystem     = gCoordinator.RegisterSystem<RenderSystem>();
     auto ecsPhysicsSystem = gCoordinator.RegisterSystem<ECSPhysicsSystem>();
     auto hierarchySystem  = gCoordinator.RegisterSystem<HierarchySystem>();
+    auto spatialIndex     = gCoordinator.RegisterSystem<SpatialIndexSystem>();
+    auto spatialHash      = gCoordinator.RegisterSystem<SpatialHashSystem>();
 #if MIST_ENABLE_SCRIPTING
     auto scriptSystem     = gCoordinator.RegisterSystem<ScriptSystem>();
 #endif
@@ -135,6 +144,13 @@ int main() {
     renderSignature.set(gCoordinator.GetComponentType<TransformComponent>());
     renderSignature.set(gCoordinator.GetComponentType<RenderComponent>());
     gCoordinator.SetSystemSignature<RenderSystem>(renderSignature);
+    gCoordinator.SetSystemSignature<SpatialIndexSystem>(renderSignature);
+    ServiceLocator::Instance().SetSpatialIndex(spatialIndex.get());
+
+    Signature transformSignature;
+    transformSignature.set(gCoordinator.GetComponentType<TransformComponent>());
+    gCoordinator.SetSystemSignature<SpatialHashSystem>(transformSignature);
+    ServiceLocator::Instance().SetSpatialHash(spatialHash.get());
 
     Signature physicsSignature;
     physicsSignature.set(gCoordinator.GetComponentType<TransformComponent>());
@@ -162,6 +178,9 @@ int main() {
 
     Renderer renderer(SCR_WIDTH, SCR_HEIGHT);
     if (!renderer.Init()) return -1;
+    // The GL context is current on this thread now; MainThread jobs (GPU
+    // uploads after a background load) run here and nowhere else.
+    Mist::JobSystem::Instance().BindMainThread();
 
     UIManager uiManager;
     g_uiManager = &uiManager;
@@ -262,6 +281,40 @@ int main() {
     std::cout << "=== Engine Initialization Complete ===" << std::endl;
     std::cout << "Editor ready. F1=Demo  F2=AI panel  F3=Scene editor  F=focus on selection" << std::endl;
 
+    // The per-frame stages between physics and render, on the JobSystem.
+    // Registration order is the frame order wherever two conflict; the
+    // undeclared ones (user callbacks, Lua, playback) conflict with
+    // everything and stay on this thread. Each stage reads what the one
+    // before it wrote, so today this is a chain, timed per stage in the
+    // profiler; a stage that declares disjoint access overlaps for free.
+    const auto hierarchyAccess = SystemAccess{}.Read<HierarchyComponent>().Write<TransformComponent>();
+    SystemScheduler frameSystems;
+    frameSystems.SetProfiler(&renderer.GetProfiler());
+    // Resolve parent→child transform chains into cachedGlobal, then fire
+    // any pending OnReady callbacks, before anything reads them.
+    frameSystems.AddSystem("Hierarchy", [&](float) { hierarchySystem->UpdateTransforms(gCoordinator); },
+                           hierarchyAccess);
+    frameSystems.AddSystem("OnReady", [&](float) { hierarchySystem->FireReadyCallbacks(gCoordinator); },
+                           SystemAccess{});
+    // Scripts' query_radius/query_box read this frame's positions.
+    frameSystems.AddSystem("SpatialHash", [&](float) { spatialHash->Update(gCoordinator); },
+                           SystemAccess{}.Read<TransformComponent>());
+#if MIST_ENABLE_SCRIPTING
+    // _process runs after _ready-via-OnReady so first-frame scripts see a
+    // live transform.
+    frameSystems.AddSystem("Scripts", [&](float dt) { scriptSystem->Update(gCoordinator, dt); }, SystemAccess{});
+#endif
+    // Sync point: spawns/destroys from _process and hierarchy callbacks
+    // are visible to this frame's render.
+    frameSystems.AddSystem("Playback", [&](float) { gEntityCommands.Playback(gCoordinator); }, SystemAccess{});
+    // Scripts may have moved hierarchy members; resolve cachedGlobal again
+    // (a no-op when nothing was stamped) before the index reads it, or the
+    // index consumes the stamp against last frame's value.
+    frameSystems.AddSystem("Hierarchy (post-script)",
+                           [&](float) { hierarchySystem->UpdateTransforms(gCoordinator); }, hierarchyAccess);
+    frameSystems.AddSystem("SpatialIndex", [&](float) { spatialIndex->Update(gCoordinator); },
+                           SystemAccess{}.Read<TransformComponent, RenderComponent, HierarchyComponent>());
+
     // Fixed-timestep physics. Decouples deterministic physics from the
     // variable-rate render frame: at 144 Hz display we still run physics at
     // 60 Hz, at 30 Hz display we catch up by stepping twice per frame.
@@ -307,6 +360,11 @@ int main() {
             ProcessLegacyPhysicsInput(renderer.GetWindow(), physicsSystem, scene.getPhysicsRenderables(), deltaTime);
         }
 
+        // Sync point: structural changes recorded since the last one (editor
+        // deletes during last frame's UI pass, bootstrap.lua spawns on the
+        // first frame) land before any system runs.
+        gEntityCommands.Playback(gCoordinator);
+
         moduleManager.UpdateModules(deltaTime);
 
         // Advance the physics clock in fixed-step chunks — see the
@@ -321,16 +379,10 @@ int main() {
             physicsAccumulator -= kPhysicsStep;
         }
 
-        // Resolve parent→child transform chains into cachedGlobal, then
-        // fire any pending OnReady callbacks, before rendering picks them up.
-        hierarchySystem->UpdateTransforms(gCoordinator);
-        hierarchySystem->FireReadyCallbacks(gCoordinator);
+        // Hierarchy, spatial structures and scripts; see frameSystems.
+        frameSystems.Execute(deltaTime);
 
-#if MIST_ENABLE_SCRIPTING
-        // _process runs after _ready-via-OnReady so first-frame scripts
-        // see a live transform. deltaTime is already clamped above.
-        scriptSystem->Update(gCoordinator, deltaTime);
-#endif
+        Mist::JobSystem::Instance().PumpMainThread();
 
         renderer.RenderWithECSAndUI(scene, renderSystem, &uiManager);
     }
@@ -5,6 +5,9 @@
 
 Model::Model(const std::string& path) {
     loadModel(path);
+    for (const Mesh& mesh : meshes) {
+        if (mesh.GetLocalBounds().IsValid()) m_LocalBounds.Merge(mesh.GetLocalBounds());
+    }
 }
 
 Model::~Model() {
@@ -16,6 +19,20 @@ void Model::Draw(Shader& shader) {
     }
 }
 
+bool Model::RaycastLocal(const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const {
+    // Meshes share the model's space; keep the nearest, shrinking the
+    // segment as hits come in.
+    bool found = false;
+    for (const Mesh& mesh : meshes) {
+        float hit = 0.0f;
+        if (mesh.RaycastLocal(origin, dir, maxT, hit)) {
+            maxT = t = hit;
+            found = true;
+        }
+    }
+    return found;
+}
+
 void Model::loadModel(const std::string& path) {
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(path,
@@ -10,6 +10,10 @@
 
 Orb::Orb(const glm::vec3& position, float radius, const glm::vec3& color)
     : position(position), radius(radius), color(color), indexCount(0) {
+    // Draw places the unit sphere itself rather than using the entity's
+    // model matrix.
+    m_LocalBounds.Merge(position - glm::vec3(radius));
+    m_LocalBounds.Merge(position + glm::vec3(radius));
     setupMesh();
 }
 
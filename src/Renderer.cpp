@@ -40,6 +40,11 @@ Renderer::~Renderer() {
     glDeleteFramebuffers(1, &depthMapFBO);
     glDeleteTextures(1, &depthMap);
 
+    // Meshes that outlive the renderer keep their handles; after this
+    // they free nothing and draw nothing.
+    Mist::Renderer::SetGeometry(nullptr);
+    m_GeometryPool.Shutdown();
+
     // Clear the global device before GL dies so any late dtor call that
     // still reaches for Device() sees nullptr instead of a dangling member.
     Mist::GPU::SetDevice(nullptr);
@@ -103,6 +108,8 @@ bool Renderer::Init() {
     // ShadowSystem) read `Mist::GPU::Device()` during their construction.
     Mist::GPU::SetDevice(&m_GpuDevice);
     LOG_INFO("Rendering backend: ", m_GpuDevice.GetBackendName());
+    // Meshes built from here on share the pool's buffers.
+    Mist::Renderer::SetGeometry(&m_GeometryPool);
 
     LOG_INFO("OpenGL Version: ", (const char*)glGetString(GL_VERSION));
     LOG_INFO("GLSL Version: ", (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION));
@@ -222,21 +229,38 @@ void Renderer::RenderWithECSAndUI(Scene& scene, std::shared_ptr<RenderSystem> re
     m_LightManager.UploadToGPU();
     m_LightManager.CullLights(view, projection);
 
+    // One ECS walk per frame: every pass below draws from this queue.
+    m_Profiler.BeginCPUSection("Extract");
+    renderSystem->Extract(camera.Position, camera.Front, 0.1f, 100.0f);
+    m_Profiler.EndCPUSection("Extract");
+
+    // Cascaded shadow maps; fitted before culling so each cascade is a view.
+    m_ShadowSystem.CalculateCascades(camera, glm::normalize(lightDir), 0.1f, 100.0f);
+
+    // One culling sweep for every view: views 0..NUM_CASCADES-1 are the
+    // cascades, the last is the camera (unjittered; jitter is sub-pixel).
+    const int cameraView = ShadowSystem::NUM_CASCADES;
+    glm::mat4 cullViews[ShadowSystem::NUM_CASCADES + 1];
+    for (int cascade = 0; cascade < ShadowSystem::NUM_CASCADES; cascade++) {
+        cullViews[cascade] = m_ShadowSystem.GetLightSpaceMatrix(cascade);
+    }
+    cullViews[cameraView] = projection * view;
+    m_Profiler.BeginCPUSection("Culling");
+    renderSystem->Cull(cullViews, ShadowSystem::NUM_CASCADES + 1);
+    m_Profiler.EndCPUSection("Culling");
+
     // === SHADOW PASS ===
     m_Profiler.BeginCPUSection("Shadows");
     m_Profiler.BeginGPUSection("Shadows");
 
-    // Cascaded shadow maps
-    m_ShadowSystem.CalculateCascades(camera, glm::normalize(lightDir), 0.1f, 100.0f);
-
     Shader& csmDepthShader = depthShader; // Reuse depth shader for CSM
     for (int cascade = 0; cascade < ShadowSystem::NUM_CASCADES; cascade++) {
         m_ShadowSystem.BeginShadowPass(cascade);
         csmDepthShader.use();
         csmDepthShader.setMat4("lightSpaceMatrix", m_ShadowSystem.GetLightSpaceMatrix(cascade));
 
-        // Render ECS entities to shadow map
-        renderSystem->Update(csmDepthShader);
+        // Render ECS entities to shadow map (depth only: no materials)
+        renderSystem->Draw(csmDepthShader, Mist::Renderer::kPassShadow, false, cascade);
 
         // Render legacy physics objects to shadow map
         for (auto& obj : scene.getPhysicsRenderables()) {
@@ -342,8 +366,9 @@ void Renderer::RenderWithECSAndUI(Scene& scene, std::shared_ptr<RenderSystem> re
     }
 
     // Render ECS entities
-    renderSystem->Update(mainShader);
-    m_Profiler.IncrementDrawCalls(1); // Approximate
+    const auto sceneStats = renderSystem->Draw(mainShader, Mist::Renderer::kPassMain, true, cameraView);
+    m_Profiler.IncrementDrawCalls(static_cast<int>(sceneStats.draws));
+    m_Profiler.AddInstanceGroups(static_cast<int>(sceneStats.instanceGroups), static_cast<int>(sceneStats.instances));
 
     // Render legacy scene objects
     for (auto& obj : scene.getPhysicsRenderables()) {
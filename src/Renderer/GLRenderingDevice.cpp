@@ -27,10 +27,11 @@ GLenum toGLInternalFormat(TextureFormat f) {
 
 GLenum toGLBufferTarget(BufferUsage u) {
     switch (u) {
-        case BufferUsage::Vertex:  return GL_ARRAY_BUFFER;
-        case BufferUsage::Index:   return GL_ELEMENT_ARRAY_BUFFER;
-        case BufferUsage::Uniform: return GL_UNIFORM_BUFFER;
-        case BufferUsage::Storage: return GL_SHADER_STORAGE_BUFFER;
+        case BufferUsage::Vertex:   return GL_ARRAY_BUFFER;
+        case BufferUsage::Index:    return GL_ELEMENT_ARRAY_BUFFER;
+        case BufferUsage::Uniform:  return GL_UNIFORM_BUFFER;
+        case BufferUsage::Storage:  return GL_SHADER_STORAGE_BUFFER;
+        case BufferUsage::Indirect: return GL_DRAW_INDIRECT_BUFFER;
     }
     return GL_ARRAY_BUFFER;
 }
@@ -57,10 +58,7 @@ RID GLRenderingDevice::CreateTexture(const TextureDesc& desc) {
                        static_cast<GLsizei>(desc.width),
                        static_cast<GLsizei>(desc.height));
 
-    const RID rid{m_NextId.fetch_add(1)};
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Live[rid.id] = Entry{Kind::Texture, tex};
-    return rid;
+    return track(Kind::Texture, tex);
 }
 
 RID GLRenderingDevice::CreateTextureArray(const TextureArrayDesc& desc) {
@@ -72,10 +70,7 @@ RID GLRenderingDevice::CreateTextureArray(const TextureArrayDesc& desc) {
                        static_cast<GLsizei>(desc.height),
                        static_cast<GLsizei>(desc.layers));
 
-    const RID rid{m_NextId.fetch_add(1)};
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Live[rid.id] = Entry{Kind::TextureArray, tex};
-    return rid;
+    return track(Kind::TextureArray, tex);
 }
 
 RID GLRenderingDevice::CreateBuffer(const BufferDesc& desc) {
@@ -89,10 +84,7 @@ RID GLRenderingDevice::CreateBuffer(const BufferDesc& desc) {
     }
     (void)toGLBufferTarget; // reserved for bindings; not used at create time
 
-    const RID rid{m_NextId.fetch_add(1)};
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Live[rid.id] = Entry{Kind::Buffer, buf};
-    return rid;
+    return track(Kind::Buffer, buf);
 }
 
 RID GLRenderingDevice::CreateShader(const ShaderDesc& desc) {
@@ -101,10 +93,7 @@ RID GLRenderingDevice::CreateShader(const ShaderDesc& desc) {
         glShaderSource(sh, 1, &desc.source, nullptr);
         glCompileShader(sh);
     }
-    const RID rid{m_NextId.fetch_add(1)};
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Live[rid.id] = Entry{Kind::Shader, sh};
-    return rid;
+    return track(Kind::Shader, sh);
 }
 
 RID GLRenderingDevice::CreateShaderProgram(const ProgramDesc& desc) {
@@ -114,9 +103,8 @@ RID GLRenderingDevice::CreateShaderProgram(const ProgramDesc& desc) {
     {
         std::lock_guard<std::mutex> lock(m_Mutex);
         auto resolve = [&](RID r) -> GLuint {
-            if (!r.IsValid()) return 0;
-            auto it = m_Live.find(r.id);
-            return it == m_Live.end() ? 0u : it->second.glHandle;
+            const Entry* entry = lookup(r);
+            return entry ? entry->glHandle : 0u;
         };
         vs = resolve(desc.vertex);
         fs = resolve(desc.fragment);
@@ -136,10 +124,7 @@ RID GLRenderingDevice::CreateShaderProgram(const ProgramDesc& desc) {
         if (fs) glDetachShader(prog, fs);
     }
 
-    const RID rid{m_NextId.fetch_add(1)};
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Live[rid.id] = Entry{Kind::Program, prog};
-    return rid;
+    return track(Kind::Program, prog);
 }
 
 void GLRenderingDevice::Destroy(RID rid) {
@@ -147,10 +132,10 @@ void GLRenderingDevice::Destroy(RID rid) {
     Entry e{};
     {
         std::lock_guard<std::mutex> lock(m_Mutex);
-        auto it = m_Live.find(rid.id);
-        if (it == m_Live.end()) return;
-        e = it->second;
-        m_Live.erase(it);
+        const Entry* entry = lookup(rid);
+        if (!entry) return;
+        e = *entry;
+        m_Live.Erase(Mist::SlotMapKey::Unpack(rid.id));
     }
 
     switch (e.kind) {
@@ -166,8 +151,18 @@ void GLRenderingDevice::Destroy(RID rid) {
 std::uint32_t GLRenderingDevice::GetGLHandle(RID rid) const {
     if (!rid.IsValid()) return 0;
     std::lock_guard<std::mutex> lock(m_Mutex);
-    auto it = m_Live.find(rid.id);
-    return it == m_Live.end() ? 0u : it->second.glHandle;
+    const Entry* entry = lookup(rid);
+    return entry ? entry->glHandle : 0u;
+}
+
+RID GLRenderingDevice::track(Kind kind, std::uint32_t glHandle) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return RID{m_Live.Insert(Entry{kind, glHandle}).Pack()};
+}
+
+// Caller holds m_Mutex.
+const GLRenderingDevice::Entry* GLRenderingDevice::lookup(RID rid) const {
+    return m_Live.Get(Mist::SlotMapKey::Unpack(rid.id));
 }
 
 } // namespace Mist::GPU
@@ -0,0 +1,194 @@
+#include "Renderer/GeometryPool.h"
+
+#include "Mesh.h"
+#include "Renderer/GLRenderingDevice.h"
+#include "Renderer/RenderingDevice.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+
+namespace Mist::Renderer {
+
+namespace {
+
+GeometryPool* g_geometry = nullptr;
+
+} // namespace
+
+GeometryPool* Geometry()                  { return g_geometry; }
+void          SetGeometry(GeometryPool* p) { g_geometry = p; }
+
+GeometryPool::~GeometryPool() {
+    Shutdown();
+}
+
+void GeometryPool::Shutdown() {
+    m_Self = std::make_shared<GeometryPool*>(this);
+    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
+    if (auto* dev = Mist::GPU::Device()) {
+        if (m_VboRid.IsValid()) dev->Destroy(m_VboRid);
+        if (m_EboRid.IsValid()) dev->Destroy(m_EboRid);
+    }
+    m_VboRid = RID{};
+    m_EboRid = RID{};
+    m_VBO = m_EBO = m_VAO = 0;
+    m_InstanceBuffer = 0;
+    m_Vertices = Mist::RangeAllocator();
+    m_Indices = Mist::RangeAllocator();
+}
+
+GeometryHandle GeometryPool::Allocate(const Vertex* vertices, std::uint32_t vertexCount,
+                                      const std::uint32_t* indices, std::uint32_t indexCount) {
+    if (vertexCount == 0 || indexCount == 0) return nullptr;
+    if (!reserve(vertexCount, indexCount)) return nullptr;
+
+    GeometryRange range;
+    range.baseVertex = m_Vertices.Allocate(vertexCount);
+    range.vertexCount = vertexCount;
+    range.firstIndex = m_Indices.Allocate(indexCount);
+    range.indexCount = indexCount;
+
+    glNamedBufferSubData(m_VBO, static_cast<GLintptr>(std::size_t(range.baseVertex) * sizeof(Vertex)),
+                         static_cast<GLsizeiptr>(std::size_t(vertexCount) * sizeof(Vertex)), vertices);
+    glNamedBufferSubData(m_EBO, static_cast<GLintptr>(std::size_t(range.firstIndex) * sizeof(std::uint32_t)),
+                         static_cast<GLsizeiptr>(std::size_t(indexCount) * sizeof(std::uint32_t)), indices);
+
+    // Copies of a Mesh share the handle; the last one out frees the range,
+    // unless the pool was shut down (or destroyed) first.
+    std::weak_ptr<GeometryPool*> owner = m_Self;
+    return GeometryHandle(new GeometryRange(range), [owner](const GeometryRange* r) {
+        if (auto pool = owner.lock()) (*pool)->free(*r);
+        delete r;
+    });
+}
+
+void GeometryPool::free(const GeometryRange& range) {
+    m_Vertices.Free(range.baseVertex, range.vertexCount);
+    m_Indices.Free(range.firstIndex, range.indexCount);
+}
+
+bool GeometryPool::reserve(std::uint32_t vertexCount, std::uint32_t indexCount) {
+    if (!m_VAO) createVAO();
+    if (!m_VAO) return false;
+
+    // The grown tail alone fits the request, however fragmented the rest.
+    if (m_Vertices.LargestFree() < vertexCount) {
+        const std::uint32_t capacity =
+            std::max({m_Vertices.Capacity() * 2, m_Vertices.Capacity() + vertexCount, kMinVertices});
+        if (!growBuffer(m_VboRid, m_VBO, std::size_t(m_Vertices.Capacity()) * sizeof(Vertex),
+                        std::size_t(capacity) * sizeof(Vertex), false)) {
+            return false;
+        }
+        m_Vertices.Grow(capacity);
+    }
+    if (m_Indices.LargestFree() < indexCount) {
+        const std::uint32_t capacity =
+            std::max({m_Indices.Capacity() * 2, m_Indices.Capacity() + indexCount, kMinIndices});
+        if (!growBuffer(m_EboRid, m_EBO, std::size_t(m_Indices.Capacity()) * sizeof(std::uint32_t),
+                        std::size_t(capacity) * sizeof(std::uint32_t), true)) {
+            return false;
+        }
+        m_Indices.Grow(capacity);
+    }
+    return true;
+}
+
+bool GeometryPool::growBuffer(RID& rid, std::uint32_t& handle, std::size_t oldBytes, std::size_t newBytes,
+                              bool index) {
+    auto* dev = static_cast<Mist::GPU::GLRenderingDevice*>(Mist::GPU::Device());
+    if (!dev) return false;
+
+    Mist::GPU::BufferDesc desc{};
+    desc.size_bytes = newBytes;
+    desc.usage = index ? Mist::GPU::BufferUsage::Index : Mist::GPU::BufferUsage::Vertex;
+    const RID grown = dev->CreateBuffer(desc);
+    const std::uint32_t grownHandle = dev->GetGLHandle(grown);
+    if (!grownHandle) return false;
+
+    // GPU-side copy: no readback, and draws already queued against the
+    // old buffer finish before the driver lets it go.
+    if (handle && oldBytes > 0) {
+        glCopyNamedBufferSubData(handle, grownHandle, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+    }
+    if (rid.IsValid()) dev->Destroy(rid);
+    rid = grown;
+    handle = grownHandle;
+
+    if (index) {
+        glVertexArrayElementBuffer(m_VAO, handle);
+    } else {
+        glVertexArrayVertexBuffer(m_VAO, 0, handle, 0, sizeof(Vertex));
+    }
+    return true;
+}
+
+void GeometryPool::createVAO() {
+    if (!Mist::GPU::Device()) return;
+    glCreateVertexArrays(1, &m_VAO);
+
+    // Same locations as Mesh's own VAO, all from binding 0.
+    const struct {
+        GLuint location;
+        GLint size;
+        std::size_t offset;
+    } attributes[] = {
+        {0, 3, offsetof(Vertex, Position)},
+        {1, 3, offsetof(Vertex, Normal)},
+        {2, 2, offsetof(Vertex, TexCoords)},
+        {3, 3, offsetof(Vertex, Tangent)},
+        {4, 3, offsetof(Vertex, Bitangent)},
+    };
+    for (const auto& a : attributes) {
+        glEnableVertexArrayAttrib(m_VAO, a.location);
+        glVertexArrayAttribFormat(m_VAO, a.location, a.size, GL_FLOAT, GL_FALSE, static_cast<GLuint>(a.offset));
+        glVertexArrayAttribBinding(m_VAO, a.location, 0);
+    }
+
+    // Instance matrix columns from binding 1, one mat4 per instance;
+    // enabled once an instance buffer is bound.
+    for (GLuint column = 0; column < 4; ++column) {
+        const GLuint location = Mesh::kInstanceAttribute + column;
+        glVertexArrayAttribFormat(m_VAO, location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4) * column);
+        glVertexArrayAttribBinding(m_VAO, location, 1);
+    }
+    glVertexArrayBindingDivisor(m_VAO, 1, 1);
+}
+
+void GeometryPool::Bind() const {
+    glBindVertexArray(m_VAO);
+}
+
+void GeometryPool::MultiDrawIndirect(std::uint32_t commandBuffer, std::uint32_t drawDataBuffer,
+                                     std::uint32_t firstCommand, std::uint32_t commandCount) {
+    if (!m_VAO || !commandBuffer || commandCount == 0) return;
+    // Matrices come from the SSBO; the instance attributes would read
+    // past the end of whatever instance buffer they last pointed at.
+    BindInstanceBuffer(0);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawDataBinding, drawDataBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                (const void*)(std::size_t(firstCommand) * sizeof(DrawElementsIndirectCommand)),
+                                static_cast<GLsizei>(commandCount), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GeometryPool::BindInstanceBuffer(std::uint32_t instanceBuffer) {
+    if (!m_VAO || instanceBuffer == m_InstanceBuffer) return;
+    // Both directions matter: an enabled attribute over a buffer shorter
+    // than the draw's instances reads out of bounds.
+    for (GLuint column = 0; column < 4; ++column) {
+        const GLuint location = Mesh::kInstanceAttribute + column;
+        if (instanceBuffer) {
+            glEnableVertexArrayAttrib(m_VAO, location);
+        } else {
+            glDisableVertexArrayAttrib(m_VAO, location);
+        }
+    }
+    if (instanceBuffer) glVertexArrayVertexBuffer(m_VAO, 1, instanceBuffer, 0, sizeof(glm::mat4));
+    m_InstanceBuffer = instanceBuffer;
+}
+
+} // namespace Mist::Renderer
@@ -0,0 +1,287 @@
+#include "Renderer/RenderQueue.h"
+
+#include "Renderable.h"
+#include "Renderer/GeometryPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Mist::Renderer {
+
+std::uint64_t DrawKey::Make(std::uint32_t shader, std::uint32_t material, std::uint32_t mesh, std::uint32_t depth) {
+    constexpr std::uint32_t kShaderMax = (1u << kShaderBits) - 1;
+    constexpr std::uint32_t kMaterialMax = (1u << kMaterialBits) - 1;
+    constexpr std::uint32_t kMeshMax = (1u << kMeshBits) - 1;
+    constexpr std::uint32_t kDepthMax = (1u << kDepthBits) - 1;
+    return std::uint64_t(std::min(shader, kShaderMax)) << 52
+         | std::uint64_t(std::min(material, kMaterialMax)) << 36
+         | std::uint64_t(std::min(mesh, kMeshMax)) << 20
+         | std::uint64_t(std::min(depth, kDepthMax));
+}
+
+void RenderQueue::Begin(const glm::vec3& eye, const glm::vec3& forward, float nearPlane, float farPlane) {
+    m_Items.clear();
+    m_Transforms.clear();
+    m_Bounds.Clear();
+    m_Order.clear();
+    m_ShaderIds.clear();
+    m_MaterialIds.clear();
+    m_MeshIds.clear();
+
+    m_Eye = eye;
+    const float length = std::sqrt(glm::dot(forward, forward));
+    m_Forward = length > 0.0f ? forward / length : glm::vec3(0.0f, 0.0f, -1.0f);
+    m_Near = nearPlane;
+    m_InvRange = farPlane > nearPlane ? 1.0f / (farPlane - nearPlane) : 0.0f;
+}
+
+std::uint32_t RenderQueue::Add(Renderable* renderable, const PBRMaterial* material, const glm::mat4& world,
+                               std::uint32_t passMask, Entity entity, const void* shader) {
+    const auto index = static_cast<std::uint32_t>(m_Items.size());
+    glm::vec3 center(world[3]);
+    if (renderable && renderable->GetLocalBounds().IsValid()) {
+        const AABB bounds = renderable->GetLocalBounds().Transform(world);
+        center = bounds.Center();
+        m_Bounds.Push(bounds);
+    } else {
+        m_Bounds.Push(AABB{glm::vec3(std::numeric_limits<float>::lowest()),
+                           glm::vec3(std::numeric_limits<float>::max())});
+    }
+
+    DrawItem item;
+    item.key = DrawKey::Make(denseId(m_ShaderIds, shader), denseId(m_MaterialIds, material),
+                             denseId(m_MeshIds, renderable), depthBits(center));
+    item.renderable = renderable;
+    item.material = material;
+    item.transform = static_cast<std::uint32_t>(m_Transforms.size());
+    item.passMask = passMask;
+    item.entity = entity;
+    m_Items.push_back(item);
+    m_Transforms.push_back(world);
+    // Until Sort, draw order is submission order.
+    m_Order.push_back(index);
+    return index;
+}
+
+void RenderQueue::Sort() {
+    const std::size_t count = m_Items.size();
+    m_SortKeys.resize(count);
+    m_SortScratch.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        m_SortKeys[i] = {m_Items[i].key, static_cast<std::uint32_t>(i)};
+    }
+
+    // One histogram pass for all eight bytes, then a scatter per byte that
+    // actually varies; keys from one frame share most of their high bits,
+    // so several digits usually drop out.
+    std::uint32_t histogram[8][256] = {};
+    for (const SortEntry& entry : m_SortKeys) {
+        for (int digit = 0; digit < 8; ++digit) ++histogram[digit][(entry.key >> (digit * 8)) & 0xFF];
+    }
+
+    SortEntry* from = m_SortKeys.data();
+    SortEntry* to = m_SortScratch.data();
+    for (int digit = 0; digit < 8; ++digit) {
+        std::uint32_t* counts = histogram[digit];
+        const int shift = digit * 8;
+        if (count == 0 || counts[(from[0].key >> shift) & 0xFF] == count) continue;
+
+        std::uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            const std::uint32_t n = counts[bucket];
+            counts[bucket] = offset;
+            offset += n;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            to[counts[(from[i].key >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+
+    m_Order.resize(count);
+    for (std::size_t i = 0; i < count; ++i) m_Order[i] = from[i].item;
+}
+
+SubmitStats RenderQueue::Submit(std::uint32_t passMask, DrawSink& sink, bool bindMaterials,
+                                const VisibilityBitset* visible) const {
+    SubmitStats stats;
+    const PBRMaterial* bound = nullptr;
+    ForEach(passMask, [&](const DrawItem& item) {
+        // A shared material binds once per run. Items without one bind
+        // their own state, and that state is theirs alone, so the next
+        // material has to rebind after them.
+        if (bindMaterials && (!item.material || item.material != bound)) {
+            sink.BindMaterial(item);
+            bound = item.material;
+            ++stats.materialBinds;
+        }
+        sink.Draw(item, m_Transforms[item.transform]);
+        ++stats.draws;
+    }, visible);
+    return stats;
+}
+
+void RenderQueue::BuildDrawList(std::uint32_t passMask, std::uint32_t minInstances, DrawList& list,
+                                const VisibilityBitset* visible) const {
+    list.Clear();
+    for (std::uint32_t index : m_Order) {
+        if ((m_Items[index].passMask & passMask) && (!visible || visible->Test(index))) list.items.push_back(index);
+    }
+
+    // Equal keys sort together, but ids saturate, so runs are cut on the
+    // pointers themselves.
+    const std::size_t count = list.items.size();
+    for (std::size_t begin = 0, end = 0; begin < count; begin = end) {
+        const DrawItem& first = m_Items[list.items[begin]];
+        end = begin + 1;
+        while (end < count && m_Items[list.items[end]].renderable == first.renderable
+               && m_Items[list.items[end]].material == first.material) {
+            ++end;
+        }
+
+        const auto run = static_cast<std::uint32_t>(end - begin);
+        if (minInstances > 0 && run >= minInstances && first.renderable
+            && first.renderable->SupportsInstancing()) {
+            DrawBatch batch;
+            batch.item = list.items[begin];
+            batch.firstInstance = static_cast<std::uint32_t>(list.instances.size());
+            batch.count = run;
+            batch.instanced = true;
+            for (std::size_t i = begin; i < end; ++i) {
+                list.instances.push_back(m_Transforms[m_Items[list.items[i]].transform]);
+            }
+            list.batches.push_back(batch);
+        } else {
+            for (std::size_t i = begin; i < end; ++i) {
+                DrawBatch batch;
+                batch.item = list.items[i];
+                list.batches.push_back(batch);
+            }
+        }
+    }
+}
+
+SubmitStats RenderQueue::Submit(const DrawList& list, DrawSink& sink, bool bindMaterials) const {
+    SubmitStats stats;
+    const PBRMaterial* bound = nullptr;
+    for (const DrawBatch& batch : list.batches) {
+        const DrawItem& item = m_Items[batch.item];
+        if (bindMaterials && (!item.material || item.material != bound)) {
+            sink.BindMaterial(item);
+            bound = item.material;
+            ++stats.materialBinds;
+        }
+        if (batch.instanced) {
+            sink.DrawInstanced(item, batch.firstInstance, batch.count);
+            ++stats.instanceGroups;
+            stats.instances += batch.count;
+        } else {
+            sink.Draw(item, m_Transforms[item.transform]);
+        }
+        ++stats.draws;
+    }
+    return stats;
+}
+
+void RenderQueue::BuildIndirectList(std::uint32_t passMask, bool splitByMaterial, IndirectList& list,
+                                    const VisibilityBitset* visible) const {
+    list.Clear();
+    // Batch and renderable the next item may extend; -1 after an unpooled
+    // item, so key order is kept around it.
+    std::int64_t open = -1;
+    const Renderable* lastRenderable = nullptr;
+
+    ForEach(passMask, [&](const DrawItem& item) {
+        const auto index = static_cast<std::uint32_t>(&item - m_Items.data());
+        const GeometryRange* range = item.renderable ? item.renderable->GetGeometryRange() : nullptr;
+        if (!range || !range->IsValid()) {
+            IndirectBatch single;
+            single.item = index;
+            list.batches.push_back(single);
+            open = -1;
+            return;
+        }
+
+        // Same rule as binding: an item without a shared material brings
+        // state only its own renderable shares.
+        if (open >= 0 && splitByMaterial) {
+            const DrawItem& first = m_Items[list.batches[open].item];
+            if (item.material != first.material || (!item.material && item.renderable != first.renderable)) {
+                open = -1;
+            }
+        }
+        if (open < 0) {
+            IndirectBatch batch;
+            batch.item = index;
+            batch.firstCommand = static_cast<std::uint32_t>(list.commands.size());
+            batch.indirect = true;
+            list.batches.push_back(batch);
+            open = static_cast<std::int64_t>(list.batches.size() - 1);
+            lastRenderable = nullptr;
+        }
+
+        // drawData grows with every item, so a run's matrices stay
+        // contiguous from its command's baseInstance.
+        IndirectBatch& batch = list.batches[open];
+        if (batch.commandCount > 0 && item.renderable == lastRenderable) {
+            ++list.commands.back().instanceCount;
+        } else {
+            DrawElementsIndirectCommand command;
+            command.count = range->indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = range->firstIndex;
+            command.baseVertex = static_cast<std::int32_t>(range->baseVertex);
+            command.baseInstance = static_cast<std::uint32_t>(list.drawData.size());
+            list.commands.push_back(command);
+            ++batch.commandCount;
+            lastRenderable = item.renderable;
+        }
+        list.drawData.push_back(m_Transforms[item.transform]);
+    }, visible);
+}
+
+SubmitStats RenderQueue::Submit(const IndirectList& list, DrawSink& sink, bool bindMaterials) const {
+    SubmitStats stats;
+    const PBRMaterial* bound = nullptr;
+    for (const IndirectBatch& batch : list.batches) {
+        const DrawItem& item = m_Items[batch.item];
+        if (bindMaterials && (!item.material || item.material != bound)) {
+            sink.BindMaterial(item);
+            bound = item.material;
+            ++stats.materialBinds;
+        }
+        if (batch.indirect) {
+            sink.DrawIndirect(item, batch.firstCommand, batch.commandCount);
+            stats.indirectCommands += batch.commandCount;
+            for (std::uint32_t c = batch.firstCommand; c < batch.firstCommand + batch.commandCount; ++c) {
+                if (list.commands[c].instanceCount < 2) continue;
+                ++stats.instanceGroups;
+                stats.instances += list.commands[c].instanceCount;
+            }
+        } else {
+            sink.Draw(item, m_Transforms[item.transform]);
+        }
+        ++stats.draws;
+    }
+    return stats;
+}
+
+std::uint32_t RenderQueue::denseId(Mist::FlatHashMap<const void*, std::uint32_t>& ids, const void* ptr) {
+    // 0 stays free for "none" so null pointers sort together and first.
+    if (!ptr) return 0;
+    const auto [it, inserted] = ids.try_emplace(ptr, static_cast<std::uint32_t>(ids.size()) + 1);
+    return it->second;
+}
+
+std::uint32_t RenderQueue::depthBits(const glm::vec3& center) const {
+    // Behind the near plane clamps to 0, past the far plane to the top;
+    // NaN lands on 0 as well.
+    const float t = (glm::dot(center - m_Eye, m_Forward) - m_Near) * m_InvRange;
+    constexpr float kScale = float((1u << DrawKey::kDepthBits) - 1);
+    if (!(t > 0.0f)) return 0;
+    if (t >= 1.0f) return (1u << DrawKey::kDepthBits) - 1;
+    return static_cast<std::uint32_t>(t * kScale);
+}
+
+} // namespace Mist::Renderer
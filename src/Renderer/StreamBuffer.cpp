@@ -0,0 +1,37 @@
+#include "Renderer/StreamBuffer.h"
+
+#include "Renderer/GLRenderingDevice.h"
+#include "Renderer/RenderingDevice.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace Mist::Renderer {
+
+StreamBuffer::~StreamBuffer() {
+    if (auto* dev = Mist::GPU::Device()) {
+        if (m_Rid.IsValid()) dev->Destroy(m_Rid);
+    }
+}
+
+void StreamBuffer::Upload(const void* data, std::size_t bytes) {
+    if (bytes == 0) return;
+
+    if (!m_Handle) {
+        auto* dev = static_cast<Mist::GPU::GLRenderingDevice*>(Mist::GPU::Device());
+        if (!dev) return;
+        Mist::GPU::BufferDesc desc{};
+        desc.usage = Mist::GPU::BufferUsage::Vertex;
+        m_Rid = dev->CreateBuffer(desc);
+        m_Handle = dev->GetGLHandle(m_Rid);
+        if (!m_Handle) return;
+    }
+
+    // Orphan (or grow) first: the driver hands back fresh storage and
+    // retires the old block once the GPU is done with it.
+    if (bytes > m_Capacity) m_Capacity = std::max({bytes, m_Capacity * 2, kMinCapacity});
+    glNamedBufferData(m_Handle, static_cast<GLsizeiptr>(m_Capacity), nullptr, GL_STREAM_DRAW);
+    glNamedBufferSubData(m_Handle, 0, static_cast<GLsizeiptr>(bytes), data);
+}
+
+} // namespace Mist::Renderer
@@ -0,0 +1,380 @@
+#include "Scene/DynamicAABBTree.h"
+
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace {
+
+AABB Union(const AABB& a, const AABB& b) {
+    AABB result = a;
+    result.Merge(b);
+    return result;
+}
+
+// Squared distance from `p` to the closest point of `box`; 0 inside.
+float DistanceSq(const AABB& box, const glm::vec3& p) {
+    const glm::vec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+    return glm::dot(d, d);
+}
+
+} // namespace
+
+AABB DynamicAABBTree::fatten(const AABB& bounds, const glm::vec3& displacement) {
+    AABB fat{bounds.min - glm::vec3(kFatMargin), bounds.max + glm::vec3(kFatMargin)};
+    const glm::vec3 lead = displacement * kDisplacementMultiplier;
+    fat.min += glm::min(lead, glm::vec3(0.0f));
+    fat.max += glm::max(lead, glm::vec3(0.0f));
+    return fat;
+}
+
+void DynamicAABBTree::Insert(Entity entity, const AABB& bounds) {
+    // Any leaf under this index belongs to this entity or a stale handle
+    // of it; the slot may also have been reused for an internal node.
+    const std::uint32_t existing = m_Index.Get(entity);
+    if (existing != SparseEntityIndex::kInvalid && m_Nodes[existing].height == 0 &&
+        EntityIndex(m_Nodes[existing].entity) == EntityIndex(entity)) {
+        Remove(m_Nodes[existing].entity);
+    }
+
+    const std::int32_t leaf = allocateNode();
+    Node& node = m_Nodes[leaf];
+    node.entity = entity;
+    node.box = fatten(bounds, glm::vec3(0.0f));
+    m_Tight[leaf] = bounds;
+    m_Index.Slot(entity) = static_cast<std::uint32_t>(leaf);
+    ++m_LeafCount;
+    insertLeaf(leaf, m_Root);
+}
+
+bool DynamicAABBTree::Remove(Entity entity) {
+    const std::int32_t leaf = leafOf(entity);
+    if (leaf == kNull) return false;
+    removeLeaf(leaf);
+    freeNode(leaf);
+    m_Index.Slot(entity) = SparseEntityIndex::kInvalid;
+    --m_LeafCount;
+    return true;
+}
+
+bool DynamicAABBTree::Move(Entity entity, const AABB& bounds, const glm::vec3& displacement) {
+    const std::int32_t leaf = leafOf(entity);
+    if (leaf == kNull) {
+        Insert(entity, bounds);
+        return true;
+    }
+    Node& node = m_Nodes[leaf];
+    m_Tight[leaf] = bounds;
+
+    const AABB fat = fatten(bounds, displacement);
+    if (node.box.Contains(bounds)) {
+        // Still covered. Keep the old fat box unless it is well past what
+        // this move needs on some side (a fast mover that stopped would
+        // otherwise keep overlapping everything it once swept through).
+        // The slack includes the lead, so a steady mover's trailing edge
+        // doesn't count as too large.
+        const glm::vec3 slack = glm::vec3(4.0f * kFatMargin) + glm::abs(displacement) * kDisplacementMultiplier;
+        const AABB loose{fat.min - slack, fat.max + slack};
+        if (loose.Contains(node.box)) return false;
+    }
+
+    // Start the descent at the lowest ancestor that already covers the new
+    // box rather than at the root: a moving entity usually lands a few
+    // levels from where it was, and that part of the tree is in cache.
+    std::int32_t start = m_Nodes[leaf].parent;
+    while (start != kNull && !m_Nodes[start].box.Contains(fat)) start = m_Nodes[start].parent;
+    const std::int32_t parent = m_Nodes[leaf].parent;
+    const std::int32_t sibling = removeLeaf(leaf);
+    if (start == parent) start = sibling; // the parent is gone; the sibling took its place
+    m_Nodes[leaf].box = fat;
+    insertLeaf(leaf, start == kNull ? m_Root : start);
+    return true;
+}
+
+void DynamicAABBTree::Clear() {
+    m_Nodes.clear();
+    m_Tight.clear();
+    m_Root = kNull;
+    m_FreeList = kNull;
+    m_LeafCount = 0;
+    m_Index.Clear();
+}
+
+bool DynamicAABBTree::RaycastClosest(const glm::vec3& origin, const glm::vec3& direction,
+                                     float maxDistance, RayHit& hit) const {
+    if (m_Root == kNull) return false;
+    const Ray ray(origin, direction);
+    float best = maxDistance;
+    bool found = false;
+
+    // Nearer child first; anything entered beyond the best hit so far is
+    // skipped, which prunes most of the tree once a hit is in hand.
+    Mist::SmallVector<std::pair<std::int32_t, float>, 64> stack;
+    float t = 0.0f;
+    if (ray.Hit(m_Nodes[m_Root].box, best, t)) stack.push_back({m_Root, t});
+    while (!stack.empty()) {
+        const auto [index, entry] = stack.back();
+        stack.pop_back();
+        if (entry > best) continue;
+        const Node& node = m_Nodes[index];
+        if (node.IsLeaf()) {
+            if (ray.Hit(m_Tight[index], best, t) && (!found || t < best)) {
+                best = t;
+                hit = {node.entity, t};
+                found = true;
+            }
+            continue;
+        }
+        float tl = 0.0f, tr = 0.0f;
+        const bool hitL = ray.Hit(m_Nodes[node.left].box, best, tl);
+        const bool hitR = ray.Hit(m_Nodes[node.right].box, best, tr);
+        if (hitL && hitR) {
+            if (tl < tr) {
+                stack.push_back({node.right, tr});
+                stack.push_back({node.left, tl});
+            } else {
+                stack.push_back({node.left, tl});
+                stack.push_back({node.right, tr});
+            }
+        } else if (hitL) {
+            stack.push_back({node.left, tl});
+        } else if (hitR) {
+            stack.push_back({node.right, tr});
+        }
+    }
+    return found;
+}
+
+void DynamicAABBTree::QueryNearest(const glm::vec3& point, std::size_t k,
+                                   std::vector<std::pair<Entity, float>>& out) const {
+    out.clear();
+    if (m_Root == kNull || k == 0) return;
+
+    // Best-first over the fat boxes, which never overstate how close a
+    // subtree can be. `found` is a max-heap of the k best squared
+    // distances; once it's full, a subtree farther than its top is done.
+    using Candidate = std::pair<float, std::int32_t>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> open;
+    std::priority_queue<std::pair<float, Entity>> found;
+    open.push({DistanceSq(m_Nodes[m_Root].box, point), m_Root});
+    while (!open.empty()) {
+        const auto [distSq, index] = open.top();
+        open.pop();
+        if (found.size() == k && distSq >= found.top().first) break;
+        const Node& node = m_Nodes[index];
+        if (node.IsLeaf()) {
+            const float d = DistanceSq(m_Tight[index], point);
+            if (found.size() < k) {
+                found.push({d, node.entity});
+            } else if (d < found.top().first) {
+                found.pop();
+                found.push({d, node.entity});
+            }
+            continue;
+        }
+        open.push({DistanceSq(m_Nodes[node.left].box, point), node.left});
+        open.push({DistanceSq(m_Nodes[node.right].box, point), node.right});
+    }
+
+    out.resize(found.size());
+    for (std::size_t i = found.size(); i-- > 0;) {
+        out[i] = {found.top().second, std::sqrt(found.top().first)};
+        found.pop();
+    }
+}
+
+bool DynamicAABBTree::Validate() const {
+    if (m_Root == kNull) return m_LeafCount == 0;
+    if (m_Nodes[m_Root].parent != kNull) return false;
+
+    std::size_t leaves = 0;
+    std::vector<std::int32_t> stack{m_Root};
+    while (!stack.empty()) {
+        const std::int32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = m_Nodes[index];
+        if (node.IsLeaf()) {
+            if (node.right != kNull || node.height != 0) return false;
+            if (!node.box.Contains(m_Tight[index])) return false;
+            if (leafOf(node.entity) != index) return false;
+            ++leaves;
+            continue;
+        }
+        const Node& l = m_Nodes[node.left];
+        const Node& r = m_Nodes[node.right];
+        if (l.parent != index || r.parent != index) return false;
+        if (node.height != 1 + std::max(l.height, r.height)) return false;
+        const AABB joined = Union(l.box, r.box);
+        if (joined.min != node.box.min || joined.max != node.box.max) return false;
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+    return leaves == m_LeafCount;
+}
+
+std::int32_t DynamicAABBTree::allocateNode() {
+    std::int32_t index;
+    if (m_FreeList != kNull) {
+        index = m_FreeList;
+        m_FreeList = m_Nodes[index].parent;
+        m_Nodes[index] = Node{};
+    } else {
+        index = static_cast<std::int32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+        m_Tight.emplace_back();
+    }
+    return index;
+}
+
+void DynamicAABBTree::freeNode(std::int32_t index) {
+    Node& node = m_Nodes[index];
+    node.parent = m_FreeList;
+    node.left = node.right = kNull;
+    node.height = -1;
+    node.entity = NULL_ENTITY;
+    m_FreeList = index;
+}
+
+void DynamicAABBTree::insertLeaf(std::int32_t leaf, std::int32_t start) {
+    if (m_Root == kNull) {
+        m_Root = leaf;
+        m_Nodes[leaf].parent = kNull;
+        return;
+    }
+
+    // Descend towards the sibling that adds the least surface area: making
+    // `leaf` a sibling of `index` costs the area of their union, and every
+    // ancestor passed on the way pays for growing to cover `leaf`.
+    const AABB box = m_Nodes[leaf].box;
+    std::int32_t index = start;
+    while (!m_Nodes[index].IsLeaf()) {
+        const Node& node = m_Nodes[index];
+        const float area = node.box.HalfArea();
+        const float combined = Union(node.box, box).HalfArea();
+        const float siblingCost = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+
+        auto descendCost = [&](std::int32_t child) {
+            const Node& c = m_Nodes[child];
+            const float grown = Union(c.box, box).HalfArea();
+            return (c.IsLeaf() ? grown : grown - c.box.HalfArea()) + inherited;
+        };
+        const float costL = descendCost(node.left);
+        const float costR = descendCost(node.right);
+        if (siblingCost < costL && siblingCost < costR) break;
+        index = costL < costR ? node.left : node.right;
+    }
+
+    // New internal node in the sibling's place, holding both.
+    const std::int32_t sibling = index;
+    const std::int32_t oldParent = m_Nodes[sibling].parent;
+    const std::int32_t newParent = allocateNode();
+    Node& joined = m_Nodes[newParent];
+    joined.parent = oldParent;
+    joined.box = Union(box, m_Nodes[sibling].box);
+    joined.height = m_Nodes[sibling].height + 1;
+    joined.left = sibling;
+    joined.right = leaf;
+    m_Nodes[sibling].parent = newParent;
+    m_Nodes[leaf].parent = newParent;
+    if (oldParent == kNull) {
+        m_Root = newParent;
+    } else {
+        replaceChild(oldParent, sibling, newParent);
+    }
+
+    // Refit and rebalance on the way back up.
+    for (index = m_Nodes[leaf].parent; index != kNull; index = m_Nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_Nodes[index];
+        node.height = 1 + std::max(m_Nodes[node.left].height, m_Nodes[node.right].height);
+        node.box = Union(m_Nodes[node.left].box, m_Nodes[node.right].box);
+    }
+}
+
+std::int32_t DynamicAABBTree::removeLeaf(std::int32_t leaf) {
+    if (leaf == m_Root) {
+        m_Root = kNull;
+        return kNull;
+    }
+
+    // The sibling takes the parent's place.
+    const std::int32_t parent = m_Nodes[leaf].parent;
+    const std::int32_t grandParent = m_Nodes[parent].parent;
+    const std::int32_t sibling = m_Nodes[parent].left == leaf ? m_Nodes[parent].right : m_Nodes[parent].left;
+    m_Nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    if (grandParent == kNull) {
+        m_Root = sibling;
+        return sibling;
+    }
+    replaceChild(grandParent, parent, sibling);
+
+    for (std::int32_t index = grandParent; index != kNull; index = m_Nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_Nodes[index];
+        node.height = 1 + std::max(m_Nodes[node.left].height, m_Nodes[node.right].height);
+        node.box = Union(m_Nodes[node.left].box, m_Nodes[node.right].box);
+    }
+    return sibling;
+}
+
+// If one child of `a` is more than one level taller than the other, rotate
+// the taller child `c` up into a's place: `a` keeps its shorter child plus
+// c's shorter child, and `c` keeps `a` plus its own taller child. Returns
+// the index now at this position.
+std::int32_t DynamicAABBTree::balance(std::int32_t a) {
+    Node& A = m_Nodes[a];
+    if (A.IsLeaf() || A.height < 2) return a;
+
+    const std::int32_t b = A.left;
+    const std::int32_t c = A.right;
+    const int diff = m_Nodes[c].height - m_Nodes[b].height;
+    if (diff >= -1 && diff <= 1) return a;
+
+    // `up` is the taller child, `keep` the one staying under `a`.
+    const bool rightTaller = diff > 1;
+    const std::int32_t up = rightTaller ? c : b;
+    const std::int32_t keep = rightTaller ? b : c;
+    Node& U = m_Nodes[up];
+    const std::int32_t f = U.left;
+    const std::int32_t g = U.right;
+    const bool fTaller = m_Nodes[f].height > m_Nodes[g].height;
+    const std::int32_t tall = fTaller ? f : g;
+    const std::int32_t small = fTaller ? g : f;
+
+    // `up` replaces `a` under a's parent and takes `a` as a child.
+    U.parent = A.parent;
+    A.parent = up;
+    if (U.parent == kNull) {
+        m_Root = up;
+    } else {
+        replaceChild(U.parent, a, up);
+    }
+    U.left = a;
+    U.right = tall;
+    m_Nodes[tall].parent = up;
+
+    // `a` swaps its taller child for up's smaller one.
+    if (rightTaller) {
+        A.right = small;
+    } else {
+        A.left = small;
+    }
+    m_Nodes[small].parent = a;
+
+    A.box = Union(m_Nodes[keep].box, m_Nodes[small].box);
+    A.height = 1 + std::max(m_Nodes[keep].height, m_Nodes[small].height);
+    U.box = Union(A.box, m_Nodes[tall].box);
+    U.height = 1 + std::max(A.height, m_Nodes[tall].height);
+    return up;
+}
+
+void DynamicAABBTree::replaceChild(std::int32_t parent, std::int32_t from, std::int32_t to) {
+    Node& node = m_Nodes[parent];
+    if (node.left == from) {
+        node.left = to;
+    } else {
+        node.right = to;
+    }
+}
@@ -0,0 +1,166 @@
+#include "Scene/FrustumCuller.h"
+
+#include <algorithm>
+#include <bitset>
+
+#if defined(__AVX__)
+#define MIST_CULL_AVX 1
+#define MIST_CULL_SSE 0
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MIST_CULL_AVX 0
+#define MIST_CULL_SSE 1
+#include <emmintrin.h>
+#else
+#define MIST_CULL_AVX 0
+#define MIST_CULL_SSE 0
+#endif
+
+void BoundsSoA::Clear() {
+    for (auto* axis : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) axis->clear();
+}
+
+void BoundsSoA::Reserve(std::size_t count) {
+    for (auto* axis : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) axis->reserve(count);
+}
+
+void BoundsSoA::Push(const AABB& box) {
+    minX.push_back(box.min.x);
+    minY.push_back(box.min.y);
+    minZ.push_back(box.min.z);
+    maxX.push_back(box.max.x);
+    maxY.push_back(box.max.y);
+    maxZ.push_back(box.max.z);
+}
+
+void VisibilityBitset::Reset(std::size_t count) {
+    m_Size = count;
+    m_Words.assign((count + 63) / 64, 0);
+}
+
+std::size_t VisibilityBitset::Count() const {
+    std::size_t count = 0;
+    for (std::uint64_t word : m_Words) count += std::bitset<64>(word).count();
+    return count;
+}
+
+namespace FrustumCuller {
+
+namespace {
+
+#if MIST_CULL_AVX || MIST_CULL_SSE
+
+#if MIST_CULL_AVX
+using Lanes = __m256;
+constexpr std::size_t kWidth = 8;
+inline Lanes Load(const float* p) { return _mm256_loadu_ps(p); }
+inline Lanes Splat(float v) { return _mm256_set1_ps(v); }
+inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+inline Lanes And(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+// Unordered, so a NaN distance keeps the box, as the scalar `< 0` test does.
+inline Lanes NotBehind(Lanes d) { return _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_NLT_UQ); }
+inline std::uint64_t Bits(Lanes mask) { return std::uint64_t(_mm256_movemask_ps(mask)); }
+inline Lanes AllLanes() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+#else
+using Lanes = __m128;
+constexpr std::size_t kWidth = 4;
+inline Lanes Load(const float* p) { return _mm_loadu_ps(p); }
+inline Lanes Splat(float v) { return _mm_set1_ps(v); }
+inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes And(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+inline Lanes NotBehind(Lanes d) { return _mm_cmpnlt_ps(d, _mm_setzero_ps()); }
+inline std::uint64_t Bits(Lanes mask) { return std::uint64_t(_mm_movemask_ps(mask)); }
+inline Lanes AllLanes() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+#endif
+
+// A plane splatted across the lanes, with the box arrays that hold the
+// corner furthest along its normal (max where the normal is >= 0).
+struct LanePlane {
+    Lanes nx, ny, nz, d;
+    const float* px;
+    const float* py;
+    const float* pz;
+};
+
+void CullSimd(const Frustum* frusta, std::size_t viewCount, const BoundsSoA& bounds, VisibilityBitset* out) {
+    std::vector<LanePlane> planes(viewCount * 6);
+    for (std::size_t v = 0; v < viewCount; ++v) {
+        for (int p = 0; p < 6; ++p) {
+            const Plane& plane = frusta[v].planes[p];
+            planes[v * 6 + p] = {Splat(plane.normal.x), Splat(plane.normal.y), Splat(plane.normal.z),
+                                 Splat(plane.distance),
+                                 plane.normal.x >= 0 ? bounds.maxX.data() : bounds.minX.data(),
+                                 plane.normal.y >= 0 ? bounds.maxY.data() : bounds.minY.data(),
+                                 plane.normal.z >= 0 ? bounds.maxZ.data() : bounds.minZ.data()};
+        }
+    }
+
+    // A block of 64 boxes (1.5 KB) stays in L1 while every view tests it,
+    // and each view's bits collect in a register for one store per word.
+    const std::size_t count = bounds.Size();
+    const std::size_t simdEnd = count - count % kWidth;
+    for (std::size_t block = 0; block < simdEnd; block += 64) {
+        const std::size_t blockEnd = std::min(block + 64, simdEnd);
+        for (std::size_t v = 0; v < viewCount; ++v) {
+            const LanePlane* view = &planes[v * 6];
+            std::uint64_t bits = 0;
+            for (std::size_t i = block; i < blockEnd; i += kWidth) {
+                Lanes inside = AllLanes();
+                for (int p = 0; p < 6; ++p) {
+                    const LanePlane& plane = view[p];
+                    // Same association as Plane::DistanceToPoint.
+                    const Lanes dist = Add(Add(Add(Mul(plane.nx, Load(plane.px + i)), Mul(plane.ny, Load(plane.py + i))),
+                                               Mul(plane.nz, Load(plane.pz + i))),
+                                           plane.d);
+                    inside = And(inside, NotBehind(dist));
+                }
+                bits |= Bits(inside) << (i - block);
+            }
+            out[v].Words()[block >> 6] |= bits;
+        }
+    }
+
+    for (std::size_t i = simdEnd; i < count; ++i) {
+        const AABB box = bounds.Get(i);
+        for (std::size_t v = 0; v < viewCount; ++v) {
+            if (frusta[v].Intersects(box)) out[v].Set(i);
+        }
+    }
+}
+
+#endif
+
+} // namespace
+
+void CullFrustums(const Frustum* frusta, std::size_t viewCount, const BoundsSoA& bounds, VisibilityBitset* out) {
+#if MIST_CULL_AVX || MIST_CULL_SSE
+    for (std::size_t v = 0; v < viewCount; ++v) out[v].Reset(bounds.Size());
+    CullSimd(frusta, viewCount, bounds, out);
+#else
+    CullFrustumsScalar(frusta, viewCount, bounds, out);
+#endif
+}
+
+void CullFrustumsScalar(const Frustum* frusta, std::size_t viewCount, const BoundsSoA& bounds, VisibilityBitset* out) {
+    for (std::size_t v = 0; v < viewCount; ++v) out[v].Reset(bounds.Size());
+    for (std::size_t i = 0; i < bounds.Size(); ++i) {
+        const AABB box = bounds.Get(i);
+        for (std::size_t v = 0; v < viewCount; ++v) {
+            if (frusta[v].Intersects(box)) out[v].Set(i);
+        }
+    }
+}
+
+const char* BackendName() {
+#if MIST_CULL_AVX
+    return "AVX";
+#elif MIST_CULL_SSE
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace FrustumCuller
@@ -13,10 +13,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <vector>
 
 extern Coordinator gCoordinator;
 
@@ -88,7 +90,7 @@ Renderable* resolve_mesh_ref(const json& meshJson) {
 } // namespace
 
 bool SceneSerializer::Save(const std::string& filepath, Coordinator& /*coordinator*/,
-                            int entityCount) {
+                            int /*entityCount*/) {
     const auto sandbox = SceneSandboxRoot();
     std::filesystem::path resolved;
     if (!Mist::PathGuard::is_under(sandbox, filepath, &resolved)) {
@@ -105,11 +107,17 @@ bool SceneSerializer::Save(const std::string& filepath, Coordinator& /*coordinat
         {"entities", json::array()},
     };
 
-    for (int i = 0; i < entityCount; ++i) {
-        const Entity entity = static_cast<Entity>(i);
+    // Walk the living set rather than 0..entityCount: handles carry a
+    // generation, so a recycled entity's value lies outside any dense
+    // range. Slot order keeps the file stable across save/load cycles.
+    std::vector<Entity> living(gCoordinator.GetLivingEntities().begin(),
+                               gCoordinator.GetLivingEntities().end());
+    std::sort(living.begin(), living.end(),
+              [](Entity a, Entity b) { return EntityIndex(a) < EntityIndex(b); });
 
+    for (const Entity entity : living) {
         json e = json::object();
-        e["id"] = static_cast<int>(entity);
+        e["id"] = static_cast<std::uint32_t>(entity);
 
         // Transform is the gatekeeper — any entity without one is skipped.
         TransformComponent transform;
@@ -120,7 +128,7 @@ bool SceneSerializer::Save(const std::string& filepath, Coordinator& /*coordinat
         }
         e["transform"] = {
             {"pos",   vec3_to_json(transform.position)},
-            {"rot",   vec3_to_json(transform.rotation)},
+            {"rot",   vec3_to_json(transform.GetEulerDegrees())},
             {"scale", vec3_to_json(transform.scale)},
         };
 
@@ -129,6 +137,7 @@ bool SceneSerializer::Save(const std::string& filepath, Coordinator& /*coordinat
             e["render"] = {
                 {"mesh",    mesh_ref_for(render.renderable)},
                 {"visible", render.visible},
+                {"castShadows", render.castShadows},
             };
         } catch (...) {
             // No render component — skip.
@@ -199,15 +208,18 @@ bool SceneSerializer::Load(const std::string& filepath, Coordinator& /*coordinat
     entityCount = 0;
     for (const auto& e : root["entities"]) {
         Entity entity = gCoordinator.CreateEntity();
-        entityCount = std::max(entityCount, static_cast<int>(entity) + 1);
+        entityCount = std::max(entityCount, static_cast<int>(EntityIndex(entity)) + 1);
 
         // Transform — required.
         if (e.contains("transform") && e["transform"].is_object()) {
             TransformComponent t;
             if (e["transform"].contains("pos"))
                 vec3_from_json(e["transform"]["pos"], t.position);
-            if (e["transform"].contains("rot"))
-                vec3_from_json(e["transform"]["rot"], t.rotation);
+            if (e["transform"].contains("rot")) {
+                glm::vec3 euler(0.0f);
+                vec3_from_json(e["transform"]["rot"], euler);
+                t.SetEulerDegrees(euler);
+            }
             if (e["transform"].contains("scale"))
                 vec3_from_json(e["transform"]["scale"], t.scale);
             gCoordinator.AddComponent(entity, t);
@@ -218,6 +230,7 @@ bool SceneSerializer::Load(const std::string& filepath, Coordinator& /*coordinat
         if (e.contains("render") && e["render"].is_object()) {
             RenderComponent r;
             r.visible = e["render"].value("visible", true);
+            r.castShadows = e["render"].value("castShadows", true);
             if (e["render"].contains("mesh")) {
                 r.renderable = resolve_mesh_ref(e["render"]["mesh"]);
             }
@@ -0,0 +1,126 @@
+#include "Scene/SpatialHashGrid.h"
+
+#include <cassert>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHashGrid::SetCellSize(float cellSize) {
+    assert(cellSize > 0.0f);
+    if (!(cellSize > 0.0f)) return;
+    m_CellSize = cellSize;
+    m_InvCellSize = 1.0f / cellSize;
+    if (m_Locations.empty()) return;
+
+    std::vector<Member> members;
+    members.reserve(m_Locations.size());
+    for (const Location& at : m_Locations) members.push_back(m_Cells[at.cell].members[at.slot]);
+    Clear();
+    for (const Member& member : members) Insert(member.entity, member.position);
+}
+
+void SpatialHashGrid::Insert(Entity entity, const glm::vec3& position) {
+    // Whatever sits under this index is this entity or a stale handle of
+    // it; either way it goes.
+    const std::uint32_t existing = m_Index.Get(entity);
+    if (existing != SparseEntityIndex::kInvalid) Remove(m_Locations[existing].entity);
+
+    const auto location = static_cast<std::uint32_t>(m_Locations.size());
+    m_Locations.push_back({entity, 0, 0});
+    m_Index.Slot(entity) = location;
+    addToCell(location, acquireCell(cellOf(position)), position);
+}
+
+bool SpatialHashGrid::Remove(Entity entity) {
+    const std::uint32_t location = locationOf(entity);
+    if (location == SparseEntityIndex::kInvalid) return false;
+    removeFromCell(location);
+
+    // Swap-remove the location, repointing the member that moves into it.
+    const Location last = m_Locations.back();
+    m_Locations.pop_back();
+    if (location < m_Locations.size()) {
+        m_Locations[location] = last;
+        m_Index.Slot(last.entity) = location;
+    }
+    m_Index.Slot(entity) = SparseEntityIndex::kInvalid;
+    return true;
+}
+
+bool SpatialHashGrid::Move(Entity entity, const glm::vec3& position) {
+    const std::uint32_t location = locationOf(entity);
+    assert(location != SparseEntityIndex::kInvalid);
+    if (location == SparseEntityIndex::kInvalid) return false;
+
+    const Location& at = m_Locations[location];
+    const CellCoord to = cellOf(position);
+    const CellCoord& from = m_Cells[at.cell].coord;
+    if (to.x == from.x && to.y == from.y && to.z == from.z) {
+        m_Cells[at.cell].members[at.slot].position = position;
+        return false;
+    }
+    removeFromCell(location);
+    addToCell(location, acquireCell(to), position);
+    return true;
+}
+
+void SpatialHashGrid::Clear() {
+    m_Cells.clear();
+    m_FreeCells.clear();
+    m_CellLookup.clear();
+    m_Locations.clear();
+    m_Index.Clear();
+    m_Results.clear();
+}
+
+EntitySpan SpatialHashGrid::QueryRadius(const glm::vec3& center, float radius) {
+    m_Results.clear();
+    ForEachInRadius(center, radius, [this](Entity e) { m_Results.push_back(e); });
+    return {m_Results.data(), m_Results.size()};
+}
+
+EntitySpan SpatialHashGrid::QueryBox(const AABB& box) {
+    m_Results.clear();
+    ForEachInBox(box, [this](Entity e) { m_Results.push_back(e); });
+    return {m_Results.data(), m_Results.size()};
+}
+
+std::uint32_t SpatialHashGrid::acquireCell(const CellCoord& coord) {
+    const auto [it, inserted] = m_CellLookup.try_emplace(keyOf(coord), 0u);
+    if (!inserted) return it->second;
+
+    // Recycled cells keep their member capacity.
+    std::uint32_t cell;
+    if (!m_FreeCells.empty()) {
+        cell = m_FreeCells.back();
+        m_FreeCells.pop_back();
+    } else {
+        cell = static_cast<std::uint32_t>(m_Cells.size());
+        m_Cells.emplace_back();
+    }
+    m_Cells[cell].coord = coord;
+    it->second = cell;
+    return cell;
+}
+
+void SpatialHashGrid::addToCell(std::uint32_t location, std::uint32_t cell, const glm::vec3& position) {
+    std::vector<Member>& members = m_Cells[cell].members;
+    m_Locations[location].cell = cell;
+    m_Locations[location].slot = static_cast<std::uint32_t>(members.size());
+    members.push_back({m_Locations[location].entity, position});
+}
+
+void SpatialHashGrid::removeFromCell(std::uint32_t location) {
+    const Location& at = m_Locations[location];
+    Cell& cell = m_Cells[at.cell];
+    if (at.slot + 1 < cell.members.size()) {
+        cell.members[at.slot] = cell.members.back();
+        m_Locations[m_Index.Get(cell.members[at.slot].entity)].slot = at.slot;
+    }
+    cell.members.pop_back();
+    if (cell.members.empty()) {
+        m_CellLookup.erase(keyOf(cell.coord));
+        m_FreeCells.push_back(at.cell);
+    }
+}
@@ -0,0 +1,356 @@
+#include "Scene/TriangleBVH.h"
+
+#include "Core/SmallVector.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MIST_BVH_SSE 1
+#include <emmintrin.h>
+#else
+#define MIST_BVH_SSE 0
+#endif
+
+namespace {
+
+constexpr float kMiss = std::numeric_limits<float>::infinity();
+
+// Ray set up once for many box tests. Direction components too small to
+// invert are nudged off zero so a slab the ray runs parallel to gives
+// +-huge rather than 0 * inf = NaN.
+struct BoxRay {
+#if MIST_BVH_SSE
+    __m128 origin;
+    __m128 invDir;
+#else
+    glm::vec3 origin;
+    glm::vec3 invDir;
+#endif
+
+    BoxRay(const glm::vec3& o, const glm::vec3& d) {
+        float inv[3];
+        for (int i = 0; i < 3; ++i) {
+            const float c = std::fabs(d[i]) < 1e-20f ? std::copysign(1e-20f, d[i]) : d[i];
+            inv[i] = 1.0f / c;
+        }
+#if MIST_BVH_SSE
+        // Lane 3 is zero in both, so it contributes t = 0 to the entry
+        // maximum: the clamp to the start of the segment for free.
+        origin = _mm_set_ps(0.0f, o.z, o.y, o.x);
+        invDir = _mm_set_ps(0.0f, inv[2], inv[1], inv[0]);
+#else
+        origin = o;
+        invDir = glm::vec3(inv[0], inv[1], inv[2]);
+#endif
+    }
+
+    // Where the segment [0, maxDistance] enters the node's box, or kMiss.
+    template<typename NodeT>
+    float Entry(const NodeT& node, float maxDistance) const {
+#if MIST_BVH_SSE
+        // min/max are each followed by a 32-bit child/count field; mask that
+        // lane to zero rather than feed integer bits (often denormal as a
+        // float) through the arithmetic.
+        const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        const __m128 bmin = _mm_and_ps(_mm_loadu_ps(&node.min.x), xyz);
+        const __m128 bmax = _mm_and_ps(_mm_loadu_ps(&node.max.x), xyz);
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(bmin, origin), invDir);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(bmax, origin), invDir);
+        __m128 tNear = _mm_min_ps(t0, t1);
+        // Lane 3 of the exit side becomes maxDistance: the far clamp.
+        __m128 tFar = _mm_or_ps(_mm_and_ps(_mm_max_ps(t0, t1), xyz),
+                                _mm_andnot_ps(xyz, _mm_set1_ps(maxDistance)));
+        tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+        tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+        tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+        tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+        const float entry = _mm_cvtss_f32(tNear);
+        return entry <= _mm_cvtss_f32(tFar) ? entry : kMiss;
+#else
+        float tNear = 0.0f, tFar = maxDistance;
+        for (int i = 0; i < 3; ++i) {
+            float t0 = (node.min[i] - origin[i]) * invDir[i];
+            float t1 = (node.max[i] - origin[i]) * invDir[i];
+            if (t0 > t1) std::swap(t0, t1);
+            tNear = std::max(tNear, t0);
+            tFar = std::min(tFar, t1);
+        }
+        return tNear <= tFar ? tNear : kMiss;
+#endif
+    }
+};
+
+float HalfArea(const glm::vec3& min, const glm::vec3& max) {
+    const glm::vec3 d = max - min;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+} // namespace
+
+struct TriangleBVH::BuildState {
+    // Indexed by input triangle.
+    std::vector<AABB> bounds;
+    std::vector<glm::vec3> centroids;
+};
+
+void TriangleBVH::Clear() {
+    m_Nodes.clear();
+    m_Triangles.clear();
+    m_TriangleIds.clear();
+}
+
+AABB TriangleBVH::Bounds() const {
+    if (m_Nodes.empty()) return AABB{};
+    return AABB{m_Nodes[0].min, m_Nodes[0].max};
+}
+
+void TriangleBVH::Build(const glm::vec3* positions, std::size_t strideBytes, std::size_t vertexCount,
+                        const std::uint32_t* indices, std::size_t indexCount) {
+    Clear();
+    const std::size_t inputCount = (indices ? indexCount : vertexCount) / 3;
+    const auto* base = reinterpret_cast<const unsigned char*>(positions);
+    auto vertex = [&](std::size_t i) -> const glm::vec3& {
+        return *reinterpret_cast<const glm::vec3*>(base + i * strideBytes);
+    };
+
+    BuildState state;
+    state.bounds.resize(inputCount);
+    state.centroids.resize(inputCount);
+    std::vector<Triangle> input(inputCount);
+    m_TriangleIds.reserve(inputCount);
+    for (std::size_t t = 0; t < inputCount; ++t) {
+        std::array<std::size_t, 3> corner;
+        bool inRange = true;
+        for (std::size_t k = 0; k < 3; ++k) {
+            corner[k] = indices ? indices[3 * t + k] : 3 * t + k;
+            inRange = inRange && corner[k] < vertexCount;
+        }
+        // Triangles pointing past the vertices are left out rather than
+        // read out of bounds.
+        if (!inRange) continue;
+        const glm::vec3& a = vertex(corner[0]);
+        const glm::vec3& b = vertex(corner[1]);
+        const glm::vec3& c = vertex(corner[2]);
+        input[t] = {a, b - a, c - a};
+        state.bounds[t].Merge(a);
+        state.bounds[t].Merge(b);
+        state.bounds[t].Merge(c);
+        state.centroids[t] = (a + b + c) * (1.0f / 3.0f);
+        m_TriangleIds.push_back(static_cast<std::uint32_t>(t));
+    }
+    if (m_TriangleIds.empty()) return;
+
+    m_Nodes.reserve(2 * m_TriangleIds.size() - 1);
+    m_Nodes.push_back({});
+    m_Nodes[0].first = 0;
+    m_Nodes[0].count = static_cast<std::uint32_t>(m_TriangleIds.size());
+    subdivide(state, 0);
+
+    m_Triangles.reserve(m_TriangleIds.size());
+    for (std::uint32_t id : m_TriangleIds) m_Triangles.push_back(input[id]);
+}
+
+void TriangleBVH::subdivide(BuildState& state, std::uint32_t root) {
+    Mist::SmallVector<std::uint32_t, 64> pending{root};
+    while (!pending.empty()) {
+        const std::uint32_t nodeIndex = pending.back();
+        pending.pop_back();
+        const std::uint32_t first = m_Nodes[nodeIndex].first;
+        const std::uint32_t count = m_Nodes[nodeIndex].count;
+
+        AABB box, centroidBox;
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            box.Merge(state.bounds[m_TriangleIds[i]]);
+            centroidBox.Merge(state.centroids[m_TriangleIds[i]]);
+        }
+        m_Nodes[nodeIndex].min = box.min;
+        m_Nodes[nodeIndex].max = box.max;
+        if (count <= kMaxLeafTriangles) continue;
+
+        // Binned SAH: per axis, drop centroids into kBins slabs and cost
+        // every plane between slabs as area * triangles on each side.
+        struct Bin {
+            AABB box;
+            std::uint32_t count = 0;
+        };
+        std::array<std::array<Bin, kBins>, 3> bins;
+        float scale[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float extent = centroidBox.max[axis] - centroidBox.min[axis];
+            scale[axis] = extent > 0.0f ? kBins / extent : 0.0f;
+        }
+        // One pass fills all three axes' bins.
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            const std::uint32_t id = m_TriangleIds[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                const float offset = state.centroids[id][axis] - centroidBox.min[axis];
+                Bin& bin = bins[axis][std::min(kBins - 1, int(offset * scale[axis]))];
+                bin.box.Merge(state.bounds[id]);
+                ++bin.count;
+            }
+        }
+
+        int bestAxis = -1, bestPlane = 0;
+        float bestCost = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; ++axis) {
+            if (scale[axis] == 0.0f) continue;
+            std::array<float, kBins - 1> leftCost;
+            AABB left;
+            std::uint32_t leftCount = 0;
+            for (int plane = 0; plane < kBins - 1; ++plane) {
+                left.Merge(bins[axis][plane].box);
+                leftCount += bins[axis][plane].count;
+                leftCost[plane] = leftCount ? HalfArea(left.min, left.max) * float(leftCount) : 0.0f;
+            }
+            AABB right;
+            std::uint32_t rightCount = 0;
+            for (int plane = kBins - 2; plane >= 0; --plane) {
+                right.Merge(bins[axis][plane + 1].box);
+                rightCount += bins[axis][plane + 1].count;
+                if (rightCount == 0 || rightCount == count) continue;
+                const float cost = leftCost[plane] + HalfArea(right.min, right.max) * float(rightCount);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestPlane = plane;
+                }
+            }
+        }
+
+        std::uint32_t split = first + count / 2;
+        if (bestAxis >= 0) {
+            const float lo = centroidBox.min[bestAxis];
+            auto* begin = m_TriangleIds.data() + first;
+            auto* mid = std::partition(begin, begin + count, [&](std::uint32_t id) {
+                return std::min(kBins - 1, int((state.centroids[id][bestAxis] - lo) * scale[bestAxis])) <= bestPlane;
+            });
+            split = first + static_cast<std::uint32_t>(mid - begin);
+        }
+        // else every centroid coincides: no plane separates them, so halve
+        // the range to keep leaves small.
+
+        const auto left = static_cast<std::uint32_t>(m_Nodes.size());
+        m_Nodes.push_back({});
+        m_Nodes.push_back({});
+        m_Nodes[left].first = first;
+        m_Nodes[left].count = split - first;
+        m_Nodes[left + 1].first = split;
+        m_Nodes[left + 1].count = first + count - split;
+        m_Nodes[nodeIndex].first = left;
+        m_Nodes[nodeIndex].count = 0;
+        pending.push_back(left + 1);
+        pending.push_back(left);
+    }
+}
+
+bool TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                            Hit& hit) const {
+    if (m_Nodes.empty()) return false;
+    const BoxRay ray(origin, direction);
+    float best = maxDistance;
+    std::uint32_t found = kNoTriangle;
+    float bestU = 0.0f, bestV = 0.0f;
+
+    Mist::SmallVector<std::pair<std::uint32_t, float>, 64> stack;
+    const float rootEntry = ray.Entry(m_Nodes[0], best);
+    if (rootEntry != kMiss) stack.push_back({0u, rootEntry});
+    while (!stack.empty()) {
+        const auto [index, entry] = stack.back();
+        stack.pop_back();
+        if (entry > best) continue;
+        const Node& node = m_Nodes[index];
+        if (node.IsLeaf()) {
+            // Möller–Trumbore, two-sided.
+            for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const Triangle& tri = m_Triangles[i];
+                const glm::vec3 p = glm::cross(direction, tri.e2);
+                const float det = glm::dot(tri.e1, p);
+                if (det == 0.0f) continue;
+                const float invDet = 1.0f / det;
+                const glm::vec3 s = origin - tri.v0;
+                const float u = glm::dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+                const glm::vec3 q = glm::cross(s, tri.e1);
+                const float v = glm::dot(direction, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+                const float t = glm::dot(tri.e2, q) * invDet;
+                if (t < 0.0f || t > best) continue;
+                best = t;
+                found = i;
+                bestU = u;
+                bestV = v;
+            }
+            continue;
+        }
+        // Nearer child on top; a child entered beyond the best hit is
+        // pruned here, or on pop if the best improved meanwhile.
+        const float tl = ray.Entry(m_Nodes[node.first], best);
+        const float tr = ray.Entry(m_Nodes[node.first + 1], best);
+        if (tl <= tr) {
+            if (tr != kMiss) stack.push_back({node.first + 1, tr});
+            if (tl != kMiss) stack.push_back({node.first, tl});
+        } else {
+            if (tl != kMiss) stack.push_back({node.first, tl});
+            stack.push_back({node.first + 1, tr});
+        }
+    }
+
+    if (found == kNoTriangle) return false;
+    hit.distance = best;
+    hit.triangle = m_TriangleIds[found];
+    hit.u = bestU;
+    hit.v = bestV;
+    return true;
+}
+
+std::size_t TriangleBVH::IntersectBatch(const Ray* rays, std::size_t count, Hit* hits) const {
+    std::size_t hitCount = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        hits[i] = Hit{};
+        hitCount += Intersect(rays[i].origin, rays[i].direction, rays[i].maxDistance, hits[i]);
+    }
+    return hitCount;
+}
+
+bool TriangleBVH::Validate() const {
+    if (m_Nodes.empty()) return m_Triangles.empty();
+    if (m_Triangles.size() != m_TriangleIds.size()) return false;
+
+    // Triangle corners are rebuilt from v0 + edge, which can land an ulp
+    // or so outside boxes built from the original vertices.
+    const glm::vec3 extent = m_Nodes[0].max - m_Nodes[0].min;
+    const float slack = 1e-5f * (1.0f + std::max(extent.x, std::max(extent.y, extent.z)));
+    auto inside = [&](const Node& node, const glm::vec3& p) {
+        for (int a = 0; a < 3; ++a) {
+            if (p[a] < node.min[a] - slack || p[a] > node.max[a] + slack) return false;
+        }
+        return true;
+    };
+
+    std::vector<std::uint8_t> seen(m_Triangles.size(), 0);
+    Mist::SmallVector<std::uint32_t, 64> stack{0u};
+    while (!stack.empty()) {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+        if (node.IsLeaf()) {
+            if (node.count > kMaxLeafTriangles || node.first + node.count > m_Triangles.size()) return false;
+            for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const Triangle& tri = m_Triangles[i];
+                if (seen[i]++ || !inside(node, tri.v0) || !inside(node, tri.v0 + tri.e1) ||
+                    !inside(node, tri.v0 + tri.e2)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+        if (node.first + 1 >= m_Nodes.size()) return false;
+        for (std::uint32_t child = node.first; child <= node.first + 1; ++child) {
+            if (!inside(node, m_Nodes[child].min) || !inside(node, m_Nodes[child].max)) return false;
+            stack.push_back(child);
+        }
+    }
+    return std::all_of(seen.begin(), seen.end(), [](std::uint8_t s) { return s == 1; });
+}
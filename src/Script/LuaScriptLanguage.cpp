@@ -4,11 +4,15 @@
 
 #include "Core/Logger.h"
 #include "Core/PathGuard.h"
+#include "Core/ServiceLocator.h"
 #include "ECS/Components/HierarchyComponent.h"
 #include "ECS/Components/RenderComponent.h"
 #include "ECS/Components/ScriptComponent.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
+#include "ECS/Systems/SpatialHashSystem.h"
+#include "ECS/Systems/SpatialIndexSystem.h"
 #include "Mesh.h"
 #include "Resources/AssetRegistry.h"
 #include "Resources/Ref.h"
@@ -16,10 +20,15 @@
 
 #include <sol/sol.hpp>
 
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <sstream>
+#include <tuple>
+#include <unordered_map>
 
 extern Coordinator gCoordinator;
+extern EntityCommandBuffer gEntityCommands;
 
 namespace Mist::Script {
 
@@ -27,6 +36,16 @@ namespace Mist::Script {
 // bleed into every translation unit that touches scripting.
 struct LuaStatePimpl {
     sol::state state;
+    // The array query_radius/query_box hand back on every call, and how
+    // many entries it holds. Declared after `state` so it's released
+    // while the state is still open.
+    sol::table queryResults;
+    std::size_t queryCount = 0;
+    // Transforms of entities spawned since gEntityCommands last played
+    // back: the ids are live, but their components are still recorded
+    // commands. get/set_transform use these until then.
+    std::unordered_map<Entity, TransformComponent> spawned;
+    std::uint64_t spawnedEpoch = 0;
 };
 
 struct LuaEnvPimpl {
@@ -39,6 +58,88 @@ namespace {
 // setups (one sol::state per thread) share this pattern without rewrite.
 thread_local Entity g_current_entity = static_cast<Entity>(-1);
 thread_local float  g_last_dt        = 0.0f;
+
+// Entity handles use all 32 bits (slot index + generation), which overflows
+// a Lua-side int once a slot has been recycled enough. Ids cross the
+// boundary as 64-bit integers instead; -1 still means "no entity".
+std::int64_t ToLuaId(Entity e) {
+    return e == NULL_ENTITY ? -1 : static_cast<std::int64_t>(e);
+}
+
+// False for negative, out-of-range or stale ids.
+bool FromLuaId(std::int64_t id, Entity& out) {
+    if (id < 0 || id >= static_cast<std::int64_t>(NULL_ENTITY)) return false;
+    out = static_cast<Entity>(id);
+    return gCoordinator.IsAlive(out);
+}
+
+// The entity get/set_transform act on: `id` when given, else the one
+// whose script is running. NULL_ENTITY for a bad id.
+Entity TargetEntity(sol::optional<std::int64_t> id) {
+    if (!id) return LuaScriptLanguage::CurrentEntity();
+    Entity e;
+    return FromLuaId(*id, e) ? e : NULL_ENTITY;
+}
+
+// Forgets the staged transforms once gEntityCommands has played back (the
+// real components exist then) or dropped its commands.
+void ForgetAppliedSpawns(LuaStatePimpl& pimpl) {
+    if (pimpl.spawnedEpoch == gEntityCommands.GetEpoch()) return;
+    pimpl.spawned.clear();
+    pimpl.spawnedEpoch = gEntityCommands.GetEpoch();
+}
+
+// The staged transform of an entity spawn_* created since the last
+// playback, or null.
+TransformComponent* SpawnedTransform(LuaStatePimpl& pimpl, Entity e) {
+    ForgetAppliedSpawns(pimpl);
+    auto it = pimpl.spawned.find(e);
+    return it == pimpl.spawned.end() ? nullptr : &it->second;
+}
+
+// Creates the entity now, so scripts get a usable id, and records its
+// components into gEntityCommands: scripts run while ScriptSystem is
+// walking its entity set. `renderable` may be null.
+Entity Spawn(LuaStatePimpl& pimpl, const TransformComponent& t, Renderable* renderable) {
+    ForgetAppliedSpawns(pimpl);
+    Entity e = gCoordinator.CreateEntity();
+    gEntityCommands.AddComponent(e, t);
+    if (renderable) {
+        RenderComponent r;
+        r.renderable = renderable; // non-owning; registry keeps it alive
+        r.visible    = true;
+        gEntityCommands.AddComponent(e, r);
+    }
+    gEntityCommands.AddComponent(e, HierarchyComponent{});
+    pimpl.spawned[e] = t;
+    return e;
+}
+
+// Applies the fields present in a get_transform-style table.
+void ApplyTransformTable(TransformComponent& t, const sol::table& tbl) {
+    t.SetPosition({tbl.get_or("x", t.position.x), tbl.get_or("y", t.position.y),
+                   tbl.get_or("z", t.position.z)});
+    // Only round-trip through Euler when the script actually set an
+    // angle, so position-only updates leave the quaternion untouched.
+    if (tbl["rx"].valid() || tbl["ry"].valid() || tbl["rz"].valid()) {
+        const glm::vec3 euler = t.GetEulerDegrees();
+        t.SetEulerDegrees({tbl.get_or("rx", euler.x), tbl.get_or("ry", euler.y),
+                           tbl.get_or("rz", euler.z)});
+    }
+    t.SetScale({tbl.get_or("sx", t.scale.x), tbl.get_or("sy", t.scale.y),
+                tbl.get_or("sz", t.scale.z)});
+}
+
+// Copies `hits` into the state's reused result array, clearing whatever
+// a longer previous result left past the end so `#ids` and ipairs stay
+// correct.
+std::tuple<sol::table, std::int64_t> FillQueryResults(LuaStatePimpl& pimpl, EntitySpan hits) {
+    sol::table& out = pimpl.queryResults;
+    for (std::size_t i = 0; i < hits.size(); ++i) out.raw_set(i + 1, ToLuaId(hits[i]));
+    for (std::size_t i = hits.size(); i < pimpl.queryCount; ++i) out.raw_set(i + 1, sol::lua_nil);
+    pimpl.queryCount = hits.size();
+    return {out, static_cast<std::int64_t>(hits.size())};
+}
 } // namespace
 
 Entity LuaScriptLanguage::CurrentEntity()            { return g_current_entity; }
@@ -69,109 +170,105 @@ void LuaScriptLanguage::Init() {
         LOG_INFO("[lua] ", joined);
     };
 
-    state["entity_id"] = []() -> int {
-        return static_cast<int>(CurrentEntity());
+    state["entity_id"] = []() -> std::int64_t {
+        return ToLuaId(CurrentEntity());
     };
 
     state["get_delta_time"] = []() -> float { return LastDeltaTime(); };
 
+    LuaStatePimpl* pimpl = m_State.get();
+
     // Transform accessors — flat table form. A sol::usertype<glm::vec3>
-    // can land later without breaking the binding surface.
-    state["get_transform"] = [](sol::this_state ts) -> sol::object {
+    // can land later without breaking the binding surface. Both act on
+    // the running script's entity, or on `id` when given; an entity
+    // spawned this frame is readable and movable before its components
+    // land.
+    state["get_transform"] = [pimpl](sol::this_state ts, sol::optional<std::int64_t> id) -> sol::object {
         sol::state_view lua(ts);
-        Entity e = CurrentEntity();
-        if (e == static_cast<Entity>(-1) ||
-            !gCoordinator.HasComponent<TransformComponent>(e)) {
-            return sol::make_object(lua, sol::lua_nil);
+        Entity e = TargetEntity(id);
+        const TransformComponent* found = nullptr;
+        if (e != NULL_ENTITY) {
+            found = gCoordinator.HasComponent<TransformComponent>(e) ? &gCoordinator.GetComponent<TransformComponent>(e)
+                                                                      : SpawnedTransform(*pimpl, e);
         }
-        auto& t = gCoordinator.GetComponent<TransformComponent>(e);
+        if (!found) return sol::make_object(lua, sol::lua_nil);
+        const TransformComponent& t = *found;
         sol::table tbl = lua.create_table();
         tbl["x"]  = t.position.x; tbl["y"]  = t.position.y; tbl["z"]  = t.position.z;
-        tbl["rx"] = t.rotation.x; tbl["ry"] = t.rotation.y; tbl["rz"] = t.rotation.z;
+        const glm::vec3 euler = t.GetEulerDegrees();
+        tbl["rx"] = euler.x;      tbl["ry"] = euler.y;      tbl["rz"] = euler.z;
         tbl["sx"] = t.scale.x;    tbl["sy"] = t.scale.y;    tbl["sz"] = t.scale.z;
         return sol::make_object(lua, tbl);
     };
 
-    state["set_transform"] = [](sol::table tbl) {
-        Entity e = CurrentEntity();
-        if (e == static_cast<Entity>(-1) ||
-            !gCoordinator.HasComponent<TransformComponent>(e)) return;
-        auto& t = gCoordinator.GetComponent<TransformComponent>(e);
-        t.position.x = tbl.get_or("x",  t.position.x);
-        t.position.y = tbl.get_or("y",  t.position.y);
-        t.position.z = tbl.get_or("z",  t.position.z);
-        t.rotation.x = tbl.get_or("rx", t.rotation.x);
-        t.rotation.y = tbl.get_or("ry", t.rotation.y);
-        t.rotation.z = tbl.get_or("rz", t.rotation.z);
-        t.scale.x    = tbl.get_or("sx", t.scale.x);
-        t.scale.y    = tbl.get_or("sy", t.scale.y);
-        t.scale.z    = tbl.get_or("sz", t.scale.z);
-        t.dirty = true;  // HierarchySystem rebuilds cachedGlobal next frame
+    state["set_transform"] = [pimpl](sol::table tbl, sol::optional<std::int64_t> id) {
+        Entity e = TargetEntity(id);
+        if (e == NULL_ENTITY) return;
+        if (gCoordinator.HasComponent<TransformComponent>(e)) {
+            ApplyTransformTable(gCoordinator.GetComponentMut<TransformComponent>(e), tbl);
+        } else if (TransformComponent* t = SpawnedTransform(*pimpl, e)) {
+            // Recorded after the spawn's Add, so it wins at playback.
+            ApplyTransformTable(*t, tbl);
+            gEntityCommands.SetComponent(e, *t);
+        }
     };
 
     // --- Gameplay bindings (this cycle) ---
 
     // spawn_cube(x, y, z) — returns new entity id or -1 on failure.
     // Uses the shared "builtin://cube" mesh from AssetRegistry so N cubes
-    // allocate exactly one Mesh, not N.
-    state["spawn_cube"] = [](float x, float y, float z) -> int {
+    // allocate exactly one Mesh, not N. The id is live at once; the
+    // components land at the next sync point (see Spawn).
+    state["spawn_cube"] = [pimpl](float x, float y, float z) -> std::int64_t {
         auto& meshes = Mist::Assets::AssetRegistry::Instance().meshes();
         auto ref = LoadRef(meshes, std::string("builtin://cube"));
         if (!ref) {
             LOG_ERROR("spawn_cube: failed to load builtin://cube");
             return -1;
         }
-        Entity e = gCoordinator.CreateEntity();
         TransformComponent t;
         t.position = {x, y, z};
-        gCoordinator.AddComponent(e, t);
-
-        RenderComponent r;
-        r.renderable = ref.get();   // non-owning; registry keeps it alive
-        r.visible    = true;
-        gCoordinator.AddComponent(e, r);
-
-        gCoordinator.AddComponent(e, HierarchyComponent{});
-        return static_cast<int>(e);
+        return ToLuaId(Spawn(*pimpl, t, ref.get()));
     };
 
     // spawn_plane(x, y, z, sx, sy, sz) — convenience for the ground plate.
     // Scale defaults are a big flat 20×0.2×20 slab matching the old
     // hardcoded default scene.
-    state["spawn_plane"] = [](float x, float y, float z,
-                              sol::optional<float> sx,
-                              sol::optional<float> sy,
-                              sol::optional<float> sz) -> int {
+    state["spawn_plane"] = [pimpl](float x, float y, float z,
+                                   sol::optional<float> sx,
+                                   sol::optional<float> sy,
+                                   sol::optional<float> sz) -> std::int64_t {
         auto& meshes = Mist::Assets::AssetRegistry::Instance().meshes();
         auto ref = LoadRef(meshes, std::string("builtin://plane"));
         if (!ref) {
             LOG_ERROR("spawn_plane: failed to load builtin://plane");
             return -1;
         }
-        Entity e = gCoordinator.CreateEntity();
         TransformComponent t;
         t.position = {x, y, z};
         t.scale    = {sx.value_or(20.0f), sy.value_or(1.0f), sz.value_or(20.0f)};
-        gCoordinator.AddComponent(e, t);
-
-        RenderComponent r;
-        r.renderable = ref.get();
-        r.visible    = true;
-        gCoordinator.AddComponent(e, r);
+        return ToLuaId(Spawn(*pimpl, t, ref.get()));
+    };
 
-        gCoordinator.AddComponent(e, HierarchyComponent{});
-        return static_cast<int>(e);
+    // spawn_empty(x, y, z) — a bare transform in the hierarchy, nothing
+    // drawn: a pivot to parent things under, or a marker.
+    state["spawn_empty"] = [pimpl](float x, float y, float z) -> std::int64_t {
+        TransformComponent t;
+        t.position = {x, y, z};
+        return ToLuaId(Spawn(*pimpl, t, nullptr));
     };
 
-    // destroy_entity(id) — removes the entity from every system. Safe
-    // to call on an already-dead id; the coordinator logs but doesn't
-    // throw.
-    state["destroy_entity"] = [](int id) {
-        if (id < 0) {
-            LOG_WARN("destroy_entity: ignoring negative id");
+    // destroy_entity(id) — removes the entity from every system at the
+    // next sync point (deferred for the same reason as spawn_cube). Safe
+    // to call on an already-dead id: the handle is stale, so it's ignored
+    // rather than destroying whatever reused the slot.
+    state["destroy_entity"] = [](std::int64_t id) {
+        Entity e;
+        if (!FromLuaId(id, e)) {
+            LOG_WARN("destroy_entity: ignoring invalid or dead id ", id);
             return;
         }
-        gCoordinator.DestroyEntity(static_cast<Entity>(id));
+        gEntityCommands.DestroyEntity(e);
     };
 
     // run_script(path) — compile + run a .lua file's top-level once,
@@ -198,11 +295,13 @@ void LuaScriptLanguage::Init() {
     };
 
     // attach_script(id, path) — compile a Lua file and bind it as a
-    // ScriptComponent on the given entity. Path must be res://-relative
-    // and stays within the project root sandbox.
-    state["attach_script"] = [](int id, const std::string& path) -> bool {
-        if (id < 0) {
-            LOG_WARN("attach_script: negative entity id");
+    // ScriptComponent on the given entity (deferred to the next sync
+    // point). Path must be res://-relative and stays within the project
+    // root sandbox.
+    state["attach_script"] = [](std::int64_t id, const std::string& path) -> bool {
+        Entity target;
+        if (!FromLuaId(id, target)) {
+            LOG_WARN("attach_script: invalid or dead entity id ", id);
             return false;
         }
         auto abs = Mist::PathGuard::resolve_res_path(path);
@@ -228,10 +327,41 @@ void LuaScriptLanguage::Init() {
         ScriptComponent sc;
         sc.path     = path;
         sc.instance = std::shared_ptr<IScriptInstance>(inst.release());
-        gCoordinator.AddComponent(static_cast<Entity>(id), sc);
+        gEntityCommands.AddComponent(target, sc);
         return true;
     };
 
+    // query_radius(x, y, z, r) / query_box(minx, miny, minz, maxx, maxy, maxz)
+    // — ids of the entities whose world position is in range, from
+    // SpatialHashSystem's grid, and their count. The array is the same
+    // table on every call and is overwritten by the next query, so a
+    // script querying every tick doesn't feed the GC; copy what must
+    // outlive it. Empty when no grid is registered.
+    pimpl->queryResults = state.create_table(64, 0);
+    state["query_radius"] = [pimpl](float x, float y, float z, float r) {
+        SpatialHashSystem* proximity = ServiceLocator::Instance().GetSpatialHash();
+        return FillQueryResults(*pimpl, proximity ? proximity->GetGrid().QueryRadius({x, y, z}, r) : EntitySpan());
+    };
+    state["query_box"] = [pimpl](float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+        SpatialHashSystem* proximity = ServiceLocator::Instance().GetSpatialHash();
+        const AABB box{{minX, minY, minZ}, {maxX, maxY, maxZ}};
+        return FillQueryResults(*pimpl, proximity ? proximity->GetGrid().QueryBox(box) : EntitySpan());
+    };
+
+    // raycast(ox, oy, oz, dx, dy, dz, max_distance?) → id, distance — the
+    // closest rendered entity the ray hits, tested against its triangles,
+    // or -1 and nil. Distance is in units of the direction vector.
+    state["raycast"] = [](float ox, float oy, float oz, float dx, float dy, float dz,
+                          sol::optional<float> maxDistance) -> std::tuple<std::int64_t, sol::optional<float>> {
+        SpatialIndexSystem* index = ServiceLocator::Instance().GetSpatialIndex();
+        DynamicAABBTree::RayHit hit;
+        if (!index || !index->Raycast(gCoordinator, {ox, oy, oz}, {dx, dy, dz},
+                                      maxDistance.value_or(std::numeric_limits<float>::max()), hit)) {
+            return {-1, sol::nullopt};
+        }
+        return {ToLuaId(hit.entity), hit.distance};
+    };
+
     LOG_INFO("LuaScriptLanguage initialized (Lua 5.4 + sol2)");
 }
 
@@ -147,7 +147,7 @@ GLint Shader::getUniformLocation(const std::string& name) const {
     auto it = m_UniformLocationCache.find(name);
     if (it != m_UniformLocationCache.end()) return it->second;
     GLint location = glGetUniformLocation(ID, name.c_str());
-    m_UniformLocationCache[name] = location;
+    m_UniformLocationCache.try_emplace(name, location);
     return location;
 }
 
@@ -2,6 +2,8 @@
 #include "Core/Reflection.h"
 #include "GameExporter.h"
 #include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
+#include "ECS/WorldSnapshot.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Components/RenderComponent.h"
 #include "ECS/Components/PhysicsComponent.h"
@@ -40,9 +42,8 @@
 #include <set>
 #include <algorithm>
 
-#define MAX_ENTITIES 1000  // Reasonable limit for entity iteration
-
 extern Coordinator gCoordinator;
+extern EntityCommandBuffer gEntityCommands;
 
 UIManager::UIManager()
     : m_ShowDemo(false)
@@ -70,6 +71,8 @@ UIManager::UIManager()
     m_AssetBrowser = std::make_unique<AssetBrowser>();
     m_GizmoSystem = std::make_unique<GizmoSystem>();
     m_EditorState = std::make_unique<EditorState>();
+    m_PlaySnapshot = std::make_unique<WorldSnapshot>();
+    InstallPlaySnapshot();
     m_ConsoleSystem = std::make_unique<ConsoleSystem>();
     m_ConsoleSystem->RegisterBuiltins();
 
@@ -94,6 +97,65 @@ UIManager::~UIManager() {
     Shutdown();
 }
 
+void UIManager::InstallPlaySnapshot() {
+    // Bullet keeps its own copy of each body's pose and velocity, so a
+    // restored PhysicsComponent would still point at a body left wherever
+    // the simulation put it. Save the body state alongside the world and
+    // push it back after the restore.
+    // Plain scalars: Bullet's math types aren't trivially copyable.
+    struct BodyState {
+        btScalar transform[16];
+        btScalar linearVelocity[3];
+        btScalar angularVelocity[3];
+    };
+    m_PlaySnapshot->AddHooks<PhysicsComponent, BodyState>(
+        [](Entity, const PhysicsComponent& physics) {
+            BodyState state{};
+            if (btRigidBody* body = physics.rigidBody) {
+                body->getWorldTransform().getOpenGLMatrix(state.transform);
+                const btVector3& linear = body->getLinearVelocity();
+                const btVector3& angular = body->getAngularVelocity();
+                for (int i = 0; i < 3; i++) {
+                    state.linearVelocity[i] = linear[i];
+                    state.angularVelocity[i] = angular[i];
+                }
+            }
+            return state;
+        },
+        [](Entity, PhysicsComponent& physics, const BodyState& state) {
+            btRigidBody* body = physics.rigidBody;
+            if (!body) return;
+            btTransform transform;
+            transform.setFromOpenGLMatrix(state.transform);
+            body->setWorldTransform(transform);
+            if (body->getMotionState()) body->getMotionState()->setWorldTransform(transform);
+            body->setLinearVelocity(btVector3(state.linearVelocity[0], state.linearVelocity[1], state.linearVelocity[2]));
+            body->setAngularVelocity(btVector3(state.angularVelocity[0], state.angularVelocity[1], state.angularVelocity[2]));
+            body->clearForces();
+            body->activate(true);
+        });
+
+    // Capture after the frame's deferred commands land so the snapshot is
+    // the world the user sees; on restore, anything queued during play
+    // refers to handles the restore just invalidated.
+    m_EditorState->SetSnapshotCallbacks(
+        [this]() {
+            Coordinator& coordinator = m_Coordinator ? *m_Coordinator : gCoordinator;
+            gEntityCommands.Playback(coordinator);
+            m_PlaySnapshot->Capture(coordinator);
+        },
+        [this]() {
+            Coordinator& coordinator = m_Coordinator ? *m_Coordinator : gCoordinator;
+            gEntityCommands.Clear();
+            m_PendingDeletes.clear(); // their destroys were just dropped
+            m_PlaySnapshot->Restore(coordinator);
+            if (m_HasSelectedEntity && !coordinator.IsAlive(m_SelectedEntity)) {
+                m_HasSelectedEntity = false;
+                m_SelectedEntity = 0;
+            }
+        });
+}
+
 bool UIManager::Initialize(GLFWwindow* window) {
     m_Window = window;  // cache for title updates + future GLFW calls
 
@@ -224,6 +286,9 @@ void UIManager::NewFrame() {
         // no runtime "game active" branch anymore. Kept the outer brace so the
         // diff vs the old `else` block is trivial.
 
+        // Before undo/redo, so a delete that has landed is undoable.
+        FlushPendingDeletes();
+
         // Process Ctrl+Z / Ctrl+Y for undo/redo
         ImGuiIO& undoIO = ImGui::GetIO();
         if (undoIO.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_Z) && m_UndoStack.CanUndo()) {
@@ -505,6 +570,7 @@ UIManager::EntitySnapshot UIManager::SnapshotEntity(Entity e) const {
         s.hasRender = true;
         s.renderable = r.renderable;
         s.visible    = r.visible;
+        s.castShadows = r.castShadows;
     }
     if (m_Coordinator->HasComponent<HierarchyComponent>(e)) {
         const auto& h = m_Coordinator->GetComponent<HierarchyComponent>(e);
@@ -528,6 +594,7 @@ Entity UIManager::RespawnFromSnapshot(const EntitySnapshot& snap) {
         RenderComponent r;
         r.renderable = static_cast<Renderable*>(snap.renderable);
         r.visible    = snap.visible;
+        r.castShadows = snap.castShadows;
         m_Coordinator->AddComponent(e, r);
     }
     if (snap.hasHierarchy) {
@@ -676,7 +743,6 @@ void UIManager::DrawHierarchyNode(Entity entity, const std::string& filterLower)
         ImGui::Separator();
         if (ImGui::MenuItem("Delete")) {
             DeleteEntity(entity);
-            m_EntityNames.erase(entity);
         }
         ImGui::EndPopup();
     }
@@ -847,6 +913,7 @@ void UIManager::DrawInspector() {
                 RenderComponent r;
                 r.renderable = static_cast<Renderable*>(snap.renderable);
                 r.visible    = snap.visible;
+                r.castShadows = snap.castShadows;
                 coord->AddComponent(sel, r);
             },
             [&] { DrawRenderComponent(coord->GetComponent<RenderComponent>(sel)); });
@@ -1058,7 +1125,7 @@ void UIManager::CreateEntity(const std::string& name) {
     if (!m_Coordinator) return;
 
     Entity entity = m_Coordinator->CreateEntity();
-    m_EntityCounter = std::max(m_EntityCounter, (int)entity + 1);
+    m_EntityCounter = std::max(m_EntityCounter, (int)EntityIndex(entity) + 1);
 
     TransformComponent transform;
     m_Coordinator->AddComponent(entity, transform);
@@ -1105,35 +1172,55 @@ void UIManager::DeleteEntity(Entity entity) {
     // documents this trade-off.
     EntitySnapshot snap = SnapshotEntity(entity);
 
-    m_Coordinator->DestroyEntity(entity);
-    m_EntityNames.erase(entity);
+    // Deferred: the hierarchy panel calls this mid-walk, holding pointers
+    // into HierarchyComponent storage that an immediate destroy would
+    // swap-and-pop out from under it. Applied at the next frame's sync
+    // point; FlushPendingDeletes records the undo once it has been.
+    gEntityCommands.DestroyEntity(entity);
+    m_PendingDeletes.push_back({entity, std::move(snap)});
     if (m_HasSelectedEntity && m_SelectedEntity == entity) {
         m_HasSelectedEntity = false;
         m_SelectedEntity = 0;
     }
     m_ConsoleMessages.push_back("Deleted entity: " + std::to_string(entity));
+}
 
-    // Record undo. Redo re-destroys the entity-id-of-the-moment; undo
-    // respawns from the snapshot. Entity ids *may* change across the
-    // cycle — undo_id below is mutable state the lambda captures by
-    // shared_ptr so redo/undo can rebind after a respawn.
-    auto respawnedId = std::make_shared<Entity>(entity);
-    Mist::Editor::Command c;
-    c.label = "Delete entity";
-    c.merge_key = 0;  // never merge deletes
-    c.undo = [this, snap, respawnedId]() {
-        *respawnedId = RespawnFromSnapshot(snap);
-    };
-    c.redo = [this, respawnedId]() {
-        if (m_Coordinator && m_Coordinator->GetLivingEntities().count(*respawnedId)) {
-            m_Coordinator->DestroyEntity(*respawnedId);
-            m_EntityNames.erase(*respawnedId);
-            if (m_HasSelectedEntity && m_SelectedEntity == *respawnedId) {
-                m_HasSelectedEntity = false;
-            }
+void UIManager::FlushPendingDeletes() {
+    if (!m_Coordinator || m_PendingDeletes.empty()) return;
+
+    std::vector<PendingDelete> waiting;
+    for (PendingDelete& pending : m_PendingDeletes) {
+        if (m_Coordinator->IsAlive(pending.entity)) {
+            waiting.push_back(std::move(pending));
+            continue;
         }
-    };
-    m_UndoStack.Push(std::move(c));
+        m_EntityNames.erase(pending.entity);
+
+        // Record undo. Redo re-destroys the entity-id-of-the-moment; undo
+        // respawns from the snapshot. Entity ids *may* change across the
+        // cycle — the id below is mutable state the lambdas capture by
+        // shared_ptr so redo/undo can rebind after a respawn. Both run
+        // from the shortcut handler or the Edit menu, outside any panel
+        // walk, so they apply immediately.
+        auto respawnedId = std::make_shared<Entity>(pending.entity);
+        Mist::Editor::Command c;
+        c.label = "Delete entity";
+        c.merge_key = 0;  // never merge deletes
+        c.undo = [this, snap = std::move(pending.snapshot), respawnedId]() {
+            *respawnedId = RespawnFromSnapshot(snap);
+        };
+        c.redo = [this, respawnedId]() {
+            if (m_Coordinator && m_Coordinator->IsAlive(*respawnedId)) {
+                m_Coordinator->DestroyEntity(*respawnedId);
+                m_EntityNames.erase(*respawnedId);
+                if (m_HasSelectedEntity && m_SelectedEntity == *respawnedId) {
+                    m_HasSelectedEntity = false;
+                }
+            }
+        };
+        m_UndoStack.Push(std::move(c));
+    }
+    m_PendingDeletes = std::move(waiting);
 }
 
 void UIManager::SelectEntity(Entity entity) {
@@ -1144,7 +1231,7 @@ void UIManager::SelectEntity(Entity entity) {
 void UIManager::CreateCube() {
     if (m_Coordinator && m_PhysicsSystem) {
         Entity entity = m_Coordinator->CreateEntity();
-        m_EntityCounter = std::max(m_EntityCounter, (int)entity + 1);
+        m_EntityCounter = std::max(m_EntityCounter, (int)EntityIndex(entity) + 1);
         
         m_ConsoleMessages.push_back("Creating cube entity " + std::to_string(entity));
         
@@ -1190,7 +1277,7 @@ void UIManager::CreateCube() {
 void UIManager::CreateSphere() {
     if (m_Coordinator && m_PhysicsSystem) {
         Entity entity = m_Coordinator->CreateEntity();
-        m_EntityCounter = std::max(m_EntityCounter, (int)entity + 1);
+        m_EntityCounter = std::max(m_EntityCounter, (int)EntityIndex(entity) + 1);
         
         m_ConsoleMessages.push_back("Creating sphere entity " + std::to_string(entity));
         
@@ -1236,7 +1323,7 @@ void UIManager::CreateSphere() {
 void UIManager::CreatePlane() {
     if (m_Coordinator && m_PhysicsSystem) {
         Entity entity = m_Coordinator->CreateEntity();
-        m_EntityCounter = std::max(m_EntityCounter, (int)entity + 1);
+        m_EntityCounter = std::max(m_EntityCounter, (int)EntityIndex(entity) + 1);
         
         m_ConsoleMessages.push_back("Creating plane entity " + std::to_string(entity));
         
@@ -1282,12 +1369,21 @@ void UIManager::CreatePlane() {
 void UIManager::DrawTransformComponent(TransformComponent& transform) {
     // Store original values to detect changes
     glm::vec3 originalPos = transform.position;
-    glm::vec3 originalRot = transform.rotation;
+    glm::quat originalRot = transform.rotation;
     glm::vec3 originalScale = transform.scale;
 
+    // Rotation is a quaternion; the inspector edits an Euler view of it.
+    glm::vec3 euler = transform.GetEulerDegrees();
+    if (m_EulerView.entity == m_SelectedEntity && m_EulerView.rotation == transform.rotation) {
+        euler = m_EulerView.degrees;
+    }
+    const glm::vec3 originalEuler = euler;
+
     DrawVec3Control("Position", transform.position);
-    DrawVec3Control("Rotation", transform.rotation);
+    DrawVec3Control("Rotation", euler);
     DrawVec3Control("Scale", transform.scale, 1.0f);
+    if (euler != originalEuler) transform.SetEulerDegrees(euler);
+    m_EulerView = {m_SelectedEntity, transform.rotation, euler};
 
     // If transform was modified, record undo command and sync physics
     if (m_HasSelectedEntity && m_Coordinator) {
@@ -1296,13 +1392,16 @@ void UIManager::DrawTransformComponent(TransformComponent& transform) {
                                 transform.scale != originalScale);
 
         if (transformChanged) {
+            transform.dirty = true;
+            m_Coordinator->MarkChanged<TransformComponent>(m_SelectedEntity);
+
             // Capture for undo via the merge-aware stack. Using one key
             // per entity transform ("entity/transform") means successive
             // drags within 500ms collapse into a single undo step —
             // matches Godot's slider-drag behaviour.
             Entity entity = m_SelectedEntity;
             glm::vec3 newPos = transform.position;
-            glm::vec3 newRot = transform.rotation;
+            glm::quat newRot = transform.rotation;
             glm::vec3 newScale = transform.scale;
             Coordinator* coord = m_Coordinator;
 
@@ -1311,16 +1410,14 @@ void UIManager::DrawTransformComponent(TransformComponent& transform) {
             c.merge_key = (static_cast<std::uint64_t>(entity) << 8) | 0x01; // 0x01 = transform
             c.redo = [coord, entity, newPos, newRot, newScale]() {
                 if (coord->HasComponent<TransformComponent>(entity)) {
-                    auto& t = coord->GetComponent<TransformComponent>(entity);
-                    t.position = newPos; t.rotation = newRot; t.scale = newScale;
-                    t.dirty = true;
+                    auto& t = coord->GetComponentMut<TransformComponent>(entity);
+                    t.SetPosition(newPos); t.SetRotation(newRot); t.SetScale(newScale);
                 }
             };
             c.undo = [coord, entity, originalPos, originalRot, originalScale]() {
                 if (coord->HasComponent<TransformComponent>(entity)) {
-                    auto& t = coord->GetComponent<TransformComponent>(entity);
-                    t.position = originalPos; t.rotation = originalRot; t.scale = originalScale;
-                    t.dirty = true;
+                    auto& t = coord->GetComponentMut<TransformComponent>(entity);
+                    t.SetPosition(originalPos); t.SetRotation(originalRot); t.SetScale(originalScale);
                 }
             };
             m_UndoStack.Push(std::move(c));
@@ -1334,12 +1431,8 @@ void UIManager::DrawTransformComponent(TransformComponent& transform) {
                     btTransform physicsTransform;
                     physicsTransform.setOrigin(btVector3(transform.position.x, transform.position.y, transform.position.z));
                     
-                    // Convert rotation from degrees to radians for physics
-                    btQuaternion rotation;
-                    rotation.setEulerZYX(glm::radians(transform.rotation.y), 
-                                       glm::radians(transform.rotation.x), 
-                                       glm::radians(transform.rotation.z));
-                    physicsTransform.setRotation(rotation);
+                    const glm::quat& q = transform.rotation;
+                    physicsTransform.setRotation(btQuaternion(q.x, q.y, q.z, q.w));
                     
                     physics.rigidBody->setWorldTransform(physicsTransform);
                     physics.rigidBody->getMotionState()->setWorldTransform(physicsTransform);
@@ -1955,6 +2048,7 @@ void UIManager::DrawProfilerWindow() {
     ImGui::Text("FPS: %.1f (%.2f ms)", profiler.GetFPS(), profiler.GetFrameTimeMs());
     ImGui::Text("Draw Calls: %d", profiler.GetDrawCalls());
     ImGui::Text("Triangles: %d", profiler.GetTriangles());
+    ImGui::Text("Instance Groups: %d (%d instances)", profiler.GetInstanceGroups(), profiler.GetInstances());
 
     ImGui::PlotLines("FPS", profiler.GetFPSHistory(), profiler.GetFPSHistorySize(),
         profiler.GetFPSHistoryOffset(), nullptr, 0.0f, 120.0f, ImVec2(0, 60));
@@ -2120,7 +2214,7 @@ void UIManager::DrawSkyboxControls() {
 
 void UIManager::SetEntityName(Entity entity, const std::string& name) {
     m_EntityNames[entity] = name;
-    m_EntityCounter = std::max(m_EntityCounter, (int)entity + 1);
+    m_EntityCounter = std::max(m_EntityCounter, (int)EntityIndex(entity) + 1);
 }
 
 // --- Toolbar ---
@@ -2313,13 +2407,19 @@ void UIManager::DrawEditorLayout() {
                 }
 
                 if (m_GizmoSystem->Manipulate(view, proj, model)) {
-                    float tr[3], rot[3], sc[3];
-                    ImGuizmo::DecomposeMatrixToComponents(
-                        glm::value_ptr(model), tr, rot, sc);
-                    t.position = {tr[0],  tr[1],  tr[2]};
-                    t.rotation = {rot[0], rot[1], rot[2]};
-                    t.scale    = {sc[0],  sc[1],  sc[2]};
-                    t.dirty    = true;
+                    // TRS straight off the matrix: translation column,
+                    // column lengths, and the rotation from the normalised
+                    // basis. No Euler round trip.
+                    const glm::vec3 sc(glm::length(glm::vec3(model[0])),
+                                       glm::length(glm::vec3(model[1])),
+                                       glm::length(glm::vec3(model[2])));
+                    const glm::mat3 basis(glm::vec3(model[0]) / sc.x,
+                                          glm::vec3(model[1]) / sc.y,
+                                          glm::vec3(model[2]) / sc.z);
+                    t.SetPosition(glm::vec3(model[3]));
+                    t.SetRotation(glm::normalize(glm::quat_cast(basis)));
+                    t.SetScale(sc);
+                    m_Coordinator->MarkChanged<TransformComponent>(m_SelectedEntity);
                 }
 
                 // Drag ended this frame — push the undo command.
@@ -2327,10 +2427,10 @@ void UIManager::DrawEditorLayout() {
                     Coordinator* coord = m_Coordinator;
                     Entity ent         = m_GizmoCapture.entity;
                     glm::vec3 oldPos   = m_GizmoCapture.position;
-                    glm::vec3 oldRot   = m_GizmoCapture.rotation;
+                    glm::quat oldRot   = m_GizmoCapture.rotation;
                     glm::vec3 oldScale = m_GizmoCapture.scale;
                     glm::vec3 newPos   = t.position;
-                    glm::vec3 newRot   = t.rotation;
+                    glm::quat newRot   = t.rotation;
                     glm::vec3 newScale = t.scale;
 
                     Mist::Editor::Command c;
@@ -2343,16 +2443,14 @@ void UIManager::DrawEditorLayout() {
                                 | (static_cast<std::uint64_t>(m_GizmoSystem->GetMode()) + 0x10);
                     c.redo = [coord, ent, newPos, newRot, newScale]() {
                         if (coord->HasComponent<TransformComponent>(ent)) {
-                            auto& tt = coord->GetComponent<TransformComponent>(ent);
-                            tt.position = newPos; tt.rotation = newRot; tt.scale = newScale;
-                            tt.dirty = true;
+                            auto& tt = coord->GetComponentMut<TransformComponent>(ent);
+                            tt.SetPosition(newPos); tt.SetRotation(newRot); tt.SetScale(newScale);
                         }
                     };
                     c.undo = [coord, ent, oldPos, oldRot, oldScale]() {
                         if (coord->HasComponent<TransformComponent>(ent)) {
-                            auto& tt = coord->GetComponent<TransformComponent>(ent);
-                            tt.position = oldPos; tt.rotation = oldRot; tt.scale = oldScale;
-                            tt.dirty = true;
+                            auto& tt = coord->GetComponentMut<TransformComponent>(ent);
+                            tt.SetPosition(oldPos); tt.SetRotation(oldRot); tt.SetScale(oldScale);
                         }
                     };
                     m_UndoStack.Push(std::move(c));
@@ -2514,6 +2612,7 @@ void UIManager::LoadScene(const std::string& path) {
         // New scene = fresh history. Undoing back into the previous
         // scene's entities would produce zombie ids.
         m_UndoStack.Clear();
+        m_PendingDeletes.clear();
     } else {
         m_ConsoleMessages.push_back("Failed to load scene from: " + path);
     }
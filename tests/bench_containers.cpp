@@ -0,0 +1,143 @@
+// Core container microbenchmarks against the std containers they replace;
+// hidden like bench_ecs.cpp, run with
+//
+//     ./MistEngineTests "[benchmark][containers]"
+//
+// Build in Release — Debug + ASan numbers are meaningless here.
+#include "Core/FlatHashMap.h"
+#include "Core/SlotMap.h"
+#include "Core/SmallVector.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Every uniform in the PBR program (pbr_vertex.glsl + pbr_fragment.glsl),
+// i.e. what its Shader's location cache holds once warm.
+const char* const kUniformNames[] = {
+    "model", "view", "projection", "lightSpaceMatrix",
+    "material.albedoMap", "material.normalMap", "material.metallicMap", "material.roughnessMap",
+    "material.aoMap", "material.emissiveMap", "material.hasAlbedoMap", "material.hasNormalMap",
+    "material.hasMetallicMap", "material.hasRoughnessMap", "material.hasAOMap",
+    "material.hasEmissiveMap", "material.albedoColor", "material.metallicValue",
+    "material.roughnessValue", "material.aoValue", "material.emissiveColor",
+    "viewPos", "lightDir", "lightColor", "exposure", "shadowMap", "ssaoTexture", "useSSAO",
+    "irradianceMap", "prefilterMap", "brdfLUT", "useIBL",
+};
+
+} // namespace
+
+TEST_CASE("Uniform-location lookups: unordered_map vs FlatHashMap", "[.][benchmark][containers]") {
+    std::vector<std::string> names(std::begin(kUniformNames), std::end(kUniformNames));
+    std::unordered_map<std::string, int> stdMap;
+    Mist::FlatHashMap<std::string, int> flatMap;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        stdMap[names[i]] = int(i);
+        flatMap[names[i]] = int(i);
+    }
+
+    BENCHMARK("std::unordered_map, PBR uniforms") {
+        int sum = 0;
+        for (const std::string& name : names) sum += stdMap.find(name)->second;
+        return sum;
+    };
+    BENCHMARK("FlatHashMap, PBR uniforms") {
+        int sum = 0;
+        for (const std::string& name : names) sum += flatMap.find(name)->second;
+        return sum;
+    };
+}
+
+TEST_CASE("Integer-key lookups: unordered_map vs FlatHashMap", "[.][benchmark][containers]") {
+    constexpr std::uint64_t kKeys = 100000;
+    std::vector<std::uint64_t> probes(kKeys);
+    std::mt19937_64 rng(7);
+    for (auto& probe : probes) probe = rng() % (kKeys * 2); // ~half miss
+
+    std::unordered_map<std::uint64_t, std::uint32_t> stdMap;
+    Mist::FlatHashMap<std::uint64_t, std::uint32_t> flatMap;
+    for (std::uint64_t k = 0; k < kKeys; ++k) {
+        stdMap[k * 2] = std::uint32_t(k);
+        flatMap[k * 2] = std::uint32_t(k);
+    }
+
+    BENCHMARK("std::unordered_map find, 100k") {
+        std::uint64_t hits = 0;
+        for (std::uint64_t probe : probes) hits += stdMap.count(probe);
+        return hits;
+    };
+    BENCHMARK("FlatHashMap find, 100k") {
+        std::uint64_t hits = 0;
+        for (std::uint64_t probe : probes) hits += flatMap.count(probe);
+        return hits;
+    };
+
+    BENCHMARK("std::unordered_map insert, 100k") {
+        std::unordered_map<std::uint64_t, std::uint32_t> map;
+        for (std::uint64_t k = 0; k < kKeys; ++k) map[k] = std::uint32_t(k);
+        return map.size();
+    };
+    BENCHMARK("FlatHashMap insert, 100k") {
+        Mist::FlatHashMap<std::uint64_t, std::uint32_t> map;
+        for (std::uint64_t k = 0; k < kKeys; ++k) map[k] = std::uint32_t(k);
+        return map.size();
+    };
+}
+
+TEST_CASE("Short lists: std::vector vs SmallVector", "[.][benchmark][containers]") {
+    // Build-and-drop of a 6-element list, as for an entity's children.
+    BENCHMARK("std::vector, 10k lists of 6") {
+        int sum = 0;
+        for (int list = 0; list < 10000; ++list) {
+            std::vector<int> v;
+            for (int i = 0; i < 6; ++i) v.push_back(i + list);
+            sum += v.back();
+        }
+        return sum;
+    };
+    BENCHMARK("SmallVector<8>, 10k lists of 6") {
+        int sum = 0;
+        for (int list = 0; list < 10000; ++list) {
+            Mist::SmallVector<int, 8> v;
+            for (int i = 0; i < 6; ++i) v.push_back(i + list);
+            sum += v.back();
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Handle lookups: unordered_map vs SlotMap", "[.][benchmark][containers]") {
+    // GLRenderingDevice's resource table: resolve a live handle per bind.
+    constexpr std::uint32_t kHandles = 10000;
+    std::unordered_map<std::uint64_t, std::uint32_t> stdMap;
+    Mist::SlotMap<std::uint32_t> slotMap;
+    std::vector<std::uint64_t> ids;
+    std::vector<Mist::SlotMapKey> keys;
+    for (std::uint32_t i = 0; i < kHandles; ++i) {
+        stdMap[i + 1] = i;
+        ids.push_back(i + 1);
+        keys.push_back(slotMap.Insert(i));
+    }
+    std::mt19937 rng(11);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    BENCHMARK("std::unordered_map, 10k handles") {
+        std::uint64_t sum = 0;
+        for (std::uint64_t id : ids) sum += stdMap.find(id)->second;
+        return sum;
+    };
+    BENCHMARK("SlotMap, 10k handles") {
+        std::uint64_t sum = 0;
+        for (Mist::SlotMapKey key : keys) sum += *slotMap.Get(key);
+        return sum;
+    };
+}
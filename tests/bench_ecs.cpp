@@ -0,0 +1,500 @@
+// ECS microbenchmarks. Tagged `[.][benchmark]` so they're hidden from the
+// default run (and therefore from ctest); invoke explicitly with
+//
+//     ./MistEngineTests "[benchmark]"
+//
+// Build in Release — Debug + ASan numbers are meaningless here.
+#include "ECS/ComponentArray.h"
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/TransformComponent.h"
+#include "ECS/Coordinator.h"
+#include "ECS/Systems/HierarchySystem.h"
+#include "ECS/WorldSnapshot.h"
+
+#include <catch2/catch_all.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr Entity kBenchEntities = 100000;
+
+struct BenchPosition {
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+};
+
+struct BenchVelocity {
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+};
+
+struct BenchTag {
+    int value = 0;
+};
+
+class BenchMoveSystem : public System {};
+
+// The pre-sparse-set ComponentArray, kept verbatim (minus the interface)
+// as the "before" side of the comparison.
+template <typename T> class HashMapComponentArray {
+  public:
+    void InsertData(Entity entity, T component) {
+        size_t newIndex = m_Size;
+        m_EntityToIndexMap[entity] = newIndex;
+        m_IndexToEntityMap[newIndex] = entity;
+        if (newIndex >= m_ComponentArray.size()) {
+            m_ComponentArray.resize(newIndex + 1);
+        }
+        m_ComponentArray[newIndex] = component;
+        ++m_Size;
+    }
+
+    void RemoveData(Entity entity) {
+        auto it = m_EntityToIndexMap.find(entity);
+        if (it == m_EntityToIndexMap.end()) return;
+        size_t indexOfRemovedEntity = it->second;
+        size_t indexOfLastElement = m_Size - 1;
+        if (indexOfRemovedEntity != indexOfLastElement) {
+            m_ComponentArray[indexOfRemovedEntity] = m_ComponentArray[indexOfLastElement];
+            Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
+            m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
+            m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+        }
+        m_EntityToIndexMap.erase(entity);
+        m_IndexToEntityMap.erase(indexOfLastElement);
+        --m_Size;
+    }
+
+    T& GetData(Entity entity) { return m_ComponentArray[m_EntityToIndexMap.find(entity)->second]; }
+
+    template <typename Fn> void ForEach(Fn&& fn) {
+        for (size_t i = 0; i < m_Size; i++) {
+            fn(m_IndexToEntityMap[i], m_ComponentArray[i]);
+        }
+    }
+
+  private:
+    std::vector<T> m_ComponentArray;
+    std::unordered_map<Entity, size_t> m_EntityToIndexMap;
+    std::unordered_map<size_t, Entity> m_IndexToEntityMap;
+    size_t m_Size{};
+};
+
+std::vector<Entity> ShuffledEntities() {
+    std::vector<Entity> ids(kBenchEntities);
+    std::iota(ids.begin(), ids.end(), Entity{0});
+    std::shuffle(ids.begin(), ids.end(), std::mt19937{1234});
+    return ids;
+}
+
+template <typename Array> void Fill(Array& arr) {
+    for (Entity e = 0; e < kBenchEntities; ++e) {
+        arr.InsertData(e, BenchPosition{float(e), 0.f, 0.f});
+    }
+}
+
+template <typename Array> void RunComponentArrayBenchmarks() {
+    const auto shuffled = ShuffledEntities();
+
+    BENCHMARK("insert 100k") {
+        Array arr;
+        Fill(arr);
+        return arr.GetData(kBenchEntities - 1).x;
+    };
+
+    BENCHMARK_ADVANCED("remove 100k (random order)")(Catch::Benchmark::Chronometer meter) {
+        std::vector<Array> arrays(meter.runs());
+        for (auto& arr : arrays) Fill(arr);
+        meter.measure([&](int run) {
+            auto& arr = arrays[run];
+            for (Entity e : shuffled) arr.RemoveData(e);
+        });
+    };
+
+    Array filled;
+    Fill(filled);
+
+    BENCHMARK("random get 100k") {
+        float sum = 0.f;
+        for (Entity e : shuffled) sum += filled.GetData(e).x;
+        return sum;
+    };
+
+    BENCHMARK("linear iterate 100k") {
+        float sum = 0.f;
+        filled.ForEach([&](Entity, BenchPosition& p) { sum += p.x; });
+        return sum;
+    };
+}
+
+} // namespace
+
+TEST_CASE("ComponentArray storage: hash-map baseline", "[.][benchmark][ecs]") {
+    RunComponentArrayBenchmarks<HashMapComponentArray<BenchPosition>>();
+}
+
+TEST_CASE("ComponentArray storage: sparse set", "[.][benchmark][ecs]") {
+    RunComponentArrayBenchmarks<ComponentArray<BenchPosition>>();
+}
+
+TEST_CASE("Two-component iteration: system set vs archetype view", "[.][benchmark][ecs]") {
+    // Same world built three times: once with the default sparse-set storage and
+    // the usual System + GetComponent<T> loop, once with archetype storage
+    // iterated through Coordinator::View, plus sparse-set storage with an
+    // owning group over the pair. A third of the entities carry an
+    // extra tag so the view has to cross more than one archetype.
+    auto registerTypes = [](Coordinator& coord, ComponentStorage storage) {
+        coord.Init();
+        coord.RegisterComponent<BenchPosition>(storage);
+        coord.RegisterComponent<BenchVelocity>(storage);
+        coord.RegisterComponent<BenchTag>(storage);
+    };
+    auto spawn = [](Coordinator& coord) {
+        for (Entity i = 0; i < kBenchEntities; ++i) {
+            Entity e = coord.CreateEntity();
+            coord.AddComponent(e, BenchPosition{float(i), 0.f, 0.f});
+            coord.AddComponent(e, BenchVelocity{1.f, 2.f, 3.f});
+            if (i % 3 == 0) coord.AddComponent(e, BenchTag{int(i)});
+        }
+    };
+
+    Coordinator sparse;
+    registerTypes(sparse, ComponentStorage::SparseSet);
+    auto system = sparse.RegisterSystem<BenchMoveSystem>();
+    Signature sig;
+    sig.set(sparse.GetComponentType<BenchPosition>());
+    sig.set(sparse.GetComponentType<BenchVelocity>());
+    sparse.SetSystemSignature<BenchMoveSystem>(sig);
+    spawn(sparse);
+
+    Coordinator chunked;
+    registerTypes(chunked, ComponentStorage::Archetype);
+    spawn(chunked);
+
+    Coordinator grouped;
+    registerTypes(grouped, ComponentStorage::SparseSet);
+    spawn(grouped);
+    grouped.Group<BenchPosition, BenchVelocity>();
+
+    BENCHMARK("system set + GetComponent x2") {
+        for (Entity e : system->m_Entities) {
+            auto& p = sparse.GetComponent<BenchPosition>(e);
+            const auto& v = sparse.GetComponent<BenchVelocity>(e);
+            p.x += v.x;
+            p.y += v.y;
+            p.z += v.z;
+        }
+        return sparse.GetComponent<BenchPosition>(0).x;
+    };
+
+    BENCHMARK("Group<Position, Velocity>::ForEach") {
+        grouped.Group<BenchPosition, BenchVelocity>().ForEach(
+            [](Entity, BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.x;
+                p.y += v.y;
+                p.z += v.z;
+            });
+        return grouped.GetComponent<BenchPosition>(0).x;
+    };
+
+    BENCHMARK("View<Position, Velocity>::ForEach") {
+        chunked.View<BenchPosition, BenchVelocity>().ForEach(
+            [](Entity, BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.x;
+                p.y += v.y;
+                p.z += v.z;
+            });
+        return chunked.GetComponent<BenchPosition>(0).x;
+    };
+
+    BENCHMARK("View<Position, Velocity>::ForEachChunk") {
+        chunked.View<BenchPosition, BenchVelocity>().ForEachChunk(
+            [](size_t count, const Entity*, BenchPosition* p, const BenchVelocity* v) {
+                for (size_t i = 0; i < count; ++i) {
+                    p[i].x += v[i].x;
+                    p[i].y += v[i].y;
+                    p[i].z += v[i].z;
+                }
+            });
+        return chunked.GetComponent<BenchPosition>(0).x;
+    };
+}
+
+namespace {
+class BenchSystemA : public System {};
+class BenchSystemB : public System {};
+class BenchSystemC : public System {};
+class BenchSystemD : public System {};
+} // namespace
+
+TEST_CASE("Bulk scene load: membership updates", "[.][benchmark][ecs]") {
+    // Mirrors a scene load: 100k entities, three AddComponent calls each,
+    // four registered systems with overlapping signatures.
+    BENCHMARK("spawn 100k x 3 components, 4 systems") {
+        Coordinator coord;
+        coord.Init();
+        coord.RegisterComponent<BenchPosition>();
+        coord.RegisterComponent<BenchVelocity>();
+        coord.RegisterComponent<BenchTag>();
+        coord.RegisterSystem<BenchSystemA>();
+        coord.RegisterSystem<BenchSystemB>();
+        coord.RegisterSystem<BenchSystemC>();
+        coord.RegisterSystem<BenchSystemD>();
+
+        const ComponentType pos = coord.GetComponentType<BenchPosition>();
+        const ComponentType vel = coord.GetComponentType<BenchVelocity>();
+        const ComponentType tag = coord.GetComponentType<BenchTag>();
+        coord.SetSystemSignature<BenchSystemA>(Signature{}.set(pos));
+        coord.SetSystemSignature<BenchSystemB>(Signature{}.set(pos).set(vel));
+        coord.SetSystemSignature<BenchSystemC>(Signature{}.set(pos).set(tag));
+        coord.SetSystemSignature<BenchSystemD>(Signature{}.set(tag));
+
+        for (Entity i = 0; i < kBenchEntities; ++i) {
+            Entity e = coord.CreateEntity();
+            coord.AddComponent(e, BenchPosition{});
+            coord.AddComponent(e, BenchVelocity{});
+            coord.AddComponent(e, BenchTag{});
+        }
+        return coord.GetComponentType<BenchTag>();
+    };
+}
+
+TEST_CASE("Bulk spawn: per-entity vs CreateEntities + AddComponents", "[.][benchmark][ecs]") {
+    // 100k fully-formed entities (three components, four systems), built
+    // one AddComponent at a time and then through the bulk API.
+    auto makeWorld = [](Coordinator& coord) {
+        coord.Init();
+        coord.RegisterComponent<BenchPosition>();
+        coord.RegisterComponent<BenchVelocity>();
+        coord.RegisterComponent<BenchTag>();
+        coord.RegisterSystem<BenchSystemA>();
+        coord.RegisterSystem<BenchSystemB>();
+        coord.RegisterSystem<BenchSystemC>();
+        coord.RegisterSystem<BenchSystemD>();
+        const ComponentType pos = coord.GetComponentType<BenchPosition>();
+        const ComponentType vel = coord.GetComponentType<BenchVelocity>();
+        const ComponentType tag = coord.GetComponentType<BenchTag>();
+        coord.SetSystemSignature<BenchSystemA>(Signature{}.set(pos));
+        coord.SetSystemSignature<BenchSystemB>(Signature{}.set(pos).set(vel));
+        coord.SetSystemSignature<BenchSystemC>(Signature{}.set(pos).set(tag));
+        coord.SetSystemSignature<BenchSystemD>(Signature{}.set(tag));
+    };
+
+    std::vector<BenchPosition> positions(kBenchEntities);
+    std::vector<BenchVelocity> velocities(kBenchEntities, BenchVelocity{1.f, 2.f, 3.f});
+    std::vector<BenchTag> tags(kBenchEntities);
+    for (Entity i = 0; i < kBenchEntities; ++i) {
+        positions[i] = {float(i), 0.f, 0.f};
+        tags[i] = {int(i)};
+    }
+
+    BENCHMARK("per-entity: CreateEntity + 3x AddComponent") {
+        Coordinator coord;
+        makeWorld(coord);
+        for (Entity i = 0; i < kBenchEntities; ++i) {
+            Entity e = coord.CreateEntity();
+            coord.AddComponent(e, positions[i]);
+            coord.AddComponent(e, velocities[i]);
+            coord.AddComponent(e, tags[i]);
+        }
+        return coord.GetLivingEntities().size();
+    };
+
+    BENCHMARK("bulk: CreateEntities + AddComponents") {
+        Coordinator coord;
+        makeWorld(coord);
+        std::vector<Entity> entities = coord.CreateEntities(kBenchEntities);
+        coord.AddComponents(entities, positions, velocities, tags);
+        return coord.GetLivingEntities().size();
+    };
+}
+
+TEST_CASE("World snapshot capture and restore", "[.][benchmark][ecs]") {
+    // Editor play-mode round trip on a 100k-entity world: three components
+    // and two systems per entity.
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<BenchPosition>();
+    coord.RegisterComponent<BenchVelocity>();
+    coord.RegisterComponent<BenchTag>();
+    coord.RegisterSystem<BenchSystemA>();
+    coord.RegisterSystem<BenchSystemB>();
+    coord.SetSystemSignature<BenchSystemA>(Signature{}.set(coord.GetComponentType<BenchPosition>()));
+    coord.SetSystemSignature<BenchSystemB>(Signature{}
+                                               .set(coord.GetComponentType<BenchPosition>())
+                                               .set(coord.GetComponentType<BenchVelocity>()));
+    for (Entity i = 0; i < kBenchEntities; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, BenchPosition{float(i), 0.f, 0.f});
+        coord.AddComponent(e, BenchVelocity{1.f, 2.f, 3.f});
+        coord.AddComponent(e, BenchTag{int(i)});
+    }
+
+    WorldSnapshot snapshot;
+    snapshot.Capture(coord);
+
+    BENCHMARK("capture 100k") {
+        snapshot.Capture(coord);
+        return snapshot.GetArenaSize();
+    };
+
+    BENCHMARK("restore 100k") {
+        snapshot.Restore(coord);
+        return coord.GetLivingEntities().size();
+    };
+}
+
+TEST_CASE("ComponentArray ForEach vs ParallelForEach", "[.][benchmark][ecs]") {
+    // A sync-loop-sized body per element, so the comparison is about the
+    // fan-out rather than about an empty loop being memory-bound.
+    ComponentArray<BenchPosition> arr;
+    Fill(arr);
+    auto body = [](Entity e, BenchPosition& p) {
+        p.y = std::sin(p.x + float(e)) * std::cos(p.z);
+        p.z += 0.5f * p.y;
+    };
+
+    BENCHMARK("ForEach 100k") {
+        arr.ForEach(body);
+        return arr.GetData(0).z;
+    };
+
+    BENCHMARK("ParallelForEach 100k (default grain)") {
+        arr.ParallelForEach(body);
+        return arr.GetData(0).z;
+    };
+
+    ParallelForOptions coarse;
+    coarse.grain = 16384;
+    BENCHMARK("ParallelForEach 100k (grain 16k)") {
+        arr.ParallelForEach(body, coarse);
+        return arr.GetData(0).z;
+    };
+}
+
+namespace {
+
+// The previous HierarchySystem walk, kept as the "before" side: recurse
+// from each root through HierarchyComponent::children, one component
+// lookup per node per level, and every local matrix rebuilt.
+void RecursiveCompose(Coordinator& coord, Entity e, const glm::mat4& parentGlobal) {
+    auto& t = coord.GetComponent<TransformComponent>(e);
+    t.cachedGlobal = parentGlobal * t.RebuildModelMatrix();
+    for (Entity child : coord.GetComponent<HierarchyComponent>(e).children) {
+        RecursiveCompose(coord, child, t.cachedGlobal);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Hierarchy update: recursive walk vs flattened levels", "[.][benchmark][ecs]") {
+    // 200 props, each a root with 10 parts of 10 sub-parts: 22,200 nodes
+    // in three levels.
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TransformComponent>();
+    coord.RegisterComponent<HierarchyComponent>();
+    auto sys = coord.RegisterSystem<HierarchySystem>();
+    coord.SetSystemSignature<HierarchySystem>(Signature{}
+                                                  .set(coord.GetComponentType<TransformComponent>())
+                                                  .set(coord.GetComponentType<HierarchyComponent>()));
+    auto make = [&](float x) {
+        Entity e = coord.CreateEntity();
+        TransformComponent t;
+        t.position = {x, 0.f, 0.f};
+        coord.AddComponent(e, t);
+        coord.AddComponent(e, HierarchyComponent{});
+        return e;
+    };
+    std::vector<Entity> roots;
+    for (int r = 0; r < 200; ++r) {
+        roots.push_back(make(float(r)));
+        for (int p = 0; p < 10; ++p) {
+            Entity part = make(1.f);
+            HierarchySystem::Attach(coord, roots.back(), part);
+            for (int s = 0; s < 10; ++s) HierarchySystem::Attach(coord, part, make(0.1f));
+        }
+    }
+    sys->UpdateTransforms(coord);
+
+    // Every root moves every frame, so both sides recompute every node.
+    BENCHMARK("recursive walk, 22k nodes") {
+        for (Entity root : roots) coord.GetComponentMut<TransformComponent>(root).position.y += 1.f;
+        for (Entity root : roots) RecursiveCompose(coord, root, glm::mat4(1.0f));
+        return coord.GetComponent<TransformComponent>(roots[0]).cachedGlobal[3][1];
+    };
+    BENCHMARK("flattened levels, 22k nodes") {
+        for (Entity root : roots) coord.GetComponentMut<TransformComponent>(root).position.y += 1.f;
+        sys->UpdateTransforms(coord);
+        return coord.GetComponent<TransformComponent>(roots[0]).cachedGlobal[3][1];
+    };
+
+    // One prop moves: only its 111-node subtree is walked.
+    BENCHMARK("dirty subtree, 1 of 200 props moved") {
+        coord.GetComponentMut<TransformComponent>(roots[7]).position.y += 1.f;
+        sys->UpdateTransforms(coord);
+        return coord.GetComponent<TransformComponent>(roots[7]).cachedGlobal[3][1];
+    };
+
+    // Static frame: both hierarchy passes the main loop runs.
+    sys->FireReadyCallbacks(coord);
+    BENCHMARK("static frame, UpdateTransforms + FireReadyCallbacks") {
+        sys->UpdateTransforms(coord);
+        sys->FireReadyCallbacks(coord);
+        return coord.GetChangeTick();
+    };
+
+    // Re-hanging a 111-node prop under another one moves it two levels down
+    // and back.
+    BENCHMARK("reparent a prop subtree and back") {
+        HierarchySystem::Attach(coord, roots[1], roots[0]);
+        sys->UpdateTransforms(coord);
+        HierarchySystem::Detach(coord, roots[0]);
+        sys->UpdateTransforms(coord);
+        return coord.GetComponent<TransformComponent>(roots[0]).cachedGlobal[3][0];
+    };
+}
+
+TEST_CASE("Local matrix: Euler rebuild vs cached quaternion TRS", "[.][benchmark][ecs]") {
+    // 10k transforms read once per pass, as RenderSystem does per cascade.
+    std::vector<TransformComponent> transforms(10000);
+    std::vector<glm::vec3> eulers(transforms.size());
+    for (std::size_t i = 0; i < transforms.size(); ++i) {
+        eulers[i] = glm::vec3(float(i % 360), float(i % 90), float(i % 180));
+        transforms[i].SetPosition(glm::vec3(float(i), 0.f, 0.f));
+        transforms[i].SetEulerDegrees(eulers[i]);
+    }
+
+    BENCHMARK("Euler translate/rotate x3/scale, 10k") {
+        float sum = 0.f;
+        for (std::size_t i = 0; i < transforms.size(); ++i) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), transforms[i].position);
+            m = glm::rotate(m, glm::radians(eulers[i].x), glm::vec3(1.0f, 0.0f, 0.0f));
+            m = glm::rotate(m, glm::radians(eulers[i].y), glm::vec3(0.0f, 1.0f, 0.0f));
+            m = glm::rotate(m, glm::radians(eulers[i].z), glm::vec3(0.0f, 0.0f, 1.0f));
+            m = glm::scale(m, transforms[i].scale);
+            sum += m[0][1];
+        }
+        return sum;
+    };
+    BENCHMARK("quaternion TRS rebuild, 10k") {
+        float sum = 0.f;
+        for (auto& t : transforms) sum += t.RebuildModelMatrix()[0][1];
+        return sum;
+    };
+    BENCHMARK("cached GetModelMatrix, 10k") {
+        float sum = 0.f;
+        for (const auto& t : transforms) sum += t.GetModelMatrix()[0][1];
+        return sum;
+    };
+}
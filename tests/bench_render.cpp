@@ -0,0 +1,145 @@
+// Render-stage microbenchmarks (CPU side only); hidden like bench_ecs.cpp,
+// run with
+//
+//     ./MistEngineTests "[benchmark][render]"
+//
+// Build in Release — Debug + ASan numbers are meaningless here.
+#include "Material.h"
+#include "Renderable.h"
+#include "Renderer/GeometryPool.h"
+#include "Renderer/RenderQueue.h"
+
+#include <catch2/catch_all.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kDrawItems = 100000;
+
+struct BenchMesh : Renderable {
+    Mist::Renderer::GeometryRange range{0, 24, 0, 36};
+
+    BenchMesh() { m_LocalBounds = AABB{glm::vec3(-0.5f), glm::vec3(0.5f)}; }
+    void Draw(Shader&) override {}
+    bool SupportsInstancing() const override { return true; }
+    const Mist::Renderer::GeometryRange* GetGeometryRange() const override { return &range; }
+};
+
+// 100k instances of 64 meshes and 32 materials over a 1 km square: a
+// prop-heavy level seen from its middle.
+struct DrawWorld {
+    std::vector<BenchMesh> meshes = std::vector<BenchMesh>(64);
+    std::vector<PBRMaterial> materials = std::vector<PBRMaterial>(32);
+    std::vector<BenchMesh*> itemMesh;
+    std::vector<const PBRMaterial*> itemMaterial;
+    std::vector<glm::mat4> world;
+
+    DrawWorld() {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        for (std::size_t i = 0; i < kDrawItems; ++i) {
+            itemMesh.push_back(&meshes[rng() % meshes.size()]);
+            itemMaterial.push_back(&materials[rng() % materials.size()]);
+            glm::mat4 m(1.0f);
+            m[3] = glm::vec4(pos(rng), 0.0f, pos(rng), 1.0f);
+            world.push_back(m);
+        }
+    }
+
+    void Fill(Mist::Renderer::RenderQueue& queue) const {
+        queue.Begin(glm::vec3(0, 10, 0), glm::vec3(1, 0, 1), 0.1f, 1000.0f);
+        for (std::size_t i = 0; i < kDrawItems; ++i) {
+            queue.Add(itemMesh[i], itemMaterial[i], world[i], Mist::Renderer::kPassAll, Entity(i));
+        }
+    }
+};
+
+struct NullSink : Mist::Renderer::DrawSink {
+    std::uint64_t touched = 0;
+    void BindMaterial(const Mist::Renderer::DrawItem& item) override { touched += item.entity; }
+    void Draw(const Mist::Renderer::DrawItem& item, const glm::mat4& m) override {
+        touched += item.entity + std::uint64_t(m[3].x);
+    }
+    void DrawInstanced(const Mist::Renderer::DrawItem& item, std::uint32_t first, std::uint32_t count) override {
+        touched += item.entity + first + count;
+    }
+    void DrawIndirect(const Mist::Renderer::DrawItem& item, std::uint32_t first, std::uint32_t count) override {
+        touched += item.entity + first + count;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Render queue: 100k draw items", "[.][benchmark][render]") {
+    DrawWorld world;
+    Mist::Renderer::RenderQueue queue;
+
+    BENCHMARK("extract 100k (Begin + Add)") {
+        world.Fill(queue);
+        return queue.Size();
+    };
+
+    world.Fill(queue);
+    BENCHMARK("radix sort 100k keys") {
+        queue.Sort();
+        return queue.Sorted(0).entity;
+    };
+    BENCHMARK("std::sort 100k keys (reference)") {
+        std::vector<std::uint64_t> keys;
+        keys.reserve(queue.Size());
+        for (const auto& item : queue.Items()) keys.push_back(item.key);
+        std::sort(keys.begin(), keys.end());
+        return keys.front();
+    };
+
+    queue.Sort();
+    BENCHMARK("submit 5 passes (4 shadow + main)") {
+        NullSink sink;
+        std::uint32_t binds = 0;
+        for (int cascade = 0; cascade < 4; ++cascade) {
+            binds += queue.Submit(Mist::Renderer::kPassShadow, sink, false).materialBinds;
+        }
+        binds += queue.Submit(Mist::Renderer::kPassMain, sink, true).materialBinds;
+        return sink.touched + binds;
+    };
+
+    Mist::Renderer::DrawList shadowList, mainList;
+    BENCHMARK("instanced: build 2 lists + submit 5 passes") {
+        queue.BuildDrawList(Mist::Renderer::kPassShadow, 2, shadowList);
+        queue.BuildDrawList(Mist::Renderer::kPassMain, 2, mainList);
+        NullSink sink;
+        std::uint32_t draws = 0;
+        for (int cascade = 0; cascade < 4; ++cascade) draws += queue.Submit(shadowList, sink, false).draws;
+        draws += queue.Submit(mainList, sink, true).draws;
+        return sink.touched + draws;
+    };
+
+    Mist::Renderer::IndirectList shadowIndirect, mainIndirect;
+    BENCHMARK("indirect: build 2 lists + submit 5 passes") {
+        queue.BuildIndirectList(Mist::Renderer::kPassShadow, false, shadowIndirect);
+        queue.BuildIndirectList(Mist::Renderer::kPassMain, true, mainIndirect);
+        NullSink sink;
+        std::uint32_t draws = 0;
+        for (int cascade = 0; cascade < 4; ++cascade) draws += queue.Submit(shadowIndirect, sink, false).draws;
+        draws += queue.Submit(mainIndirect, sink, true).draws;
+        return sink.touched + draws;
+    };
+
+    // The camera at the centre looking along +x+z, as in Fill.
+    Frustum camera;
+    camera.ExtractFromVP(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+                         glm::lookAt(glm::vec3(0, 10, 0), glm::vec3(1, 10, 1), glm::vec3(0, 1, 0)));
+    VisibilityBitset visible;
+    BENCHMARK("culled: cull + build + submit main pass") {
+        FrustumCuller::CullFrustum(camera, queue.Bounds(), visible);
+        queue.BuildDrawList(Mist::Renderer::kPassMain, 2, mainList, &visible);
+        NullSink sink;
+        return sink.touched + queue.Submit(mainList, sink, true).draws;
+    };
+}
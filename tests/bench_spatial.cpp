@@ -0,0 +1,253 @@
+// Spatial index microbenchmarks against the full scans they replace;
+// hidden like bench_ecs.cpp, run with
+//
+//     ./MistEngineTests "[benchmark][spatial]"
+//
+// Build in Release — Debug + ASan numbers are meaningless here.
+#include "Scene/DynamicAABBTree.h"
+#include "Scene/FrustumCuller.h"
+#include "Scene/SpatialHashGrid.h"
+#include "Scene/TriangleBVH.h"
+
+#include <catch2/catch_all.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kMovingEntities = 100000;
+
+// 100k unit-ish boxes spread over a 1 km square, each drifting at walking
+// pace: the shape of a crowd or a particle-heavy scene at 60 Hz.
+struct MovingWorld {
+    std::vector<AABB> boxes;
+    std::vector<glm::vec3> velocity;
+
+    MovingWorld() {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> height(0.0f, 20.0f);
+        std::uniform_real_distribution<float> half(0.25f, 1.5f);
+        std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+        for (std::size_t i = 0; i < kMovingEntities; ++i) {
+            const glm::vec3 c(pos(rng), height(rng), pos(rng));
+            const glm::vec3 h(half(rng), half(rng), half(rng));
+            boxes.push_back({c - h, c + h});
+            velocity.emplace_back(speed(rng), 0.0f, speed(rng));
+        }
+    }
+
+    void Step() {
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            boxes[i].min += velocity[i];
+            boxes[i].max += velocity[i];
+        }
+    }
+};
+
+Frustum CameraFrustum() {
+    Frustum frustum;
+    frustum.ExtractFromVP(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) *
+                          glm::lookAt(glm::vec3(0, 10, 0), glm::vec3(100, 0, 100), glm::vec3(0, 1, 0)));
+    return frustum;
+}
+
+} // namespace
+
+TEST_CASE("Spatial index: 100k moving entities", "[.][benchmark][spatial]") {
+    MovingWorld world;
+    DynamicAABBTree tree;
+    for (std::size_t i = 0; i < world.boxes.size(); ++i) tree.Insert(Entity(i), world.boxes[i]);
+
+    BENCHMARK("update 100k drifting (Move per entity)") {
+        world.Step();
+        std::size_t reinserted = 0;
+        for (std::size_t i = 0; i < world.boxes.size(); ++i) {
+            reinserted += tree.Move(Entity(i), world.boxes[i], world.velocity[i]);
+        }
+        return reinserted;
+    };
+
+    const Frustum frustum = CameraFrustum();
+    BENCHMARK("frustum: full scan") {
+        std::size_t visible = 0;
+        for (const AABB& box : world.boxes) visible += frustum.Intersects(box);
+        return visible;
+    };
+    BENCHMARK("frustum: tree") {
+        std::size_t visible = 0;
+        tree.QueryFrustum(frustum, [&](Entity) { ++visible; });
+        return visible;
+    };
+
+    // The render path's culling: SoA batches into a bitset per view.
+    BoundsSoA soa;
+    for (const AABB& box : world.boxes) soa.Push(box);
+    VisibilityBitset visibleBits;
+    BENCHMARK("frustum: SoA batch, scalar") {
+        FrustumCuller::CullFrustumsScalar(&frustum, 1, soa, &visibleBits);
+        return visibleBits.Count();
+    };
+    BENCHMARK("frustum: SoA batch, SIMD") {
+        FrustumCuller::CullFrustum(frustum, soa, visibleBits);
+        return visibleBits.Count();
+    };
+    // Camera plus four cascades, the per-frame shape.
+    const Frustum views[5] = {frustum, frustum, frustum, frustum, frustum};
+    VisibilityBitset viewBits[5];
+    BENCHMARK("frustum: 5 views, scalar") {
+        FrustumCuller::CullFrustumsScalar(views, 5, soa, viewBits);
+        return viewBits[4].Count();
+    };
+    BENCHMARK("frustum: 5 views, SIMD sweep") {
+        FrustumCuller::CullFrustums(views, 5, soa, viewBits);
+        return viewBits[4].Count();
+    };
+
+    const AABB region{glm::vec3(-20, -5, -20), glm::vec3(20, 25, 20)};
+    BENCHMARK("AABB overlap: full scan") {
+        std::size_t hits = 0;
+        for (const AABB& box : world.boxes) hits += box.Intersects(region);
+        return hits;
+    };
+    BENCHMARK("AABB overlap: tree") {
+        std::size_t hits = 0;
+        tree.QueryAABB(region, [&](Entity) { ++hits; });
+        return hits;
+    };
+
+    // A pick ray from the camera, the editor's click-to-select.
+    const glm::vec3 origin(0, 10, 0);
+    const glm::vec3 dir = glm::normalize(glm::vec3(100, -10, 100));
+    BENCHMARK("closest ray hit: full scan") {
+        float best = 1000.0f;
+        std::size_t hit = kMovingEntities;
+        for (std::size_t i = 0; i < world.boxes.size(); ++i) {
+            const AABB& box = world.boxes[i];
+            float lo = 0.0f, hi = best;
+            bool miss = false;
+            for (int a = 0; a < 3 && !miss; ++a) {
+                const float t0 = (box.min[a] - origin[a]) / dir[a];
+                const float t1 = (box.max[a] - origin[a]) / dir[a];
+                lo = std::max(lo, std::min(t0, t1));
+                hi = std::min(hi, std::max(t0, t1));
+                miss = lo > hi;
+            }
+            if (!miss) {
+                best = lo;
+                hit = i;
+            }
+        }
+        return hit;
+    };
+    BENCHMARK("closest ray hit: tree") {
+        DynamicAABBTree::RayHit hit;
+        tree.RaycastClosest(origin, dir, 1000.0f, hit);
+        return hit.entity;
+    };
+
+    std::vector<std::pair<Entity, float>> nearest;
+    BENCHMARK("nearest 8: tree") {
+        tree.QueryNearest(glm::vec3(12, 3, -40), 8, nearest);
+        return nearest.size();
+    };
+}
+
+TEST_CASE("Spatial hash grid: 100k moving points", "[.][benchmark][spatial]") {
+    MovingWorld world;
+    SpatialHashGrid grid(8.0f);
+    for (std::size_t i = 0; i < world.boxes.size(); ++i) grid.Insert(Entity(i), world.boxes[i].Center());
+
+    BENCHMARK("update 100k drifting (Move per entity)") {
+        world.Step();
+        std::size_t migrated = 0;
+        for (std::size_t i = 0; i < world.boxes.size(); ++i) {
+            migrated += grid.Move(Entity(i), world.boxes[i].Center());
+        }
+        return migrated;
+    };
+
+    // "Who's within 10 m of me", asked by 100 scripted agents a tick.
+    std::vector<glm::vec3> askers;
+    for (std::size_t i = 0; i < 100; ++i) askers.push_back(world.boxes[i * 997].Center());
+    BENCHMARK("100 radius queries: full scan") {
+        std::size_t hits = 0;
+        for (const glm::vec3& c : askers) {
+            for (const AABB& box : world.boxes) {
+                const glm::vec3 d = box.Center() - c;
+                hits += glm::dot(d, d) <= 100.0f;
+            }
+        }
+        return hits;
+    };
+    BENCHMARK("100 radius queries: grid") {
+        std::size_t hits = 0;
+        for (const glm::vec3& c : askers) hits += grid.QueryRadius(c, 10.0f).size();
+        return hits;
+    };
+}
+
+TEST_CASE("Triangle BVH: picking on a 2M-triangle mesh", "[.][benchmark][spatial]") {
+    // 1000 x 1000 quads of rolling terrain, 10 cm apart.
+    constexpr std::uint32_t kSide = 1000;
+    std::vector<glm::vec3> positions;
+    std::vector<std::uint32_t> indices;
+    for (std::uint32_t z = 0; z <= kSide; ++z) {
+        for (std::uint32_t x = 0; x <= kSide; ++x) {
+            positions.emplace_back(x * 0.1f, std::sin(x * 0.05f) * std::cos(z * 0.07f) * 3.0f, z * 0.1f);
+        }
+    }
+    for (std::uint32_t z = 0; z < kSide; ++z) {
+        for (std::uint32_t x = 0; x < kSide; ++x) {
+            const std::uint32_t i = z * (kSide + 1) + x, row = kSide + 1;
+            indices.insert(indices.end(), {i, i + row, i + 1, i + 1, i + row, i + row + 1});
+        }
+    }
+    TriangleBVH bvh;
+    bvh.Build(positions, indices);
+
+    // Camera-ish pick rays from above one corner, fanned over the terrain.
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> target(0.0f, kSide * 0.1f);
+    std::vector<TriangleBVH::Ray> rays;
+    const glm::vec3 eye(-10.0f, 30.0f, -10.0f);
+    for (int i = 0; i < 64; ++i) {
+        rays.push_back({eye, glm::vec3(target(rng), 0.0f, target(rng)) - eye, 2.0f});
+    }
+
+    std::size_t next = 0;
+    BENCHMARK("one pick ray: full scan") {
+        const TriangleBVH::Ray& ray = rays[next++ % rays.size()];
+        float best = ray.maxDistance;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            const glm::vec3 v0 = positions[indices[i]];
+            const glm::vec3 e1 = positions[indices[i + 1]] - v0, e2 = positions[indices[i + 2]] - v0;
+            const glm::vec3 p = glm::cross(ray.direction, e2);
+            const float det = glm::dot(e1, p);
+            if (det == 0.0f) continue;
+            const glm::vec3 s = ray.origin - v0;
+            const float u = glm::dot(s, p) / det;
+            if (u < 0.0f || u > 1.0f) continue;
+            const glm::vec3 q = glm::cross(s, e1);
+            const float v = glm::dot(ray.direction, q) / det;
+            if (v < 0.0f || u + v > 1.0f) continue;
+            const float t = glm::dot(e2, q) / det;
+            if (t >= 0.0f && t < best) best = t;
+        }
+        return best;
+    };
+    BENCHMARK("one pick ray: BVH") {
+        const TriangleBVH::Ray& ray = rays[next++ % rays.size()];
+        TriangleBVH::Hit hit;
+        return bvh.Intersect(ray.origin, ray.direction, ray.maxDistance, hit);
+    };
+    std::vector<TriangleBVH::Hit> hits(rays.size());
+    BENCHMARK("64 rays: BVH batch") {
+        return bvh.IntersectBatch(rays.data(), rays.size(), hits.data());
+    };
+}
@@ -0,0 +1,344 @@
+#include <catch2/catch_all.hpp>
+
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/RenderComponent.h"
+#include "ECS/Components/TransformComponent.h"
+#include "ECS/Coordinator.h"
+#include "ECS/Systems/HierarchySystem.h"
+#include "ECS/Systems/SpatialIndexSystem.h"
+#include "Scene/DynamicAABBTree.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+AABB Box(const glm::vec3& center, const glm::vec3& half) {
+    return AABB{center - half, center + half};
+}
+
+// Reference answers: a scan over every box, through the same predicates.
+struct BruteForce {
+    std::unordered_map<Entity, AABB> boxes;
+
+    std::vector<Entity> Overlapping(const AABB& query) const {
+        std::vector<Entity> out;
+        for (const auto& [e, box] : boxes) {
+            if (box.Intersects(query)) out.push_back(e);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    std::vector<Entity> InFrustum(const Frustum& frustum) const {
+        std::vector<Entity> out;
+        for (const auto& [e, box] : boxes) {
+            if (frustum.Intersects(box)) out.push_back(e);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Slab test, written out independently of the tree's.
+    static bool RayHit(const AABB& box, const glm::vec3& o, const glm::vec3& d, float maxT, float& t) {
+        float lo = 0.0f, hi = maxT;
+        for (int i = 0; i < 3; ++i) {
+            if (d[i] == 0.0f) {
+                if (o[i] < box.min[i] || o[i] > box.max[i]) return false;
+                continue;
+            }
+            const float a = (box.min[i] - o[i]) / d[i];
+            const float b = (box.max[i] - o[i]) / d[i];
+            lo = std::max(lo, std::min(a, b));
+            hi = std::min(hi, std::max(a, b));
+            if (lo > hi) return false;
+        }
+        t = lo;
+        return true;
+    }
+
+    std::vector<Entity> Hit(const glm::vec3& o, const glm::vec3& d, float maxT) const {
+        std::vector<Entity> out;
+        float t = 0.0f;
+        for (const auto& [e, box] : boxes) {
+            if (RayHit(box, o, d, maxT, t)) out.push_back(e);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    float ClosestHit(const glm::vec3& o, const glm::vec3& d, float maxT) const {
+        float best = -1.0f, t = 0.0f;
+        for (const auto& [e, box] : boxes) {
+            if (RayHit(box, o, d, maxT, t) && (best < 0.0f || t < best)) best = t;
+        }
+        return best;
+    }
+
+    std::vector<float> NearestDistances(const glm::vec3& p, std::size_t k) const {
+        std::vector<float> out;
+        for (const auto& [e, box] : boxes) {
+            const glm::vec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+            out.push_back(glm::length(d));
+        }
+        std::sort(out.begin(), out.end());
+        out.resize(std::min(k, out.size()));
+        return out;
+    }
+};
+
+template<typename Query>
+std::vector<Entity> Sorted(Query&& query) {
+    std::vector<Entity> out;
+    query([&out](Entity e) { out.push_back(e); });
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("DynamicAABBTree queries match brute force under random edits", "[spatial][aabb_tree]") {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+    std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    DynamicAABBTree tree;
+    BruteForce ref;
+    std::vector<Entity> live;
+    Entity next = 0;
+    auto randomBox = [&]() { return Box({coord(rng), coord(rng), coord(rng)}, {size(rng), size(rng), size(rng)}); };
+
+    for (int i = 0; i < 1500; ++i) {
+        const AABB box = randomBox();
+        tree.Insert(next, box);
+        ref.boxes[next] = box;
+        live.push_back(next++);
+    }
+    REQUIRE(tree.Validate());
+    // Balanced: well under the 1500-deep worst case of an unrotated tree.
+    REQUIRE(tree.Height() < 40);
+
+    for (int round = 0; round < 20; ++round) {
+        // Small drifts (mostly absorbed by the fat boxes), a few teleports,
+        // removals and fresh inserts.
+        for (int i = 0; i < 300; ++i) {
+            const Entity e = live[rng() % live.size()];
+            const glm::vec3 d(step(rng), step(rng), step(rng));
+            const AABB moved{ref.boxes[e].min + d, ref.boxes[e].max + d};
+            tree.Move(e, moved, d);
+            ref.boxes[e] = moved;
+        }
+        for (int i = 0; i < 20; ++i) {
+            const Entity e = live[rng() % live.size()];
+            const AABB box = randomBox();
+            tree.Move(e, box);
+            ref.boxes[e] = box;
+        }
+        for (int i = 0; i < 40; ++i) {
+            const std::size_t at = rng() % live.size();
+            REQUIRE(tree.Remove(live[at]));
+            ref.boxes.erase(live[at]);
+            live[at] = live.back();
+            live.pop_back();
+        }
+        for (int i = 0; i < 40; ++i) {
+            const AABB box = randomBox();
+            tree.Insert(next, box);
+            ref.boxes[next] = box;
+            live.push_back(next++);
+        }
+        REQUIRE(tree.Validate());
+        REQUIRE(tree.Size() == ref.boxes.size());
+
+        for (int q = 0; q < 10; ++q) {
+            const AABB query = Box({coord(rng), coord(rng), coord(rng)}, glm::vec3(15.0f));
+            REQUIRE(Sorted([&](auto fn) { tree.QueryAABB(query, fn); }) == ref.Overlapping(query));
+
+            const glm::vec3 eye(coord(rng), coord(rng), coord(rng));
+            const glm::vec3 target(coord(rng), coord(rng), coord(rng));
+            Frustum frustum;
+            frustum.ExtractFromVP(glm::perspective(glm::radians(60.0f), 1.5f, 0.5f, 80.0f) *
+                                  glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+            REQUIRE(Sorted([&](auto fn) { tree.QueryFrustum(frustum, fn); }) == ref.InFrustum(frustum));
+
+            glm::vec3 dir(unit(rng), unit(rng), unit(rng));
+            if (q == 0) dir = glm::vec3(0.0f, 0.0f, 1.0f); // axis-aligned: two still axes
+            const float maxT = 150.0f;
+            REQUIRE(Sorted([&](auto fn) {
+                        tree.Raycast(eye, dir, maxT, [&](Entity e, float) { fn(e); });
+                    }) == ref.Hit(eye, dir, maxT));
+            DynamicAABBTree::RayHit hit;
+            const float closest = ref.ClosestHit(eye, dir, maxT);
+            REQUIRE(tree.RaycastClosest(eye, dir, maxT, hit) == (closest >= 0.0f));
+            if (closest >= 0.0f) REQUIRE(hit.distance == Catch::Approx(closest));
+
+            std::vector<std::pair<Entity, float>> nearest;
+            tree.QueryNearest(eye, 12, nearest);
+            const std::vector<float> expected = ref.NearestDistances(eye, 12);
+            REQUIRE(nearest.size() == expected.size());
+            for (std::size_t i = 0; i < nearest.size(); ++i) {
+                REQUIRE(nearest[i].second == Catch::Approx(expected[i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("DynamicAABBTree only restructures when a box leaves its fat bounds", "[spatial][aabb_tree]") {
+    DynamicAABBTree tree;
+    tree.Insert(1, Box({0, 0, 0}, {1, 1, 1}));
+    tree.Insert(2, Box({10, 0, 0}, {1, 1, 1}));
+
+    // Within the margin: kept as is.
+    REQUIRE_FALSE(tree.Move(1, Box({0.05f, 0, 0}, {1, 1, 1})));
+    REQUIRE(tree.GetBounds(1).min.x == Catch::Approx(-0.95f));
+    // Out of it: reinserted, with the fat box stretched along the move.
+    REQUIRE(tree.Move(1, Box({1, 0, 0}, {1, 1, 1}), {1, 0, 0}));
+    REQUIRE(tree.GetFatBounds(1).max.x >= 2.0f + DynamicAABBTree::kDisplacementMultiplier);
+    // The next few steps of the same motion stay inside it.
+    REQUIRE_FALSE(tree.Move(1, Box({2, 0, 0}, {1, 1, 1}), {1, 0, 0}));
+    REQUIRE_FALSE(tree.Move(1, Box({3, 0, 0}, {1, 1, 1}), {1, 0, 0}));
+    // Stopped far inside a stretched box: shrunk back down.
+    REQUIRE(tree.Move(1, Box({3, 0, 0}, {1, 1, 1})));
+    REQUIRE(tree.GetFatBounds(1).max.x == Catch::Approx(4.0f + DynamicAABBTree::kFatMargin));
+    REQUIRE(tree.Validate());
+
+    // A stale handle sharing the index is replaced, not duplicated.
+    const Entity reused = MakeEntity(EntityIndex(2), EntityGeneration(2) + 1);
+    tree.Insert(reused, Box({-10, 0, 0}, {1, 1, 1}));
+    REQUIRE(tree.Size() == 2);
+    REQUIRE_FALSE(tree.Contains(2));
+    REQUIRE(tree.Contains(reused));
+    REQUIRE_FALSE(tree.Remove(2));
+    REQUIRE(tree.Validate());
+}
+
+namespace {
+
+struct BoxRenderable : Renderable {
+    explicit BoxRenderable(const AABB& bounds) { m_LocalBounds = bounds; }
+    void Draw(Shader&) override {}
+};
+
+} // namespace
+
+TEST_CASE("SpatialIndexSystem tracks world bounds of rendered entities", "[spatial][aabb_tree]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TransformComponent>();
+    coord.RegisterComponent<RenderComponent>();
+    coord.RegisterComponent<HierarchyComponent>();
+    auto sys = coord.RegisterSystem<SpatialIndexSystem>();
+    Signature sig;
+    sig.set(coord.GetComponentType<TransformComponent>());
+    sig.set(coord.GetComponentType<RenderComponent>());
+    coord.SetSystemSignature<SpatialIndexSystem>(sig);
+
+    BoxRenderable unitCube(Box({0, 0, 0}, {0.5f, 0.5f, 0.5f}));
+    auto spawn = [&](glm::vec3 pos) {
+        Entity e = coord.CreateEntity();
+        TransformComponent t;
+        t.position = pos;
+        coord.AddComponent(e, t);
+        coord.AddComponent(e, RenderComponent{&unitCube, true});
+        return e;
+    };
+    const Entity a = spawn({0, 0, 0});
+    const Entity b = spawn({5, 0, 0});
+    const Entity bare = coord.CreateEntity();
+    coord.AddComponent(bare, TransformComponent{});
+    sys->Update(coord);
+
+    const DynamicAABBTree& tree = sys->GetTree();
+    REQUIRE(tree.Size() == 2);
+    REQUIRE(tree.GetBounds(b).min.x == Catch::Approx(4.5f));
+
+    // A stamped move is picked up; scale goes through the world matrix.
+    auto& t = coord.GetComponentMut<TransformComponent>(b);
+    t.SetPosition({0, 10, 0});
+    t.SetScale({4, 4, 4});
+    sys->Update(coord);
+    REQUIRE(tree.GetBounds(b).min.y == Catch::Approx(8.0f));
+    REQUIRE(tree.GetBounds(b).max.x == Catch::Approx(2.0f));
+
+    DynamicAABBTree::RayHit hit;
+    REQUIRE(tree.RaycastClosest({0, 20, 0}, {0, -1, 0}, 100.0f, hit));
+    REQUIRE(hit.entity == b);
+    REQUIRE(hit.distance == Catch::Approx(8.0f));
+
+    coord.DestroyEntity(b);
+    sys->Update(coord);
+    REQUIRE(tree.Size() == 1);
+    REQUIRE(tree.Contains(a));
+    REQUIRE(tree.Validate());
+}
+
+TEST_CASE("SpatialIndexSystem sees a script moving a hierarchy member", "[spatial][aabb_tree][hierarchy]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TransformComponent>();
+    coord.RegisterComponent<RenderComponent>();
+    coord.RegisterComponent<HierarchyComponent>();
+    auto hierarchy = coord.RegisterSystem<HierarchySystem>();
+    auto sys = coord.RegisterSystem<SpatialIndexSystem>();
+    Signature hsig;
+    hsig.set(coord.GetComponentType<TransformComponent>());
+    hsig.set(coord.GetComponentType<HierarchyComponent>());
+    coord.SetSystemSignature<HierarchySystem>(hsig);
+    Signature sig;
+    sig.set(coord.GetComponentType<TransformComponent>());
+    sig.set(coord.GetComponentType<RenderComponent>());
+    coord.SetSystemSignature<SpatialIndexSystem>(sig);
+
+    BoxRenderable unitCube(Box({0, 0, 0}, {0.5f, 0.5f, 0.5f}));
+    auto spawn = [&](glm::vec3 pos) {
+        Entity e = coord.CreateEntity();
+        TransformComponent t;
+        t.position = pos;
+        coord.AddComponent(e, t);
+        coord.AddComponent(e, RenderComponent{&unitCube, true});
+        coord.AddComponent(e, HierarchyComponent{});
+        return e;
+    };
+    const Entity parent = spawn({0, 0, 0});
+    const Entity child = spawn({2, 0, 0});
+    REQUIRE(HierarchySystem::Attach(coord, parent, child));
+
+    // The engine loop's order: resolve, scripts, resolve again, index.
+    auto frame = [&](const std::function<void()>& script) {
+        hierarchy->UpdateTransforms(coord);
+        if (script) script();
+        hierarchy->UpdateTransforms(coord);
+        sys->Update(coord);
+    };
+    auto hitDistance = [&](const glm::vec3& origin, Entity expected) {
+        DynamicAABBTree::RayHit hit;
+        REQUIRE(sys->Raycast(coord, origin, {0, -1, 0}, 100.0f, hit));
+        REQUIRE(hit.entity == expected);
+        return hit.distance;
+    };
+    frame(nullptr);
+    REQUIRE(hitDistance({2, 20, 0}, child) == Catch::Approx(19.5f));
+
+    // set_transform on the parent: the child follows in the same frame,
+    // and stays put in the next one.
+    frame([&] { coord.GetComponentMut<TransformComponent>(parent).SetPosition({0, 10, 0}); });
+    REQUIRE(hitDistance({0, 20, 0}, parent) == Catch::Approx(9.5f));
+    REQUIRE(hitDistance({2, 20, 0}, child) == Catch::Approx(9.5f));
+    frame(nullptr);
+    REQUIRE(hitDistance({2, 20, 0}, child) == Catch::Approx(9.5f));
+
+    // set_transform on the child itself moves it in parent space.
+    frame([&] { coord.GetComponentMut<TransformComponent>(child).SetPosition({4, 0, 0}); });
+    REQUIRE(hitDistance({4, 20, 0}, child) == Catch::Approx(9.5f));
+    DynamicAABBTree::RayHit miss;
+    REQUIRE_FALSE(sys->Raycast(coord, {2, 20, 0}, {0, -1, 0}, 100.0f, miss));
+    REQUIRE(sys->GetTree().Validate());
+}
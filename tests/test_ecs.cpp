@@ -3,6 +3,16 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 // Independent coordinator for ECS tests — we deliberately don't touch the
 // global gCoordinator so tests remain isolated and can run in any order.
 
@@ -16,11 +26,8 @@ struct TestTag {
 };
 
 TEST_CASE("Coordinator::CreateEntity issues distinct IDs", "[ecs]") {
-    // Note on recycling: EntityManager pre-populates a queue with every
-    // possible entity ID, so a freshly-destroyed ID goes to the *back* of the
-    // pool. Asserting "next CreateEntity returns the destroyed id" doesn't
-    // match that design, and forcing recycling would require exhausting
-    // MAX_ENTITIES. The property we actually care about here is distinctness.
+    // Recycling reuses the freed slot right away but with a new generation
+    // (covered below); the property checked here is distinctness.
     Coordinator coord;
     coord.Init();
 
@@ -42,6 +49,72 @@ TEST_CASE("Coordinator::CreateEntity issues distinct IDs", "[ecs]") {
     }
 }
 
+TEST_CASE("Recycled entity slots get a new generation", "[ecs][handles]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestTag>();
+
+    Entity a = coord.CreateEntity();
+    coord.AddComponent(a, TestTag{1});
+    coord.DestroyEntity(a);
+    REQUIRE_FALSE(coord.IsAlive(a));
+
+    Entity b = coord.CreateEntity();
+    REQUIRE(EntityIndex(b) == EntityIndex(a)); // the freed slot is reused...
+    REQUIRE(EntityGeneration(b) == EntityGeneration(a) + 1); // ...as a new handle
+    REQUIRE(b != a);
+    REQUIRE(coord.IsAlive(b));
+
+    // The stale handle sees nothing of the new occupant, and destroying it
+    // again must not take the new occupant down with it.
+    coord.AddComponent(b, TestTag{2});
+    REQUIRE_FALSE(coord.HasComponent<TestTag>(a));
+    REQUIRE_THROWS_AS(coord.GetComponent<TestTag>(a), std::runtime_error);
+    coord.DestroyEntity(a);
+    REQUIRE(coord.IsAlive(b));
+    REQUIRE(coord.GetComponent<TestTag>(b).value == 2);
+    REQUIRE(coord.GetLivingEntities().count(a) == 0);
+    REQUIRE(coord.GetLivingEntities().count(b) == 1);
+
+    REQUIRE_FALSE(coord.IsAlive(NULL_ENTITY)); // also HierarchyComponent::kNoParent
+}
+
+TEST_CASE("EntityManager grows past the old 100k cap on demand", "[ecs][handles]") {
+    EntityManager manager;
+    REQUIRE(manager.GetLivingEntityCount() == 0);
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 150000; ++i) entities.push_back(manager.CreateEntity());
+    REQUIRE(manager.GetLivingEntityCount() == 150000);
+    REQUIRE(EntityIndex(entities.back()) == 149999);
+
+    manager.SetSignature(entities.back(), Signature{}.set(3));
+    REQUIRE(manager.GetSignature(entities.back()).test(3));
+
+    // Free list is LIFO: the most recently destroyed slot comes back first.
+    manager.DestroyEntity(entities[10]);
+    manager.DestroyEntity(entities[20]);
+    REQUIRE(EntityIndex(manager.CreateEntity()) == 20);
+    REQUIRE(EntityIndex(manager.CreateEntity()) == 10);
+    REQUIRE(manager.GetLivingEntities().size() == 150000);
+}
+
+TEST_CASE("Archetype storage rejects stale handles", "[ecs][handles][archetype]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>(ComponentStorage::Archetype);
+
+    Entity a = coord.CreateEntity();
+    coord.AddComponent(a, TestPosition{1.f, 0.f});
+    coord.DestroyEntity(a);
+    Entity b = coord.CreateEntity();
+    coord.AddComponent(b, TestPosition{2.f, 0.f});
+
+    REQUIRE(EntityIndex(a) == EntityIndex(b));
+    REQUIRE_FALSE(coord.HasComponent<TestPosition>(a));
+    REQUIRE(coord.GetComponent<TestPosition>(b).x == 2.f);
+}
+
 TEST_CASE("ComponentArray removes middle entries without corrupting neighbors", "[ecs]") {
     // Regression guard for the off-by-one in the swap-and-pop removal path.
     ComponentArray<TestPosition> arr;
@@ -90,3 +163,480 @@ TEST_CASE("AddComponent + RemoveComponent flip the entity's signature bit", "[ec
     coord.RemoveComponent<TestPosition>(e);
     REQUIRE_FALSE(coord.HasComponent<TestPosition>(e));
 }
+
+TEST_CASE("ComponentArray handles sparse, high entity IDs", "[ecs]") {
+    // IDs far apart land on different sparse pages; lookups for IDs on
+    // pages that were never touched must report absent, not crash.
+    ComponentArray<TestTag> arr;
+    arr.InsertData(3, TestTag{3});
+    arr.InsertData(MAX_ENTITIES - 1, TestTag{99});
+
+    REQUIRE(arr.Size() == 2);
+    REQUIRE(arr.GetData(MAX_ENTITIES - 1).value == 99);
+    REQUIRE_FALSE(arr.HasData(50000));
+    REQUIRE_FALSE(arr.HasData(NULL_ENTITY));
+
+    arr.RemoveData(3);
+    REQUIRE(arr.Size() == 1);
+    REQUIRE(arr.Entities()[0] == MAX_ENTITIES - 1);
+}
+
+TEST_CASE("ComponentArray::ForEach visits each live component once", "[ecs]") {
+    ComponentArray<TestTag> arr;
+    for (Entity e = 0; e < 8; ++e) {
+        arr.InsertData(e, TestTag{static_cast<int>(e)});
+    }
+    arr.RemoveData(0);
+    arr.RemoveData(5);
+    // Re-insert overwrites instead of duplicating.
+    arr.InsertData(2, TestTag{200});
+
+    int sum = 0;
+    int visits = 0;
+    arr.ForEach([&](Entity e, TestTag& t) {
+        REQUIRE(arr.GetData(e).value == t.value);
+        sum += t.value;
+        ++visits;
+    });
+    REQUIRE(visits == 6);
+    REQUIRE(sum == 1 + 200 + 3 + 4 + 6 + 7);
+}
+
+TEST_CASE("Archetype storage moves components between archetypes intact", "[ecs][archetype]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>(ComponentStorage::Archetype);
+    coord.RegisterComponent<TestTag>(ComponentStorage::Archetype);
+
+    Entity a = coord.CreateEntity();
+    Entity b = coord.CreateEntity();
+    coord.AddComponent(a, TestPosition{1.f, 2.f});
+    coord.AddComponent(b, TestPosition{3.f, 4.f});
+    coord.AddComponent(a, TestTag{7}); // a moves {Pos} -> {Pos, Tag}
+
+    REQUIRE(coord.HasComponent<TestTag>(a));
+    REQUIRE_FALSE(coord.HasComponent<TestTag>(b));
+    REQUIRE(coord.GetComponent<TestPosition>(a).y == Catch::Approx(2.f));
+    REQUIRE(coord.GetComponent<TestPosition>(b).x == Catch::Approx(3.f));
+    REQUIRE(coord.GetComponent<TestTag>(a).value == 7);
+
+    coord.RemoveComponent<TestPosition>(a); // a moves {Pos, Tag} -> {Tag}
+    REQUIRE_FALSE(coord.HasComponent<TestPosition>(a));
+    REQUIRE(coord.GetComponent<TestTag>(a).value == 7);
+
+    coord.DestroyEntity(b);
+    REQUIRE_FALSE(coord.HasComponent<TestPosition>(b));
+}
+
+TEST_CASE("Coordinator::View visits exactly the matching entities", "[ecs][archetype]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>(ComponentStorage::Archetype);
+    coord.RegisterComponent<TestTag>(ComponentStorage::Archetype);
+
+    // Enough entities to span several chunks, split across two archetypes.
+    std::vector<Entity> both;
+    for (int i = 0; i < 3000; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, TestPosition{float(i), 0.f});
+        if (i % 3 == 0) {
+            coord.AddComponent(e, TestTag{i});
+            both.push_back(e);
+        }
+    }
+    // Swap-and-pop from the middle of a chunk.
+    coord.DestroyEntity(both[10]);
+    both.erase(both.begin() + 10);
+
+    std::vector<Entity> seen;
+    coord.View<TestPosition, TestTag>().ForEach([&](Entity e, TestPosition& p, TestTag& t) {
+        REQUIRE(int(p.x) == t.value);
+        seen.push_back(e);
+    });
+    std::sort(seen.begin(), seen.end());
+    REQUIRE(seen == both);
+
+    size_t positions = 0;
+    coord.View<TestPosition>().ForEachChunk(
+        [&](size_t count, const Entity*, TestPosition*) { positions += count; });
+    REQUIRE(positions == 2999);
+}
+
+TEST_CASE("Archetype storage relocates non-trivial components", "[ecs][archetype]") {
+    struct Named {
+        std::string name;
+        std::vector<int> values;
+    };
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<Named>(ComponentStorage::Archetype);
+    coord.RegisterComponent<TestTag>(ComponentStorage::Archetype);
+
+    Entity e = coord.CreateEntity();
+    coord.AddComponent(e, Named{"a fairly long name that defeats SSO", {1, 2, 3}});
+    coord.AddComponent(e, TestTag{1});
+    coord.RemoveComponent<TestTag>(e);
+
+    auto& n = coord.GetComponent<Named>(e);
+    REQUIRE(n.name == "a fairly long name that defeats SSO");
+    REQUIRE(n.values == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("EntitySet insert/erase keeps members packed", "[ecs]") {
+    EntitySet set;
+    REQUIRE(set.insert(4));
+    REQUIRE(set.insert(9000));
+    REQUIRE(set.insert(2));
+    REQUIRE_FALSE(set.insert(9000));
+    REQUIRE(set.size() == 3);
+
+    REQUIRE(set.erase(4));
+    REQUIRE_FALSE(set.erase(4));
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.count(9000) == 1);
+    REQUIRE(set.count(2) == 1);
+    REQUIRE(set.count(4) == 0);
+
+    std::vector<Entity> members(set.begin(), set.end());
+    std::sort(members.begin(), members.end());
+    REQUIRE(members == std::vector<Entity>{2, 9000});
+}
+
+namespace {
+class PositionOnlySystem : public System {};
+class PositionTagSystem : public System {};
+class EverythingSystem : public System {};
+} // namespace
+
+TEST_CASE("System membership tracks signature changes per component", "[ecs]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>();
+    coord.RegisterComponent<TestTag>();
+
+    auto posOnly = coord.RegisterSystem<PositionOnlySystem>();
+    auto posTag = coord.RegisterSystem<PositionTagSystem>();
+    auto everything = coord.RegisterSystem<EverythingSystem>();
+
+    Signature pos;
+    pos.set(coord.GetComponentType<TestPosition>());
+    coord.SetSystemSignature<PositionOnlySystem>(pos);
+    Signature both = pos;
+    both.set(coord.GetComponentType<TestTag>());
+    coord.SetSystemSignature<PositionTagSystem>(both);
+    // EverythingSystem keeps an empty signature and so matches any entity
+    // that has had a component added.
+
+    Entity e = coord.CreateEntity();
+    coord.AddComponent(e, TestTag{1});
+    REQUIRE(posOnly->m_Entities.count(e) == 0);
+    REQUIRE(posTag->m_Entities.count(e) == 0);
+    REQUIRE(everything->m_Entities.count(e) == 1);
+
+    coord.AddComponent(e, TestPosition{});
+    REQUIRE(posOnly->m_Entities.count(e) == 1);
+    REQUIRE(posTag->m_Entities.count(e) == 1);
+
+    coord.RemoveComponent<TestTag>(e);
+    REQUIRE(posOnly->m_Entities.count(e) == 1);
+    REQUIRE(posTag->m_Entities.count(e) == 0);
+
+    coord.DestroyEntity(e);
+    REQUIRE(posOnly->m_Entities.empty());
+    REQUIRE(everything->m_Entities.empty());
+}
+
+TEST_CASE("ParallelRanges chunks cover the range on cache-line boundaries", "[ecs][parallel]") {
+    Mist::JobSystem jobs(3);
+    ParallelForOptions options;
+    options.jobs = &jobs;
+    options.grain = 100;
+    options.serialThreshold = 0;
+
+    alignas(64) static TestPosition items[5000];
+    std::mutex mutex;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    // Start one element in so the head chunk is the unaligned one.
+    Mist::ecs::ParallelRanges(items + 1, sizeof(TestPosition), 4999, options,
+                              [&](size_t begin, size_t end) {
+                                  std::lock_guard<std::mutex> lock(mutex);
+                                  ranges.emplace_back(begin, end);
+                              });
+    std::sort(ranges.begin(), ranges.end());
+    REQUIRE(ranges.size() > 1);
+    REQUIRE(ranges.front().first == 0);
+    REQUIRE(ranges.back().second == 4999);
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        REQUIRE(ranges[i].first == ranges[i - 1].second);
+        const auto addr = reinterpret_cast<std::uintptr_t>(items + 1 + ranges[i].first);
+        REQUIRE(addr % Mist::ecs::kCacheLineBytes == 0);
+    }
+}
+
+TEST_CASE("ParallelForEach visits every component once in both backends", "[ecs][parallel]") {
+    Mist::JobSystem jobs(3);
+    ParallelForOptions options;
+    options.jobs = &jobs;
+    options.grain = 64;
+    options.serialThreshold = 256;
+
+    for (ComponentStorage storage : {ComponentStorage::SparseSet, ComponentStorage::Archetype}) {
+        Coordinator coord;
+        coord.Init();
+        coord.RegisterComponent<TestPosition>(storage);
+        for (int i = 0; i < 5000; ++i) {
+            Entity e = coord.CreateEntity();
+            coord.AddComponent(e, TestPosition{float(i), 0.f});
+        }
+
+        coord.ParallelForEach<TestPosition>([](Entity, TestPosition& p) { p.y += 1.f; }, options);
+
+        std::atomic<int> visited{0};
+        coord.ParallelForEach<TestPosition>(
+            [&](Entity, TestPosition& p) {
+                if (p.y == 1.f) ++visited;
+            },
+            options);
+        REQUIRE(visited.load() == 5000);
+    }
+}
+
+TEST_CASE("Parallel views and entity sets split the work", "[ecs][parallel]") {
+    Mist::JobSystem jobs(3);
+    ParallelForOptions options;
+    options.jobs = &jobs;
+    options.grain = 256;
+    options.serialThreshold = 0;
+
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>(ComponentStorage::Archetype);
+    coord.RegisterComponent<TestTag>(ComponentStorage::Archetype);
+    auto system = coord.RegisterSystem<PositionTagSystem>();
+    coord.SetSystemSignature<PositionTagSystem>(Signature{}
+                                                    .set(coord.GetComponentType<TestPosition>())
+                                                    .set(coord.GetComponentType<TestTag>()));
+    for (int i = 0; i < 6000; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, TestPosition{float(i), 0.f});
+        if (i % 2 == 0) coord.AddComponent(e, TestTag{i});
+    }
+
+    std::atomic<int> mismatches{0};
+    std::atomic<size_t> rows{0};
+    coord.View<TestPosition, TestTag>().ParallelForEachChunk(
+        [&](size_t count, const Entity*, TestPosition* p, TestTag* t) {
+            for (size_t i = 0; i < count; ++i) {
+                if (int(p[i].x) != t[i].value) ++mismatches;
+            }
+            rows += count;
+        },
+        options);
+    REQUIRE(mismatches.load() == 0);
+    REQUIRE(rows.load() == 3000);
+
+    std::atomic<int> members{0};
+    coord.ParallelForEach(system->m_Entities, [&](Entity e) {
+        if (coord.GetComponent<TestTag>(e).value % 2 == 0) ++members;
+    }, options);
+    REQUIRE(members.load() == 3000);
+}
+
+TEST_CASE("ForEachChanged reports only components stamped since a tick", "[ecs][changes]") {
+    for (ComponentStorage storage : {ComponentStorage::SparseSet, ComponentStorage::Archetype}) {
+        Coordinator coord;
+        coord.Init();
+        coord.RegisterComponent<TestPosition>(storage);
+        coord.RegisterComponent<TestTag>(storage);
+
+        std::vector<Entity> entities;
+        for (int i = 0; i < 100; ++i) {
+            Entity e = coord.CreateEntity();
+            coord.AddComponent(e, TestPosition{float(i), 0.f});
+            entities.push_back(e);
+        }
+
+        // Freshly added components count as changed.
+        int seen = 0;
+        coord.ForEachChanged<TestPosition>(0, [&](Entity, TestPosition&) { ++seen; });
+        REQUIRE(seen == 100);
+
+        ChangeTick lastRun = coord.AdvanceChangeTick();
+        REQUIRE(coord.LastChangeTick<TestPosition>() <= lastRun);
+        seen = 0;
+        coord.ForEachChanged<TestPosition>(lastRun, [&](Entity, TestPosition&) { ++seen; });
+        REQUIRE(seen == 0);
+
+        // Plain GetComponent is untracked; GetComponentMut and MarkChanged stamp.
+        coord.GetComponent<TestPosition>(entities[1]).y = 1.f;
+        coord.GetComponentMut<TestPosition>(entities[3]).y = 3.f;
+        coord.MarkChanged<TestPosition>(entities[7]);
+        coord.MarkChanged<TestTag>(entities[9]); // has no TestTag: no-op
+        REQUIRE(coord.ChangedSince<TestPosition>(entities[3], lastRun));
+        REQUIRE_FALSE(coord.ChangedSince<TestPosition>(entities[1], lastRun));
+        REQUIRE(coord.LastChangeTick<TestTag>() == 0);
+
+        std::vector<Entity> changed;
+        coord.ForEachChanged<TestPosition>(lastRun, [&](Entity e, TestPosition&) { changed.push_back(e); });
+        std::sort(changed.begin(), changed.end());
+        REQUIRE(changed == std::vector<Entity>{entities[3], entities[7]});
+
+        // Ticks follow their element through swap-and-pop and archetype moves.
+        lastRun = coord.AdvanceChangeTick();
+        coord.MarkChanged<TestPosition>(entities[99]);
+        coord.DestroyEntity(entities[0]);
+        coord.AddComponent(entities[50], TestTag{50});
+        changed.clear();
+        coord.ForEachChanged<TestPosition>(lastRun, [&](Entity e, TestPosition& p) {
+            changed.push_back(e);
+            REQUIRE(p.x == 99.f);
+        });
+        REQUIRE(changed == std::vector<Entity>{entities[99]});
+        REQUIRE_FALSE(coord.ChangedSince<TestPosition>(entities[50], lastRun));
+        REQUIRE(coord.ChangedSince<TestTag>(entities[50], lastRun));
+    }
+}
+
+TEST_CASE("MarkChanged is safe from a parallel pass", "[ecs][changes][parallel]") {
+    Mist::JobSystem jobs(3);
+    ParallelForOptions options;
+    options.jobs = &jobs;
+    options.grain = 64;
+    options.serialThreshold = 0;
+
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>();
+    for (int i = 0; i < 4000; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, TestPosition{float(i), 0.f});
+    }
+    const ChangeTick lastRun = coord.AdvanceChangeTick();
+
+    coord.ParallelForEach<TestPosition>([&](Entity e, TestPosition& p) {
+        if (int(p.x) % 4 == 0) {
+            p.y = 1.f;
+            coord.MarkChanged<TestPosition>(e);
+        }
+    }, options);
+
+    int changed = 0;
+    coord.ForEachChanged<TestPosition>(lastRun, [&](Entity, TestPosition& p) {
+        REQUIRE(p.y == 1.f);
+        ++changed;
+    });
+    REQUIRE(changed == 1000);
+    REQUIRE(coord.LastChangeTick<TestPosition>() == coord.GetChangeTick());
+}
+
+TEST_CASE("Bulk CreateEntities + AddComponents match the per-entity path", "[ecs][bulk]") {
+    for (ComponentStorage storage : {ComponentStorage::SparseSet, ComponentStorage::Archetype}) {
+        Coordinator coord;
+        coord.Init();
+        coord.RegisterComponent<TestPosition>(storage);
+        coord.RegisterComponent<TestTag>(storage);
+        auto posOnly = coord.RegisterSystem<PositionOnlySystem>();
+        auto posTag = coord.RegisterSystem<PositionTagSystem>();
+        const ComponentType pos = coord.GetComponentType<TestPosition>();
+        const ComponentType tag = coord.GetComponentType<TestTag>();
+        coord.SetSystemSignature<PositionOnlySystem>(Signature{}.set(pos));
+        coord.SetSystemSignature<PositionTagSystem>(Signature{}.set(pos).set(tag));
+
+        // Recycle a couple of slots so the batch mixes reused and fresh ones.
+        Entity old1 = coord.CreateEntity();
+        Entity old2 = coord.CreateEntity();
+        coord.DestroyEntity(old1);
+        coord.DestroyEntity(old2);
+
+        std::vector<Entity> entities = coord.CreateEntities(1000);
+        REQUIRE(coord.GetLivingEntities().size() == 1000);
+        for (Entity e : entities) REQUIRE(coord.IsAlive(e));
+        REQUIRE_FALSE(coord.IsAlive(old1));
+
+        std::vector<TestPosition> positions;
+        std::vector<TestTag> tags;
+        for (int i = 0; i < 1000; ++i) {
+            positions.push_back({float(i), 0.f});
+            tags.push_back({i});
+        }
+        // One entity already holds a Position, which gets overwritten.
+        coord.AddComponent(entities[10], TestPosition{-1.f, -1.f});
+
+        coord.AddComponents(entities, positions, tags);
+
+        REQUIRE(posOnly->m_Entities.size() == 1000);
+        REQUIRE(posTag->m_Entities.size() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(coord.GetComponent<TestPosition>(entities[i]).x == float(i));
+            REQUIRE(coord.GetComponent<TestTag>(entities[i]).value == i);
+        }
+
+        // A later single-type batch only touches its own type.
+        const ChangeTick lastRun = coord.AdvanceChangeTick();
+        coord.RemoveComponent<TestTag>(entities[0]);
+        const TestTag retag{7};
+        coord.AddComponents(&entities[0], 1, &retag);
+        REQUIRE(coord.GetComponent<TestTag>(entities[0]).value == 7);
+        REQUIRE(coord.GetComponent<TestPosition>(entities[0]).x == 0.f);
+        REQUIRE(posTag->m_Entities.count(entities[0]) == 1);
+        REQUIRE(coord.ChangedSince<TestTag>(entities[0], lastRun));
+        REQUIRE_FALSE(coord.ChangedSince<TestPosition>(entities[0], lastRun));
+    }
+}
+
+TEST_CASE("Owning group keeps matching entities packed through adds, removes and destroys", "[ecs][group]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TestPosition>();
+    coord.RegisterComponent<TestTag>();
+
+    std::mt19937 rng(7);
+    std::vector<Entity> entities;
+    // Some entities exist before the group is created, to cover packing.
+    for (int i = 0; i < 200; ++i) {
+        Entity e = coord.CreateEntity();
+        if (i % 2 == 0) coord.AddComponent(e, TestPosition{float(i), 0.f});
+        if (i % 3 == 0) coord.AddComponent(e, TestTag{i});
+        entities.push_back(e);
+    }
+    REQUIRE(coord.Group<TestPosition, TestTag>().Size() == 34);
+
+    auto check = [&] {
+        std::size_t expected = 0;
+        for (Entity e : coord.GetLivingEntities()) {
+            if (coord.HasComponent<TestPosition>(e) && coord.HasComponent<TestTag>(e)) ++expected;
+        }
+        auto group = coord.Group<TestPosition, TestTag>();
+        REQUIRE(group.Size() == expected);
+        std::size_t visited = 0;
+        group.ForEach([&](Entity e, TestPosition& p, TestTag& t) {
+            ++visited;
+            REQUIRE(&coord.GetComponent<TestPosition>(e) == &p);
+            REQUIRE(&coord.GetComponent<TestTag>(e) == &t);
+        });
+        REQUIRE(visited == expected);
+    };
+    check();
+
+    for (int step = 0; step < 2000; ++step) {
+        Entity e = entities[rng() % entities.size()];
+        if (!coord.IsAlive(e)) continue;
+        switch (rng() % 5) {
+        case 0: if (!coord.HasComponent<TestPosition>(e)) coord.AddComponent(e, TestPosition{1.f, 2.f}); break;
+        case 1: if (!coord.HasComponent<TestTag>(e)) coord.AddComponent(e, TestTag{step}); break;
+        case 2: if (coord.HasComponent<TestPosition>(e)) coord.RemoveComponent<TestPosition>(e); break;
+        case 3: if (coord.HasComponent<TestTag>(e)) coord.RemoveComponent<TestTag>(e); break;
+        case 4:
+            coord.DestroyEntity(e);
+            entities.push_back(coord.CreateEntity());
+            break;
+        }
+        if (step % 100 == 0) check();
+    }
+    check();
+
+    // Bulk adds join the group too.
+    std::vector<Entity> fresh = coord.CreateEntities(50);
+    coord.AddComponents(fresh, std::vector<TestPosition>(50), std::vector<TestTag>(50));
+    check();
+}
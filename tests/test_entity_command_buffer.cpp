@@ -0,0 +1,205 @@
+#include "Core/JobSystem.h"
+#include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct CmdPosition {
+    float x = 0.f;
+    float y = 0.f;
+};
+
+struct CmdTag {
+    int value = 0;
+};
+
+// Non-trivial payload: lets the tests see that recorded components are
+// moved into storage and that dropped ones are destroyed.
+struct CmdHandle {
+    std::shared_ptr<int> value;
+};
+
+class CmdPositionTagSystem : public System {};
+
+void initCoordinator(Coordinator& coord) {
+    coord.Init();
+    coord.RegisterComponent<CmdPosition>();
+    coord.RegisterComponent<CmdTag>();
+    coord.RegisterComponent<CmdHandle>();
+}
+
+} // namespace
+
+TEST_CASE("EntityCommandBuffer defers changes until playback", "[ecs][commands]") {
+    Coordinator coord;
+    initCoordinator(coord);
+    auto system = coord.RegisterSystem<CmdPositionTagSystem>();
+    Signature both;
+    both.set(coord.GetComponentType<CmdPosition>());
+    both.set(coord.GetComponentType<CmdTag>());
+    coord.SetSystemSignature<CmdPositionTagSystem>(both);
+
+    Entity live = coord.CreateEntity();
+    coord.AddComponent(live, CmdTag{1});
+
+    EntityCommandBuffer commands;
+    commands.AddComponent(live, CmdPosition{1.f, 2.f});
+    auto pending = commands.CreateEntity();
+    commands.AddComponent(pending, CmdPosition{3.f, 4.f});
+    commands.AddComponent(pending, CmdTag{7});
+
+    REQUIRE_FALSE(coord.HasComponent<CmdPosition>(live));
+    REQUIRE(coord.GetLivingEntities().size() == 1);
+    REQUIRE(commands.GetCommandCount() == 4);
+    REQUIRE(commands.Resolve(pending) == NULL_ENTITY);
+
+    commands.Playback(coord);
+
+    const Entity spawned = commands.Resolve(pending);
+    REQUIRE(coord.IsAlive(spawned));
+    REQUIRE(coord.GetComponent<CmdPosition>(live).y == 2.f);
+    REQUIRE(coord.GetComponent<CmdPosition>(spawned).x == 3.f);
+    REQUIRE(coord.GetComponent<CmdTag>(spawned).value == 7);
+    REQUIRE(system->m_Entities.size() == 2);
+    REQUIRE(system->m_Entities.count(live) == 1);
+    REQUIRE(system->m_Entities.count(spawned) == 1);
+    REQUIRE(commands.GetCommandCount() == 0);
+}
+
+TEST_CASE("EntityCommandBuffer collapses an entity's ops into its final signature", "[ecs][commands]") {
+    Coordinator coord;
+    initCoordinator(coord);
+    auto system = coord.RegisterSystem<CmdPositionTagSystem>();
+    Signature both;
+    both.set(coord.GetComponentType<CmdPosition>());
+    both.set(coord.GetComponentType<CmdTag>());
+    coord.SetSystemSignature<CmdPositionTagSystem>(both);
+
+    Entity e = coord.CreateEntity();
+    coord.AddComponent(e, CmdPosition{});
+    coord.AddComponent(e, CmdTag{});
+    REQUIRE(system->m_Entities.count(e) == 1);
+
+    EntityCommandBuffer commands;
+    commands.RemoveComponent<CmdTag>(e);
+    commands.AddComponent(e, CmdTag{5});
+    commands.SetComponent(e, CmdPosition{9.f, 0.f});
+    commands.RemoveComponent<CmdPosition>(e);
+    commands.Playback(coord);
+
+    REQUIRE(coord.GetComponent<CmdTag>(e).value == 5);
+    REQUIRE_FALSE(coord.HasComponent<CmdPosition>(e));
+    REQUIRE(system->m_Entities.count(e) == 0);
+
+    // Set on a component the entity doesn't have is dropped, not added.
+    commands.SetComponent(e, CmdPosition{1.f, 1.f});
+    commands.Playback(coord);
+    REQUIRE_FALSE(coord.HasComponent<CmdPosition>(e));
+}
+
+TEST_CASE("EntityCommandBuffer applies a Set recorded after the Add it follows", "[ecs][commands]") {
+    // Lua's spawn_* records an Add and then a Set per set_transform on the
+    // same fresh entity; the last write has to land.
+    Coordinator coord;
+    initCoordinator(coord);
+    Entity e = coord.CreateEntity();
+
+    EntityCommandBuffer commands;
+    const std::uint64_t epoch = commands.GetEpoch();
+    commands.AddComponent(e, CmdPosition{1.f, 2.f});
+    commands.SetComponent(e, CmdPosition{5.f, 2.f});
+    commands.SetComponent(e, CmdPosition{6.f, 2.f});
+    REQUIRE(commands.GetEpoch() == epoch);
+    commands.Playback(coord);
+
+    REQUIRE(coord.GetComponent<CmdPosition>(e).x == 6.f);
+    REQUIRE(commands.GetEpoch() != epoch);
+    const std::uint64_t played = commands.GetEpoch();
+    commands.Clear();
+    REQUIRE(commands.GetEpoch() != played);
+}
+
+TEST_CASE("EntityCommandBuffer destroy wins and stale handles are ignored", "[ecs][commands]") {
+    Coordinator coord;
+    initCoordinator(coord);
+
+    Entity doomed = coord.CreateEntity();
+    Entity stale = coord.CreateEntity();
+    coord.DestroyEntity(stale);
+    Entity reused = coord.CreateEntity(); // same slot, new generation
+    REQUIRE(EntityIndex(reused) == EntityIndex(stale));
+
+    auto payload = std::make_shared<int>(42);
+    EntityCommandBuffer commands;
+    commands.AddComponent(doomed, CmdHandle{payload});
+    commands.DestroyEntity(doomed);
+    commands.AddComponent(doomed, CmdTag{1});
+    commands.DestroyEntity(stale);
+    commands.AddComponent(stale, CmdTag{2});
+    auto pending = commands.CreateEntity();
+    commands.DestroyEntity(pending);
+    REQUIRE(payload.use_count() == 2);
+
+    commands.Playback(coord);
+
+    REQUIRE_FALSE(coord.IsAlive(doomed));
+    REQUIRE_FALSE(coord.IsAlive(commands.Resolve(pending)));
+    REQUIRE(coord.IsAlive(reused));
+    REQUIRE_FALSE(coord.HasComponent<CmdTag>(reused));
+    // The dropped payload was destroyed, not leaked.
+    REQUIRE(payload.use_count() == 1);
+
+    commands.AddComponent(reused, CmdHandle{payload});
+    commands.Clear();
+    REQUIRE(payload.use_count() == 1);
+    REQUIRE(commands.GetCommandCount() == 0);
+}
+
+TEST_CASE("EntityCommandBuffer records from many threads without locks", "[ecs][commands]") {
+    Coordinator coord;
+    initCoordinator(coord);
+    std::vector<Entity> targets;
+    for (int i = 0; i < 2000; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, CmdPosition{static_cast<float>(i), 0.f});
+        targets.push_back(e);
+    }
+
+    Mist::JobSystem jobs(4);
+    EntityCommandBuffer commands;
+    // Each job tags its own slice and spawns one entity per target; odd
+    // targets are destroyed. Commands on one entity come from one thread.
+    jobs.ParallelFor(targets.size(), 64, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const Entity e = targets[i];
+            if (i % 2) {
+                commands.DestroyEntity(e);
+            } else {
+                commands.AddComponent(e, CmdTag{static_cast<int>(i)});
+            }
+            auto spawned = commands.CreateEntity();
+            commands.AddComponent(spawned, CmdTag{-1});
+        }
+    });
+
+    commands.Playback(coord);
+
+    REQUIRE(coord.GetLivingEntities().size() == 1000 + 2000);
+    int spawned = 0;
+    for (Entity e : coord.GetLivingEntities()) {
+        REQUIRE(coord.HasComponent<CmdTag>(e));
+        const int value = coord.GetComponent<CmdTag>(e).value;
+        if (value < 0) {
+            ++spawned;
+        } else {
+            REQUIRE(value % 2 == 0);
+            REQUIRE(coord.GetComponent<CmdPosition>(e).x == static_cast<float>(value));
+        }
+    }
+    REQUIRE(spawned == 2000);
+}
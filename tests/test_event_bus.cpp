@@ -0,0 +1,119 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/JobSystem.h"
+#include "ECS/Event.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct HitEvent {
+    int a = 0;
+    int b = 0;
+};
+
+struct OtherEvent {
+    float value = 0.f;
+};
+
+} // namespace
+
+TEST_CASE("EventBus queues events and hands each subscriber the whole batch", "[event]") {
+    EventBus bus;
+    std::vector<std::size_t> batchSizes;
+    std::vector<int> seen;
+    bus.Subscribe<HitEvent>([&](EventSpan<HitEvent> hits) {
+        batchSizes.push_back(hits.size());
+        for (const HitEvent& hit : hits) seen.push_back(hit.a);
+    });
+    int otherCalls = 0;
+    bus.Subscribe<OtherEvent>([&](EventSpan<OtherEvent>) { ++otherCalls; });
+
+    for (int i = 0; i < 100; ++i) bus.Publish(HitEvent{i, -i});
+    REQUIRE(seen.empty());
+
+    bus.Flush();
+    REQUIRE(batchSizes == std::vector<std::size_t>{100});
+    REQUIRE(seen.size() == 100);
+    for (int i = 0; i < 100; ++i) REQUIRE(seen[i] == i);
+    // A channel with nothing queued doesn't call its subscribers.
+    REQUIRE(otherCalls == 0);
+
+    bus.Flush();
+    REQUIRE(batchSizes.size() == 1);
+}
+
+TEST_CASE("EventBus drops events with no subscriber and defers re-entrant changes", "[event]") {
+    EventBus bus;
+    bus.Publish(HitEvent{1, 1}); // nobody listening yet: dropped
+
+    int firstCalls = 0;
+    int lateCalls = 0;
+    std::vector<int> echoed;
+    EventBus::Subscription first = 0;
+    first = bus.Subscribe<HitEvent>([&](EventSpan<HitEvent> hits) {
+        ++firstCalls;
+        bus.Unsubscribe(first);
+        bus.Subscribe<HitEvent>([&](EventSpan<HitEvent>) { ++lateCalls; });
+        // Published from a handler: lands in the next Flush.
+        bus.Publish(HitEvent{hits[0].a + 1, 0});
+    });
+    bus.Subscribe<HitEvent>([&](EventSpan<HitEvent> hits) {
+        for (const HitEvent& hit : hits) echoed.push_back(hit.a);
+    });
+
+    bus.Flush();
+    REQUIRE(firstCalls == 0);
+    REQUIRE(echoed.empty());
+
+    bus.Publish(HitEvent{10, 0});
+    bus.Flush();
+    REQUIRE(firstCalls == 1);
+    REQUIRE(lateCalls == 0);
+    REQUIRE(echoed == std::vector<int>{10});
+
+    bus.Flush();
+    REQUIRE(firstCalls == 1);
+    REQUIRE(lateCalls == 1);
+    REQUIRE(echoed == std::vector<int>{10, 11});
+}
+
+TEST_CASE("EventBus PublishConcurrent collects events from many threads", "[event]") {
+    EventBus bus;
+    std::vector<int> counts(20000, 0);
+    std::size_t total = 0;
+    bus.Subscribe<HitEvent>([&](EventSpan<HitEvent> hits) {
+        total += hits.size();
+        for (const HitEvent& hit : hits) ++counts[hit.a];
+    });
+
+    Mist::JobSystem jobs(4);
+    // Two frames, so the second reuses the block chain the first grew.
+    for (int frame = 0; frame < 2; ++frame) {
+        total = 0;
+        std::fill(counts.begin(), counts.end(), 0);
+        bus.Publish(HitEvent{0, 0});
+        jobs.ParallelFor(counts.size() - 1, 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                bus.PublishConcurrent(HitEvent{static_cast<int>(i + 1), 0});
+            }
+        });
+        bus.Flush();
+        REQUIRE(total == counts.size());
+        for (int c : counts) REQUIRE(c == 1);
+    }
+}
+
+TEST_CASE("EventBus destroys queued payloads it never delivers", "[event]") {
+    auto payload = std::make_shared<int>(1);
+    {
+        EventBus bus;
+        bus.Subscribe<std::shared_ptr<int>>([](EventSpan<std::shared_ptr<int>>) {});
+        bus.Publish(payload);
+        bus.PublishConcurrent(payload);
+        REQUIRE(payload.use_count() == 3);
+    }
+    REQUIRE(payload.use_count() == 1);
+}
@@ -0,0 +1,236 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/FlatHashMap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Counts live instances so tests can catch leaked or double-destroyed slots.
+struct Tracked {
+    static inline int live = 0;
+    int value = 0;
+
+    Tracked(int v = 0) : value(v) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+    ~Tracked() { --live; }
+};
+
+// Every key lands in the same home slot, so probing and tombstones get
+// exercised on every operation.
+struct CollidingHash {
+    std::size_t operator()(int) const { return 42; }
+};
+
+// Eight home slots for the whole key range.
+struct ClusteringHash {
+    std::size_t operator()(std::uint32_t key) const { return key % 8; }
+};
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    std::shared_ptr<std::size_t> bytes = std::make_shared<std::size_t>(0);
+
+    CountingAllocator() = default;
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : bytes(other.bytes) {}
+
+    T* allocate(std::size_t n) {
+        *bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) {
+        *bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return bytes == other.bytes; }
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const { return bytes != other.bytes; }
+};
+
+template<typename Hash>
+void checkAgainstUnorderedMap(std::uint32_t keyRange) {
+    Mist::FlatHashMap<std::uint32_t, std::uint32_t, Hash> flat;
+    std::unordered_map<std::uint32_t, std::uint32_t> reference;
+    std::mt19937 rng(1234);
+
+    for (int step = 0; step < 50000; ++step) {
+        const std::uint32_t key = rng() % keyRange;
+        switch (rng() % 3) {
+            case 0:
+                flat[key] = std::uint32_t(step);
+                reference[key] = std::uint32_t(step);
+                break;
+            case 1:
+                REQUIRE(flat.erase(key) == reference.erase(key));
+                break;
+            default: {
+                auto it = flat.find(key);
+                auto ref = reference.find(key);
+                REQUIRE((it == flat.end()) == (ref == reference.end()));
+                if (ref != reference.end()) REQUIRE(it->second == ref->second);
+                break;
+            }
+        }
+    }
+
+    REQUIRE(flat.size() == reference.size());
+    std::size_t visited = 0;
+    for (const auto& [key, value] : flat) {
+        REQUIRE(reference.at(key) == value);
+        ++visited;
+    }
+    REQUIRE(visited == reference.size());
+}
+
+} // namespace
+
+TEST_CASE("FlatHashMap insert, find and overwrite", "[containers][flat_hash_map]") {
+    Mist::FlatHashMap<std::string, int> map;
+    REQUIRE(map.empty());
+    REQUIRE(map.find("missing") == map.end());
+
+    auto [it, inserted] = map.insert({"model", 1});
+    REQUIRE(inserted);
+    REQUIRE(it->first == "model");
+    REQUIRE(it->second == 1);
+
+    REQUIRE_FALSE(map.insert({"model", 2}).second);
+    REQUIRE(map.at("model") == 1);
+
+    map["view"] = 3;
+    map.insert_or_assign("model", 4);
+    REQUIRE(map.size() == 2);
+    REQUIRE(map["model"] == 4);
+    REQUIRE(map.contains("view"));
+    REQUIRE(map.count("projection") == 0);
+    REQUIRE_THROWS_AS(map.at("projection"), std::out_of_range);
+}
+
+TEST_CASE("FlatHashMap try_emplace only consumes arguments on insert", "[containers][flat_hash_map]") {
+    Mist::FlatHashMap<int, std::unique_ptr<int>> map;
+    auto value = std::make_unique<int>(7);
+    REQUIRE(map.try_emplace(1, std::move(value)).second);
+    REQUIRE(value == nullptr);
+
+    auto other = std::make_unique<int>(8);
+    REQUIRE_FALSE(map.try_emplace(1, std::move(other)).second);
+    REQUIRE(other != nullptr);
+    REQUIRE(*map.at(1) == 7);
+}
+
+TEST_CASE("FlatHashMap matches std::unordered_map under random churn", "[containers][flat_hash_map]") {
+    checkAgainstUnorderedMap<std::hash<std::uint32_t>>(2048);
+    // Long runs of shared home slots: erase has to choose correctly between
+    // tombstone and empty.
+    checkAgainstUnorderedMap<ClusteringHash>(512);
+}
+
+TEST_CASE("FlatHashMap stays correct when every key collides", "[containers][flat_hash_map]") {
+    Mist::FlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 100; ++i) map[i] = i * 2;
+    for (int i = 0; i < 100; i += 2) REQUIRE(map.erase(i) == 1);
+
+    // Reinsert over the tombstones left in the probe chain.
+    for (int i = 0; i < 100; i += 4) map[i] = -i;
+
+    // Remaining tombstones sit inside other keys' probe sequences; a copy
+    // has to keep them.
+    Mist::FlatHashMap<int, int, CollidingHash> copy = map;
+    for (const auto* table : {&map, &copy}) {
+        for (int i = 0; i < 100; ++i) {
+            auto it = table->find(i);
+            if (i % 4 == 0) {
+                REQUIRE(it->second == -i);
+            } else if (i % 2 == 0) {
+                REQUIRE(it == table->end());
+            } else {
+                REQUIRE(it->second == i * 2);
+            }
+        }
+        REQUIRE(table->size() == 75);
+    }
+}
+
+TEST_CASE("FlatHashMap erase during iteration visits every element once", "[containers][flat_hash_map]") {
+    Mist::FlatHashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map[i] = i;
+
+    int seen = 0;
+    for (auto it = map.begin(); it != map.end();) {
+        ++seen;
+        it = (it->first % 3 == 0) ? map.erase(it) : std::next(it);
+    }
+    REQUIRE(seen == 1000);
+    REQUIRE(map.size() == 666);
+    for (const auto& [key, value] : map) REQUIRE(key % 3 != 0);
+}
+
+TEST_CASE("FlatHashMap copy, move, clear and reserve keep elements alive exactly once",
+          "[containers][flat_hash_map]") {
+    REQUIRE(Tracked::live == 0);
+    {
+        Mist::FlatHashMap<int, Tracked> map;
+        map.reserve(500);
+        const std::size_t capacity = map.capacity();
+        for (int i = 0; i < 500; ++i) map.try_emplace(i, i);
+        REQUIRE(map.capacity() == capacity);
+        REQUIRE(Tracked::live == 500);
+
+        Mist::FlatHashMap<int, Tracked> copy = map;
+        REQUIRE(Tracked::live == 1000);
+        REQUIRE(copy.at(250).value == 250);
+
+        Mist::FlatHashMap<int, Tracked> moved = std::move(copy);
+        REQUIRE(Tracked::live == 1000);
+        REQUIRE(copy.empty());
+        REQUIRE(moved.size() == 500);
+
+        map.clear();
+        REQUIRE(Tracked::live == 500);
+        REQUIRE(map.capacity() == capacity);
+
+        map = moved;
+        REQUIRE(Tracked::live == 1000);
+        for (int i = 0; i < 500; i += 2) map.erase(i);
+        REQUIRE(Tracked::live == 750);
+    }
+    REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("FlatHashMap allocates through its allocator", "[containers][flat_hash_map]") {
+    using Alloc = CountingAllocator<std::pair<int, int>>;
+    Alloc alloc;
+    {
+        Mist::FlatHashMap<int, int, std::hash<int>, std::equal_to<int>, Alloc> map(alloc);
+        for (int i = 0; i < 100; ++i) map[i] = i;
+        REQUIRE(*alloc.bytes >= map.capacity() * (sizeof(std::pair<int, int>) + 1));
+    }
+    REQUIRE(*alloc.bytes == 0);
+}
+
+TEST_CASE("FlatHashSet insert, erase and iterate", "[containers][flat_hash_map]") {
+    Mist::FlatHashSet<std::string> set{"albedo", "normal"};
+    REQUIRE(set.size() == 2);
+    REQUIRE_FALSE(set.insert("albedo").second);
+    REQUIRE(set.insert("roughness").second);
+    REQUIRE(set.erase("normal") == 1);
+    REQUIRE(set.erase("normal") == 0);
+
+    std::vector<std::string> items(set.begin(), set.end());
+    std::sort(items.begin(), items.end());
+    REQUIRE(items == std::vector<std::string>{"albedo", "roughness"});
+}
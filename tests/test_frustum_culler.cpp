@@ -0,0 +1,97 @@
+#include <catch2/catch_all.hpp>
+
+#include "Scene/FrustumCuller.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+Frustum FromVP(const glm::mat4& vp) {
+    Frustum frustum;
+    frustum.ExtractFromVP(vp);
+    return frustum;
+}
+
+// A camera and four cascade-like light views, the shape of a real frame.
+std::vector<Frustum> FrameViews() {
+    const glm::mat4 light = glm::lookAt(glm::vec3(30, 60, 30), glm::vec3(0), glm::vec3(0, 1, 0));
+    return {
+        FromVP(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+               glm::lookAt(glm::vec3(0, 5, 0), glm::vec3(40, 0, 40), glm::vec3(0, 1, 0))),
+        FromVP(glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.0f, 150.0f) * light),
+        FromVP(glm::ortho(-25.0f, 25.0f, -25.0f, 25.0f, 0.0f, 150.0f) * light),
+        FromVP(glm::ortho(-50.0f, 50.0f, -50.0f, 50.0f, 0.0f, 150.0f) * light),
+        FromVP(glm::ortho(-90.0f, 90.0f, -90.0f, 90.0f, 0.0f, 150.0f) * light),
+    };
+}
+
+} // namespace
+
+TEST_CASE("FrustumCuller matches Frustum::Intersects box for box", "[culling]") {
+    std::mt19937 rng(24);
+    std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> half(0.0f, 8.0f);
+    const std::vector<Frustum> views = FrameViews();
+
+    // Counts that leave every possible SIMD tail, plus a word boundary.
+    for (std::size_t count : {0u, 1u, 3u, 7u, 63u, 64u, 65u, 1000u, 4099u}) {
+        BoundsSoA bounds;
+        for (std::size_t i = 0; i < count; ++i) {
+            const glm::vec3 c(pos(rng), pos(rng) * 0.2f, pos(rng));
+            const glm::vec3 h(half(rng), half(rng), half(rng));
+            bounds.Push(AABB{c - h, c + h});
+        }
+        if (count > 10) {
+            // Degenerate, everywhere and broken boxes.
+            bounds.minX[1] = bounds.maxX[1];
+            bounds.minX[2] = bounds.minY[2] = bounds.minZ[2] = -1e30f;
+            bounds.maxX[2] = bounds.maxY[2] = bounds.maxZ[2] = 1e30f;
+            bounds.minY[5] = std::nanf("");
+        }
+
+        std::vector<VisibilityBitset> simd(views.size()), scalar(views.size());
+        FrustumCuller::CullFrustums(views.data(), views.size(), bounds, simd.data());
+        FrustumCuller::CullFrustumsScalar(views.data(), views.size(), bounds, scalar.data());
+
+        for (std::size_t v = 0; v < views.size(); ++v) {
+            REQUIRE(simd[v].Size() == count);
+            for (std::size_t i = 0; i < count; ++i) {
+                REQUIRE(simd[v].Test(i) == views[v].Intersects(bounds.Get(i)));
+            }
+            REQUIRE(simd[v] == scalar[v]);
+        }
+        if (count > 10) {
+            for (const VisibilityBitset& visible : simd) REQUIRE(visible.Test(2));
+        }
+    }
+}
+
+TEST_CASE("FrustumCuller single view and bitset basics", "[culling]") {
+    const Frustum camera = FrameViews()[0];
+    BoundsSoA bounds;
+    bounds.Push(AABB{{19, -1, 19}, {21, 1, 21}});        // straight ahead
+    bounds.Push(AABB{{-21, -1, -21}, {-19, 1, -19}});    // behind
+    bounds.Push(AABB{{200, -1, 200}, {201, 1, 201}});    // past the far plane
+    bounds.Push(AABB{{-1, 4, -1}, {1, 6, 1}});           // around the eye
+
+    VisibilityBitset visible;
+    FrustumCuller::CullFrustum(camera, bounds, visible);
+    REQUIRE(visible.Size() == 4);
+    REQUIRE(visible.Count() == 2);
+    REQUIRE(visible.Test(0));
+    REQUIRE_FALSE(visible.Test(1));
+    REQUIRE_FALSE(visible.Test(2));
+    REQUIRE(visible.Test(3));
+
+    // Reuse shrinks and clears.
+    bounds.Clear();
+    FrustumCuller::CullFrustum(camera, bounds, visible);
+    REQUIRE(visible.Size() == 0);
+    REQUIRE(visible.Count() == 0);
+    REQUIRE(std::string(FrustumCuller::BackendName()).size() > 0);
+}
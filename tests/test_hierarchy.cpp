@@ -4,9 +4,13 @@
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Coordinator.h"
 #include "ECS/Systems/HierarchySystem.h"
+#include "ECS/Systems/TransformHierarchy.h"
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <memory>
+#include <random>
+#include <vector>
 
 // Each test builds its own Coordinator (not the global one) so they stay
 // isolated from whatever the main engine would have set up.
@@ -135,3 +139,289 @@ TEST_CASE("HierarchySystem OnReady fires post-order", "[hierarchy][signal]") {
 
     HierarchySystem::OnReady().Disconnect(id);
 }
+
+TEST_CASE("HierarchySystem OnReady only visits newly added or attached entities", "[hierarchy][signal]") {
+    HierarchyFixture fx;
+    Entity root = fx.MakeEntity();
+    Entity a = fx.MakeEntity();
+    REQUIRE(HierarchySystem::Attach(fx.coord, root, a));
+
+    std::vector<Entity> fired;
+    auto id = HierarchySystem::OnReady().Connect([&](Entity e) { fired.push_back(e); });
+    fx.sys->FireReadyCallbacks(fx.coord);
+    REQUIRE(fired == std::vector<Entity>{a, root});
+
+    // A two-deep subtree added under an already-ready parent: only the new
+    // entities fire, deepest first.
+    Entity b = fx.MakeEntity();
+    Entity c = fx.MakeEntity();
+    REQUIRE(HierarchySystem::Attach(fx.coord, b, c));
+    REQUIRE(HierarchySystem::Attach(fx.coord, a, b));
+    fired.clear();
+    fx.sys->FireReadyCallbacks(fx.coord);
+    REQUIRE(fired == std::vector<Entity>{c, b});
+
+    // An entity nobody stamped isn't revisited, even if its flag is reset.
+    fx.coord.GetComponent<HierarchyComponent>(root).readyFired = false;
+    fired.clear();
+    fx.sys->FireReadyCallbacks(fx.coord);
+    REQUIRE(fired.empty());
+
+    HierarchySystem::OnReady().Disconnect(id);
+}
+
+TEST_CASE("HierarchySystem only recomputes what changed", "[hierarchy][changes]") {
+    HierarchyFixture fx;
+    Entity parent = fx.MakeEntity({10, 0, 0});
+    Entity child  = fx.MakeEntity({0, 5, 0});
+    Entity other  = fx.MakeEntity({1, 0, 0});
+    REQUIRE(HierarchySystem::Attach(fx.coord, parent, child));
+    fx.sys->UpdateTransforms(fx.coord);
+
+    // Nothing stamped: a poisoned cache survives, proving no work was done.
+    auto& ot = fx.coord.GetComponent<TransformComponent>(other);
+    ot.cachedGlobal[3][0] = 42.0f;
+    fx.sys->UpdateTransforms(fx.coord);
+    REQUIRE(ot.cachedGlobal[3][0] == Catch::Approx(42.0f));
+
+    // Moving the parent through GetComponentMut reaches the child, and the
+    // child is stamped so cachedGlobal consumers can see it moved.
+    const ChangeTick before = fx.coord.GetChangeTick();
+    fx.coord.GetComponentMut<TransformComponent>(parent).position.x = 20.0f;
+    fx.sys->UpdateTransforms(fx.coord);
+    auto& ct = fx.coord.GetComponent<TransformComponent>(child);
+    REQUIRE(ct.cachedGlobal[3][0] == Catch::Approx(20.0f));
+    REQUIRE(fx.coord.ChangedSince<TransformComponent>(child, before - 1));
+    REQUIRE(ot.cachedGlobal[3][0] == Catch::Approx(42.0f));
+}
+
+TEST_CASE("HierarchySystem re-roots children when their parent is destroyed", "[hierarchy][changes]") {
+    HierarchyFixture fx;
+    Entity parent = fx.MakeEntity({10, 0, 0});
+    Entity child  = fx.MakeEntity({0, 5, 0});
+    REQUIRE(HierarchySystem::Attach(fx.coord, parent, child));
+    fx.sys->UpdateTransforms(fx.coord);
+    REQUIRE(fx.sys->GetTree().Contains(parent));
+
+    // Destroying stamps nothing: only the membership shrinks.
+    fx.coord.DestroyEntity(parent);
+    fx.sys->UpdateTransforms(fx.coord);
+
+    auto& ct = fx.coord.GetComponent<TransformComponent>(child);
+    REQUIRE(ct.cachedGlobal == ct.GetModelMatrix());
+    REQUIRE_FALSE(fx.sys->GetTree().Contains(parent));
+    REQUIRE(fx.sys->GetTree().Size() == 1);
+}
+
+namespace {
+
+glm::mat4 Translation(float x, float y, float z) {
+    glm::mat4 m(1.0f);
+    m[3] = glm::vec4(x, y, z, 1.0f);
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("TransformHierarchy matches a recursive reference under random edits", "[hierarchy][flat]") {
+    // Reference: plain parent links + locals, world computed by walking up.
+    constexpr Entity kCount = 300;
+    std::vector<Entity> parentOf(kCount, NULL_ENTITY);
+    std::vector<glm::mat4> localOf(kCount);
+    std::vector<bool> live(kCount, false);
+
+    auto isAncestor = [&](Entity ancestor, Entity e) {
+        for (Entity up = e; up != NULL_ENTITY; up = parentOf[up]) {
+            if (up == ancestor) return true;
+        }
+        return false;
+    };
+    auto worldOf = [&](Entity e) {
+        glm::mat4 world(1.0f);
+        std::vector<Entity> chain;
+        for (Entity up = e; up != NULL_ENTITY; up = parentOf[up]) chain.push_back(up);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) world = world * localOf[*it];
+        return world;
+    };
+
+    TransformHierarchy tree;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+    for (int step = 0; step < 3000; ++step) {
+        const Entity e = rng() % kCount;
+        const Entity other = rng() % kCount;
+        switch (rng() % 4) {
+            case 0:
+                if (!live[e]) {
+                    live[e] = true;
+                    parentOf[e] = NULL_ENTITY;
+                    localOf[e] = Translation(offset(rng), offset(rng), offset(rng));
+                    tree.Insert(e, localOf[e]);
+                } else {
+                    tree.Remove(e);
+                    live[e] = false;
+                    for (Entity c = 0; c < kCount; ++c) {
+                        if (parentOf[c] == e) parentOf[c] = NULL_ENTITY;
+                    }
+                    parentOf[e] = NULL_ENTITY;
+                }
+                break;
+            case 1:
+            case 2:
+                if (!live[e]) break;
+                if (live[other] && other != e && !isAncestor(e, other)) {
+                    REQUIRE(tree.SetParent(e, other));
+                    parentOf[e] = other;
+                } else if (live[other] && isAncestor(e, other)) {
+                    REQUIRE_FALSE(tree.SetParent(e, other));
+                } else {
+                    REQUIRE(tree.SetParent(e, NULL_ENTITY));
+                    parentOf[e] = NULL_ENTITY;
+                }
+                break;
+            default:
+                if (!live[e]) break;
+                localOf[e] = Translation(offset(rng), offset(rng), offset(rng));
+                tree.SetLocal(e, localOf[e]);
+                break;
+        }
+
+        // Frequent updates keep the dirty list short (subtree walks); the
+        // first ones, with everything new, sweep whole levels.
+        if (step % 5 != 0) continue;
+        tree.Update([](Entity, const glm::mat4&, bool) {});
+        if (step % 50 != 0) continue;
+
+        std::size_t liveCount = 0;
+        std::uint32_t lastDepth = 0;
+        for (std::size_t slot = 0; slot < tree.Size(); ++slot) {
+            const Entity s = tree.EntityAt(slot);
+            REQUIRE(tree.GetDepth(s) >= lastDepth); // depth-sorted
+            lastDepth = tree.GetDepth(s);
+        }
+        for (Entity c = 0; c < kCount; ++c) {
+            REQUIRE(tree.Contains(c) == live[c]);
+            if (!live[c]) continue;
+            ++liveCount;
+            REQUIRE(tree.GetParent(c) == parentOf[c]);
+            const glm::mat4 expected = worldOf(c);
+            for (int col = 0; col < 4; ++col) {
+                for (int row = 0; row < 4; ++row) {
+                    REQUIRE(tree.GetWorld(c)[col][row] == Catch::Approx(expected[col][row]).margin(1e-4));
+                }
+            }
+        }
+        REQUIRE(tree.Size() == liveCount);
+    }
+}
+
+TEST_CASE("HierarchySystem handles deep and wide trees and reparenting", "[hierarchy][flat]") {
+    HierarchyFixture fx;
+
+    // A 64-deep chain, each link one unit along X.
+    std::vector<Entity> chain{fx.MakeEntity({1, 0, 0})};
+    for (int i = 1; i < 64; ++i) {
+        chain.push_back(fx.MakeEntity({1, 0, 0}));
+        REQUIRE(HierarchySystem::Attach(fx.coord, chain[i - 1], chain[i]));
+    }
+    // A root with enough children that its level is split across jobs.
+    Entity hub = fx.MakeEntity({0, 100, 0});
+    std::vector<Entity> leaves;
+    for (int i = 0; i < 5000; ++i) {
+        leaves.push_back(fx.MakeEntity({0, 0, float(i)}));
+        REQUIRE(HierarchySystem::Attach(fx.coord, hub, leaves.back()));
+    }
+    fx.sys->UpdateTransforms(fx.coord);
+
+    auto world = [&](Entity e) { return fx.coord.GetComponent<TransformComponent>(e).cachedGlobal[3]; };
+    REQUIRE(world(chain.back()).x == Catch::Approx(64.0f));
+    REQUIRE(world(leaves[4321]).y == Catch::Approx(100.0f));
+    REQUIRE(world(leaves[4321]).z == Catch::Approx(4321.0f));
+
+    // Hang the second half of the chain off a leaf: the subtree changes
+    // depth, and every node in it follows.
+    REQUIRE(HierarchySystem::Detach(fx.coord, chain[32]));
+    REQUIRE(HierarchySystem::Attach(fx.coord, leaves[10], chain[32]));
+    fx.sys->UpdateTransforms(fx.coord);
+    REQUIRE(world(chain[31]).x == Catch::Approx(32.0f));
+    REQUIRE(world(chain.back()).x == Catch::Approx(32.0f));
+    REQUIRE(world(chain.back()).y == Catch::Approx(100.0f));
+    REQUIRE(world(chain.back()).z == Catch::Approx(10.0f));
+
+    // Moving the hub now reaches the re-hung chain too.
+    fx.coord.GetComponentMut<TransformComponent>(hub).position.y = 200.0f;
+    fx.sys->UpdateTransforms(fx.coord);
+    REQUIRE(world(chain.back()).y == Catch::Approx(200.0f));
+    REQUIRE(world(chain[0]).y == Catch::Approx(0.0f));
+
+    // A destroyed parent leaves its children as roots.
+    fx.coord.DestroyEntity(leaves[10]);
+    fx.coord.GetComponentMut<TransformComponent>(chain[32]).position.x = 5.0f;
+    fx.sys->UpdateTransforms(fx.coord);
+    REQUIRE(world(chain[32]).x == Catch::Approx(5.0f));
+    REQUIRE(world(chain[32]).y == Catch::Approx(0.0f));
+    REQUIRE(world(chain.back()).x == Catch::Approx(5.0f + 31.0f));
+
+    // A member leaving in the same frame another joins keeps the counts
+    // equal until the newcomer is in; the leaver must still be dropped
+    // before its old parent's move reaches it. (The bare entity takes the
+    // freed index, so the newcomer doesn't simply replace the stale handle.)
+    fx.coord.DestroyEntity(chain.back());
+    fx.coord.CreateEntity();
+    Entity late = fx.MakeEntity({0, 0, 7});
+    fx.coord.GetComponentMut<TransformComponent>(chain[32]).position.x = 6.0f;
+    REQUIRE_NOTHROW(fx.sys->UpdateTransforms(fx.coord));
+    REQUIRE(world(chain[62]).x == Catch::Approx(6.0f + 30.0f));
+    REQUIRE(world(late).z == Catch::Approx(7.0f));
+}
+
+TEST_CASE("TransformComponent Euler view matches translate * Rx * Ry * Rz * scale", "[hierarchy][transform]") {
+    const glm::vec3 position{1.0f, -2.0f, 3.0f};
+    const glm::vec3 scale{2.0f, 1.0f, 0.5f};
+    for (const glm::vec3& degrees : {glm::vec3(30.0f, 45.0f, 60.0f), glm::vec3(-120.0f, 10.0f, 170.0f),
+                                     glm::vec3(0.0f, 90.0f, 0.0f)}) {
+        TransformComponent t;
+        t.SetPosition(position);
+        t.SetEulerDegrees(degrees);
+        t.SetScale(scale);
+
+        // The matrix the Euler-angle component used to build every call.
+        glm::mat4 expected = glm::translate(glm::mat4(1.0f), position);
+        expected = glm::rotate(expected, glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        expected = glm::rotate(expected, glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        expected = glm::rotate(expected, glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        expected = glm::scale(expected, scale);
+
+        TransformComponent roundTrip;
+        roundTrip.SetEulerDegrees(t.GetEulerDegrees());
+        roundTrip.SetPosition(position);
+        roundTrip.SetScale(scale);
+
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                REQUIRE(t.GetModelMatrix()[col][row] == Catch::Approx(expected[col][row]).margin(1e-5));
+                REQUIRE(roundTrip.GetModelMatrix()[col][row] == Catch::Approx(expected[col][row]).margin(1e-4));
+            }
+        }
+    }
+}
+
+TEST_CASE("TransformComponent caches the local matrix until a setter runs", "[hierarchy][transform]") {
+    TransformComponent t;
+    t.SetPosition({1.0f, 0.0f, 0.0f});
+    const glm::mat4* cached = &t.GetModelMatrix();
+    REQUIRE_FALSE(t.dirty);
+    REQUIRE((*cached)[3][0] == Catch::Approx(1.0f));
+
+    // A direct field write isn't seen until something invalidates...
+    t.position.x = 5.0f;
+    REQUIRE(t.GetModelMatrix()[3][0] == Catch::Approx(1.0f));
+    REQUIRE(t.RebuildModelMatrix()[3][0] == Catch::Approx(5.0f));
+
+    // ...while a setter is.
+    t.SetRotation(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    REQUIRE(t.dirty);
+    REQUIRE(t.GetModelMatrix()[0][1] == Catch::Approx(1.0f)); // X axis now points along +Y
+    REQUIRE(&t.GetModelMatrix() == cached);
+}
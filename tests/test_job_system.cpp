@@ -0,0 +1,124 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("JobSystem runs scheduled jobs", "[jobs]") {
+    Mist::JobSystem jobs(2);
+    std::atomic<int> ran{0};
+    std::vector<Mist::JobHandle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(jobs.Schedule([&] { ++ran; }));
+    }
+    for (const auto& h : handles) jobs.Wait(h);
+    REQUIRE(ran.load() == 100);
+    for (const auto& h : handles) REQUIRE(h.IsDone());
+}
+
+TEST_CASE("JobSystem runs a job only after its dependencies", "[jobs]") {
+    Mist::JobSystem jobs(3);
+    for (int frame = 0; frame < 50; ++frame) {
+        std::atomic<int> stage{0};
+        std::atomic<bool> orderOk{true};
+        auto a = jobs.Schedule([&] {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++stage;
+        });
+        auto b = jobs.Schedule([&] { ++stage; });
+        auto c = jobs.Schedule([&] { if (stage.load() != 2) orderOk = false; }, {a, b});
+        // An empty handle counts as done.
+        auto d = jobs.Schedule([&] { if (stage.load() != 2) orderOk = false; }, {c, Mist::JobHandle{}});
+        jobs.Wait(d);
+        REQUIRE(orderOk.load());
+        REQUIRE(c.IsDone());
+    }
+}
+
+TEST_CASE("JobSystem parallel-for covers every index exactly once", "[jobs]") {
+    Mist::JobSystem jobs(3);
+    std::vector<int> hits(10007, 0);
+    jobs.ParallelFor(hits.size(), 64, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) ++hits[i];
+    });
+    REQUIRE(std::accumulate(hits.begin(), hits.end(), 0) == 10007);
+    REQUIRE(*std::min_element(hits.begin(), hits.end()) == 1);
+
+    // Below one grain the range runs inline on the caller.
+    const auto caller = std::this_thread::get_id();
+    bool inline_ = false;
+    jobs.ParallelFor(10, 64, [&](std::size_t begin, std::size_t end) {
+        inline_ = begin == 0 && end == 10 && std::this_thread::get_id() == caller;
+    });
+    REQUIRE(inline_);
+}
+
+TEST_CASE("JobSystem spreads work across workers", "[jobs]") {
+    // Every chunk sleeps, so a single thread can't drain them all before
+    // the others wake up and steal.
+    Mist::JobSystem jobs(3);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    jobs.ParallelFor(32, 1, [&](std::size_t, std::size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    REQUIRE(threads.size() > 1);
+}
+
+TEST_CASE("JobSystem nested waits inside jobs complete", "[jobs]") {
+    // Each outer job waits on inner jobs it scheduled. With one worker this
+    // only finishes because Wait() runs queued work instead of blocking.
+    Mist::JobSystem jobs(1);
+    std::atomic<int> inner{0};
+    auto outer = jobs.ScheduleParallelFor(4, 1, [&](std::size_t, std::size_t) {
+        jobs.ParallelFor(8, 1, [&](std::size_t, std::size_t) { ++inner; });
+    });
+    jobs.Wait(outer);
+    REQUIRE(inner.load() == 32);
+}
+
+TEST_CASE("JobSystem main-thread jobs only run on the bound thread", "[jobs]") {
+    Mist::JobSystem jobs(2);
+    jobs.BindMainThread();
+    REQUIRE(jobs.IsMainThread());
+
+    const auto mainId = std::this_thread::get_id();
+    std::atomic<bool> onMain{false};
+    auto decode = jobs.Schedule([] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    auto upload = jobs.Schedule([&] { onMain = std::this_thread::get_id() == mainId; }, {decode},
+                                Mist::JobAffinity::MainThread);
+
+    // Workers never pick it up, however long we give them.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(upload.IsDone());
+
+    jobs.PumpMainThread();
+    REQUIRE(upload.IsDone());
+    REQUIRE(onMain.load());
+
+    // Wait() on the main thread drains main-thread jobs too.
+    auto another = jobs.Schedule([&] { onMain = std::this_thread::get_id() == mainId; },
+                                 Mist::JobAffinity::MainThread);
+    jobs.Wait(another);
+    REQUIRE(onMain.load());
+}
+
+TEST_CASE("JobSystem rethrows a job's exception from Wait", "[jobs]") {
+    Mist::JobSystem jobs(2);
+    std::atomic<int> after{0};
+    auto boom = jobs.Schedule([] { throw std::runtime_error("boom"); });
+    auto next = jobs.Schedule([&] { ++after; }, {boom});
+    REQUIRE_THROWS_AS(jobs.Wait(boom), std::runtime_error);
+    jobs.Wait(next);
+    REQUIRE(after.load() == 1);
+}
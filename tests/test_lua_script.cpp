@@ -2,19 +2,25 @@
 
 #include <catch2/catch_all.hpp>
 
+#include "Core/ServiceLocator.h"
 #include "ECS/Components/ScriptComponent.h"
 #include "ECS/Components/TransformComponent.h"
 #include "ECS/Components/HierarchyComponent.h"
 #include "ECS/Coordinator.h"
+#include "ECS/EntityCommandBuffer.h"
 #include "ECS/Systems/HierarchySystem.h"
 #include "ECS/Systems/ScriptSystem.h"
+#include "ECS/Systems/SpatialHashSystem.h"
 #include "Script/LuaScriptLanguage.h"
 #include "Script/ScriptRegistry.h"
 
+#include <glm/glm.hpp>
+
 #include <memory>
 #include <string>
 
 extern Coordinator gCoordinator;
+extern EntityCommandBuffer gEntityCommands;
 
 // Each test builds a LuaScriptLanguage fresh; singleton ScriptRegistry
 // tolerates re-registration (last-writer wins) so tests stay isolated.
@@ -112,6 +118,7 @@ TEST_CASE("spawn_cube is callable from Lua (binding registered)", "[lua][binding
             and (type(destroy_entity) == 'function')
             and (type(attach_script) == 'function')
             and (type(run_script) == 'function')
+            and (type(raycast) == 'function')
         has_ok = tostring(ok)
     )");
     REQUIRE(inst != nullptr);
@@ -129,4 +136,72 @@ TEST_CASE("destroy_entity tolerates negative ids without crashing", "[lua][bindi
     SUCCEED();
 }
 
+TEST_CASE("query_radius/query_box return the reused result array", "[lua][bindings]") {
+    SpatialHashSystem proximity;
+    proximity.GetGrid().Insert(static_cast<Entity>(7), {0, 0, 0});
+    proximity.GetGrid().Insert(static_cast<Entity>(8), {1, 0, 0});
+    proximity.GetGrid().Insert(static_cast<Entity>(9), {50, 0, 0});
+    ServiceLocator::Instance().SetSpatialHash(&proximity);
+
+    auto lua = makeLua();
+    auto inst = lua->Compile(R"(
+        local near, n = query_radius(0, 0, 0, 2)
+        local sum = 0
+        for i = 1, n do sum = sum + near[i] end
+        local far, m = query_box(40, -1, -1, 60, 1, 1)
+        -- Same table, shrunk to the new result.
+        result = tostring(n) .. ' ' .. tostring(sum) .. ' ' .. tostring(m) .. ' '
+            .. tostring(far[1]) .. ' ' .. tostring(#far) .. ' ' .. tostring(rawequal(near, far))
+    )");
+    ServiceLocator::Instance().SetSpatialHash(nullptr);
+    REQUIRE(inst != nullptr);
+
+    std::string out;
+    REQUIRE(inst->GetString("result", out));
+    REQUIRE(out == "2 15 1 9 1 true");
+}
+
+TEST_CASE("An entity spawned in _process can be moved before playback", "[lua][bindings]") {
+    gCoordinator.Init();
+    gCoordinator.RegisterComponent<TransformComponent>();
+    gCoordinator.RegisterComponent<HierarchyComponent>();
+    gEntityCommands.Clear();
+
+    auto lua = makeLua();
+    auto inst = lua->Compile(R"(
+        function _process()
+            spawned = spawn_empty(1, 2, 3)
+            local t = get_transform(spawned)
+            t.x = t.x + 10
+            set_transform(t, spawned)
+            t = get_transform(spawned)
+            seen = tostring(t.x) .. ' ' .. tostring(t.y)
+            spawned_id = tostring(spawned)
+        end
+        function move_again()
+            set_transform({ x = 20 }, spawned)
+        end
+    )");
+    REQUIRE(inst != nullptr);
+    inst->CallVoid("_process");
+
+    std::string out;
+    REQUIRE(inst->GetString("seen", out));
+    REQUIRE(out == "11.0 2.0");
+    REQUIRE(inst->GetString("spawned_id", out));
+    const Entity e = static_cast<Entity>(std::stoll(out));
+    REQUIRE(gCoordinator.IsAlive(e));
+    REQUIRE_FALSE(gCoordinator.HasComponent<TransformComponent>(e));
+
+    // The move lands with the spawn.
+    gEntityCommands.Playback(gCoordinator);
+    REQUIRE(gCoordinator.HasComponent<HierarchyComponent>(e));
+    REQUIRE(gCoordinator.GetComponent<TransformComponent>(e).position == glm::vec3(11, 2, 3));
+
+    // From then on it's the live component, written directly.
+    inst->CallVoid("move_again");
+    REQUIRE(gEntityCommands.GetCommandCount() == 0);
+    REQUIRE(gCoordinator.GetComponent<TransformComponent>(e).position.x == 20.0f);
+}
+
 #endif // MIST_ENABLE_SCRIPTING
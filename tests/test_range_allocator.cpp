@@ -0,0 +1,114 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/RangeAllocator.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+using Mist::RangeAllocator;
+
+TEST_CASE("RangeAllocator hands out disjoint blocks and coalesces on free", "[range_allocator]") {
+    RangeAllocator alloc(100);
+    REQUIRE(alloc.Capacity() == 100);
+    REQUIRE(alloc.LargestFree() == 100);
+
+    const std::uint32_t a = alloc.Allocate(30);
+    const std::uint32_t b = alloc.Allocate(30);
+    const std::uint32_t c = alloc.Allocate(30);
+    REQUIRE(a == 0);
+    REQUIRE(b == 30);
+    REQUIRE(c == 60);
+    REQUIRE(alloc.Used() == 90);
+    REQUIRE(alloc.Allocate(11) == RangeAllocator::kInvalid);
+    REQUIRE(alloc.Allocate(0) == RangeAllocator::kInvalid);
+
+    // A hole in the middle, then its neighbours: one block again.
+    alloc.Free(b, 30);
+    REQUIRE(alloc.FreeBlockCount() == 2);
+    REQUIRE(alloc.LargestFree() == 30);
+    alloc.Free(a, 30);
+    REQUIRE(alloc.FreeBlockCount() == 2);
+    REQUIRE(alloc.LargestFree() == 60);
+    alloc.Free(c, 30);
+    REQUIRE(alloc.FreeBlockCount() == 1);
+    REQUIRE(alloc.LargestFree() == 100);
+    REQUIRE(alloc.Used() == 0);
+}
+
+TEST_CASE("RangeAllocator takes the best fit", "[range_allocator]") {
+    RangeAllocator alloc(100);
+    std::uint32_t blocks[5];
+    for (std::uint32_t& block : blocks) block = alloc.Allocate(20);
+    alloc.Free(blocks[0], 20); // 20 free at 0
+    alloc.Free(blocks[2], 20); // 20 free at 40
+    alloc.Free(blocks[3], 20); // merges: 40 free at 40
+
+    // 15 fits both; the smaller hole takes it and the 40 stays whole.
+    REQUIRE(alloc.Allocate(15) == 0);
+    REQUIRE(alloc.LargestFree() == 40);
+    REQUIRE(alloc.Allocate(40) == 40);
+    REQUIRE(alloc.LargestFree() == 5);
+}
+
+TEST_CASE("RangeAllocator grows into a free tail", "[range_allocator]") {
+    RangeAllocator alloc;
+    REQUIRE(alloc.Allocate(1) == RangeAllocator::kInvalid);
+
+    alloc.Grow(64);
+    const std::uint32_t a = alloc.Allocate(48);
+    REQUIRE(a == 0);
+    REQUIRE(alloc.Allocate(32) == RangeAllocator::kInvalid);
+
+    // The 16 free at the end and the new 64 become one block of 80.
+    alloc.Grow(128);
+    REQUIRE(alloc.FreeBlockCount() == 1);
+    REQUIRE(alloc.LargestFree() == 80);
+    REQUIRE(alloc.Allocate(80) == 48);
+
+    // A full space grows a fresh block; shrinking is ignored.
+    alloc.Grow(160);
+    alloc.Grow(10);
+    REQUIRE(alloc.Capacity() == 160);
+    REQUIRE(alloc.Allocate(32) == 128);
+    REQUIRE(alloc.Used() == 160);
+}
+
+TEST_CASE("RangeAllocator survives random churn", "[range_allocator]") {
+    std::mt19937 rng(25);
+    RangeAllocator alloc(1u << 16);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> live;
+    std::vector<std::uint8_t> owner(1u << 16, 0);
+
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            const std::uint32_t count = 1 + rng() % 700;
+            const std::uint32_t offset = alloc.Allocate(count);
+            if (offset == RangeAllocator::kInvalid) {
+                REQUIRE(alloc.LargestFree() < count);
+                continue;
+            }
+            for (std::uint32_t i = offset; i < offset + count; ++i) {
+                REQUIRE(owner[i] == 0);
+                owner[i] = 1;
+            }
+            live.emplace_back(offset, count);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const auto [offset, count] = live[pick];
+            for (std::uint32_t i = offset; i < offset + count; ++i) owner[i] = 0;
+            alloc.Free(offset, count);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+
+    std::uint32_t used = 0;
+    for (const auto& block : live) used += block.second;
+    REQUIRE(alloc.Used() == used);
+
+    for (const auto& block : live) alloc.Free(block.first, block.second);
+    REQUIRE(alloc.Used() == 0);
+    REQUIRE(alloc.FreeBlockCount() == 1);
+    REQUIRE(alloc.LargestFree() == alloc.Capacity());
+}
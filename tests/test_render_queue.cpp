@@ -0,0 +1,390 @@
+#include <catch2/catch_all.hpp>
+
+#include "Material.h"
+#include "Renderable.h"
+#include "Renderer/GeometryPool.h"
+#include "Renderer/RenderQueue.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Mist::Renderer;
+
+namespace {
+
+struct UnitCube : Renderable {
+    bool instancing = true;
+    GeometryRange range; // pooled when it has indices
+
+    UnitCube() { m_LocalBounds = AABB{glm::vec3(-0.5f), glm::vec3(0.5f)}; }
+    void Draw(Shader&) override {}
+    bool SupportsInstancing() const override { return instancing; }
+    const GeometryRange* GetGeometryRange() const override { return range.IsValid() ? &range : nullptr; }
+};
+
+// Stands in for the GL device: records what a pass would have issued.
+struct RecordingSink : DrawSink {
+    struct Call {
+        bool bind;
+        Entity entity;
+        glm::vec3 origin;
+        std::uint32_t firstInstance = 0;
+        std::uint32_t count = 1;
+        bool indirect = false;
+    };
+    std::vector<Call> calls;
+
+    void BindMaterial(const DrawItem& item) override { calls.push_back({true, item.entity, {}}); }
+    void Draw(const DrawItem& item, const glm::mat4& world) override {
+        calls.push_back({false, item.entity, glm::vec3(world[3])});
+    }
+    void DrawInstanced(const DrawItem& item, std::uint32_t firstInstance, std::uint32_t count) override {
+        calls.push_back({false, item.entity, {}, firstInstance, count});
+    }
+    void DrawIndirect(const DrawItem& item, std::uint32_t firstCommand, std::uint32_t commandCount) override {
+        calls.push_back({false, item.entity, {}, firstCommand, commandCount, true});
+    }
+    std::size_t Binds() const {
+        return std::count_if(calls.begin(), calls.end(), [](const Call& c) { return c.bind; });
+    }
+};
+
+glm::mat4 At(const glm::vec3& p) {
+    glm::mat4 m(1.0f);
+    m[3] = glm::vec4(p, 1.0f);
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("DrawKey packs fields in priority order and saturates", "[render][queue]") {
+    const std::uint64_t key = DrawKey::Make(3, 70, 9, 12345);
+    REQUIRE(DrawKey::Shader(key) == 3);
+    REQUIRE(DrawKey::Material(key) == 70);
+    REQUIRE(DrawKey::Mesh(key) == 9);
+    REQUIRE(DrawKey::Depth(key) == 12345);
+
+    // Each field outranks everything below it, whatever those hold.
+    REQUIRE(DrawKey::Make(1, 0, 0, 0) > DrawKey::Make(0, 0xFFFF, 0xFFFF, 0xFFFFF));
+    REQUIRE(DrawKey::Make(0, 1, 0, 0) > DrawKey::Make(0, 0, 0xFFFF, 0xFFFFF));
+    REQUIRE(DrawKey::Make(0, 0, 1, 0) > DrawKey::Make(0, 0, 0, 0xFFFFF));
+
+    // Out-of-range ids clamp rather than spill into the next field.
+    const std::uint64_t big = DrawKey::Make(0, 0x12345, 0, ~0u);
+    REQUIRE(DrawKey::Shader(big) == 0);
+    REQUIRE(DrawKey::Material(big) == 0xFFFF);
+    REQUIRE(DrawKey::Mesh(big) == 0);
+    REQUIRE(DrawKey::Depth(big) == 0xFFFFF);
+}
+
+TEST_CASE("RenderQueue sorts by state, then front to back, stably", "[render][queue]") {
+    std::mt19937 rng(22);
+    std::uniform_real_distribution<float> coord(-40.0f, 40.0f);
+    std::vector<UnitCube> meshes(7);
+    std::vector<PBRMaterial> materials(5);
+
+    RenderQueue queue;
+    // Looking down -z from the origin; a second frame reuses the queue.
+    for (int frame = 0; frame < 2; ++frame) {
+        queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -2.0f), 0.1f, 100.0f);
+        for (Entity e = 0; e < 3000; ++e) {
+            UnitCube* mesh = &meshes[rng() % meshes.size()];
+            // A few items bring their own state.
+            const PBRMaterial* material = rng() % 8 == 0 ? nullptr : &materials[rng() % materials.size()];
+            queue.Add(mesh, material, At({coord(rng), coord(rng), -1.0f - std::abs(coord(rng))}), kPassAll, e);
+        }
+        queue.Sort();
+        REQUIRE(queue.Size() == 3000);
+
+        // Same order as a stable comparison sort on the keys.
+        std::vector<std::uint32_t> expected(queue.Size());
+        for (std::uint32_t i = 0; i < expected.size(); ++i) expected[i] = i;
+        std::stable_sort(expected.begin(), expected.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return queue.Items()[a].key < queue.Items()[b].key;
+        });
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            REQUIRE(queue.Sorted(i).entity == queue.Items()[expected[i]].entity);
+        }
+
+        // Within one material and mesh, nearer draws come first.
+        for (std::size_t i = 1; i < queue.Size(); ++i) {
+            const DrawItem& a = queue.Sorted(i - 1);
+            const DrawItem& b = queue.Sorted(i);
+            if (a.material != b.material || a.renderable != b.renderable) continue;
+            const float za = -queue.Transforms()[a.transform][3].z;
+            const float zb = -queue.Transforms()[b.transform][3].z;
+            REQUIRE(za <= zb + 1e-3f);
+        }
+    }
+}
+
+TEST_CASE("RenderQueue submits filtered passes with one bind per material run", "[render][queue]") {
+    UnitCube cube, sphere;
+    PBRMaterial stone, metal;
+
+    RenderQueue queue;
+    queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 0.1f, 100.0f);
+    queue.Add(&cube, &stone, At({0, 0, -30}), kPassAll, 1);
+    queue.Add(&sphere, &metal, At({0, 0, -5}), kPassAll, 2);
+    queue.Add(&cube, &stone, At({0, 0, -10}), kPassAll, 3);
+    queue.Add(&sphere, &stone, At({0, 0, -20}), kPassMain, 4); // casts no shadow
+    queue.Add(&cube, nullptr, At({0, 0, -1}), kPassAll, 5);
+    queue.Add(&cube, nullptr, At({0, 0, -2}), kPassAll, 6);
+    queue.Sort();
+
+    SECTION("main pass") {
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(kPassMain, sink, true);
+        REQUIRE(stats.draws == 6);
+        // Own-state items bind each; stone's three draws and metal's one
+        // bind once per run.
+        REQUIRE(stats.materialBinds == 4);
+        REQUIRE(sink.Binds() == 4);
+
+        std::vector<Entity> order;
+        for (const auto& call : sink.calls) {
+            if (!call.bind) order.push_back(call.entity);
+        }
+        REQUIRE(order == std::vector<Entity>{5, 6, 3, 1, 4, 2});
+        // The world matrix travels with its item.
+        REQUIRE(sink.calls.back().origin == glm::vec3(0, 0, -5));
+    }
+
+    SECTION("shadow pass") {
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(kPassShadow, sink, false);
+        REQUIRE(stats.draws == 5);
+        REQUIRE(stats.materialBinds == 0);
+        REQUIRE(sink.Binds() == 0);
+        for (const auto& call : sink.calls) REQUIRE(call.entity != 4);
+    }
+
+    SECTION("next frame starts empty") {
+        queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 0.1f, 100.0f);
+        queue.Sort();
+        RecordingSink sink;
+        REQUIRE(queue.Submit(kPassAll, sink, true).draws == 0);
+        REQUIRE(queue.Empty());
+    }
+}
+
+TEST_CASE("RenderQueue folds runs of one mesh and material into instanced batches", "[render][queue]") {
+    UnitCube rock, tree, statue;
+    statue.instancing = false;
+    PBRMaterial stone, bark;
+
+    RenderQueue queue;
+    queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 0.1f, 100.0f);
+    Entity next = 0;
+    for (int i = 0; i < 5; ++i) queue.Add(&rock, &stone, At({float(i), 0, -10.0f - i}), kPassAll, next++);
+    for (int i = 0; i < 3; ++i) queue.Add(&tree, &bark, At({0, float(i), -20.0f - i}), kPassAll, next++);
+    // Same mesh, other material: its own run.
+    queue.Add(&rock, &bark, At({0, 0, -30}), kPassAll, next++);
+    // Can't instance; drawn one by one whatever the run length.
+    for (int i = 0; i < 3; ++i) queue.Add(&statue, &stone, At({0, 0, -40.0f - i}), kPassAll, next++);
+    // Two rocks that stay out of the shadows.
+    for (int i = 0; i < 2; ++i) queue.Add(&rock, &stone, At({0, 5, -50.0f - i}), kPassMain, next++);
+    queue.Sort();
+
+    SECTION("main pass") {
+        DrawList list;
+        queue.BuildDrawList(kPassMain, 2, list);
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(list, sink, true);
+
+        // rock+stone x7, statue x3 (single), tree+bark x3, rock+bark x1.
+        REQUIRE(stats.instanceGroups == 2);
+        REQUIRE(stats.instances == 10);
+        REQUIRE(stats.draws == 2 + 3 + 1);
+        REQUIRE(stats.materialBinds == 2); // stone's run, then bark's
+        REQUIRE(list.instances.size() == 10);
+
+        // Every instanced batch's matrices are its run's, nearest first.
+        std::size_t covered = 0;
+        for (const DrawBatch& batch : list.batches) {
+            if (!batch.instanced) {
+                ++covered;
+                continue;
+            }
+            const DrawItem& first = queue.Items()[batch.item];
+            for (std::uint32_t i = 0; i < batch.count; ++i) {
+                const DrawItem& member = queue.Items()[list.items[covered + i]];
+                REQUIRE(member.renderable == first.renderable);
+                REQUIRE(member.material == first.material);
+                REQUIRE(list.instances[batch.firstInstance + i] == queue.Transforms()[member.transform]);
+                if (i > 0) REQUIRE(list.instances[batch.firstInstance + i][3].z <=
+                                   list.instances[batch.firstInstance + i - 1][3].z);
+            }
+            covered += batch.count;
+        }
+        REQUIRE(covered == queue.Size());
+    }
+
+    SECTION("shadow pass reuses one list per cascade") {
+        DrawList list;
+        queue.BuildDrawList(kPassShadow, 2, list);
+        REQUIRE(list.items.size() == queue.Size() - 2);
+        for (int cascade = 0; cascade < 4; ++cascade) {
+            RecordingSink sink;
+            const SubmitStats stats = queue.Submit(list, sink, false);
+            REQUIRE(stats.instances == 8);
+            REQUIRE(stats.materialBinds == 0);
+            REQUIRE(stats.draws == 2 + 3 + 1);
+        }
+    }
+
+    SECTION("grouping off or above the run length") {
+        DrawList list;
+        queue.BuildDrawList(kPassMain, 0, list);
+        REQUIRE(list.instances.empty());
+        REQUIRE(list.batches.size() == queue.Size());
+
+        queue.BuildDrawList(kPassMain, 4, list);
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(list, sink, true);
+        REQUIRE(stats.instanceGroups == 1); // only the seven rocks
+        REQUIRE(stats.instances == 7);
+        REQUIRE(stats.draws == 1 + 3 + 3 + 1);
+    }
+}
+
+TEST_CASE("RenderQueue culls through per-view visibility bitsets", "[render][queue][culling]") {
+    UnitCube cube;
+    PBRMaterial stone;
+
+    struct NoBounds : Renderable {
+        void Draw(Shader&) override {}
+    } skybox;
+
+    RenderQueue queue;
+    queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 0.1f, 100.0f);
+    for (Entity e = 0; e < 4; ++e) queue.Add(&cube, &stone, At({0, 0, -5.0f - e}), kPassAll, e);
+    queue.Add(&cube, &stone, At({0, 0, 50}), kPassAll, 4); // behind the camera
+    queue.Add(&skybox, &stone, At({0, 0, 50}), kPassAll, 5); // no bounds: never culled
+    queue.Sort();
+
+    REQUIRE(queue.Bounds().Size() == queue.Size());
+    REQUIRE(queue.Bounds().Get(0).min == glm::vec3(-0.5f, -0.5f, -5.5f));
+
+    Frustum camera;
+    camera.ExtractFromVP(glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f));
+    VisibilityBitset visible;
+    FrustumCuller::CullFrustum(camera, queue.Bounds(), visible);
+    REQUIRE(visible.Count() == 5);
+    REQUIRE_FALSE(visible.Test(4));
+
+    RecordingSink sink;
+    const SubmitStats stats = queue.Submit(kPassMain, sink, true, &visible);
+    REQUIRE(stats.draws == 5);
+    for (const auto& call : sink.calls) REQUIRE(call.entity != 4);
+
+    DrawList list;
+    queue.BuildDrawList(kPassShadow, 2, list, &visible);
+    REQUIRE(list.items.size() == 5);
+    REQUIRE(list.instances.size() == 4); // the visible cubes
+}
+
+TEST_CASE("RenderQueue builds multi-draw indirect commands per material bucket", "[render][queue]") {
+    UnitCube rock, tree, legacy;
+    rock.range = GeometryRange{0, 24, 0, 36};
+    tree.range = GeometryRange{24, 100, 36, 300};
+    PBRMaterial stone, bark;
+
+    RenderQueue queue;
+    queue.Begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 0.1f, 100.0f);
+    Entity next = 0;
+    for (int i = 0; i < 4; ++i) queue.Add(&rock, &stone, At({float(i), 0, -10.0f - i}), kPassAll, next++);
+    for (int i = 0; i < 2; ++i) queue.Add(&tree, &stone, At({0, float(i), -20.0f - i}), kPassAll, next++);
+    for (int i = 0; i < 3; ++i) queue.Add(&tree, &bark, At({0, 0, -30.0f - i}), kPassAll, next++);
+    // Outside the pool: drawn on its own, between the buckets.
+    queue.Add(&legacy, &bark, At({0, 0, -40}), kPassAll, next++);
+    queue.Add(&rock, &bark, At({0, 0, -50}), kPassMain, next++);
+    queue.Sort();
+
+    SECTION("main pass: one multi-draw per material") {
+        IndirectList list;
+        queue.BuildIndirectList(kPassMain, true, list);
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(list, sink, true);
+
+        REQUIRE(list.drawData.size() == queue.Size() - 1);
+        REQUIRE(stats.materialBinds == 2);
+        REQUIRE(stats.indirectCommands == list.commands.size());
+        REQUIRE(stats.instances == 4 + 2 + 3);
+        REQUIRE(stats.draws == list.batches.size());
+
+        // Every command draws its renderable's range, and each of its
+        // instances reads the matrix of an item of that renderable.
+        std::size_t drawn = 0;
+        for (const DrawElementsIndirectCommand& command : list.commands) {
+            const bool isRock = command.firstIndex == rock.range.firstIndex;
+            const GeometryRange& range = isRock ? rock.range : tree.range;
+            REQUIRE(command.count == range.indexCount);
+            REQUIRE(command.baseVertex == std::int32_t(range.baseVertex));
+            REQUIRE(command.baseInstance == drawn);
+            drawn += command.instanceCount;
+        }
+        REQUIRE(drawn == list.drawData.size());
+
+        std::size_t singles = 0;
+        for (const IndirectBatch& batch : list.batches) {
+            const DrawItem& first = queue.Items()[batch.item];
+            if (!batch.indirect) {
+                REQUIRE(first.renderable == &legacy);
+                ++singles;
+                continue;
+            }
+            REQUIRE(batch.commandCount > 0);
+            // Within a batch, instances keep the bucket's material.
+            for (std::uint32_t c = batch.firstCommand; c < batch.firstCommand + batch.commandCount; ++c) {
+                const DrawElementsIndirectCommand& command = list.commands[c];
+                for (std::uint32_t i = 0; i < command.instanceCount; ++i) {
+                    const glm::mat4& world = list.drawData[command.baseInstance + i];
+                    const auto match = std::find_if(queue.Items().begin(), queue.Items().end(), [&](const DrawItem& it) {
+                        return queue.Transforms()[it.transform] == world;
+                    });
+                    REQUIRE(match != queue.Items().end());
+                    REQUIRE(match->material == first.material);
+                }
+            }
+        }
+        REQUIRE(singles == 1);
+
+        const auto multiDraws = std::count_if(sink.calls.begin(), sink.calls.end(),
+                                              [](const RecordingSink::Call& c) { return c.indirect; });
+        REQUIRE(multiDraws == 2);
+    }
+
+    SECTION("depth pass ignores materials") {
+        IndirectList list;
+        queue.BuildIndirectList(kPassShadow, false, list);
+        RecordingSink sink;
+        const SubmitStats stats = queue.Submit(list, sink, false);
+        REQUIRE(stats.materialBinds == 0);
+        REQUIRE(list.drawData.size() == queue.Size() - 2);
+        // One multi-draw for every pooled item, whatever its material;
+        // the trees' two runs merge into one command. Then the legacy item.
+        REQUIRE(stats.draws == 2);
+        REQUIRE(list.commands.size() == 2);
+        REQUIRE(list.commands[1].instanceCount == 5);
+        REQUIRE(sink.calls.size() == 2);
+        REQUIRE_FALSE(sink.calls.back().indirect);
+    }
+
+    SECTION("culled items never become commands") {
+        VisibilityBitset visible;
+        visible.Reset(queue.Size());
+        visible.Set(0);
+        visible.Set(1);
+        IndirectList list;
+        queue.BuildIndirectList(kPassMain, true, list, &visible);
+        REQUIRE(list.commands.size() == 1);
+        REQUIRE(list.commands[0].instanceCount == 2);
+        REQUIRE(list.drawData.size() == 2);
+    }
+}
@@ -16,9 +16,9 @@ namespace {
 class MockDevice : public Mist::GPU::RenderingDevice {
 public:
     // Every Create* returns a unique RID that Destroy later removes. A
-    // monotonically-increasing counter mirrors GLRenderingDevice's
-    // `m_NextId` so the uniqueness guarantee is part of the contract,
-    // not just an implementation accident.
+    // plain counter is enough here; GLRenderingDevice gets the same
+    // guarantee from SlotMap generations, so uniqueness is part of the
+    // contract, not just an implementation accident.
     RID CreateTexture(const Mist::GPU::TextureDesc&)           override { return alloc(); }
     RID CreateTextureArray(const Mist::GPU::TextureArrayDesc&) override { return alloc(); }
     RID CreateBuffer(const Mist::GPU::BufferDesc&)             override { return alloc(); }
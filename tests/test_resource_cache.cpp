@@ -3,6 +3,7 @@
 #include "Resources/ResourceHandle.h"
 #include "Resources/ResourceManager.h"
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <memory>
@@ -44,13 +45,24 @@ TEST_CASE("ResourceManager returns nullptr for missing loader", "[resource]") {
     REQUIRE_FALSE(h.IsValid());
 }
 
-TEST_CASE("ResourceManager::LoadAsync runs concurrently", "[resource][async]") {
-    // 10 parallel loads against a loader that sleeps 20ms each. If the
-    // scheduler really ran them sequentially we'd need ~200ms; in parallel
-    // it should be ~20-40ms. Generous bound so slow CI doesn't flake.
+TEST_CASE("ResourceManager::LoadAsync runs concurrently on a bounded pool", "[resource][async]") {
+    // 10 parallel loads against a loader that sleeps 20ms each, on a
+    // 4-worker job system. Sequentially that's ~200ms; on the pool it's
+    // three waves, ~60ms. Generous bound so slow CI doesn't flake. No more
+    // than 4 loaders may ever be in flight — the old thread-per-request
+    // LoadAsync would have run all 10 at once.
+    Mist::JobSystem jobs(4);
     ResourceManager<FakeAsset> mgr;
-    mgr.SetLoader([](const std::string& path) {
+    mgr.SetJobSystem(&jobs);
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    mgr.SetLoader([&](const std::string& path) {
+        const int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --active;
         return std::make_shared<FakeAsset>(FakeAsset{0, path});
     });
 
@@ -66,6 +78,7 @@ TEST_CASE("ResourceManager::LoadAsync runs concurrently", "[resource][async]") {
     const auto elapsed = std::chrono::steady_clock::now() - t0;
     const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
     REQUIRE(ms < 150); // single-threaded would be ~200ms
+    REQUIRE(peak.load() <= 4);
     REQUIRE(mgr.Count() == 10);
 }
 
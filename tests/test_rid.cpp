@@ -17,8 +17,8 @@ TEST_CASE("RID equality + hash", "[rid]") {
     REQUIRE(a == b);
     REQUIRE(a != c);
 
-    // Hashable for unordered_set / map use — GLRenderingDevice leans on
-    // this to track live resources.
+    // Hashable for unordered_set / map use — callers key per-resource
+    // caches on RIDs.
     std::unordered_set<RID> s;
     s.insert(a);
     s.insert(c);
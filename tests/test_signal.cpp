@@ -2,7 +2,9 @@
 
 #include "Core/Signal.h"
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 TEST_CASE("Signal fires registered callbacks in order", "[signal]") {
@@ -64,3 +66,24 @@ TEST_CASE("Signal with typed args carries values correctly", "[signal]") {
     REQUIRE(lastMsg == "hello");
     REQUIRE(lastN == 42);
 }
+
+TEST_CASE("Signal Emit runs alongside Connect/Disconnect on other threads", "[signal]") {
+    Mist::Signal<int> sig;
+    std::atomic<int> total{0};
+    sig.Connect([&](int x) { total.fetch_add(x, std::memory_order_relaxed); });
+
+    std::atomic<bool> done{false};
+    std::thread churn([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            auto id = sig.Connect([](int) {});
+            sig.Disconnect(id);
+        }
+    });
+    for (int i = 0; i < 20000; ++i) sig.Emit(1);
+    done = true;
+    churn.join();
+
+    // The permanent slot saw every emit; the churned ones came and went.
+    REQUIRE(total.load() == 20000);
+    REQUIRE(sig.ConnectionCount() == 1);
+}
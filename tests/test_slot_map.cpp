@@ -0,0 +1,95 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/SlotMap.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+TEST_CASE("SlotMap resolves keys until they are erased", "[containers][slot_map]") {
+    Mist::SlotMap<std::string> map;
+    const Mist::SlotMapKey a = map.Insert("a");
+    const Mist::SlotMapKey b = map.Insert("b");
+
+    REQUIRE(a.IsValid());
+    REQUIRE(a != b);
+    REQUIRE(*map.Get(a) == "a");
+    REQUIRE(*map.Get(b) == "b");
+    REQUIRE(map.Get(Mist::SlotMapKey{}) == nullptr);
+
+    REQUIRE(map.Erase(a));
+    REQUIRE_FALSE(map.Erase(a));
+    REQUIRE(map.Get(a) == nullptr);
+    REQUIRE(*map.Get(b) == "b"); // moved into a's value slot, key still valid
+    REQUIRE(map.Size() == 1);
+}
+
+TEST_CASE("SlotMap reuses slots with a new generation", "[containers][slot_map]") {
+    Mist::SlotMap<int> map;
+    const Mist::SlotMapKey old = map.Insert(1);
+    map.Erase(old);
+    const Mist::SlotMapKey reused = map.Insert(2);
+
+    REQUIRE(reused.index == old.index);
+    REQUIRE(reused.generation != old.generation);
+    REQUIRE(map.Get(old) == nullptr);
+    REQUIRE(*map.Get(reused) == 2);
+}
+
+TEST_CASE("SlotMap keys round-trip through Pack", "[containers][slot_map]") {
+    Mist::SlotMap<int> map;
+    for (int i = 0; i < 10; ++i) map.Insert(i);
+    const Mist::SlotMapKey key = map.Insert(99);
+
+    REQUIRE(key.Pack() != 0);
+    REQUIRE(Mist::SlotMapKey::Unpack(key.Pack()) == key);
+    REQUIRE(*map.Get(Mist::SlotMapKey::Unpack(key.Pack())) == 99);
+}
+
+TEST_CASE("SlotMap keeps values packed and KeyAt in sync", "[containers][slot_map]") {
+    Mist::SlotMap<int> map;
+    std::vector<Mist::SlotMapKey> keys;
+    for (int i = 0; i < 100; ++i) keys.push_back(map.Insert(i));
+    for (int i = 0; i < 100; i += 3) map.Erase(keys[i]);
+
+    REQUIRE(map.Size() == 66);
+    std::vector<int> values(map.begin(), map.end());
+    std::sort(values.begin(), values.end());
+    for (int v : values) REQUIRE(v % 3 != 0);
+
+    for (std::size_t i = 0; i < map.Size(); ++i) {
+        REQUIRE(map.Get(map.KeyAt(i)) == map.Data() + i);
+    }
+}
+
+TEST_CASE("SlotMap Clear invalidates every key", "[containers][slot_map]") {
+    Mist::SlotMap<int> map;
+    std::vector<Mist::SlotMapKey> keys;
+    for (int i = 0; i < 8; ++i) keys.push_back(map.Insert(i));
+    map.Clear();
+
+    REQUIRE(map.Empty());
+    for (const auto& key : keys) REQUIRE_FALSE(map.Contains(key));
+
+    const Mist::SlotMapKey fresh = map.Insert(42);
+    REQUIRE(*map.Get(fresh) == 42);
+    REQUIRE(std::find(keys.begin(), keys.end(), fresh) == keys.end());
+}
+
+TEST_CASE("SlotMap misses keys that match a free slot's generation", "[containers][slot_map]") {
+    Mist::SlotMap<int> map;
+    std::vector<Mist::SlotMapKey> keys;
+    for (int i = 0; i < 4; ++i) keys.push_back(map.Insert(i));
+    map.Erase(keys[1]);
+    map.Erase(keys[3]);
+
+    // Slot 1's free-list link points past the two remaining values; a key
+    // carrying its current generation must miss, not index with it.
+    for (std::uint32_t generation = 0; generation < 8; ++generation) {
+        const Mist::SlotMapKey forged{keys[1].index, generation};
+        REQUIRE(map.Get(forged) == nullptr);
+        REQUIRE_FALSE(map.Contains(forged));
+        REQUIRE_FALSE(map.Erase(forged));
+    }
+    REQUIRE(map.Size() == 2);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_all.hpp>
+
+#include "Core/SmallVector.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Tracked {
+    static inline int live = 0;
+    int value = 0;
+
+    Tracked(int v = 0) : value(v) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+    ~Tracked() { --live; }
+
+    bool operator==(const Tracked& other) const { return value == other.value; }
+};
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    std::shared_ptr<std::size_t> allocations = std::make_shared<std::size_t>(0);
+
+    CountingAllocator() = default;
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : allocations(other.allocations) {}
+
+    T* allocate(std::size_t n) {
+        ++*allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return allocations == other.allocations; }
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const { return allocations != other.allocations; }
+};
+
+} // namespace
+
+TEST_CASE("SmallVector stays inline up to N and spills past it", "[containers][small_vector]") {
+    CountingAllocator<int> alloc;
+    Mist::SmallVector<int, 4, CountingAllocator<int>> v(alloc);
+
+    for (int i = 0; i < 4; ++i) v.push_back(i);
+    REQUIRE(v.is_inline());
+    REQUIRE(*alloc.allocations == 0);
+
+    v.push_back(4);
+    REQUIRE_FALSE(v.is_inline());
+    REQUIRE(*alloc.allocations == 1);
+    REQUIRE(v == Mist::SmallVector<int, 4, CountingAllocator<int>>{0, 1, 2, 3, 4});
+
+    // clear() keeps the heap buffer.
+    v.clear();
+    REQUIRE(v.capacity() >= 5);
+    REQUIRE_FALSE(v.is_inline());
+}
+
+TEST_CASE("SmallVector insert, erase and resize", "[containers][small_vector]") {
+    Mist::SmallVector<std::string, 2> v{"b", "d"};
+    v.insert(v.begin(), "a");
+    v.insert(v.begin() + 2, "c");
+    v.insert(v.end(), "e");
+    REQUIRE(std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+    v.erase(v.begin() + 1);
+    v.erase(v.begin() + 2, v.end());
+    REQUIRE(std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"a", "c"});
+
+    v.resize(4, "z");
+    REQUIRE(v.size() == 4);
+    REQUIRE(v.back() == "z");
+    v.resize(1);
+    REQUIRE(v.size() == 1);
+    REQUIRE(v.front() == "a");
+}
+
+TEST_CASE("SmallVector push_back of its own element survives the spill", "[containers][small_vector]") {
+    Mist::SmallVector<std::string, 2> v{"first", "second"};
+    v.push_back(v[0]);
+    v.emplace_back(v[1]);
+    REQUIRE(v.size() == 4);
+    REQUIRE(v[2] == "first");
+    REQUIRE(v[3] == "second");
+}
+
+TEST_CASE("SmallVector copy and move for inline and heap storage", "[containers][small_vector]") {
+    REQUIRE(Tracked::live == 0);
+    {
+        Mist::SmallVector<Tracked, 4> small{1, 2};
+        Mist::SmallVector<Tracked, 4> large{1, 2, 3, 4, 5, 6};
+
+        Mist::SmallVector<Tracked, 4> smallCopy = small;
+        Mist::SmallVector<Tracked, 4> largeCopy = large;
+        REQUIRE(smallCopy == small);
+        REQUIRE(largeCopy == large);
+
+        const Tracked* heap = large.data();
+        Mist::SmallVector<Tracked, 4> largeMoved = std::move(large);
+        REQUIRE(largeMoved.data() == heap); // buffer stolen, not copied
+        REQUIRE(large.empty());
+        REQUIRE(large.is_inline());
+
+        Mist::SmallVector<Tracked, 4> smallMoved = std::move(small);
+        REQUIRE(smallMoved.is_inline());
+        REQUIRE(smallMoved.size() == 2);
+        REQUIRE(small.empty());
+
+        smallMoved = largeCopy;
+        REQUIRE(smallMoved.size() == 6);
+        largeCopy = std::move(smallCopy);
+        REQUIRE(largeCopy.size() == 2);
+        REQUIRE(largeCopy.is_inline());
+
+        REQUIRE(Tracked::live == 6 + 6 + 2); // largeMoved, smallMoved, largeCopy
+    }
+    REQUIRE(Tracked::live == 0);
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_all.hpp>
+
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/TransformComponent.h"
+#include "ECS/Coordinator.h"
+#include "ECS/Systems/SpatialHashSystem.h"
+#include "Scene/SpatialHashGrid.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Reference answers: a scan over every point.
+struct BruteForce {
+    std::unordered_map<Entity, glm::vec3> points;
+
+    std::vector<Entity> InRadius(const glm::vec3& c, float r) const {
+        std::vector<Entity> out;
+        for (const auto& [e, p] : points) {
+            const glm::vec3 d = p - c;
+            if (glm::dot(d, d) <= r * r) out.push_back(e);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    std::vector<Entity> InBox(const AABB& box) const {
+        std::vector<Entity> out;
+        for (const auto& [e, p] : points) {
+            if (box.Contains(AABB{p, p})) out.push_back(e);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+};
+
+std::vector<Entity> Sorted(EntitySpan span) {
+    std::vector<Entity> out(span.begin(), span.end());
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("SpatialHashGrid queries match brute force under random edits", "[spatial][hash_grid]") {
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> coord(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> step(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> radius(0.0f, 20.0f);
+
+    SpatialHashGrid grid(5.0f);
+    BruteForce ref;
+    std::vector<Entity> live;
+    Entity next = 0;
+    auto randomPoint = [&]() { return glm::vec3(coord(rng), coord(rng), coord(rng)); };
+
+    for (int i = 0; i < 2000; ++i) {
+        const glm::vec3 p = randomPoint();
+        grid.Insert(next, p);
+        ref.points[next] = p;
+        live.push_back(next++);
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 400; ++i) {
+            const Entity e = live[rng() % live.size()];
+            const glm::vec3 p = ref.points[e] + glm::vec3(step(rng), step(rng), step(rng));
+            grid.Move(e, p);
+            ref.points[e] = p;
+        }
+        for (int i = 0; i < 50; ++i) {
+            const std::size_t at = rng() % live.size();
+            REQUIRE(grid.Remove(live[at]));
+            ref.points.erase(live[at]);
+            live[at] = live.back();
+            live.pop_back();
+        }
+        for (int i = 0; i < 50; ++i) {
+            const glm::vec3 p = randomPoint();
+            grid.Insert(next, p);
+            ref.points[next] = p;
+            live.push_back(next++);
+        }
+        // Halfway through, re-bucket everything.
+        if (round == 10) grid.SetCellSize(2.5f);
+        REQUIRE(grid.Size() == ref.points.size());
+
+        for (int q = 0; q < 10; ++q) {
+            const glm::vec3 c = randomPoint();
+            const float r = q == 0 ? 500.0f : radius(rng); // q == 0: covers every cell
+            REQUIRE(Sorted(grid.QueryRadius(c, r)) == ref.InRadius(c, r));
+
+            const glm::vec3 h(radius(rng), radius(rng), radius(rng));
+            const AABB box{c - h, c + h};
+            REQUIRE(Sorted(grid.QueryBox(box)) == ref.InBox(box));
+        }
+    }
+
+    // Every member's position round-trips.
+    for (Entity e : live) REQUIRE(grid.GetPosition(e) == ref.points[e]);
+}
+
+TEST_CASE("SpatialHashGrid moves, boundaries and cell recycling", "[spatial][hash_grid]") {
+    SpatialHashGrid grid(1.0f);
+    grid.Insert(1, {0.5f, 0.5f, 0.5f});
+    grid.Insert(2, {-0.5f, 0.5f, 0.5f});
+    REQUIRE(grid.CellCount() == 2);
+
+    // Within a cell: a position write. Across: a migration.
+    REQUIRE_FALSE(grid.Move(1, {0.9f, 0.1f, 0.5f}));
+    REQUIRE(grid.Move(1, {1.1f, 0.1f, 0.5f}));
+    REQUIRE(grid.CellCount() == 2); // the cell it left emptied and went back
+
+    // Boundaries are inclusive.
+    REQUIRE(grid.QueryRadius({1.1f, 0.1f, 1.5f}, 1.0f).size() == 1);
+    REQUIRE(grid.QueryBox(AABB{{-0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}}).size() == 1);
+    REQUIRE(grid.QueryRadius({0, 0, 0}, -1.0f).empty());
+
+    // A stale handle sharing an index is replaced, not duplicated.
+    const Entity reused = MakeEntity(EntityIndex(2), EntityGeneration(2) + 1);
+    grid.Insert(reused, {5, 5, 5});
+    REQUIRE(grid.Size() == 2);
+    REQUIRE_FALSE(grid.Contains(2));
+    REQUIRE_FALSE(grid.Remove(2));
+    REQUIRE(grid.QueryRadius({5, 5, 5}, 0.1f)[0] == reused);
+
+    // Far-out and non-finite positions land on the border cells instead of
+    // wrapping, and are still answered exactly.
+    grid.Insert(3, {1.0e9f, 0, 0});
+    grid.Insert(4, {std::nanf(""), 0, 0});
+    REQUIRE(grid.QueryRadius({1.0e9f, 0, 0}, 1.0f).size() == 1);
+    REQUIRE(grid.QueryRadius({0.5f, 0.5f, 0.5f}, 2.0f).size() == 1);
+    REQUIRE(grid.Remove(4));
+
+    grid.Clear();
+    REQUIRE(grid.Empty());
+    REQUIRE(grid.CellCount() == 0);
+}
+
+TEST_CASE("SpatialHashSystem tracks world positions of transforms", "[spatial][hash_grid]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TransformComponent>();
+    coord.RegisterComponent<HierarchyComponent>();
+    auto sys = coord.RegisterSystem<SpatialHashSystem>();
+    Signature sig;
+    sig.set(coord.GetComponentType<TransformComponent>());
+    coord.SetSystemSignature<SpatialHashSystem>(sig);
+    sys->SetCellSize(2.0f);
+
+    auto spawn = [&](glm::vec3 pos) {
+        Entity e = coord.CreateEntity();
+        TransformComponent t;
+        t.position = pos;
+        coord.AddComponent(e, t);
+        return e;
+    };
+    const Entity a = spawn({0, 0, 0});
+    const Entity b = spawn({3, 0, 0});
+    const Entity c = spawn({30, 0, 0});
+    sys->Update(coord);
+
+    SpatialHashGrid& grid = sys->GetGrid();
+    REQUIRE(grid.Size() == 3);
+    REQUIRE(Sorted(grid.QueryRadius({0, 0, 0}, 5.0f)) == std::vector<Entity>{a, b});
+
+    // A stamped move is picked up; an unstamped frame is a no-op.
+    coord.GetComponentMut<TransformComponent>(c).SetPosition({1, 1, 0});
+    sys->Update(coord);
+    REQUIRE(Sorted(grid.QueryRadius({0, 0, 0}, 2.0f)) == std::vector<Entity>{a, c});
+    sys->Update(coord);
+    REQUIRE(grid.GetPosition(c) == glm::vec3(1, 1, 0));
+
+    // Hierarchy members are indexed at their cached world position.
+    coord.AddComponent(b, HierarchyComponent{});
+    coord.GetComponentMut<TransformComponent>(b).cachedGlobal[3] = glm::vec4(-20, 0, 0, 1);
+    sys->Update(coord);
+    REQUIRE(grid.GetPosition(b) == glm::vec3(-20, 0, 0));
+
+    coord.DestroyEntity(a);
+    sys->Update(coord);
+    REQUIRE(grid.Size() == 2);
+    REQUIRE_FALSE(grid.Contains(a));
+}
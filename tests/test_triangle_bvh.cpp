@@ -0,0 +1,255 @@
+#include <catch2/catch_all.hpp>
+
+#include "ECS/Components/HierarchyComponent.h"
+#include "ECS/Components/RenderComponent.h"
+#include "ECS/Components/TransformComponent.h"
+#include "ECS/Coordinator.h"
+#include "ECS/Systems/SpatialIndexSystem.h"
+#include "Scene/TriangleBVH.h"
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Soup {
+    std::vector<glm::vec3> positions;
+    std::vector<std::uint32_t> indices;
+};
+
+// Reference: every triangle, by plane intersection and an inside test on
+// the barycentrics — a different route from the BVH's Möller–Trumbore.
+float BruteClosest(const Soup& soup, const glm::vec3& o, const glm::vec3& d, float maxT, std::uint32_t& tri) {
+    float best = -1.0f;
+    for (std::size_t i = 0; i + 2 < soup.indices.size(); i += 3) {
+        const glm::vec3 a = soup.positions[soup.indices[i]];
+        const glm::vec3 b = soup.positions[soup.indices[i + 1]];
+        const glm::vec3 c = soup.positions[soup.indices[i + 2]];
+        const glm::vec3 n = glm::cross(b - a, c - a);
+        const float denom = glm::dot(n, d);
+        if (denom == 0.0f) continue;
+        const float t = glm::dot(n, a - o) / denom;
+        if (t < 0.0f || t > maxT || (best >= 0.0f && t >= best)) continue;
+        const glm::vec3 p = o + d * t;
+        const float nn = glm::dot(n, n);
+        const float wa = glm::dot(n, glm::cross(c - b, p - b)) / nn;
+        const float wb = glm::dot(n, glm::cross(a - c, p - c)) / nn;
+        const float wc = 1.0f - wa - wb;
+        if (wa < 0.0f || wb < 0.0f || wc < 0.0f) continue;
+        best = t;
+        tri = static_cast<std::uint32_t>(i / 3);
+    }
+    return best;
+}
+
+Soup RandomSoup(std::mt19937& rng, std::size_t count) {
+    std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> edge(-3.0f, 3.0f);
+    Soup soup;
+    for (std::size_t i = 0; i < count; ++i) {
+        const glm::vec3 a(coord(rng), coord(rng), coord(rng));
+        soup.positions.push_back(a);
+        soup.positions.push_back(a + glm::vec3(edge(rng), edge(rng), edge(rng)));
+        soup.positions.push_back(a + glm::vec3(edge(rng), edge(rng), edge(rng)));
+        for (std::uint32_t k = 0; k < 3; ++k) soup.indices.push_back(static_cast<std::uint32_t>(3 * i + k));
+    }
+    return soup;
+}
+
+// (n x n) quads on the XZ plane with a bumpy height, two triangles each.
+Soup Terrain(int n, float cell) {
+    Soup soup;
+    for (int z = 0; z <= n; ++z) {
+        for (int x = 0; x <= n; ++x) {
+            soup.positions.emplace_back(x * cell, std::sin(x * 0.3f) * std::cos(z * 0.2f), z * cell);
+        }
+    }
+    for (int z = 0; z < n; ++z) {
+        for (int x = 0; x < n; ++x) {
+            const auto i = static_cast<std::uint32_t>(z * (n + 1) + x);
+            const auto row = static_cast<std::uint32_t>(n + 1);
+            soup.indices.insert(soup.indices.end(), {i, i + row, i + 1, i + 1, i + row, i + row + 1});
+        }
+    }
+    return soup;
+}
+
+} // namespace
+
+TEST_CASE("TriangleBVH closest hits match brute force", "[spatial][bvh]") {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> coord(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const Soup soup = RandomSoup(rng, 3000);
+
+    TriangleBVH bvh;
+    bvh.Build(soup.positions, soup.indices);
+    REQUIRE(bvh.TriangleCount() == 3000);
+    REQUIRE(bvh.Validate());
+
+    std::vector<TriangleBVH::Ray> rays;
+    for (int i = 0; i < 400; ++i) {
+        glm::vec3 dir(unit(rng), unit(rng), unit(rng));
+        if (i % 50 == 0) dir = glm::vec3(0.0f, 0.0f, 1.0f); // two axes still
+        rays.push_back({glm::vec3(coord(rng), coord(rng), coord(rng)), dir, i % 3 == 0 ? 40.0f : 1000.0f});
+    }
+
+    std::size_t expectedHits = 0;
+    for (const TriangleBVH::Ray& ray : rays) {
+        std::uint32_t refTri = TriangleBVH::kNoTriangle;
+        const float ref = BruteClosest(soup, ray.origin, ray.direction, ray.maxDistance, refTri);
+        TriangleBVH::Hit hit;
+        REQUIRE(bvh.Intersect(ray.origin, ray.direction, ray.maxDistance, hit) == (ref >= 0.0f));
+        if (ref < 0.0f) continue;
+        ++expectedHits;
+        REQUIRE(hit.distance == Catch::Approx(ref).margin(1e-4));
+        // The reported triangle and barycentrics land on the hit point.
+        const glm::vec3 a = soup.positions[soup.indices[3 * hit.triangle]];
+        const glm::vec3 b = soup.positions[soup.indices[3 * hit.triangle + 1]];
+        const glm::vec3 c = soup.positions[soup.indices[3 * hit.triangle + 2]];
+        const glm::vec3 onTriangle = a + (b - a) * hit.u + (c - a) * hit.v;
+        REQUIRE(glm::length(onTriangle - (ray.origin + ray.direction * hit.distance)) < 1e-3f);
+    }
+    REQUIRE(expectedHits > 20);
+
+    std::vector<TriangleBVH::Hit> hits(rays.size());
+    REQUIRE(bvh.IntersectBatch(rays.data(), rays.size(), hits.data()) == expectedHits);
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        TriangleBVH::Hit single;
+        if (bvh.Intersect(rays[i].origin, rays[i].direction, rays[i].maxDistance, single)) {
+            REQUIRE(hits[i].triangle == single.triangle);
+        } else {
+            REQUIRE(hits[i].triangle == TriangleBVH::kNoTriangle);
+        }
+    }
+}
+
+TEST_CASE("TriangleBVH input forms and degenerate geometry", "[spatial][bvh]") {
+    const Soup terrain = Terrain(40, 0.5f);
+    TriangleBVH indexed;
+    indexed.Build(terrain.positions, terrain.indices);
+    REQUIRE(indexed.Validate());
+
+    // Straight down onto the terrain: exact height under the ray.
+    TriangleBVH::Hit hit;
+    REQUIRE(indexed.Intersect({3.0f, 10.0f, 5.0f}, {0, -1, 0}, 100.0f, hit));
+    std::uint32_t refTri = 0;
+    REQUIRE(hit.distance == Catch::Approx(BruteClosest(terrain, {3.0f, 10.0f, 5.0f}, {0, -1, 0}, 100.0f, refTri)));
+    REQUIRE_FALSE(indexed.Intersect({3.0f, 10.0f, 5.0f}, {0, 1, 0}, 100.0f, hit));
+    REQUIRE_FALSE(indexed.Intersect({-5.0f, 10.0f, 5.0f}, {0, -1, 0}, 100.0f, hit));
+
+    // Interleaved vertices without indices, as Mesh passes them.
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+    std::vector<Vertex> flat;
+    for (std::uint32_t i : terrain.indices) flat.push_back({terrain.positions[i], glm::vec3(0.0f)});
+    TriangleBVH interleaved;
+    interleaved.Build(&flat[0].position, sizeof(Vertex), flat.size(), nullptr, 0);
+    REQUIRE(interleaved.TriangleCount() == indexed.TriangleCount());
+    REQUIRE(interleaved.Validate());
+    TriangleBVH::Hit other;
+    REQUIRE(interleaved.Intersect({3.0f, 10.0f, 5.0f}, {0, -1, 0}, 100.0f, other));
+    REQUIRE(other.distance == Catch::Approx(hit.distance));
+
+    // Every centroid in one spot: no SAH plane separates them, but leaves
+    // still stay small.
+    Soup stacked;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        stacked.positions.insert(stacked.positions.end(), {{-1, 0, -1}, {1, 0, -1}, {0, 0, 2}});
+        stacked.indices.insert(stacked.indices.end(), {3 * i, 3 * i + 1, 3 * i + 2});
+    }
+    TriangleBVH same;
+    same.Build(stacked.positions, stacked.indices);
+    REQUIRE(same.Validate());
+    REQUIRE(same.Intersect({0, 5, 0}, {0, -1, 0}, 10.0f, hit));
+    REQUIRE(hit.distance == Catch::Approx(5.0f));
+
+    // Indices past the vertex array are dropped, not read.
+    TriangleBVH partial;
+    partial.Build(terrain.positions, {0, 1, 41, 0, 1, 999999});
+    REQUIRE(partial.TriangleCount() == 1);
+    REQUIRE(partial.Validate());
+
+    partial.Clear();
+    REQUIRE(partial.Empty());
+    REQUIRE_FALSE(partial.Intersect({0, 5, 0}, {0, -1, 0}, 10.0f, hit));
+}
+
+namespace {
+
+// A renderable with triangle-exact picking and no GL, standing in for Mesh.
+struct TriangleRenderable : Renderable {
+    TriangleBVH bvh;
+
+    explicit TriangleRenderable(const Soup& soup) {
+        bvh.Build(soup.positions, soup.indices);
+        m_LocalBounds = bvh.Bounds();
+    }
+    void Draw(Shader&) override {}
+    bool RaycastLocal(const glm::vec3& o, const glm::vec3& d, float maxT, float& t) const override {
+        TriangleBVH::Hit hit;
+        if (!bvh.Intersect(o, d, maxT, hit)) return false;
+        t = hit.distance;
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_CASE("SpatialIndexSystem::Raycast picks by triangles, not bounds", "[spatial][bvh]") {
+    Coordinator coord;
+    coord.Init();
+    coord.RegisterComponent<TransformComponent>();
+    coord.RegisterComponent<RenderComponent>();
+    coord.RegisterComponent<HierarchyComponent>();
+    auto sys = coord.RegisterSystem<SpatialIndexSystem>();
+    Signature sig;
+    sig.set(coord.GetComponentType<TransformComponent>());
+    sig.set(coord.GetComponentType<RenderComponent>());
+    coord.SetSystemSignature<SpatialIndexSystem>(sig);
+
+    // One triangle filling the lower-left half of a unit square facing +z:
+    // its bounds cover the whole square.
+    Soup wedge;
+    wedge.positions = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    wedge.indices = {0, 1, 2};
+    TriangleRenderable shape(wedge);
+
+    auto spawn = [&](glm::vec3 pos, glm::vec3 scale) {
+        Entity e = coord.CreateEntity();
+        TransformComponent t;
+        t.SetPosition(pos);
+        t.SetScale(scale);
+        coord.AddComponent(e, t);
+        coord.AddComponent(e, RenderComponent{&shape, true});
+        return e;
+    };
+    const Entity front = spawn({0, 0, 5}, {1, 1, 1});
+    const Entity back = spawn({0, 0, 0}, {2, 2, 2});
+    sys->Update(coord);
+
+    DynamicAABBTree::RayHit hit;
+    // Through the lower-left corner: the front one.
+    REQUIRE(sys->Raycast(coord, {0.2f, 0.2f, 10}, {0, 0, -1}, 100.0f, hit));
+    REQUIRE(hit.entity == front);
+    REQUIRE(hit.distance == Catch::Approx(5.0f));
+    // Through the front box's empty upper-right corner: past it to the
+    // scaled one behind.
+    REQUIRE(sys->Raycast(coord, {0.8f, 0.8f, 10}, {0, 0, -1}, 100.0f, hit));
+    REQUIRE(hit.entity == back);
+    REQUIRE(hit.distance == Catch::Approx(10.0f));
+    // Inside the back box, outside its triangle.
+    REQUIRE_FALSE(sys->Raycast(coord, {1.9f, 0.5f, 10}, {0, 0, -1}, 100.0f, hit));
+    REQUIRE_FALSE(sys->Raycast(coord, {0.2f, 0.2f, 10}, {0, 0, -1}, 4.0f, hit));
+
+    const TriangleBVH::Ray rays[] = {{{0.2f, 0.2f, 10}, {0, 0, -1}, 100.0f}, {{1.9f, 0.5f, 10}, {0, 0, -1}, 100.0f}};
+    DynamicAABBTree::RayHit hits[2];
+    REQUIRE(sys->RaycastBatch(coord, rays, 2, hits) == 1);
+    REQUIRE(hits[0].entity == front);
+    REQUIRE(hits[1].entity == NULL_ENTITY);
+}
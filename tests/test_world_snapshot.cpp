@@ -0,0 +1,238 @@
+#include "ECS/Coordinator.h"
+#include "ECS/WorldSnapshot.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct SnapBody {
+    float position = 0.f;
+    float velocity = 0.f;
+};
+
+// Not trivially copyable: goes through the typed-copy path.
+struct SnapName {
+    std::string name;
+    std::vector<int> history;
+};
+
+// Stands in for state that lives outside the ECS (a physics body).
+struct External {
+    float value = 0.f;
+};
+
+struct SnapHandle {
+    External* external = nullptr;
+};
+
+// Move-only: can't be snapshotted, only captured while none exist.
+struct SnapOwned {
+    std::unique_ptr<int> value;
+};
+
+class SnapBodySystem : public System {};
+class SnapNamedBodySystem : public System {};
+
+struct SnapWorld {
+    Coordinator coord;
+    std::shared_ptr<SnapBodySystem> bodies;
+    std::shared_ptr<SnapNamedBodySystem> named;
+
+    SnapWorld() {
+        coord.Init();
+        coord.RegisterComponent<SnapBody>();
+        coord.RegisterComponent<SnapName>();
+        coord.RegisterComponent<SnapHandle>();
+        bodies = coord.RegisterSystem<SnapBodySystem>();
+        named = coord.RegisterSystem<SnapNamedBodySystem>();
+        coord.SetSystemSignature<SnapBodySystem>(Signature{}.set(coord.GetComponentType<SnapBody>()));
+        coord.SetSystemSignature<SnapNamedBodySystem>(Signature{}
+                                                          .set(coord.GetComponentType<SnapBody>())
+                                                          .set(coord.GetComponentType<SnapName>()));
+    }
+
+    // Deterministic "game" step with structural changes mixed in.
+    void Step(int frame) {
+        std::vector<Entity> toDestroy;
+        for (Entity e : bodies->m_Entities) {
+            auto& body = coord.GetComponent<SnapBody>(e);
+            body.velocity -= 0.5f;
+            body.position += body.velocity;
+            if (body.position < -40.f) toDestroy.push_back(e);
+        }
+        for (Entity e : toDestroy) coord.DestroyEntity(e);
+        for (Entity e : named->m_Entities) {
+            coord.GetComponent<SnapName>(e).history.push_back(frame);
+        }
+        Entity spawned = coord.CreateEntity();
+        coord.AddComponent(spawned, SnapBody{float(frame), 1.f});
+        if (frame % 2) coord.AddComponent(spawned, SnapName{"spawn" + std::to_string(frame), {}});
+    }
+
+    // Everything a replay must reproduce, in iteration order.
+    std::vector<float> State() {
+        std::vector<float> out;
+        for (Entity e : coord.GetLivingEntities()) out.push_back(float(e));
+        for (Entity e : bodies->m_Entities) out.push_back(coord.GetComponent<SnapBody>(e).position);
+        for (Entity e : named->m_Entities) {
+            const auto& n = coord.GetComponent<SnapName>(e);
+            out.push_back(float(n.name.size() + n.history.size()));
+        }
+        coord.Group<SnapBody, SnapName>().ForEach(
+            [&](Entity e, SnapBody& b, SnapName&) { out.push_back(float(e) + b.velocity); });
+        return out;
+    }
+};
+
+} // namespace
+
+TEST_CASE("WorldSnapshot restores entities, components and systems in place", "[ecs][snapshot]") {
+    SnapWorld world;
+    Coordinator& coord = world.coord;
+    std::vector<Entity> original;
+    for (int i = 0; i < 100; ++i) {
+        Entity e = coord.CreateEntity();
+        coord.AddComponent(e, SnapBody{float(i), 0.f});
+        if (i % 3 == 0) coord.AddComponent(e, SnapName{"e" + std::to_string(i), {i}});
+        original.push_back(e);
+    }
+    coord.DestroyEntity(original[5]); // leave a slot on the free list
+    coord.Group<SnapBody, SnapName>();
+
+    const std::vector<float> before = world.State();
+    WorldSnapshot snapshot;
+    snapshot.Capture(coord);
+    REQUIRE(snapshot.HasCapture());
+    REQUIRE(snapshot.GetArenaSize() > 0);
+
+    std::vector<Entity> spawnedDuringPlay;
+    for (int frame = 0; frame < 60; ++frame) {
+        world.Step(frame);
+        spawnedDuringPlay.push_back(coord.CreateEntity());
+    }
+    REQUIRE(world.State() != before);
+
+    snapshot.Restore(coord);
+    REQUIRE(world.State() == before);
+    for (std::size_t i = 0; i < original.size(); ++i) {
+        REQUIRE(coord.IsAlive(original[i]) == (i != 5));
+    }
+    for (Entity e : spawnedDuringPlay) REQUIRE_FALSE(coord.IsAlive(e));
+    REQUIRE(coord.GetComponent<SnapName>(original[3]).history == std::vector<int>{3});
+
+    // The world keeps working after a restore: the free list and sparse
+    // indices are consistent.
+    Entity fresh = coord.CreateEntity();
+    REQUIRE(EntityIndex(fresh) == EntityIndex(original[5]));
+    coord.AddComponent(fresh, SnapBody{});
+    coord.AddComponent(fresh, SnapName{});
+    REQUIRE(world.named->m_Entities.count(fresh) == 1);
+    REQUIRE(coord.Group<SnapBody, SnapName>().Size() == 35);
+}
+
+TEST_CASE("WorldSnapshot replays a deterministic simulation exactly", "[ecs][snapshot]") {
+    SnapWorld world;
+    for (int i = 0; i < 50; ++i) {
+        Entity e = world.coord.CreateEntity();
+        world.coord.AddComponent(e, SnapBody{float(i), float(i % 7)});
+        if (i % 2) world.coord.AddComponent(e, SnapName{"n", {}});
+    }
+    for (int frame = 0; frame < 10; ++frame) world.Step(frame);
+
+    WorldSnapshot snapshot;
+    snapshot.Capture(world.coord);
+    std::vector<std::vector<float>> firstRun;
+    for (int frame = 10; frame < 80; ++frame) {
+        world.Step(frame);
+        firstRun.push_back(world.State());
+    }
+
+    // Roll back twice from the same capture; each replay matches.
+    for (int replay = 0; replay < 2; ++replay) {
+        snapshot.Restore(world.coord);
+        for (int frame = 10; frame < 80; ++frame) {
+            world.Step(frame);
+            REQUIRE(world.State() == firstRun[frame - 10]);
+        }
+    }
+}
+
+TEST_CASE("WorldSnapshot hooks save and reapply outside state", "[ecs][snapshot]") {
+    SnapWorld world;
+    std::vector<External> externals(10);
+    for (int i = 0; i < 10; ++i) {
+        externals[i].value = float(i);
+        Entity e = world.coord.CreateEntity();
+        world.coord.AddComponent(e, SnapHandle{&externals[i]});
+    }
+
+    WorldSnapshot snapshot;
+    snapshot.AddHooks<SnapHandle, float>(
+        [](Entity, const SnapHandle& h) { return h.external->value; },
+        [](Entity, SnapHandle& h, const float& value) { h.external->value = value; });
+    snapshot.Capture(world.coord);
+
+    for (External& ext : externals) ext.value = -1.f;
+    snapshot.Restore(world.coord);
+    for (int i = 0; i < 10; ++i) REQUIRE(externals[i].value == float(i));
+}
+
+TEST_CASE("WorldSnapshot restore reads as a change to change-tick consumers", "[ecs][snapshot]") {
+    SnapWorld world;
+    Entity e = world.coord.CreateEntity();
+    world.coord.AddComponent(e, SnapBody{1.f, 0.f});
+
+    WorldSnapshot snapshot;
+    snapshot.Capture(world.coord);
+    const ChangeTick seen = world.coord.AdvanceChangeTick();
+    REQUIRE_FALSE(world.coord.ChangedSince<SnapBody>(e, seen));
+
+    snapshot.Restore(world.coord);
+    REQUIRE(world.coord.ChangedSince<SnapBody>(e, seen));
+    REQUIRE(world.coord.LastChangeTick<SnapBody>() > seen);
+}
+
+TEST_CASE("WorldSnapshot captures non-copyable components only while there are none", "[ecs][snapshot]") {
+    SnapWorld world;
+    Coordinator& coord = world.coord;
+    coord.RegisterComponent<SnapOwned>();
+    class OwnedSystem : public System {};
+    auto owned = coord.RegisterSystem<OwnedSystem>();
+    coord.SetSystemSignature<OwnedSystem>(Signature{}
+                                              .set(coord.GetComponentType<SnapBody>())
+                                              .set(coord.GetComponentType<SnapOwned>()));
+
+    Entity e = coord.CreateEntity();
+    coord.AddComponent(e, SnapBody{2.f, 0.f});
+    WorldSnapshot snapshot;
+    snapshot.Capture(coord);
+
+    // Added during play: Restore drops it along with system membership.
+    coord.AddComponent(e, SnapOwned{std::make_unique<int>(7)});
+    coord.GetComponent<SnapBody>(e).position = 9.f;
+    REQUIRE(owned->m_Entities.count(e) == 1);
+
+    // Live non-copyable components refuse a capture, and the refusal
+    // leaves the previous one intact.
+    REQUIRE_THROWS_AS(snapshot.Capture(coord), std::logic_error);
+    REQUIRE(snapshot.HasCapture());
+
+    snapshot.Restore(coord);
+    REQUIRE(coord.IsAlive(e));
+    REQUIRE(coord.GetComponent<SnapBody>(e).position == 2.f);
+    REQUIRE_FALSE(coord.HasComponent<SnapOwned>(e));
+    REQUIRE(owned->m_Entities.empty());
+
+    // Still usable afterwards, and capturable again once emptied.
+    coord.AddComponent(e, SnapOwned{std::make_unique<int>(8)});
+    REQUIRE(*coord.GetComponent<SnapOwned>(e).value == 8);
+    REQUIRE(owned->m_Entities.count(e) == 1);
+    coord.RemoveComponent<SnapOwned>(e);
+    snapshot.Capture(coord);
+    REQUIRE(snapshot.HasCapture());
+}